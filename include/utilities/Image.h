@@ -1,39 +1,89 @@
 #ifndef UTILS_IMAGE_H
-#define UITLS_IMAGE_H
+#define UTILS_IMAGE_H
 
 #include "vkrender/VulkanRendererExports.hpp"
 #include "utilities/UtilityCommon.hpp"
+#include "utilities/memory.hpp"
 
 #include <filesystem>
+#include <utility>
+#include <vector>
 
 namespace utils
 {
+    class MappedFile;
+
     class VULKANRENDERER_EXPORTS Image
     {
     public:
         using ImgBufPtr = unsigned char*;
 
+        // one level of the payload in buffer(), levels are stored base level first
+        struct MipLevel
+        {
+            Dimension m_dimension;
+            std::size_t m_offset;
+            std::size_t m_sizeInBytes;
+        };
+
         Image();
         Image( const Dimension& dimension, const uint32_t& channels, ImgBufPtr buffer );
+        Image( const Image& ) = delete;
+        Image& operator=( const Image& ) = delete;
         ~Image();
 
-        void loadBuffer( const std::filesystem::path& path );
+        // .ktx2 and .dds files are read as stored, including their mip levels and block compressed format,
+        // baked .vkrtex files are mapped and their levels used in place, anything else is decoded by stb_image
+        // desiredChannels 0 keeps the channel count of the file, the texture upload path expects 4
+        void loadBuffer( const std::filesystem::path& path, const uint32_t& desiredChannels = 4 );
         void clearBuffer();
 
+        // every stored level
         std::size_t sizeInBytes() const;
 
+        // full chain length for decoded images, the stored level count for container images
         uint32_t miplevels() const { return m_mipLevels; }
+        uint32_t storedMiplevels() const { return static_cast<uint32_t>( m_storedMipLevels.size() ); }
+        const MipLevel& mipLevel( const uint32_t& level ) const { return m_storedMipLevels[level]; }
+        // VkFormat of a container payload, 0 (VK_FORMAT_UNDEFINED) for decoded pixels whose format the caller picks
+        uint32_t vkFormat() const { return m_vkFormat; }
+        bool isBlockCompressed() const { return m_blockDimension.m_width > 1 || m_blockDimension.m_height > 1; }
+        // channels per pixel in buffer(), 0 for block compressed payloads
         uint32_t colorChannels() const { return m_colorChannels; }
+        // channels stored in the source file
+        uint32_t sourceChannels() const { return m_sourceChannels; }
         Dimension dimension() const { return m_imgDimension; }
         const ImgBufPtr buffer() const { return m_buffer; }
+
+        // texel block footprint of the formats container payloads may use, false for any other format
+        static bool blockFootprint( const uint32_t& vkFormat, Dimension& blockDimension, uint32_t& bytesPerBlock );
+        static std::size_t levelSizeInBytes( const Dimension& levelDimension, const Dimension& blockDimension, const uint32_t& bytesPerBlock );
     private:
+        friend class MipmapGenerator;
+
         Dimension m_imgDimension;
         ImgBufPtr m_buffer;
         std::uint32_t m_colorChannels;
+        std::uint32_t m_sourceChannels;
         std::uint32_t m_mipLevels;
+        std::uint32_t m_vkFormat;
+        Dimension m_blockDimension;
+        std::vector<MipLevel> m_storedMipLevels;
+        // owns container payloads and generated mip chains, decoded pixels are owned by stb_image
+        std::vector<unsigned char> m_payload;
+        // backs buffer() for baked textures
+        Uptr<MappedFile> m_pMappedFile;
 
         void calculateMiplevels();
+        void loadKtx2( const std::filesystem::path& path );
+        void loadDds( const std::filesystem::path& path );
+        void loadTextureCache( const std::filesystem::path& path );
+        // validates the format and size of a container and takes its levels, base level first
+        void setContainerPayload(
+            const std::filesystem::path& path, const uint32_t& vkFormat, const Dimension& dimension,
+            const std::vector<std::pair<const unsigned char*, std::size_t>>& levels
+        );
     };
 } // namespace utils
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,90 @@
+#ifndef UTILS_IMAGE_LOADER_H
+#define UTILS_IMAGE_LOADER_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+#include "utilities/Image.h"
+#include "utilities/ThreadPool.h"
+#include "utilities/memory.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace utils
+{
+    // Decodes images on a thread pool, load() returns immediately with a handle that is
+    // polled or waited on. Decoded images stay owned by the loader until released.
+    class VULKANRENDERER_EXPORTS ImageLoader
+    {
+    public:
+        using Handle = std::uint64_t;
+        static constexpr Handle INVALID_HANDLE = 0;
+
+        enum class State
+        {
+            ePending,
+            eReady,
+            eFailed
+        };
+
+        struct Statistics
+        {
+            std::uint64_t m_decodedCount = 0;
+            std::uint64_t m_failedCount = 0;
+            // bytes read from disk and bytes of decoded pixels
+            std::uint64_t m_fileBytes = 0;
+            std::uint64_t m_decodedBytes = 0;
+            // summed over workers, not wall time
+            std::uint64_t m_decodeNanoseconds = 0;
+        };
+
+        explicit ImageLoader( ThreadPool* pThreadPool );
+        ImageLoader( const ImageLoader& ) = delete;
+        ImageLoader& operator=( const ImageLoader& ) = delete;
+        // waits for decodes still running on the pool
+        ~ImageLoader();
+
+        // thread safe, desiredChannels as in Image::loadBuffer
+        Handle load( const std::filesystem::path& path, const std::uint32_t& desiredChannels = 4, const JobPriority& priority = JobPriority::eNormal );
+
+        State state( const Handle& handle );
+        // nullptr until the handle is ready or when the decode failed
+        const Image* image( const Handle& handle );
+        // blocks until the decode finished, nullptr when it failed
+        const Image* wait( const Handle& handle );
+        // blocks until at least one of the pending handles finished and returns every finished one,
+        // lets callers consume decodes in completion order instead of submission order
+        std::vector<Handle> waitAny( const std::vector<Handle>& handles );
+        void waitAll();
+
+        // frees the decoded pixels, a pending handle is dropped once its decode finishes
+        void release( const Handle& handle );
+
+        Statistics statistics();
+    private:
+        struct Request
+        {
+            std::filesystem::path m_path;
+            State m_state = State::ePending;
+            bool m_bReleased = false;
+            Uptr<Image> m_pImage;
+        };
+
+        ThreadPool* m_pThreadPool;
+
+        std::mutex m_requestMutex;
+        std::condition_variable m_finishedCondition;
+        std::unordered_map<Handle, Request> m_requests;
+        Handle m_nextHandle;
+        std::size_t m_pendingCount;
+        Statistics m_statistics;
+
+        void decode( const Handle& handle, const std::filesystem::path& path, const std::uint32_t& desiredChannels );
+    };
+} // namespace utils
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef UTILS_MAPPED_FILE_H
+#define UTILS_MAPPED_FILE_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+
+#include <cstddef>
+#include <filesystem>
+
+namespace utils
+{
+    // Read only mapping of a whole file, pages are faulted in by the OS on first access
+    class VULKANRENDERER_EXPORTS MappedFile
+    {
+    public:
+        MappedFile();
+        MappedFile( const MappedFile& ) = delete;
+        MappedFile& operator=( const MappedFile& ) = delete;
+        ~MappedFile();
+
+        // throws when the file cannot be opened or mapped
+        void open( const std::filesystem::path& path );
+        void close();
+
+        bool isOpen() const { return m_pData != nullptr; }
+        const unsigned char* data() const { return m_pData; }
+        std::size_t size() const { return m_size; }
+    private:
+        const unsigned char* m_pData;
+        std::size_t m_size;
+#ifdef WIN32
+        void* m_fileHandle;
+        void* m_mappingHandle;
+#endif
+    };
+} // namespace utils
+
+#endif
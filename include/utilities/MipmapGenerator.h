@@ -0,0 +1,72 @@
+#ifndef UTILS_MIPMAP_GENERATOR_H
+#define UTILS_MIPMAP_GENERATOR_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+#include "utilities/UtilityCommon.hpp"
+
+#include <cstdint>
+#include <functional>
+
+namespace utils
+{
+    class Image;
+    class ThreadPool;
+
+    // Builds the full mip chain of decoded 8 bit RGBA images on the CPU, levels are filtered in float
+    // from the previous level and rows are split across the thread pool for large images
+    class VULKANRENDERER_EXPORTS MipmapGenerator
+    {
+    public:
+        enum class Filter : std::uint32_t
+        {
+            eBox = 0,
+            eKaiser
+        };
+
+        // kernel sets from narrowest to widest, eVector is SSE2 or NEON depending on the build target
+        enum class SimdPath : std::uint32_t
+        {
+            eScalar = 0,
+            eVector,
+            eAvx2
+        };
+
+        struct Settings
+        {
+            Filter m_filter = Filter::eBox;
+            // color is filtered in linear space and stored back as sRGB, alpha is always linear
+            bool m_bSrgb = false;
+            // alpha tested textures keep the fraction of texels above this cutoff on every level, 0 disables
+            float m_alphaCoverageCutoff = 0.0f;
+            // Kaiser window shape and half width in destination texels
+            float m_kaiserAlpha = 4.0f;
+            float m_kaiserWidth = 3.0f;
+            // widest kernels used, lowered to compare paths, clamped to what the build and the CPU support
+            SimdPath m_maxSimdPath = SimdPath::eAvx2;
+        };
+
+        // without a thread pool every level is built on the calling thread
+        explicit MipmapGenerator( ThreadPool* pThreadPool = nullptr );
+
+        // src holds decoded 4 channel pixels, dst receives its base level followed by every generated level
+        // as one payload that uploads without blits, throws for container images or other channel counts
+        // must not be called from a job of the generator's own thread pool
+        void generate( const Image& src, const Settings& settings, Image& dst ) const;
+
+        // widest kernels the build and the running CPU support, AVX2 is detected at runtime
+        static SimdPath bestSimdPath();
+        static const char* simdPathName( const SimdPath& simdPath );
+        // name of bestSimdPath()
+        static const char* simdPath();
+    private:
+        ThreadPool* m_pThreadPool;
+
+        // runs rowJob( firstRow, endRow ) over bands of [0, rowCount), on the pool when the work is large enough
+        void parallelRows(
+            const std::uint32_t& rowCount, const std::size_t& texelsPerRow,
+            const std::function<void( std::uint32_t, std::uint32_t )>& rowJob
+        ) const;
+    };
+} // namespace utils
+
+#endif
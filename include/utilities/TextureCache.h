@@ -0,0 +1,61 @@
+#ifndef UTILS_TEXTURE_CACHE_H
+#define UTILS_TEXTURE_CACHE_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+#include "utilities/UtilityCommon.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace utils
+{
+    // Baked texture file (.vkrtex), little endian:
+    //   TextureCacheHeader
+    //   TextureCacheLevel[m_levelCount], base level first
+    //   level data, each level at a LEVEL_ALIGNMENT boundary
+    // Levels are stored ready to copy into an image so a mapped file can be handed to the staging path as is.
+    struct TextureCacheHeader
+    {
+        char m_magic[8];
+        std::uint32_t m_version;
+        // VkFormat of every level
+        std::uint32_t m_vkFormat;
+        std::uint32_t m_width;
+        std::uint32_t m_height;
+        std::uint32_t m_levelCount;
+        std::uint32_t m_reserved;
+    };
+
+    struct TextureCacheLevel
+    {
+        // from the start of the file
+        std::uint64_t m_offset;
+        std::uint64_t m_sizeInBytes;
+        std::uint32_t m_width;
+        std::uint32_t m_height;
+    };
+
+    class VULKANRENDERER_EXPORTS TextureCache
+    {
+    public:
+        static constexpr char MAGIC[8] = { 'V', 'K', 'R', 'T', 'E', 'X', '\r', '\n' };
+        static constexpr std::uint32_t VERSION = 1;
+        static constexpr std::uint64_t LEVEL_ALIGNMENT = 16;
+        static constexpr const char* FILE_EXTENSION = ".vkrtex";
+
+        struct Level
+        {
+            Dimension m_dimension;
+            const unsigned char* m_pData;
+            std::size_t m_sizeInBytes;
+        };
+
+        // throws when the file cannot be written
+        static void write( const std::filesystem::path& path, const std::uint32_t& vkFormat, const std::vector<Level>& levels );
+        // checks the header and level table of a mapped file against its size, throws when they do not match
+        static std::vector<TextureCacheLevel> readLevels( const std::filesystem::path& path, const unsigned char* pData, const std::size_t& size, TextureCacheHeader& header );
+    };
+} // namespace utils
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef UTILS_THREAD_POOL_H
+#define UTILS_THREAD_POOL_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace utils
+{
+    enum class JobPriority : std::uint32_t
+    {
+        eHigh = 0,
+        eNormal,
+        eLow,
+        eCount
+    };
+
+    // Fixed set of worker threads, jobs are taken FIFO from the highest non empty priority
+    class VULKANRENDERER_EXPORTS ThreadPool
+    {
+    public:
+        explicit ThreadPool( const std::uint32_t& numOfThreads = defaultThreadCount() );
+        ThreadPool( const ThreadPool& ) = delete;
+        ThreadPool& operator=( const ThreadPool& ) = delete;
+        ~ThreadPool();
+
+        template<typename _Func>
+        auto submit( _Func&& func, const JobPriority& priority = JobPriority::eNormal ) -> std::future<std::invoke_result_t<_Func>>
+        {
+            using ResultType = std::invoke_result_t<_Func>;
+
+            auto pTask = std::make_shared<std::packaged_task<ResultType()>>( std::forward<_Func>( func ) );
+            std::future<ResultType> result = pTask->get_future();
+
+            enqueue( [pTask](){ (*pTask)(); }, priority );
+
+            return result;
+        }
+
+        std::uint32_t workerCount() const { return static_cast<std::uint32_t>( m_workers.size() ); }
+
+        static std::uint32_t defaultThreadCount();
+    private:
+        std::vector<std::thread> m_workers;
+        std::array<std::deque<std::function<void()>>, static_cast<std::size_t>( JobPriority::eCount )> m_jobs;
+
+        std::mutex m_jobMutex;
+        std::condition_variable m_jobCondition;
+        bool m_bStop;
+
+        void enqueue( std::function<void()>&& job, const JobPriority& priority );
+        bool hasPendingJobs() const;
+        void workerLoop();
+    };
+} // namespace utils
+
+#endif
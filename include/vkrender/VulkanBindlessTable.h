@@ -0,0 +1,84 @@
+#ifndef VKRENDER_VULKAN_BINDLESS_TABLE_H
+#define VKRENDER_VULKAN_BINDLESS_TABLE_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+#include "vkrender/VulkanDescriptorLayoutCache.h"
+#include "vkrender/VulkanDescriptorAllocator.h"
+#include "utilities/memory.hpp"
+
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace vkrender
+{
+
+// One update-after-bind descriptor set holding every sampled image and sampler of the renderer.
+// Shaders index the arrays with slots passed through push constants or instance data, so drawing
+// with a different texture needs no descriptor set bind. A released slot is only handed out again
+// once every frame that could still read it has completed.
+class VULKANRENDERER_EXPORTS VulkanBindlessTable
+{
+public:
+    static constexpr std::uint32_t SAMPLED_IMAGE_BINDING = 0u;
+    static constexpr std::uint32_t SAMPLER_BINDING = 1u;
+    static constexpr std::uint32_t INVALID_SLOT = 0xFFFFFFFFu;
+
+    static constexpr std::uint32_t DEFAULT_MAX_SAMPLED_IMAGES = 16384u;
+    static constexpr std::uint32_t DEFAULT_MAX_SAMPLERS = 64u;
+
+    VulkanBindlessTable(
+        vk::Device* pLogicalDevice, VulkanDescriptorLayoutCache* pLayoutCache,
+        const std::uint32_t& framesInFlight,
+        const std::uint32_t& maxSampledImages = DEFAULT_MAX_SAMPLED_IMAGES,
+        const std::uint32_t& maxSamplers = DEFAULT_MAX_SAMPLERS
+    );
+    ~VulkanBindlessTable();
+
+    // thread safe, the slot stays valid until released
+    std::uint32_t registerSampledImage( const vk::ImageView& vkImageView, const vk::ImageLayout& imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal );
+    std::uint32_t registerSampler( const vk::Sampler& vkSampler );
+    void releaseSampledImage( const std::uint32_t& slot );
+    void releaseSampler( const std::uint32_t& slot );
+
+    // called once per frame after the frame's fence wait, recycles slots no frame in flight can reference
+    void beginFrame( const std::uint64_t& frameNumber );
+
+    void bind( vk::CommandBuffer& vkCmdBuffer, const vk::PipelineLayout& vkPipelineLayout, const std::uint32_t& setIndex, const vk::PipelineBindPoint& bindPoint = vk::PipelineBindPoint::eGraphics ) const;
+
+    vk::DescriptorSetLayout layout() const { return m_vkDescriptorSetLayout; }
+    vk::DescriptorSet descriptorSet() const { return m_vkDescriptorSet; }
+    std::uint32_t sampledImageCount();
+    std::uint64_t descriptorWriteCount() const { return m_pDescriptorAllocator->writeCount(); }
+private:
+    struct SlotArray
+    {
+        std::uint32_t m_capacity = 0;
+        std::uint32_t m_nextUnused = 0;
+        std::vector<std::uint32_t> m_freeSlots;
+        // slot and the frame number it was released in
+        std::deque<std::pair<std::uint32_t, std::uint64_t>> m_retiredSlots;
+
+        std::uint32_t acquire();
+    };
+
+    vk::Device* m_pLogicalDevice;
+    std::uint32_t m_framesInFlight;
+
+    vk::DescriptorSetLayout m_vkDescriptorSetLayout;
+    utils::Uptr<VulkanDescriptorAllocator> m_pDescriptorAllocator;
+    vk::DescriptorSet m_vkDescriptorSet;
+
+    std::mutex m_tableMutex;
+    std::uint64_t m_frameNumber;
+    SlotArray m_sampledImages;
+    SlotArray m_samplers;
+
+    void recycle( SlotArray& slotArray );
+    void writeDescriptor( const std::uint32_t& binding, const std::uint32_t& slot, const vk::DescriptorType& descriptorType, const vk::DescriptorImageInfo& imageInfo );
+};
+
+} // namespace vkrender
+
+#endif
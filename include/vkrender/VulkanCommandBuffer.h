@@ -2,30 +2,60 @@
 #define VKRENDER_VULKAN_COMMAND_BUFFER_H
 
 
+#include <mutex>
 #include <vulkan/vulkan.hpp>
 
 namespace vkrender
 {
 
+class VulkanImmediateCmdBuffer;
+
+// Waitable handle of a VulkanImmediateCmdBuffer::submitAsync() submission
+class VulkanSubmitToken
+{
+public:
+    VulkanSubmitToken() = default;
+    VulkanSubmitToken( VulkanImmediateCmdBuffer* pCmdBuffer, const std::uint64_t& submitIndex )
+        :m_pCmdBuffer{ pCmdBuffer }
+        ,m_submitIndex{ submitIndex }
+    {}
+
+    bool isValid() const { return m_pCmdBuffer != nullptr; }
+    bool isReady() const;
+    void wait() const;
+private:
+    VulkanImmediateCmdBuffer* m_pCmdBuffer = nullptr;
+    std::uint64_t m_submitIndex = 0;
+};
+
 class VulkanCmdBuffer
 {
 public:
     VulkanCmdBuffer(
         vk::Device* pLogicalDevice,    
         vk::Queue* pQueueToUse,
-        vk::CommandPool* pCommandPool
+        std::mutex* pQueueMutex,
+        vk::CommandPool* pCommandPool,
+        std::mutex* pCommandPoolMutex
     )
         :m_pLogicalDevice{ pLogicalDevice }
         ,m_pSubmitionQueue{ pQueueToUse }
+        ,m_pQueueMutex{ pQueueMutex }
         ,m_pCommandPool{ pCommandPool }
+        ,m_pCommandPoolMutex{ pCommandPoolMutex }
     {}
 
     virtual ~VulkanCmdBuffer() = default;
 
     vk::CommandBuffer* handle() { return &m_vkCmdBuffer; }
 
+    // fence signalled by the next submission of this command buffer
+    void signalFenceOnSubmit( const vk::Fence& vkFence ) { m_vkSignalFence = vkFence; }
+
     virtual void allocate()
     {
+        std::lock_guard<std::mutex> poolLock{ *m_pCommandPoolMutex };
+
         vk::CommandBufferAllocateInfo allocInfo{};
 	    allocInfo.commandPool = *m_pCommandPool;
 	    allocInfo.level = vk::CommandBufferLevel::ePrimary;
@@ -40,9 +70,15 @@ public:
 protected:
     vk::Device* m_pLogicalDevice;
     vk::Queue* m_pSubmitionQueue;
+    // held for every submit and wait on the queue, see VulkanRenderer::queueMutex
+    std::mutex* m_pQueueMutex;
     vk::CommandPool* m_pCommandPool;
+    // held from begin until the recording ends, see VulkanRenderer::commandPoolMutex
+    std::mutex* m_pCommandPoolMutex;
+    std::unique_lock<std::mutex> m_recordingLock;
 
     vk::CommandBuffer m_vkCmdBuffer;
+    vk::Fence m_vkSignalFence;
 };
 
 class VulkanImmediateCmdBuffer : public VulkanCmdBuffer
@@ -51,15 +87,31 @@ public:
     VulkanImmediateCmdBuffer(
         vk::Device* pLogicalDevice,
         vk::Queue* pQueueToUse,
-        vk::CommandPool* pCommandPool
+        std::mutex* pQueueMutex,
+        vk::CommandPool* pCommandPool,
+        std::mutex* pCommandPoolMutex
     )
-        :VulkanCmdBuffer{ pLogicalDevice, pQueueToUse, pCommandPool }
+        :VulkanCmdBuffer{ pLogicalDevice, pQueueToUse, pQueueMutex, pCommandPool, pCommandPoolMutex }
+        ,m_submitCount{ 0 }
+        ,m_completedCount{ 0 }
     {}
 
-    ~VulkanImmediateCmdBuffer() = default;
+    ~VulkanImmediateCmdBuffer();
+
+    void allocate() override;
 
+    // waits for the previous submission of this command buffer before recording again
     vk::CommandBuffer* beginCmdBuffer() override;
+    // submits and waits only for this submission, not for the whole device
     void endCmdBuffer() override;
+    VulkanSubmitToken submitAsync();
+
+    bool isComplete( const std::uint64_t& submitIndex );
+    void wait( const std::uint64_t& submitIndex );
+private:
+    vk::Fence m_vkCompletionFence;
+    std::uint64_t m_submitCount;
+    std::uint64_t m_completedCount;
 };
 
 class VulkanTemporaryCmdBuffer : public VulkanCmdBuffer
@@ -68,9 +120,11 @@ public:
     VulkanTemporaryCmdBuffer(
         vk::Device* pLogicalDevice,
         vk::Queue* pQueueToUse,
-        vk::CommandPool* pCommandPool
+        std::mutex* pQueueMutex,
+        vk::CommandPool* pCommandPool,
+        std::mutex* pCommandPoolMutex
     )
-        :VulkanCmdBuffer{ pLogicalDevice, pQueueToUse, pCommandPool }
+        :VulkanCmdBuffer{ pLogicalDevice, pQueueToUse, pQueueMutex, pCommandPool, pCommandPoolMutex }
     {}
 
     ~VulkanTemporaryCmdBuffer() = default;
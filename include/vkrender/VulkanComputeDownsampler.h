@@ -0,0 +1,95 @@
+#ifndef VKRENDER_VULKAN_COMPUTE_DOWNSAMPLER_H
+#define VKRENDER_VULKAN_COMPUTE_DOWNSAMPLER_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+#include "vkrender/VulkanMemoryAllocator.h"
+
+#include <atomic>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace vkrender
+{
+
+class VulkanRenderer;
+class VulkanTexture;
+
+// Single pass compute downsampler. One dispatch builds up to MAX_DOWNSAMPLED_MIPS levels below its source
+// through per level storage views, instead of a blit and two barriers per level. Work groups reduce 64x64
+// tiles to mip 6 in shared memory and the last group to finish, found through an atomic counter, reduces
+// mip 6 further. Chains longer than that, or sources larger than 4096 texels, take one more dispatch
+// per 6 levels. Commands can be recorded on any compute capable queue of the family owning the textures,
+// as long as that queue supports the stage the results are consumed in.
+class VULKANRENDERER_EXPORTS VulkanComputeDownsampler
+{
+public:
+    static constexpr std::uint32_t MAX_DOWNSAMPLED_MIPS = 12;
+    // arrival counters are handed out round robin, one per dispatch that may be in flight at once
+    static constexpr std::uint32_t COUNTER_SLOTS = 1024;
+
+    explicit VulkanComputeDownsampler( VulkanRenderer* pVkRenderer );
+    VulkanComputeDownsampler( const VulkanComputeDownsampler& ) = delete;
+    VulkanComputeDownsampler& operator=( const VulkanComputeDownsampler& ) = delete;
+    ~VulkanComputeDownsampler();
+
+    // sampled and storage support of the format or of its UNORM alias for sRGB formats
+    bool isFormatSupported( const vk::Format& format ) const;
+    // usage and create flags a texture needs at creation to go through record()
+    static vk::ImageUsageFlags requiredUsage() { return vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled; }
+    static vk::ImageCreateFlags requiredCreateFlags( const vk::Format& format );
+
+    // every level of the textures is expected in TransferDstOptimal with level 0 written by a transfer,
+    // all levels end up in ShaderReadOnlyOptimal and are made visible to dstAccess in dstStage,
+    // views and descriptors retire with the current frame
+    void record(
+        vk::CommandBuffer& vkCmdBuffer, const std::vector<VulkanTexture*>& textures,
+        const vk::PipelineStageFlags& dstStage = vk::PipelineStageFlagBits::eFragmentShader,
+        const vk::AccessFlags& dstAccess = vk::AccessFlagBits::eShaderRead
+    );
+private:
+    enum class StorageFormat : std::uint32_t
+    {
+        eRgba8 = 0,
+        eRgba16f,
+        eCount
+    };
+
+    struct PushConstants
+    {
+        std::int32_t m_srcWidth;
+        std::int32_t m_srcHeight;
+        std::uint32_t m_mipCount;
+        std::uint32_t m_workGroupCount;
+        std::uint32_t m_counterIndex;
+        std::uint32_t m_bSrgb;
+    };
+
+    // one dispatch, levels m_baseLevel + 1 .. m_baseLevel + m_mipCount of m_pTexture
+    struct Pass
+    {
+        VulkanTexture* m_pTexture;
+        std::uint32_t m_baseLevel;
+        std::uint32_t m_mipCount;
+    };
+
+    VulkanRenderer* m_pVkRenderer;
+    vk::Device* m_pLogicalDevice;
+
+    vk::DescriptorSetLayout m_vkDescriptorSetLayout;
+    vk::PipelineLayout m_vkPipelineLayout;
+    vk::Pipeline m_vkPipelines[static_cast<std::uint32_t>( StorageFormat::eCount )];
+
+    vk::Buffer m_vkCounterBuffer;
+    VulkanAllocation m_counterAllocation;
+    std::atomic<std::uint32_t> m_nextCounter;
+
+    static bool storageFormatOf( const vk::Format& format, vk::Format& storageFormat, StorageFormat& shaderFormat );
+    static std::vector<Pass> splitPasses( VulkanTexture* pTexture );
+
+    void createPipelines();
+    vk::ImageView createLevelView( VulkanTexture* pTexture, const std::uint32_t& level, const vk::Format& viewFormat, const vk::ImageUsageFlags& viewUsage );
+};
+
+} // namespace vkrender
+
+#endif
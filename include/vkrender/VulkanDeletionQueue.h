@@ -0,0 +1,113 @@
+#ifndef VKRENDER_VULKAN_DELETION_QUEUE_H
+#define VKRENDER_VULKAN_DELETION_QUEUE_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+#include "vkrender/VulkanMemoryAllocator.h"
+#include "vkrender/VulkanDescriptorAllocator.h"
+#include "vkrender/VulkanUploadScheduler.h"
+
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace vkrender
+{
+
+// Holds resources the GPU may still read until the point that last used them has retired.
+// Without a ticket a resource is keyed on the frame being recorded when it is queued, it is freed
+// once that frame's fence has been waited on. With a valid upload ticket it is freed once the
+// scheduler's ticket timeline reaches the ticket's value. Only the graphics queue signals that timeline,
+// after acquiring the upload and running its recorders, so a finished transfer alone never retires the
+// resource. Retired resources are destroyed in batches by collect().
+class VULKANRENDERER_EXPORTS VulkanDeletionQueue
+{
+public:
+    struct Statistics
+    {
+        std::uint64_t m_queuedCount = 0;
+        std::uint64_t m_destroyedCount = 0;
+        std::uint64_t m_batchCount = 0;
+        std::uint64_t m_maxPendingCount = 0;
+    };
+
+    VulkanDeletionQueue( vk::Device* pLogicalDevice, VulkanMemoryAllocator* pMemoryAllocator, const std::uint32_t& framesInFlight );
+    VulkanDeletionQueue( const VulkanDeletionQueue& ) = delete;
+    VulkanDeletionQueue& operator=( const VulkanDeletionQueue& ) = delete;
+    ~VulkanDeletionQueue();
+
+    // thread safe, the handles must not be used by the caller afterwards
+    void destroyBuffer( const vk::Buffer& vkBuffer, const VulkanAllocation& allocation, const VulkanUploadTicket& lastUse = {} );
+    void destroyImage( const vk::Image& vkImage, const VulkanAllocation& allocation, const VulkanUploadTicket& lastUse = {} );
+    void destroyImageView( const vk::ImageView& vkImageView, const VulkanUploadTicket& lastUse = {} );
+    void freeMemory( const VulkanAllocation& allocation, const VulkanUploadTicket& lastUse = {} );
+    void destroyPipeline( const vk::Pipeline& vkPipeline, const VulkanUploadTicket& lastUse = {} );
+    void destroyPipelineLayout( const vk::PipelineLayout& vkPipelineLayout, const VulkanUploadTicket& lastUse = {} );
+    void destroyDescriptorPool( const vk::DescriptorPool& vkDescriptorPool, const VulkanUploadTicket& lastUse = {} );
+    // the allocator must outlive the queue or be flushed before it is destroyed
+    void freeDescriptorSets( VulkanDescriptorAllocator* pDescriptorAllocator, const std::vector<vk::DescriptorSet>& vkDescriptorSets, const VulkanUploadTicket& lastUse = {} );
+    // the pool must outlive the queue or be flushed before it is destroyed, the free holds the pool's mutex
+    // since collect() runs on the frame thread while other threads may record into the same pool
+    void freeCommandBuffers(
+        const vk::CommandPool& vkCommandPool, std::mutex* pCommandPoolMutex,
+        const std::vector<vk::CommandBuffer>& vkCmdBuffers, const VulkanUploadTicket& lastUse = {}
+    );
+
+    // called once per frame after the frame's fence wait, frames before frameNumber - framesInFlight + 1 have completed
+    void collect( const std::uint64_t& frameNumber );
+    // destroys everything regardless of its retire point, the device must be idle
+    void flush();
+
+    std::size_t pendingCount();
+    Statistics statistics();
+private:
+    struct CommandBuffers
+    {
+        vk::CommandPool m_vkCommandPool;
+        std::mutex* m_pCommandPoolMutex = nullptr;
+        std::vector<vk::CommandBuffer> m_vkCmdBuffers;
+    };
+
+    struct Resources
+    {
+        std::vector<std::pair<vk::Buffer, VulkanAllocation>> m_buffers;
+        std::vector<std::pair<vk::Image, VulkanAllocation>> m_images;
+        std::vector<vk::ImageView> m_vkImageViews;
+        std::vector<VulkanAllocation> m_allocations;
+        std::vector<vk::Pipeline> m_vkPipelines;
+        std::vector<vk::PipelineLayout> m_vkPipelineLayouts;
+        std::vector<vk::DescriptorPool> m_vkDescriptorPools;
+        std::vector<std::pair<VulkanDescriptorAllocator*, std::vector<vk::DescriptorSet>>> m_descriptorSets;
+        std::vector<CommandBuffers> m_cmdBuffers;
+        std::size_t m_count = 0;
+    };
+
+    struct Batch
+    {
+        // frame number or timeline value, depending on the list the batch lives in
+        std::uint64_t m_retireValue = 0;
+        VulkanUploadTicket m_lastUse;
+        Resources m_resources;
+    };
+
+    vk::Device* m_pLogicalDevice;
+    VulkanMemoryAllocator* m_pMemoryAllocator;
+    std::uint32_t m_framesInFlight;
+
+    std::mutex m_queueMutex;
+    std::uint64_t m_frameNumber;
+    std::deque<Batch> m_frameBatches;
+    std::deque<Batch> m_timelineBatches;
+    std::size_t m_pendingCount;
+    Statistics m_statistics;
+
+    // returns the batch the resource goes into, the queue mutex must be held
+    Resources& batchFor( const VulkanUploadTicket& lastUse );
+    void onQueued();
+    void destroyResources( Resources& resources );
+};
+
+} // namespace vkrender
+
+#endif
@@ -2,6 +2,8 @@
 #define VKRENDER_VULKAN_DESCRIPTOR_H
 
 #include "vkrender/VulkanRendererExports.hpp"
+#include "vkrender/VulkanDescriptorLayoutCache.h"
+#include "vkrender/VulkanDescriptorAllocator.h"
 
 #include <vector>
 #include <vulkan/vulkan.hpp>
@@ -9,6 +11,8 @@
 namespace vkrender
 {
 
+class VulkanDeletionQueue;
+
 class VULKANRENDERER_EXPORTS VulkanDescriptor
 {
 public:
@@ -28,28 +32,50 @@ public:
 
     using DescriptorBindingArray = std::vector<DescriptorBinding>;
 
-    explicit VulkanDescriptor( vk::Device* pLogicalDevice, const std::uint32_t& numOfSetsPerPool = 1 );
+    // the layout is shared through the cache and the sets belong to the allocator's pools,
+    // they are freed on destruction when the allocator supports it, after the frames in flight when a deletion queue is given
+    VulkanDescriptor(
+        vk::Device* pLogicalDevice,
+        VulkanDescriptorLayoutCache* pLayoutCache, VulkanDescriptorAllocator* pDescriptorAllocator,
+        const std::uint32_t& numOfSets = 1,
+        VulkanDeletionQueue* pDeletionQueue = nullptr
+    );
     ~VulkanDescriptor();
 
     void allocateDescriptorSets( const DescriptorBindingArray& bindings );
-    
+
+    vk::DescriptorSetLayout layout() const { return m_vkDescriptorSetLayout; }
+    vk::DescriptorSet getDescriptorSet( const std::uint32_t& setIndex ) const { return m_vkDescriptorSets[setIndex]; }
+
+    // the write of bindingIndex only needs its resource info, set, binding and type are filled on update
     vk::WriteDescriptorSet* getWriteDescriptor( const std::uint32_t& bindingIndex );
+    // writes the same resources to every set in a single driver call
     void updateDescriptorSets();
+    // batches the pending writes of several descriptors into one driver call
+    static void updateDescriptorSetsBatched( vk::Device* pLogicalDevice, const std::vector<VulkanDescriptor*>& descriptors );
+
+    // the template reads every binding from one packed CPU struct, entries are shared per layout by the cache
+    void setUpdateTemplate( const std::vector<vk::DescriptorUpdateTemplateEntry>& templateEntries );
+    void updateDescriptorSet( const std::uint32_t& setIndex, const void* pTemplateData );
+    // set i reads its struct at pTemplateData + i * dataStride
+    void updateDescriptorSets( const void* pTemplateData, const std::size_t& dataStride );
 private:
     vk::Device* m_pLogicalDevice;
-    std::uint32_t m_numOfSetsPerPool;
+    VulkanDescriptorLayoutCache* m_pLayoutCache;
+    VulkanDescriptorAllocator* m_pDescriptorAllocator;
+    VulkanDeletionQueue* m_pDeletionQueue;
+    std::uint32_t m_numOfSets;
 
     vk::DescriptorSetLayout m_vkDescriptorSetLayout;
-    vk::DescriptorPool m_vkDescriptorPool;
+    vk::DescriptorUpdateTemplate m_vkUpdateTemplate;
 
     std::vector<vk::DescriptorSet> m_vkDescriptorSets;
+    std::vector<vk::DescriptorType> m_vkBindingTypes;
     std::vector<vk::WriteDescriptorSet> m_vkWriteDescriptorSets;
 
     void createDescriptorSetLayout( const DescriptorBindingArray& bindings );
-    void createDescriptorPool( const DescriptorBindingArray& bindings );
     void createDescriptorSets();
-
-    void destroyDescriptorSet();
+    void appendPendingWrites( std::vector<vk::WriteDescriptorSet>& vkWriteDescriptorSets ) const;
 
     friend class VulkanGfxPipeline;
 };
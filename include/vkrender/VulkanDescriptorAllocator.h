@@ -0,0 +1,88 @@
+#ifndef VKRENDER_VULKAN_DESCRIPTOR_ALLOCATOR_H
+#define VKRENDER_VULKAN_DESCRIPTOR_ALLOCATOR_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace vkrender
+{
+
+// Descriptor sets from a growing list of pools. A pool that runs out of memory is retired and a new one
+// is taken, reset() hands every pool back at once. Only pools created with eFreeDescriptorSet also free
+// single sets, a retired pool a set is freed from is taken again once the current one runs out.
+class VULKANRENDERER_EXPORTS VulkanDescriptorAllocator
+{
+public:
+    struct PoolSizeRatio
+    {
+        vk::DescriptorType m_descriptorType;
+        // descriptors of this type per set
+        float m_ratio;
+    };
+
+    struct Statistics
+    {
+        std::uint32_t m_poolCount = 0;
+        std::uint64_t m_allocationCount = 0;
+        std::uint64_t m_freeCount = 0;
+        std::uint64_t m_poolExhaustedCount = 0;
+        // descriptor writes into sets of this allocator
+        std::uint64_t m_writeCount = 0;
+    };
+
+    static constexpr std::uint32_t DEFAULT_SETS_PER_POOL = 256u;
+    static const std::vector<PoolSizeRatio> DEFAULT_POOL_SIZE_RATIOS;
+
+    VulkanDescriptorAllocator(
+        vk::Device* pLogicalDevice,
+        const std::uint32_t& setsPerPool = DEFAULT_SETS_PER_POOL,
+        const std::vector<PoolSizeRatio>& poolSizeRatios = DEFAULT_POOL_SIZE_RATIOS,
+        const vk::DescriptorPoolCreateFlags& poolCreateFlags = {}
+    );
+    VulkanDescriptorAllocator( const VulkanDescriptorAllocator& ) = delete;
+    VulkanDescriptorAllocator& operator=( const VulkanDescriptorAllocator& ) = delete;
+    ~VulkanDescriptorAllocator();
+
+    // thread safe, pNext is forwarded to vk::DescriptorSetAllocateInfo
+    vk::DescriptorSet allocate( const vk::DescriptorSetLayout& vkDescriptorSetLayout, const void* pNext = nullptr );
+    std::vector<vk::DescriptorSet> allocate( const std::vector<vk::DescriptorSetLayout>& vkDescriptorSetLayouts, const void* pNext = nullptr );
+
+    // thread safe, needs eFreeDescriptorSet pools and the GPU must be done with the sets
+    void free( const std::vector<vk::DescriptorSet>& vkDescriptorSets );
+    bool freesSets() const { return static_cast<bool>( m_vkPoolCreateFlags & vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet ); }
+
+    // every set allocated so far becomes invalid, the GPU must be done with them
+    void reset();
+
+    // lock free, called by whoever updates the allocator's sets
+    void recordWrites( const std::uint32_t& writeCount ) { m_writeCount.fetch_add( writeCount, std::memory_order_relaxed ); }
+    std::uint64_t writeCount() const { return m_writeCount.load( std::memory_order_relaxed ); }
+
+    Statistics statistics();
+private:
+    vk::Device* m_pLogicalDevice;
+    std::uint32_t m_setsPerPool;
+    std::vector<PoolSizeRatio> m_poolSizeRatios;
+    vk::DescriptorPoolCreateFlags m_vkPoolCreateFlags;
+
+    std::mutex m_allocatorMutex;
+    vk::DescriptorPool m_vkCurrentPool;
+    std::vector<vk::DescriptorPool> m_vkUsedPools;
+    std::vector<vk::DescriptorPool> m_vkFreePools;
+    // pool of every live set, only tracked when sets can be freed
+    std::unordered_map<VkDescriptorSet, vk::DescriptorPool> m_setPools;
+    Statistics m_statistics;
+    std::atomic<std::uint64_t> m_writeCount;
+
+    vk::DescriptorPool grabPool();
+    vk::DescriptorPool createPool();
+};
+
+} // namespace vkrender
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef VKRENDER_VULKAN_DESCRIPTOR_LAYOUT_CACHE_H
+#define VKRENDER_VULKAN_DESCRIPTOR_LAYOUT_CACHE_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+#include "vkrender/VulkanShaderReflection.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace vkrender
+{
+
+// Binding signature of a descriptor set layout, bindings are kept sorted by binding number
+struct DescriptorLayoutKey
+{
+    struct Binding
+    {
+        std::uint32_t m_binding = 0;
+        vk::DescriptorType m_descriptorType = vk::DescriptorType::eUniformBuffer;
+        std::uint32_t m_descriptorCount = 0;
+        vk::ShaderStageFlags m_stageFlags;
+        vk::DescriptorBindingFlags m_bindingFlags;
+        std::vector<vk::Sampler> m_immutableSamplers;
+
+        bool operator==( const Binding& other ) const;
+    };
+
+    vk::DescriptorSetLayoutCreateFlags m_createFlags;
+    std::vector<Binding> m_bindings;
+
+    bool operator==( const DescriptorLayoutKey& other ) const;
+    std::size_t hash() const;
+};
+
+struct DescriptorLayoutKeyHash
+{
+    std::size_t operator()( const DescriptorLayoutKey& layoutKey ) const { return layoutKey.hash(); }
+};
+
+struct DescriptorUpdateTemplateKey
+{
+    vk::DescriptorSetLayout m_vkDescriptorSetLayout;
+    std::vector<vk::DescriptorUpdateTemplateEntry> m_templateEntries;
+
+    bool operator==( const DescriptorUpdateTemplateKey& other ) const;
+    std::size_t hash() const;
+};
+
+struct DescriptorUpdateTemplateKeyHash
+{
+    std::size_t operator()( const DescriptorUpdateTemplateKey& templateKey ) const { return templateKey.hash(); }
+};
+
+// Renderer wide set of descriptor set layouts, every distinct binding signature is created once and shared
+class VULKANRENDERER_EXPORTS VulkanDescriptorLayoutCache
+{
+public:
+    explicit VulkanDescriptorLayoutCache( vk::Device* pLogicalDevice );
+    ~VulkanDescriptorLayoutCache();
+
+    // bindingFlags is either empty or holds one entry per binding
+    vk::DescriptorSetLayout acquire(
+        const std::vector<vk::DescriptorSetLayoutBinding>& bindings,
+        const vk::DescriptorSetLayoutCreateFlags& createFlags = {},
+        const std::vector<vk::DescriptorBindingFlags>& bindingFlags = {}
+    );
+
+    // one layout per set the shaders declare, sets without bindings get an empty layout
+    std::vector<vk::DescriptorSetLayout> acquire( const VulkanPipelineLayoutReflection& layoutReflection );
+
+    // templates are tied to the layout they were created for and live as long as the cache
+    vk::DescriptorUpdateTemplate acquireUpdateTemplate(
+        const vk::DescriptorSetLayout& vkDescriptorSetLayout,
+        const std::vector<vk::DescriptorUpdateTemplateEntry>& templateEntries
+    );
+
+    // signature of a layout created by this cache, nullptr for layouts created elsewhere
+    const DescriptorLayoutKey* find( const vk::DescriptorSetLayout& vkDescriptorSetLayout );
+
+    std::size_t size();
+private:
+    vk::Device* m_pLogicalDevice;
+
+    std::mutex m_cacheMutex;
+    std::unordered_map<DescriptorLayoutKey, vk::DescriptorSetLayout, DescriptorLayoutKeyHash> m_layouts;
+    // keys point into m_layouts, its nodes stay put until the cache is destroyed
+    std::unordered_map<VkDescriptorSetLayout, const DescriptorLayoutKey*> m_layoutKeys;
+    std::unordered_map<DescriptorUpdateTemplateKey, vk::DescriptorUpdateTemplate, DescriptorUpdateTemplateKeyHash> m_updateTemplates;
+
+    vk::DescriptorSetLayout createLayout( const DescriptorLayoutKey& layoutKey );
+};
+
+} // namespace vkrender
+
+#endif
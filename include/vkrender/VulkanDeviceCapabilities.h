@@ -0,0 +1,90 @@
+#ifndef VKRENDER_VULKAN_DEVICE_CAPABILITIES_H
+#define VKRENDER_VULKAN_DEVICE_CAPABILITIES_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+#include "vkrender/VulkanQueueFamily.hpp"
+
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace vkrender
+{
+
+// How the CPU and GPU access a resource, mapped onto memory property flags by VulkanDeviceCapabilities
+enum class VulkanMemoryUsage
+{
+    // written by transfers or rendering, never mapped
+    eGpuOnly,
+    // written once by the CPU and copied from, kept out of the device local host visible heap
+    eUpload,
+    // rewritten by the CPU every frame and read directly by shaders, prefers ReBAR memory
+    eDynamic,
+    // written by the GPU and read back by the CPU
+    eReadback
+};
+
+// Properties, limits, memory types, queue families and format support of the selected physical device,
+// queried once when the device is picked so lookups on the allocation and upload paths never reach the driver
+class VULKANRENDERER_EXPORTS VulkanDeviceCapabilities
+{
+public:
+    struct MemoryTypePolicy
+    {
+        vk::MemoryPropertyFlags m_required;
+        // every preferred flag present outweighs any number of avoided flags
+        vk::MemoryPropertyFlags m_preferred;
+        vk::MemoryPropertyFlags m_avoided;
+    };
+
+    // BAR windows without resizable BAR are 256MB, anything larger is treated as ReBAR
+    static constexpr vk::DeviceSize LEGACY_BAR_SIZE = 256ull * 1024ull * 1024ull;
+
+    // without a surface no queue family reports present support
+    explicit VulkanDeviceCapabilities( const vk::PhysicalDevice& vkPhysicalDevice, vk::SurfaceKHR* pVkSurface = nullptr );
+    ~VulkanDeviceCapabilities() = default;
+
+    vk::PhysicalDevice physicalDevice() const { return m_vkPhysicalDevice; }
+    const vk::PhysicalDeviceProperties& properties() const { return m_vkProperties; }
+    const vk::PhysicalDeviceLimits& limits() const { return m_vkProperties.limits; }
+    const vk::PhysicalDeviceVulkan12Properties& vulkan12Properties() const { return m_vkVulkan12Properties; }
+    const vk::PhysicalDeviceFeatures& features() const { return m_vkFeatures; }
+    const vk::PhysicalDeviceMemoryProperties& memoryProperties() const { return m_vkMemoryProperties; }
+    const std::vector<QueueFamilyInfo>& queueFamilies() const { return m_queueFamilies; }
+    const QueueFamilyIndices& queueFamilyIndices() const { return m_queueFamilyIndices; }
+    // timestamps can be written on the family's queues, tick length in limits().timestampPeriod
+    bool supportsTimestamps( const std::uint32_t& queueFamilyIndex ) const;
+
+    // core formats are cached up front, extension formats on first use, thread safe
+    vk::FormatProperties formatProperties( const vk::Format& format ) const;
+
+    // best type in memoryTypeBits holding every required flag, std::nullopt when none does
+    std::optional<std::uint32_t> findMemoryType( const std::uint32_t& memoryTypeBits, const MemoryTypePolicy& policy ) const;
+    // falls back to the usage's relaxed policy before giving up, throws when no type fits
+    std::uint32_t findMemoryType( const std::uint32_t& memoryTypeBits, const VulkanMemoryUsage& usage ) const;
+    static MemoryTypePolicy memoryTypePolicy( const VulkanMemoryUsage& usage );
+
+    // a device local and host visible heap larger than the legacy BAR window
+    bool hasResizableBar() const { return m_bResizableBar; }
+    vk::SampleCountFlagBits maxUsableSampleCount() const;
+private:
+    vk::PhysicalDevice m_vkPhysicalDevice;
+    vk::PhysicalDeviceProperties m_vkProperties;
+    vk::PhysicalDeviceVulkan12Properties m_vkVulkan12Properties;
+    vk::PhysicalDeviceFeatures m_vkFeatures;
+    vk::PhysicalDeviceMemoryProperties m_vkMemoryProperties;
+    std::vector<QueueFamilyInfo> m_queueFamilies;
+    QueueFamilyIndices m_queueFamilyIndices;
+    bool m_bResizableBar;
+
+    // indexed by VkFormat for the contiguous core range
+    std::vector<vk::FormatProperties> m_coreFormatProperties;
+    mutable std::mutex m_formatMutex;
+    mutable std::unordered_map<VkFormat, vk::FormatProperties> m_extensionFormatProperties;
+};
+
+} // namespace vkrender
+
+#endif
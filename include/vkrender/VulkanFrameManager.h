@@ -0,0 +1,101 @@
+#ifndef VKRENDER_VULKAN_FRAME_MANAGER_H
+#define VKRENDER_VULKAN_FRAME_MANAGER_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+#include "vkrender/VulkanMemoryAllocator.h"
+#include "vkrender/VulkanUploadScheduler.h"
+#include "vkrender/VulkanDescriptorAllocator.h"
+#include "vkrender/VulkanUniformRing.h"
+#include "utilities/memory.hpp"
+
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace vkrender
+{
+
+class VulkanRenderer;
+
+// Resources owned by one frame in flight, they are only touched again once m_vkInFlightFence signalled
+struct VulkanFrameContext
+{
+    vk::CommandPool m_vkCommandPool;
+    vk::CommandBuffer m_vkCmdBuffer;
+
+    vk::Semaphore m_vkImageAvailableSemaphore;
+    vk::Semaphore m_vkRenderFinishedSemaphore;
+    vk::Fence m_vkInFlightFence;
+
+    // per frame and per object uniforms, rewound when the frame begins
+    utils::Uptr<VulkanUniformRing> m_pUniformRing;
+
+    // transient sets, all pools are reset in bulk when the frame begins
+    utils::Uptr<VulkanDescriptorAllocator> m_pDescriptorAllocator;
+
+    std::uint32_t m_imageIndex = 0;
+    std::uint64_t m_frameNumber = 0;
+
+    std::vector<vk::Semaphore> m_waitSemaphores;
+    std::vector<std::uint64_t> m_waitValues;
+    std::vector<vk::PipelineStageFlags> m_waitStages;
+};
+
+// Ring of N frame contexts, recording of frame n+1 overlaps the GPU execution of frame n
+class VULKANRENDERER_EXPORTS VulkanFrameManager
+{
+public:
+    struct Statistics
+    {
+        std::uint64_t m_frameCount = 0;
+        std::uint64_t m_swapchainRecreations = 0;
+        double m_lastFenceWaitMs = 0.0;
+        double m_maxFenceWaitMs = 0.0;
+        double m_totalFenceWaitMs = 0.0;
+        // descriptor writes across all allocators recorded since the previous beginFrame
+        std::uint64_t m_lastFrameDescriptorWrites = 0;
+        std::uint64_t m_totalDescriptorWrites = 0;
+    };
+
+    static constexpr std::uint32_t DEFAULT_FRAMES_IN_FLIGHT = 2u;
+    static constexpr vk::DeviceSize DEFAULT_UNIFORM_BUFFER_SIZE = 256ull * 1024ull;
+    static constexpr std::uint32_t DEFAULT_DESCRIPTOR_SETS_PER_FRAME = 256u;
+
+    VulkanFrameManager(
+        VulkanRenderer* pVkRenderer,
+        const std::uint32_t& framesInFlight = DEFAULT_FRAMES_IN_FLIGHT,
+        const vk::DeviceSize& uniformBufferSize = DEFAULT_UNIFORM_BUFFER_SIZE
+    );
+    ~VulkanFrameManager();
+
+    // returns nullptr when the swapchain had to be recreated, the frame should be skipped
+    VulkanFrameContext* beginFrame();
+    void endFrame();
+
+    // between beginFrame and endFrame, makes the frame's submission wait for the upload on the GPU instead of the host
+    void waitForUpload( const VulkanUploadTicket& uploadTicket, const vk::PipelineStageFlags& dstStage );
+
+    void waitIdle();
+
+    VulkanFrameContext* currentFrame() { return &m_frames[ m_frameNumber % m_frames.size() ]; }
+    std::uint32_t framesInFlight() const { return static_cast<std::uint32_t>( m_frames.size() ); }
+    std::uint64_t frameNumber() const { return m_frameNumber; }
+    const Statistics& statistics() const { return m_statistics; }
+private:
+    VulkanRenderer* m_pVkRenderer;
+    vk::Device* m_pLogicalDevice;
+
+    std::vector<VulkanFrameContext> m_frames;
+    std::uint64_t m_frameNumber;
+    bool m_bFrameActive;
+
+    Statistics m_statistics;
+
+    void createFrameContext( VulkanFrameContext& frame, const std::uint32_t& graphicsFamilyIndex, const vk::DeviceSize& uniformBufferSize );
+    void destroyFrameContext( VulkanFrameContext& frame );
+    void waitForFrameFence( VulkanFrameContext& frame );
+    void countDescriptorWrites();
+};
+
+} // namespace vkrender
+
+#endif
@@ -2,6 +2,7 @@
 #define VKRENDER_VULKAN_GPU_PROGRAM_H
 
 #include "vkrender/VulkanRendererExports.hpp"
+#include "vkrender/VulkanShaderReflection.h"
 
 #include <filesystem>
 #include <vector>
@@ -23,6 +24,8 @@ public:
         const std::string& entryPoint
     );
 
+    // available once createShader succeeded
+    const VulkanShaderReflector::ReflectionPtr& reflection() const { return m_pReflection; }
 private:
     vk::Device* m_pDevice;
     vk::ShaderModule m_vkShaderModule;
@@ -30,6 +33,7 @@ private:
     std::string m_entryPoint;
 
     std::vector<char> m_shaderBuffer;
+    VulkanShaderReflector::ReflectionPtr m_pReflection;
 
     void populateShaderBufferFromSourceFile( const std::filesystem::path& filePath, std::vector<char>& shaderBuffer );
     void createShaderModule();
@@ -5,6 +5,11 @@
 #include "vkrender/VulkanGPUProgram.h"
 #include "vkrender/VulkanRenderPass.h"
 #include "vkrender/VulkanDescriptor.h"
+#include "vkrender/VulkanDescriptorLayoutCache.h"
+#include "vkrender/VulkanPipelineCache.h"
+#include "vkrender/VulkanDeletionQueue.h"
+#include "vkrender/VulkanPipelineState.h"
+#include "vkrender/VulkanShaderReflection.h"
 
 #include <vulkan/vulkan.hpp>
 
@@ -26,10 +31,21 @@ public:
         vk::BlendFactor m_dstBlendFactor;
     };
 
-    VulkanGfxPipeline( vk::Device* pLogicalDevice );
+    // without a pipeline cache every creation compiles from scratch,
+    // without a deletion queue the pipeline is destroyed right away and must no longer be in use,
+    // without a layout cache shaders using descriptor sets need their layouts bound explicitly
+    VulkanGfxPipeline(
+        vk::Device* pLogicalDevice, VulkanPipelineCache* pPipelineCache = nullptr, VulkanDeletionQueue* pDeletionQueue = nullptr,
+        VulkanDescriptorLayoutCache* pDescriptorLayoutCache = nullptr
+    );
     ~VulkanGfxPipeline();
 
+    // derives a packed vertex input from the vertex stage unless setVertexInputState is called
     void bindShaderStages( const ShaderStages& shaderStages );
+    void setVertexInputState(
+        const std::vector<vk::VertexInputBindingDescription>& vertexBindings,
+        const std::vector<vk::VertexInputAttributeDescription>& vertexAttributes
+    );
     void setInputAssemblyState(
         const vk::PrimitiveTopology& primitiveTopology,
         const bool& bPrimitiveRestart = false
@@ -57,7 +73,7 @@ public:
         const vk::StencilOp& backFace = vk::StencilOp::eKeep
     );
     void setColorBlendState(
-        const vk::ColorComponentFlagBits& colorWriteMask,
+        const vk::ColorComponentFlags& colorWriteMask,
         const bool& bColorBlend = false,
         const BlendOp& colorBlendOp = { vk::BlendOp::eAdd, vk::BlendFactor::eOne, vk::BlendFactor::eZero },
         const BlendOp& alphaBlendOp = { vk::BlendOp::eAdd, vk::BlendFactor::eOne, vk::BlendFactor::eZero }
@@ -70,18 +86,48 @@ public:
     void bindDescriptors(
         const std::vector<VulkanDescriptor*>& descriptors 
     );
+    // appended after the layouts of bindDescriptors, e.g. the bindless table or a push descriptor layout,
+    // bound layouts have to declare every binding the shaders use
+    void bindDescriptorSetLayouts( const std::vector<vk::DescriptorSetLayout>& vkDescriptorSetLayouts );
+
+    // takes precedence over the reflected ranges, blocks of the bound stages the ranges miss are merged in
+    void setPushConstantRanges( const std::vector<vk::PushConstantRange>& pushConstantRanges );
+
+    template<typename _Data>
+    void pushConstants( vk::CommandBuffer& vkCmdBuffer, const vk::ShaderStageFlags& stageFlags, const _Data& data, const std::uint32_t& offset = 0 ) const
+    {
+        static_assert( sizeof( _Data ) % 4 == 0, "push constant data must be a multiple of 4 bytes" );
+        vkCmdBuffer.pushConstants( m_vkPipelineLayout, stageFlags, offset, sizeof( _Data ), &data );
+    }
 
     vk::Result createGfxPipeline(
         VulkanRenderPass* pRenderPassToUse, 
         const std::uint32_t& subPassIndexToUse
     );
 
+    // key of the state configured so far, equal keys produce interchangeable pipelines
+    PipelineStateKey stateKey( VulkanRenderPass* pRenderPassToUse, const std::uint32_t& subPassIndexToUse ) const;
+
+    vk::Pipeline handle() const { return m_vkGfxPipeline; }
+    vk::PipelineLayout layout() const { return m_vkPipelineLayout; }
+    // descriptor bindings and push constant ranges used by the bound stages
+    VulkanPipelineLayoutReflection reflectedLayout() const;
+    // bound layouts, or one layout per reflected set from the layout cache when none are bound
+    std::vector<vk::DescriptorSetLayout> descriptorSetLayouts() const;
+    std::vector<vk::PushConstantRange> pushConstantRanges() const;
 private:
     vk::Device* m_pLogicalDevice;
+    VulkanPipelineCache* m_pPipelineCache;
+    VulkanDeletionQueue* m_pDeletionQueue;
+    VulkanDescriptorLayoutCache* m_pDescriptorLayoutCache;
     vk::PipelineLayout m_vkPipelineLayout;
     vk::Pipeline m_vkGfxPipeline;
 
     std::vector<vk::PipelineShaderStageCreateInfo> m_vkShaderStages;
+    std::vector<VulkanShaderReflector::ReflectionPtr> m_stageReflections;
+    bool m_bExplicitVertexInput;
+    std::vector<vk::VertexInputBindingDescription> m_vkVertexBindings;
+    std::vector<vk::VertexInputAttributeDescription> m_vkVertexAttributes;
     vk::PipelineVertexInputStateCreateInfo m_vkVertexInput;
     vk::PipelineInputAssemblyStateCreateInfo m_vkInputAssembly;
     vk::PipelineViewportStateCreateInfo m_vkViewportState;
@@ -90,12 +136,19 @@ private:
     vk::PipelineDepthStencilStateCreateInfo m_vkDepthStencilState;
     vk::PipelineColorBlendAttachmentState m_vkColorBlendAttachment;
     vk::PipelineColorBlendStateCreateInfo m_vkColorBlendState;
+    std::vector<vk::DynamicState> m_vkDynamicStates;
     vk::PipelineDynamicStateCreateInfo m_vkDynamicState;
 
     std::vector<vk::DescriptorSetLayout> m_vkDescriptorSetLayoutArray;
+    std::vector<vk::PushConstantRange> m_vkPushConstantRanges;
+    bool m_bExplicitPushConstants;
 
     void createPipelineLayout();
+    void validateDescriptorSetLayouts( const VulkanPipelineLayoutReflection& layoutReflection ) const;
     void destroyGfxPipeline();
+
+    friend class VulkanPipelineCompiler;
+    friend class VulkanPipelineRegistry;
 };
 
 } // namespace vkrender
@@ -5,6 +5,7 @@
 #include "vkrender/VulkanQueueFamily.hpp"
 #include "vkrender/VulkanSwapChainStructs.hpp"
 #include "vkrender/VulkanCommandBuffer.h"
+#include "vkrender/VulkanMemoryAllocator.h"
 #include <vulkan/vulkan.hpp>
 
 namespace vkrender
@@ -13,10 +14,19 @@ namespace vkrender
 class VULKANRENDERER_EXPORTS VulkanHelpers
 {
 public:
+    // enumerates the families and queries surface support, runs once per device, VulkanDeviceCapabilities keeps the result
+    static std::vector<QueueFamilyInfo> queryQueueFamilies( const vk::PhysicalDevice& physicalDevice, vk::SurfaceKHR* pVkSurface );
+    static QueueFamilyIndices selectQueueFamilies( const std::vector<QueueFamilyInfo>& queueFamilies );
     static QueueFamilyIndices findQueueFamilyIndices( const vk::PhysicalDevice& physicalDevice, vk::SurfaceKHR* pVkSurface );
     static SwapChainSupportDetails querySwapChainSupport( const vk::PhysicalDevice& vkPhysicalDevice, const vk::SurfaceKHR& vkSurface );
     static vk::SampleCountFlagBits getMaxUsableSampleCount( const vk::PhysicalDevice& vkPhysicalDevice );
 
+    // first type holding every flag, throws when none does. Prefer VulkanDeviceCapabilities::findMemoryType,
+    // the physical device overload queries the driver on every call
+    static std::uint32_t findMemoryType(
+        const vk::PhysicalDeviceMemoryProperties& vkMemoryProperties,
+        const std::uint32_t& typeFilter, const vk::MemoryPropertyFlags& propertyFlags
+    );
     static std::uint32_t findMemoryType(
         const vk::PhysicalDevice& vkPhysicalDevice,
         const std::uint32_t& typeFilter, const vk::MemoryPropertyFlags& propertyFlags
@@ -24,12 +34,13 @@ public:
     
     // Image Related
     static void createImage(
-        const vk::PhysicalDevice& vkPhysicalDevice, const vk::Device& vkLogicalDevice,
+        VulkanMemoryAllocator* pMemoryAllocator, const vk::Device& vkLogicalDevice,
         const std::uint32_t& width, const std::uint32_t& height, const std::uint32_t& mipmapLevels,
 	    const vk::SampleCountFlagBits& numOfSamples,
         const vk::Format& format, const vk::ImageTiling& tiling,
         const vk::ImageUsageFlags& usageFlags, const vk::MemoryPropertyFlags& memPropFlags,
-        vk::Image& image, vk::DeviceMemory& imageMemory
+        vk::Image& image, VulkanAllocation& imageAllocation,
+        const std::string& owner = {}
     );
 
     static vk::ImageView createImageView(
@@ -0,0 +1,235 @@
+#ifndef VKRENDER_VULKAN_MEMORY_ALLOCATOR_H
+#define VKRENDER_VULKAN_MEMORY_ALLOCATOR_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+#include "vkrender/VulkanDeviceCapabilities.h"
+#include "utilities/memory.hpp"
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace vkrender
+{
+
+class VulkanMemoryBlock;
+
+struct VULKANRENDERER_EXPORTS VulkanAllocation
+{
+    vk::DeviceMemory m_vkMemory;
+    vk::DeviceSize m_offset = 0;
+    vk::DeviceSize m_size = 0;
+    std::uint32_t m_memoryTypeIndex = 0;
+    // host pointer to m_offset when the backing block is persistently mapped
+    void* m_pMapped = nullptr;
+
+    // nullptr for dedicated allocations which own m_vkMemory
+    VulkanMemoryBlock* m_pBlock = nullptr;
+    // key of the allocation in the allocator's live allocation registry
+    std::uint64_t m_allocationId = 0;
+};
+
+// Device memory entry points behind blocks and dedicated allocations, the logical device's by default.
+// Benchmarks substitute host memory to drive the allocator without a GPU.
+struct VULKANRENDERER_EXPORTS VulkanDeviceMemoryCallbacks
+{
+    std::function<vk::DeviceMemory( const vk::MemoryAllocateInfo& )> m_allocate;
+    std::function<void( const vk::DeviceMemory& )> m_free;
+    // only called for host visible memory types
+    std::function<void*( const vk::DeviceMemory& )> m_map;
+    std::function<void( const vk::DeviceMemory& )> m_unmap;
+
+    static VulkanDeviceMemoryCallbacks forDevice( vk::Device* pLogicalDevice );
+};
+
+// Power of two buddy placement inside a single device memory block.
+// Nodes of order k are ( minNodeSize << k ) bytes and always start at a multiple of their size,
+// so any alignment up to the node size is satisfied for free.
+class VULKANRENDERER_EXPORTS VulkanBuddyBlock
+{
+public:
+    VulkanBuddyBlock( const vk::DeviceSize& blockSize, const vk::DeviceSize& minNodeSize );
+    ~VulkanBuddyBlock() = default;
+
+    std::optional<vk::DeviceSize> allocate( const vk::DeviceSize& size, const vk::DeviceSize& alignment );
+    void free( const vk::DeviceSize& offset );
+
+    vk::DeviceSize blockSize() const { return m_blockSize; }
+    vk::DeviceSize usedBytes() const { return m_usedBytes; }
+    bool isEmpty() const { return m_allocatedNodes.empty(); }
+private:
+    vk::DeviceSize m_blockSize;
+    vk::DeviceSize m_minNodeSize;
+    vk::DeviceSize m_usedBytes;
+    std::uint32_t m_maxOrder;
+
+    std::vector<std::set<vk::DeviceSize>> m_freeNodes;
+    std::map<vk::DeviceSize, std::uint32_t> m_allocatedNodes;
+
+    std::uint32_t orderForSize( const vk::DeviceSize& size ) const;
+    vk::DeviceSize nodeSize( const std::uint32_t& order ) const { return m_minNodeSize << order; }
+};
+
+class VULKANRENDERER_EXPORTS VulkanMemoryBlock
+{
+public:
+    VulkanMemoryBlock(
+        const VulkanDeviceMemoryCallbacks* pMemoryCallbacks,
+        const std::uint32_t& memoryTypeIndex, const vk::DeviceSize& blockSize,
+        const bool& bHostVisible
+    );
+    ~VulkanMemoryBlock();
+
+    std::optional<VulkanAllocation> allocate( const vk::DeviceSize& size, const vk::DeviceSize& alignment );
+    void free( const VulkanAllocation& allocation );
+
+    bool isEmpty() const { return m_buddy.isEmpty(); }
+    const VulkanBuddyBlock& buddy() const { return m_buddy; }
+private:
+    const VulkanDeviceMemoryCallbacks* m_pMemoryCallbacks;
+    vk::DeviceMemory m_vkMemory;
+    std::uint32_t m_memoryTypeIndex;
+    void* m_pMapped;
+
+    VulkanBuddyBlock m_buddy;
+};
+
+class VULKANRENDERER_EXPORTS VulkanMemoryAllocator
+{
+public:
+    // Buffers and linear images are kept apart from optimal tiled images so that
+    // bufferImageGranularity never has to be considered inside a block
+    enum class ResourceKind
+    {
+        eLinear,
+        eOptimal
+    };
+
+    struct HeapBudget
+    {
+        vk::DeviceSize m_heapSize = 0;
+        vk::MemoryHeapFlags m_heapFlags;
+        // device memory held by this allocator, blocks plus dedicated allocations
+        vk::DeviceSize m_reservedBytes = 0;
+        // bytes handed out to resources, at most m_reservedBytes
+        vk::DeviceSize m_allocatedBytes = 0;
+        std::uint64_t m_allocationCount = 0;
+        std::uint32_t m_blockCount = 0;
+        std::uint32_t m_dedicatedCount = 0;
+        // process wide figures from VK_EXT_memory_budget, estimated from m_reservedBytes without it
+        vk::DeviceSize m_usage = 0;
+        vk::DeviceSize m_budget = 0;
+    };
+
+    struct Snapshot
+    {
+        bool m_bDriverBudget = false;
+        std::vector<HeapBudget> m_heaps;
+    };
+
+    static constexpr vk::DeviceSize DEFAULT_BLOCK_SIZE = 64ull * 1024ull * 1024ull;
+    static constexpr vk::DeviceSize MIN_NODE_SIZE = 256ull;
+    static constexpr const char* BUDGET_EXTENSION_NAME = VK_EXT_MEMORY_BUDGET_EXTENSION_NAME;
+
+    // bMemoryBudget must only be set when VK_EXT_memory_budget is enabled on the device
+    VulkanMemoryAllocator(
+        const VulkanDeviceCapabilities* pDeviceCapabilities, vk::Device* pLogicalDevice,
+        const vk::DeviceSize& preferredBlockSize = DEFAULT_BLOCK_SIZE,
+        const bool& bMemoryBudget = false
+    );
+    // without a device, memory comes from memoryCallbacks and memory usage policies are unavailable
+    VulkanMemoryAllocator(
+        const vk::PhysicalDeviceMemoryProperties& memoryProperties,
+        const VulkanDeviceMemoryCallbacks& memoryCallbacks,
+        const vk::DeviceSize& preferredBlockSize = DEFAULT_BLOCK_SIZE
+    );
+    ~VulkanMemoryAllocator();
+
+    static bool isBudgetSupported( const vk::PhysicalDevice& vkPhysicalDevice );
+
+    // owner tags the allocation in snapshots and dumps, e.g. a texture name or "staging ring".
+    // memProps are required flags, the usage overload picks the best type through the device's memory type policy
+    VulkanAllocation allocate(
+        const vk::MemoryRequirements& memRequirements,
+        const vk::MemoryPropertyFlags& memProps,
+        const ResourceKind& resourceKind,
+        const std::string& owner = {}
+    );
+    VulkanAllocation allocate(
+        const vk::MemoryRequirements& memRequirements,
+        const VulkanMemoryUsage& memoryUsage,
+        const ResourceKind& resourceKind,
+        const std::string& owner = {}
+    );
+    vk::MemoryPropertyFlags memoryPropertyFlags( const VulkanAllocation& allocation ) const { return m_vkMemoryProperties.memoryTypes[allocation.m_memoryTypeIndex].propertyFlags; }
+    void free( VulkanAllocation& allocation );
+    // retags a live allocation, for owners only known after creation
+    void setOwner( const VulkanAllocation& allocation, const std::string& owner );
+
+    void bindBufferMemory( const vk::Buffer& buffer, const VulkanAllocation& allocation );
+    void bindImageMemory( const vk::Image& image, const VulkanAllocation& allocation );
+
+    std::size_t blockCount() const;
+
+    // queries the driver budget when available, meant for streaming decisions rather than every allocation
+    Snapshot snapshot() const;
+    // whether an allocation of memRequirements would keep its heap within budget
+    bool fitsBudget( const vk::MemoryRequirements& memRequirements, const VulkanMemoryUsage& memoryUsage ) const;
+    // heaps followed by every live allocation with its owner tag
+    std::string dumpJson() const;
+private:
+    struct LiveAllocation
+    {
+        std::string m_owner;
+        vk::DeviceSize m_size;
+        std::uint32_t m_memoryTypeIndex;
+        bool m_bDedicated;
+    };
+
+    using BlockArray = std::vector<utils::Uptr<VulkanMemoryBlock>>;
+
+    const VulkanDeviceCapabilities* m_pDeviceCapabilities;
+    vk::PhysicalDevice m_vkPhysicalDevice;
+    vk::Device* m_pLogicalDevice;
+    vk::PhysicalDeviceMemoryProperties m_vkMemoryProperties;
+    VulkanDeviceMemoryCallbacks m_memoryCallbacks;
+
+    // indexed by ( memoryTypeIndex * 2 + ResourceKind )
+    std::vector<BlockArray> m_blockPools;
+    std::vector<vk::DeviceSize> m_blockSizes;
+
+    bool m_bMemoryBudget;
+
+    mutable std::mutex m_allocatorMutex;
+    // indexed by heap, guarded by m_allocatorMutex
+    std::vector<HeapBudget> m_heapBudgets;
+    std::unordered_map<std::uint64_t, LiveAllocation> m_liveAllocations;
+    std::uint64_t m_nextAllocationId;
+
+    VulkanAllocation allocateFromType(
+        const vk::MemoryRequirements& memRequirements, const std::uint32_t& memoryTypeIndex,
+        const ResourceKind& resourceKind, const std::string& owner
+    );
+    VulkanAllocation allocateDedicated( const vk::DeviceSize& size, const std::uint32_t& memoryTypeIndex );
+    // the allocator mutex must be held, frees the block unless it is the only empty one of its pool
+    void releaseEmptyBlock( VulkanMemoryBlock* pEmptyBlock, const std::uint32_t& memoryTypeIndex );
+    void initBlockSizes( const vk::DeviceSize& preferredBlockSize );
+    std::uint32_t findMemoryType( const std::uint32_t& memoryTypeBits, const VulkanMemoryUsage& memoryUsage ) const;
+    std::size_t poolIndex( const std::uint32_t& memoryTypeIndex, const ResourceKind& resourceKind ) const;
+    bool isHostVisible( const std::uint32_t& memoryTypeIndex ) const;
+    std::uint32_t heapIndex( const std::uint32_t& memoryTypeIndex ) const { return m_vkMemoryProperties.memoryTypes[memoryTypeIndex].heapIndex; }
+    // the allocator mutex must be held
+    void trackAllocation( VulkanAllocation& allocation, const std::string& owner, const bool& bDedicated );
+    void untrackAllocation( const VulkanAllocation& allocation );
+    std::vector<HeapBudget> queryHeapBudgets() const;
+};
+
+} // namespace vkrender
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef VKRENDER_VULKAN_PARALLEL_RECORDER_H
+#define VKRENDER_VULKAN_PARALLEL_RECORDER_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+#include "utilities/ThreadPool.h"
+
+#include <functional>
+#include <limits>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace vkrender
+{
+
+class VulkanRenderer;
+struct VulkanFrameContext;
+
+// Splits a draw list into slices recorded into secondary command buffers on the thread pool.
+// Every slice owns a command pool per frame in flight, so workers never share a pool and a pool
+// is only reset once the frame manager waited for the frame that last used it.
+class VULKANRENDERER_EXPORTS VulkanParallelRecorder
+{
+public:
+    // records draws [firstDraw, lastDraw) of the list into an already begun secondary command buffer
+    using SliceRecorder = std::function<void(vk::CommandBuffer& cmdBuffer, const std::uint32_t& firstDraw, const std::uint32_t& lastDraw)>;
+
+    static constexpr std::uint32_t DEFAULT_MIN_DRAWS_PER_SLICE = 64u;
+
+    VulkanParallelRecorder(
+        VulkanRenderer* pVkRenderer, utils::ThreadPool* pThreadPool,
+        const std::uint32_t& framesInFlight,
+        const std::uint32_t& minDrawsPerSlice = DEFAULT_MIN_DRAWS_PER_SLICE
+    );
+    ~VulkanParallelRecorder();
+
+    // the render pass has to be begun on primaryCmdBuffer with vk::SubpassContents::eSecondaryCommandBuffers,
+    // the secondaries are executed in draw list order
+    void record(
+        VulkanFrameContext* pFrame,
+        vk::CommandBuffer& primaryCmdBuffer,
+        const vk::CommandBufferInheritanceInfo& inheritanceInfo,
+        const std::uint32_t& drawCount,
+        const SliceRecorder& sliceRecorder
+    );
+
+    std::uint32_t sliceCount() const { return m_numOfSlices; }
+private:
+    struct SliceContext
+    {
+        vk::CommandPool m_vkCommandPool;
+        std::vector<vk::CommandBuffer> m_vkCmdBuffers;
+        std::uint32_t m_usedCmdBuffers = 0;
+    };
+
+    struct FrameSlot
+    {
+        std::vector<SliceContext> m_slices;
+        std::uint64_t m_frameNumber = std::numeric_limits<std::uint64_t>::max();
+    };
+
+    vk::Device* m_pLogicalDevice;
+    utils::ThreadPool* m_pThreadPool;
+    std::uint32_t m_numOfSlices;
+    std::uint32_t m_minDrawsPerSlice;
+
+    std::vector<FrameSlot> m_frameSlots;
+
+    FrameSlot& acquireFrameSlot( VulkanFrameContext* pFrame );
+    vk::CommandBuffer nextCmdBuffer( SliceContext& slice );
+};
+
+} // namespace vkrender
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef VKRENDER_VULKAN_PIPELINE_CACHE_H
+#define VKRENDER_VULKAN_PIPELINE_CACHE_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+
+#include <filesystem>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace vkrender
+{
+
+// vk::PipelineCache persisted between runs. The file is only reused when its header matches the
+// current driver ( vendor, device and cache UUID ), it is written to a temporary file and renamed over
+// the previous one so an interrupted save never leaves a truncated cache behind.
+class VULKANRENDERER_EXPORTS VulkanPipelineCache
+{
+public:
+    struct Statistics
+    {
+        std::uint64_t m_hitCount = 0;
+        std::uint64_t m_missCount = 0;
+        // creations without cache feedback, because the device lacks it or the driver left it invalid
+        std::uint64_t m_unknownCount = 0;
+        double m_hitTimeMs = 0.0;
+        double m_missTimeMs = 0.0;
+        double m_unknownTimeMs = 0.0;
+    };
+
+    static constexpr const char* DEFAULT_CACHE_FILE = "vkrender_pipeline.cache";
+    static constexpr const char* FEEDBACK_EXTENSION_NAME = VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME;
+
+    // bCreationFeedback must only be set on Vulkan 1.3 devices or when VK_EXT_pipeline_creation_feedback is enabled
+    VulkanPipelineCache(
+        const vk::PhysicalDevice& vkPhysicalDevice, vk::Device* pLogicalDevice,
+        const bool& bCreationFeedback = false,
+        const std::filesystem::path& cacheFilePath = DEFAULT_CACHE_FILE
+    );
+    ~VulkanPipelineCache();
+
+    // creation feedback is core since Vulkan 1.3, older devices need the extension
+    static bool isFeedbackCore( const vk::PhysicalDevice& vkPhysicalDevice );
+    static bool isFeedbackSupported( const vk::PhysicalDevice& vkPhysicalDevice );
+
+    // thread safe, the driver synchronizes the cache internally
+    vk::Pipeline createGraphicsPipeline( const vk::GraphicsPipelineCreateInfo& gfxPipelineCreateInfo );
+    vk::Pipeline createComputePipeline( const vk::ComputePipelineCreateInfo& computePipelineCreateInfo );
+
+    void save();
+    void logStatistics() const;
+
+    vk::PipelineCache handle() const { return m_vkPipelineCache; }
+    Statistics statistics() const;
+private:
+    vk::PhysicalDevice m_vkPhysicalDevice;
+    vk::Device* m_pLogicalDevice;
+    std::filesystem::path m_cacheFilePath;
+    bool m_bCreationFeedback;
+
+    vk::PipelineCache m_vkPipelineCache;
+
+    mutable std::mutex m_statisticsMutex;
+    Statistics m_statistics;
+
+    std::vector<char> loadCacheData();
+    bool isCacheDataCompatible( const std::vector<char>& cacheData ) const;
+    // pPipelineFeedback is nullptr when no feedback was requested
+    void recordFeedback( const vk::PipelineCreationFeedback* pPipelineFeedback, const double& creationTimeMs );
+};
+
+} // namespace vkrender
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef VKRENDER_VULKAN_PIPELINE_COMPILER_H
+#define VKRENDER_VULKAN_PIPELINE_COMPILER_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+#include "vkrender/VulkanGfxPipeline.h"
+#include "vkrender/VulkanPipelineCache.h"
+#include "utilities/ThreadPool.h"
+
+#include <future>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace vkrender
+{
+
+// Resolves to the vk::Pipeline once its compilation finished, get() rethrows a failed compilation
+class VULKANRENDERER_EXPORTS VulkanPipelineHandle
+{
+public:
+    VulkanPipelineHandle() = default;
+    explicit VulkanPipelineHandle( const std::shared_future<vk::Pipeline>& pipelineFuture )
+        :m_pipelineFuture{ pipelineFuture }
+    {}
+
+    bool isValid() const { return m_pipelineFuture.valid(); }
+    bool isReady() const;
+    vk::Pipeline get() const { return m_pipelineFuture.get(); }
+private:
+    std::shared_future<vk::Pipeline> m_pipelineFuture;
+};
+
+// Compiles fully configured VulkanGfxPipelines on the thread pool, all of them sharing the renderer's pipeline cache
+class VULKANRENDERER_EXPORTS VulkanPipelineCompiler
+{
+public:
+    struct CompileRequest
+    {
+        VulkanGfxPipeline* m_pGfxPipeline = nullptr;
+        VulkanRenderPass* m_pRenderPass = nullptr;
+        std::uint32_t m_subpassIndex = 0;
+        // pipelines needed by the first frame should use eHigh
+        utils::JobPriority m_priority = utils::JobPriority::eNormal;
+    };
+
+    VulkanPipelineCompiler( VulkanPipelineCache* pPipelineCache, utils::ThreadPool* pThreadPool );
+    ~VulkanPipelineCompiler();
+
+    VulkanPipelineHandle compile( const CompileRequest& compileRequest );
+    // handles are returned in request order
+    std::vector<VulkanPipelineHandle> compileBatch( const std::vector<CompileRequest>& compileRequests );
+
+    void waitIdle();
+    std::size_t pendingCount();
+private:
+    VulkanPipelineCache* m_pPipelineCache;
+    utils::ThreadPool* m_pThreadPool;
+
+    std::mutex m_compilerMutex;
+    std::vector<std::shared_future<vk::Pipeline>> m_pendingCompiles;
+
+    void prunePendingCompiles();
+};
+
+} // namespace vkrender
+
+#endif
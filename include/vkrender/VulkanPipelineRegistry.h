@@ -0,0 +1,64 @@
+#ifndef VKRENDER_VULKAN_PIPELINE_REGISTRY_H
+#define VKRENDER_VULKAN_PIPELINE_REGISTRY_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+#include "vkrender/VulkanGfxPipeline.h"
+#include "vkrender/VulkanPipelineState.h"
+#include "utilities/memory.hpp"
+
+#include <future>
+#include <mutex>
+#include <unordered_map>
+
+namespace vkrender
+{
+
+// Renderer wide deduplication of graphics pipelines, a configuration seen before returns the existing pipeline
+class VULKANRENDERER_EXPORTS VulkanPipelineRegistry
+{
+public:
+    struct Statistics
+    {
+        std::uint64_t m_hitCount = 0;
+        std::uint64_t m_missCount = 0;
+
+        double hitRate() const
+        {
+            const std::uint64_t lookupCount = m_hitCount + m_missCount;
+            return lookupCount == 0 ? 0.0 : static_cast<double>( m_hitCount ) / static_cast<double>( lookupCount );
+        }
+    };
+
+    explicit VulkanPipelineRegistry( VulkanPipelineCache* pPipelineCache );
+    ~VulkanPipelineRegistry();
+
+    // takes a configured but not yet created pipeline, it is only created when its key is new,
+    // callers asking for a key that is still being created wait for that creation
+    VulkanGfxPipeline* acquire(
+        utils::Uptr<VulkanGfxPipeline>&& pGfxPipeline,
+        VulkanRenderPass* pRenderPassToUse, const std::uint32_t& subPassIndexToUse
+    );
+    // waits as well when the pipeline of the key is still being created
+    VulkanGfxPipeline* find( const PipelineStateKey& stateKey );
+
+    std::size_t size();
+    Statistics statistics();
+private:
+    // inserted before the pipeline is compiled, m_created is ready once it was created
+    struct RegisteredPipeline
+    {
+        utils::Uptr<VulkanGfxPipeline> m_pGfxPipeline;
+        std::shared_future<VulkanGfxPipeline*> m_created;
+    };
+
+    VulkanPipelineCache* m_pPipelineCache;
+
+    // only guards the map, compiles run without it
+    std::mutex m_registryMutex;
+    std::unordered_map<PipelineStateKey, RegisteredPipeline, PipelineStateKeyHash> m_pipelines;
+    Statistics m_statistics;
+};
+
+} // namespace vkrender
+
+#endif
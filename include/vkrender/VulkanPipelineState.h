@@ -0,0 +1,91 @@
+#ifndef VKRENDER_VULKAN_PIPELINE_STATE_H
+#define VKRENDER_VULKAN_PIPELINE_STATE_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace vkrender
+{
+
+// Everything that makes two graphics pipelines different. The fixed function state is kept as
+// 32 bit words ( floats by their bit pattern ) so it hashes and compares without padding bytes.
+struct VULKANRENDERER_EXPORTS PipelineStateKey
+{
+    struct ShaderStage
+    {
+        vk::ShaderModule m_vkShaderModule;
+        vk::ShaderStageFlagBits m_vkShaderStage;
+        std::uint64_t m_entryPointHash;
+
+        bool operator==( const ShaderStage& other ) const;
+    };
+
+    struct FixedState
+    {
+        // input assembly
+        std::uint32_t m_topology = 0;
+        std::uint32_t m_primitiveRestart = 0;
+        // rasterizer
+        std::uint32_t m_polygonMode = 0;
+        std::uint32_t m_cullMode = 0;
+        std::uint32_t m_frontFace = 0;
+        std::uint32_t m_rasterizerDiscard = 0;
+        std::uint32_t m_depthClamp = 0;
+        std::uint32_t m_depthBias = 0;
+        std::uint32_t m_depthBiasConstantFactor = 0;
+        std::uint32_t m_depthBiasSlopeFactor = 0;
+        std::uint32_t m_lineWidth = 0;
+        // multisample
+        std::uint32_t m_sampleCount = 0;
+        std::uint32_t m_sampleShading = 0;
+        std::uint32_t m_minSampleShading = 0;
+        // depth stencil
+        std::uint32_t m_depthTest = 0;
+        std::uint32_t m_depthWrite = 0;
+        std::uint32_t m_depthCompareOp = 0;
+        std::uint32_t m_depthBoundsTest = 0;
+        std::uint32_t m_minDepthBounds = 0;
+        std::uint32_t m_maxDepthBounds = 0;
+        std::uint32_t m_stencilTest = 0;
+        std::uint32_t m_frontStencilOps[4] = {};
+        std::uint32_t m_backStencilOps[4] = {};
+        // color blend
+        std::uint32_t m_blendEnable = 0;
+        std::uint32_t m_srcColorBlendFactor = 0;
+        std::uint32_t m_dstColorBlendFactor = 0;
+        std::uint32_t m_colorBlendOp = 0;
+        std::uint32_t m_srcAlphaBlendFactor = 0;
+        std::uint32_t m_dstAlphaBlendFactor = 0;
+        std::uint32_t m_alphaBlendOp = 0;
+        std::uint32_t m_colorWriteMask = 0;
+        // render pass
+        std::uint32_t m_subpassIndex = 0;
+    };
+
+    std::vector<ShaderStage> m_shaderStages;
+    std::vector<vk::VertexInputBindingDescription> m_vertexBindings;
+    std::vector<vk::VertexInputAttributeDescription> m_vertexAttributes;
+    std::vector<vk::DescriptorSetLayout> m_descriptorSetLayouts;
+    std::vector<vk::PushConstantRange> m_pushConstantRanges;
+    std::vector<vk::DynamicState> m_dynamicStates;
+    vk::RenderPass m_vkRenderPass;
+    FixedState m_fixedState;
+
+    bool operator==( const PipelineStateKey& other ) const;
+    bool operator!=( const PipelineStateKey& other ) const { return !( *this == other ); }
+
+    std::size_t hash() const;
+
+    static std::uint32_t floatBits( const float& value );
+};
+
+struct PipelineStateKeyHash
+{
+    std::size_t operator()( const PipelineStateKey& stateKey ) const { return stateKey.hash(); }
+};
+
+} // namespace vkrender
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef VKRENDER_VULKAN_PUSH_DESCRIPTOR_H
+#define VKRENDER_VULKAN_PUSH_DESCRIPTOR_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace vkrender
+{
+
+// VK_KHR_push_descriptor entry point. Descriptors are recorded straight into the command buffer, so
+// per-draw sets need no pool, no allocation and no vkUpdateDescriptorSets. The set layout must be
+// created with vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR.
+class VULKANRENDERER_EXPORTS VulkanPushDescriptor
+{
+public:
+    static constexpr const char* EXTENSION_NAME = VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME;
+
+    explicit VulkanPushDescriptor( vk::Device* pLogicalDevice );
+
+    static bool isSupported( const vk::PhysicalDevice& vkPhysicalDevice );
+
+    // dstSet of the writes is ignored
+    void push(
+        vk::CommandBuffer& vkCmdBuffer,
+        const vk::PipelineBindPoint& bindPoint, const vk::PipelineLayout& vkPipelineLayout, const std::uint32_t& setIndex,
+        const std::vector<vk::WriteDescriptorSet>& writeDescriptorSets
+    ) const;
+private:
+    PFN_vkCmdPushDescriptorSetKHR m_pfnCmdPushDescriptorSet;
+};
+
+} // namespace vkrender
+
+#endif
@@ -2,17 +2,33 @@
 #define VKRENDER_VULKAN_QUEUE_FAMILY_HPP
 
 #include <optional>
+#include <vulkan/vulkan.hpp>
 
 namespace vkrender
 {
+	struct QueueFamilyInfo
+	{
+		std::uint32_t					m_index = 0;
+		vk::QueueFlags					m_queueFlags;
+		std::uint32_t					m_queueCount = 0;
+		// 0 when the family cannot write timestamps
+		std::uint32_t					m_timestampValidBits = 0;
+		vk::Extent3D					m_minImageTransferGranularity;
+		bool							m_bPresentSupport = false;
+	};
+
 	struct QueueFamilyIndices
 	{
 		std::optional<std::uint32_t>	m_graphicsFamily;
 		std::optional<std::uint32_t>	m_presentFamily;
 		std::optional<std::uint32_t>	m_computeFamily;
 		std::optional<std::uint32_t>	m_exclusiveTransferFamily;
+		// compute without graphics, for async compute
+		std::optional<std::uint32_t>	m_exclusiveComputeFamily;
+		// queues available in the graphics family, a second one can take transfers when there is no transfer family
+		std::uint32_t					m_graphicsQueueCount = 0;
 	};
 
 } // namespace vkrender
 
-#endif
\ No newline at end of file
+#endif
@@ -26,6 +26,8 @@ public:
         const vk::PipelineStageFlags& destStageMask, const vk::AccessFlags& dstAccessMask
     );
     void createRenderPass();
+
+    vk::RenderPass handle() const { return m_vkRenderPass; }
 private:
     vk::Device* m_pLogicalDevice;
     vk::RenderPass m_vkRenderPass;
@@ -3,9 +3,25 @@
 
 #include "vkrender/VulkanWindow.h"
 #include "vkrender/VulkanSwapchain.h"
+#include "vkrender/VulkanDeviceCapabilities.h"
+#include "vkrender/VulkanMemoryAllocator.h"
+#include "vkrender/VulkanDeletionQueue.h"
+#include "vkrender/VulkanStagingRing.h"
+#include "vkrender/VulkanUploadScheduler.h"
+#include "vkrender/VulkanPipelineCache.h"
+#include "vkrender/VulkanPipelineCompiler.h"
+#include "vkrender/VulkanPipelineRegistry.h"
+#include "vkrender/VulkanDescriptorLayoutCache.h"
+#include "vkrender/VulkanDescriptorAllocator.h"
+#include "vkrender/VulkanBindlessTable.h"
+#include "vkrender/VulkanPushDescriptor.h"
+#include "vkrender/VulkanFrameManager.h"
+#include "vkrender/VulkanParallelRecorder.h"
 #include "vkrender/VulkanRendererExports.hpp"
 #include "utilities/memory.hpp"
+#include "utilities/ThreadPool.h"
 
+#include <mutex>
 #include <vulkan/vulkan.hpp>
 
 namespace vkrender
@@ -16,13 +32,49 @@ class VULKANRENDERER_EXPORTS VulkanRenderer
 public:
     using CmdBufPtr = utils::Uptr<VulkanCmdBuffer>;
 
-    VulkanRenderer();
+    // bindless is only enabled when the device supports the descriptor indexing features it needs
+    explicit VulkanRenderer(
+        const std::uint32_t& framesInFlight = VulkanFrameManager::DEFAULT_FRAMES_IN_FLIGHT,
+        const bool& bRequestBindless = false
+    );
     ~VulkanRenderer();
 
     void initVulkan( VulkanWindow* pVulkanWindow );
     void shutdown();
+
+    VulkanFrameContext* beginFrame() { return m_pFrameManager->beginFrame(); }
+    void endFrame() { m_pFrameManager->endFrame(); }
     
     vk::PhysicalDevice getPhysicalDevice() const { return m_vkPhysicalDevice; }
+    vk::Device* getDevice() { return &m_vkLogicalDevice; }
+    const VulkanDeviceCapabilities* getDeviceCapabilities() const { return m_pDeviceCapabilities.get(); }
+    VulkanMemoryAllocator* getMemoryAllocator() const { return m_pMemoryAllocator.get(); }
+    // nullptr once the renderer is shut down, resources are then destroyed right away
+    VulkanDeletionQueue* getDeletionQueue() const { return m_pDeletionQueue.get(); }
+    VulkanPipelineCache* getPipelineCache() const { return m_pPipelineCache.get(); }
+    VulkanPipelineCompiler* getPipelineCompiler() const { return m_pPipelineCompiler.get(); }
+    VulkanPipelineRegistry* getPipelineRegistry() const { return m_pPipelineRegistry.get(); }
+    VulkanDescriptorLayoutCache* getDescriptorLayoutCache() const { return m_pDescriptorLayoutCache.get(); }
+    // long lived sets such as materials, per frame sets come from the frame context's allocator
+    VulkanDescriptorAllocator* getDescriptorAllocator() const { return m_pDescriptorAllocator.get(); }
+    // nullptr unless bindless is enabled
+    VulkanBindlessTable* getBindlessTable() const { return m_pBindlessTable.get(); }
+    bool isBindlessEnabled() const { return m_bBindlessEnabled; }
+    // nullptr when the device lacks VK_KHR_push_descriptor
+    VulkanPushDescriptor* getPushDescriptor() const { return m_pPushDescriptor.get(); }
+    VulkanStagingRing* getStagingRing() const { return m_pStagingRing.get(); }
+    VulkanUploadScheduler* getUploadScheduler() const { return m_pUploadScheduler.get(); }
+    VulkanFrameManager* getFrameManager() const { return m_pFrameManager.get(); }
+    VulkanParallelRecorder* getParallelRecorder() const { return m_pParallelRecorder.get(); }
+    utils::ThreadPool* getThreadPool() const { return m_pThreadPool.get(); }
+    vk::SharingMode getStagingSharingMode() const { return m_bHasExclusiveTransferQueue ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive; }
+
+    // VkQueue is externally synchronized, every submit and present holds the mutex of its queue,
+    // handles of the same VkQueue, e.g. transfers on the graphics queue, share one mutex
+    std::mutex& queueMutex( const vk::Queue& vkQueue );
+    // command pools are externally synchronized as well, allocating, recording, resetting and freeing hold this mutex
+    std::mutex& commandPoolMutex( const vk::CommandPool& vkCommandPool );
+    vk::Result submit( const vk::Queue& vkQueue, const std::uint32_t& submitCount, const vk::SubmitInfo* pSubmitInfos, const vk::Fence& vkFence );
 #ifdef NDEBUG
 	static constexpr bool ENABLE_VALIDATION_LAYER = false;
 #else
@@ -36,8 +88,18 @@ public:
         const vk::DeviceSize& bufferSizeInBytes,
         const vk::BufferUsageFlags& bufferUsage, const vk::SharingMode& bufferSharing,
         const vk::MemoryPropertyFlags& memProps,
-        vk::Buffer& buffer, vk::DeviceMemory& bufferMemory
+        vk::Buffer& buffer, VulkanAllocation& bufferAllocation,
+        const std::string& owner = {}
+    );
+    // memory chosen through the device's memory type policy, e.g. ReBAR for VulkanMemoryUsage::eDynamic
+    void createBuffer(
+        const vk::DeviceSize& bufferSizeInBytes,
+        const vk::BufferUsageFlags& bufferUsage, const vk::SharingMode& bufferSharing,
+        const VulkanMemoryUsage& memoryUsage,
+        vk::Buffer& buffer, VulkanAllocation& bufferAllocation,
+        const std::string& owner = {}
     );
+    void destroyBuffer( vk::Buffer& buffer, VulkanAllocation& bufferAllocation );
 
     vk::Sampler* createTexSampler(
         const vk::Filter& minFilter, const vk::Filter& magFilter,
@@ -50,40 +112,90 @@ public:
         const bool& bCmpEnable = false, const vk::CompareOp& cmpOp = vk::CompareOp::eAlways
     );
 private:
+    vk::Buffer createBufferHandle(
+        const vk::DeviceSize& bufferSizeInBytes,
+        const vk::BufferUsageFlags& bufferUsage, const vk::SharingMode& bufferSharing
+    );
+
     void createInstance();
     void setupDebugMessenger();
     void createSurface( VulkanWindow* pVulkanWindow );
     void pickPhysicalDevice();
     void createLogicalDevice();
+    void createMemoryAllocator();
+    void createDeletionQueue();
+    void createPipelineCache();
+    void createDescriptorLayoutCache();
+    void createBindlessTable();
+    void createPushDescriptor();
+    void createThreadPool();
+    void createPipelineCompiler();
     void createCommandPool();
     void createConfigCommandBuffer();
+    void createStagingRing();
+    void createUploadScheduler();
+    void createFrameManager();
+    void createParallelRecorder();
 
     vk::Instance m_vkInstance;
     vk::DebugUtilsMessengerEXT m_vkDebugUtilsMessenger;
     vk::SurfaceKHR m_vkSurface;
 
     vk::PhysicalDevice m_vkPhysicalDevice;
+    utils::Uptr<VulkanDeviceCapabilities> m_pDeviceCapabilities;
     vk::Device m_vkLogicalDevice;
     vk::Queue m_vkGraphicsQueue;
     vk::Queue m_vkPresentationQueue;
     vk::Queue m_vkTransferQueue;
+    std::mutex m_graphicsQueueMutex;
+    std::mutex m_presentationQueueMutex;
+    std::mutex m_transferQueueMutex;
     bool m_bHasExclusiveTransferQueue;
     vk::SampleCountFlagBits m_msaaSampleCount;
+    vk::PhysicalDeviceVulkan12Features m_vkEnabledVulkan12Features;
+    bool m_bBindlessRequested;
+    bool m_bBindlessEnabled;
+    bool m_bPushDescriptorSupported;
+    bool m_bMemoryBudgetSupported;
+    bool m_bPipelineFeedbackSupported;
+
+    utils::Uptr<VulkanMemoryAllocator> m_pMemoryAllocator;
+    utils::Uptr<VulkanDeletionQueue> m_pDeletionQueue;
+    utils::Uptr<VulkanPipelineCache> m_pPipelineCache;
+    utils::Uptr<VulkanPipelineCompiler> m_pPipelineCompiler;
+    utils::Uptr<VulkanPipelineRegistry> m_pPipelineRegistry;
+    utils::Uptr<VulkanDescriptorLayoutCache> m_pDescriptorLayoutCache;
+    utils::Uptr<VulkanDescriptorAllocator> m_pDescriptorAllocator;
+    utils::Uptr<VulkanBindlessTable> m_pBindlessTable;
+    utils::Uptr<VulkanPushDescriptor> m_pPushDescriptor;
 
     std::vector<const char*> m_instanceExtensionContainer;
     std::vector<const char*> m_deviceExtensionContainer;
 
     vk::CommandPool m_vkTransferCommandPool;
     vk::CommandPool m_vkGraphicsCommandPool;
+    std::mutex m_graphicsCommandPoolMutex;
+    std::mutex m_transferCommandPoolMutex;
 
     CmdBufPtr m_pConfigCmdBuffer;
+    utils::Uptr<VulkanStagingRing> m_pStagingRing;
+    utils::Uptr<VulkanUploadScheduler> m_pUploadScheduler;
     
     VulkanWindow* m_pVulkanWindow;
     utils::Uptr<VulkanSwapchain> m_pVulkanSwapchain;
 
+    std::uint32_t m_framesInFlight;
+    utils::Uptr<VulkanFrameManager> m_pFrameManager;
+
+    utils::Uptr<utils::ThreadPool> m_pThreadPool;
+    utils::Uptr<VulkanParallelRecorder> m_pParallelRecorder;
+
     std::vector<vk::Sampler> m_samplers;
 
     friend class VulkanTextureManager;
+    friend class VulkanUploadScheduler;
+    friend class VulkanFrameManager;
+    friend class VulkanParallelRecorder;
 };
 
 } // namespace vkrender
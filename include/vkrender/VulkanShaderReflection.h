@@ -0,0 +1,84 @@
+#ifndef VKRENDER_VULKAN_SHADER_REFLECTION_H
+#define VKRENDER_VULKAN_SHADER_REFLECTION_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+#include "utilities/memory.hpp"
+
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace vkrender
+{
+
+// Interface of one entry point of a SPIR-V module
+struct VULKANRENDERER_EXPORTS VulkanShaderReflection
+{
+    struct DescriptorBinding
+    {
+        std::uint32_t m_set = 0;
+        std::uint32_t m_binding = 0;
+        vk::DescriptorType m_descriptorType = vk::DescriptorType::eUniformBuffer;
+        // 0 for runtime sized arrays
+        std::uint32_t m_descriptorCount = 1;
+        std::string m_name;
+    };
+
+    struct SpecializationConstant
+    {
+        std::uint32_t m_constantId = 0;
+        std::uint32_t m_sizeInBytes = 0;
+        std::uint64_t m_defaultValue = 0;
+        std::string m_name;
+    };
+
+    struct InputVariable
+    {
+        std::uint32_t m_location = 0;
+        vk::Format m_format = vk::Format::eUndefined;
+        std::uint32_t m_sizeInBytes = 0;
+        std::string m_name;
+    };
+
+    vk::ShaderStageFlagBits m_shaderStage = vk::ShaderStageFlagBits::eVertex;
+    std::string m_entryPoint;
+    std::uint64_t m_moduleHash = 0;
+
+    std::vector<DescriptorBinding> m_descriptorBindings;
+    // empty when the stage has no push constant block
+    std::vector<vk::PushConstantRange> m_pushConstantRanges;
+    std::vector<SpecializationConstant> m_specializationConstants;
+    // sorted by location, built-ins excluded
+    std::vector<InputVariable> m_inputVariables;
+};
+
+// Descriptor and push constant interface of all stages of a pipeline
+struct VULKANRENDERER_EXPORTS VulkanPipelineLayoutReflection
+{
+    // indexed by set number, bindings sorted, stage flags of bindings used by several stages are merged
+    std::vector<std::vector<vk::DescriptorSetLayoutBinding>> m_setLayoutBindings;
+    std::vector<vk::PushConstantRange> m_pushConstantRanges;
+};
+
+class VULKANRENDERER_EXPORTS VulkanShaderReflector
+{
+public:
+    using ReflectionPtr = utils::Sptr<const VulkanShaderReflection>;
+
+    // parses the module once, later calls with identical bytes and entry point return the cached result
+    static ReflectionPtr reflect( const std::vector<char>& spirvBuffer, const std::string& entryPoint );
+    static VulkanPipelineLayoutReflection mergeStages( const std::vector<ReflectionPtr>& stageReflections );
+
+    // single tightly packed binding 0 covering every vertex stage input in location order
+    static void deriveVertexInput(
+        const VulkanShaderReflection& vertexReflection,
+        std::vector<vk::VertexInputBindingDescription>& vertexBindings,
+        std::vector<vk::VertexInputAttributeDescription>& vertexAttributes
+    );
+
+    static std::uint64_t hashModule( const std::vector<char>& spirvBuffer );
+};
+
+} // namespace vkrender
+
+#endif
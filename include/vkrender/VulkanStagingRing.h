@@ -0,0 +1,107 @@
+#ifndef VKRENDER_VULKAN_STAGING_RING_H
+#define VKRENDER_VULKAN_STAGING_RING_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+#include "vkrender/VulkanMemoryAllocator.h"
+
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace vkrender
+{
+
+class VulkanRenderer;
+
+struct VulkanStagingRegion
+{
+    vk::Buffer m_vkBuffer;
+    vk::DeviceSize m_offset = 0;
+    vk::DeviceSize m_size = 0;
+    void* m_pMapped = nullptr;
+};
+
+// Token of the regions read by one submission, from beginSpan() until submitFence()
+struct VulkanStagingSpan
+{
+    std::uint64_t m_id = 0;
+};
+
+// Persistently mapped host visible ring used as the source of every upload, shared between threads.
+// Regions are allocated into a span opened by beginSpan() and stay reserved until the fence returned by
+// submitFence() for that span is signalled, which has to be done by the submission reading them.
+// Spans of different threads may be open at once, space is reclaimed in the order spans were opened.
+class VULKANRENDERER_EXPORTS VulkanStagingRing
+{
+public:
+    struct Statistics
+    {
+        std::uint64_t m_stallCount = 0;
+        std::uint64_t m_wrapCount = 0;
+        std::uint64_t m_spillCount = 0;
+        std::uint64_t m_bytesStaged = 0;
+    };
+
+    static constexpr vk::DeviceSize DEFAULT_RING_SIZE = 32ull * 1024ull * 1024ull;
+    static constexpr vk::DeviceSize DEFAULT_ALIGNMENT = 16ull;
+
+    VulkanStagingRing( VulkanRenderer* pVkRenderer, const vk::DeviceSize& ringSize = DEFAULT_RING_SIZE );
+    ~VulkanStagingRing();
+
+    VulkanStagingSpan beginSpan();
+    VulkanStagingRegion allocate( const VulkanStagingSpan& span, const vk::DeviceSize& size, const vk::DeviceSize& alignment = DEFAULT_ALIGNMENT );
+    // closes the span, the returned fence belongs to the ring and is recycled once signalled
+    vk::Fence submitFence( const VulkanStagingSpan& span );
+    void reclaim();
+    // waits for every submitted span, open spans keep their regions
+    void waitIdle();
+
+    vk::DeviceSize size() const { return m_ringSize; }
+    Statistics statistics() const;
+private:
+    struct SpillBuffer
+    {
+        vk::Buffer m_vkBuffer;
+        VulkanAllocation m_allocation;
+    };
+
+    struct Span
+    {
+        // head when the span was opened, none of its regions start before it
+        vk::DeviceSize m_begin = 0;
+        vk::Fence m_vkFence;
+        bool m_bSubmitted = false;
+        std::vector<SpillBuffer> m_spillBuffers;
+    };
+
+    VulkanRenderer* m_pVkRenderer;
+    vk::Device* m_pLogicalDevice;
+
+    vk::Buffer m_vkRingBuffer;
+    VulkanAllocation m_ringAllocation;
+    vk::DeviceSize m_ringSize;
+
+    // monotonically increasing positions, the physical offset is position % m_ringSize
+    vk::DeviceSize m_head;
+    vk::DeviceSize m_tail;
+
+    // open and submitted spans in the order they were opened, the front has id m_frontSpanId
+    std::deque<Span> m_spans;
+    std::uint64_t m_frontSpanId;
+    std::vector<vk::Fence> m_freeFences;
+
+    Statistics m_statistics;
+
+    mutable std::mutex m_ringMutex;
+
+    // the ring mutex must be held by the following
+    Span& findSpan( const VulkanStagingSpan& span );
+    VulkanStagingRegion allocateSpill( Span& span, const vk::DeviceSize& size );
+    void reclaimSignalled();
+    void retireFrontSpan( const bool& bWait );
+};
+
+} // namespace vkrender
+
+#endif
@@ -4,6 +4,8 @@
 #include "vkrender/VulkanSwapChainStructs.hpp"
 #include "vkrender/VulkanRendererExports.hpp"
 #include "vkrender/VulkanCommandBuffer.h"
+#include "vkrender/VulkanMemoryAllocator.h"
+#include "vkrender/VulkanQueueFamily.hpp"
 #include "utilities/UtilityCommon.hpp"
 
 #include <vulkan/vulkan.hpp>
@@ -16,7 +18,10 @@ struct SwapchainCreateInfo
     vk::PhysicalDevice vkPhysicalDevice;
     vk::Device vkLogicalDevice;
     vk::SurfaceKHR vkSurface;
+    // selected once with the physical device, reused on every recreation
+    QueueFamilyIndices queueFamilyIndices;
     vk::SampleCountFlagBits vkSampleCount;
+    VulkanMemoryAllocator* pMemoryAllocator;
 };
 
 class VULKANRENDERER_EXPORTS VulkanSwapchain
@@ -28,6 +33,14 @@ public:
     void createSwapchain( const utils::Dimension& framebufferDimension );
     void destroySwapchain();
     void recreateSwapchain( const utils::Dimension& framebufferDimension );
+
+    // both return the raw result, eErrorOutOfDateKHR and eSuboptimalKHR ask for a recreation
+    vk::Result acquireNextImage( const vk::Semaphore& imageAvailableSemaphore, std::uint32_t& imageIndex );
+    vk::Result present( const vk::Queue& presentationQueue, const vk::Semaphore& renderFinishedSemaphore, const std::uint32_t& imageIndex );
+
+    vk::Format getImageFormat() const { return m_vkSwapchainImageFormat; }
+    vk::Extent2D getExtent() const { return m_vkSwapchainExtent; }
+    std::uint32_t getImageCount() const { return static_cast<std::uint32_t>( m_vkSwapchainImages.size() ); }
 private:
     void createSwapchainImageViews();
 #if 0
@@ -46,6 +59,8 @@ private:
     vk::PhysicalDevice m_vkPhysicalDevice;
     vk::Device m_vkLogicalDevice;
     vk::SurfaceKHR m_vkSurface;
+    QueueFamilyIndices m_queueFamilyIndices;
+    VulkanMemoryAllocator* m_pMemoryAllocator;
 
     utils::Dimension m_framebufferSize;
 
@@ -62,10 +77,10 @@ private:
 
     vk::Image m_vkColorImage;
     vk::ImageView m_vkColorImageView;
-    vk::DeviceMemory m_vkColorImageMemory;
+    VulkanAllocation m_colorImageAllocation;
     vk::Image m_vkDepthImage;
     vk::ImageView m_vkDepthImageView;
-    vk::DeviceMemory m_vkDepthImageMemory;
+    VulkanAllocation m_depthImageAllocation;
 #endif
 };
 
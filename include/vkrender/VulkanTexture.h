@@ -2,6 +2,7 @@
 #define VKRENDER_VULKAN_TEXTURE_H
 
 #include "vkrender/VulkanTextureManager.h"
+#include "vkrender/VulkanMemoryAllocator.h"
 #include "vkrender/VulkanRendererExports.hpp"
 
 #include <vulkan/vulkan.hpp>
@@ -24,19 +25,26 @@ public:
 
     void createImage();
     void createImageView();
+    // tags the image memory in allocator snapshots and dumps
+    void setName( const std::string& name );
 
     vk::Format format() const { return m_vkImgFormat; }
+    vk::ImageView imageView() const { return m_vkImageView; }
+    // index into the bindless image array, VulkanBindlessTable::INVALID_SLOT when bindless is disabled
+    std::uint32_t bindlessSlot() const { return m_bindlessSlot; }
     vk::SampleCountFlagBits sampleCount() const { return m_vkImgSampleCountFlags; }
 private:
     VulkanTextureManager* m_pTextureManager;
 
     vk::Image m_vkImage;
     vk::ImageView m_vkImageView;
-    vk::DeviceMemory m_vkImgMemory;
+    VulkanAllocation m_imgAllocation;
 
     vk::Format m_vkImgFormat;
     vk::ImageTiling m_vkImgTiling;
     vk::ImageUsageFlags m_vkImgUsageFlags;
+    // set by the texture manager before createImage, e.g. for storage aliases of sRGB formats
+    vk::ImageCreateFlags m_vkImgCreateFlags;
     vk::MemoryPropertyFlags m_vkImgMemoryFlags;
     vk::SampleCountFlagBits m_vkImgSampleCountFlags;
     vk::ImageAspectFlags m_vkImgAspect;
@@ -44,7 +52,10 @@ private:
     std::uint32_t m_miplevels;
     utils::Dimension m_texDimension;
 
+    std::uint32_t m_bindlessSlot;
+
     friend class VulkanTextureManager;
+    friend class VulkanComputeDownsampler;
 };
 
 } // namespace vkrender
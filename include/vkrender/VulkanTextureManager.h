@@ -2,9 +2,13 @@
 #define VKRENDER_VULKAN_TEXTURE_MANAGER_H
 
 #include "vkrender/VulkanRenderer.h"
+#include "vkrender/VulkanUploadScheduler.h"
+#include "vkrender/VulkanComputeDownsampler.h"
 #include "vkrender/VulkanRendererExports.hpp"
 
 #include "utilities/Image.h"
+#include "utilities/ImageLoader.h"
+#include "utilities/MipmapGenerator.h"
 
 #include <vulkan/vulkan.hpp>
 #include <vector>
@@ -27,6 +31,7 @@ public:
         const vk::SampleCountFlagBits& imgSampleCountFlags,
         const vk::ImageAspectFlags& imgAspect
     );
+    // imgFormat applies to decoded pixels, KTX2 and DDS images keep their stored format and mip levels
     VulkanTexture* createTextureAndUploadBuffer(
         const utils::Image& img, 
         const vk::Format& imgFormat, const vk::ImageTiling& imgTiling,
@@ -35,6 +40,28 @@ public:
         const vk::ImageAspectFlags& imgAspect
     );
 
+    // records the layout transitions, copies and mip generation of every image into as few submissions
+    // as the staging ring allows, the submissions precede any later graphics submission so the
+    // textures can be sampled by the next frame without the host waiting for them
+    std::vector<VulkanTexture*> createTexturesAndUploadBuffers(
+        const std::vector<const utils::Image*>& images,
+        const vk::Format& imgFormat, const vk::ImageTiling& imgTiling,
+        const vk::ImageUsageFlags& imgUsageFlags, const vk::MemoryPropertyFlags& memoryPropertyFlags,
+        const vk::SampleCountFlagBits& imgSampleCountFlags,
+        const vk::ImageAspectFlags& imgAspect
+    );
+
+    // uploads the loader's decodes as they finish, each finished group goes through the batched path
+    // above while the rest are still decoding, textures follow the handle order, nullptr where the decode
+    // failed, the handles are released once their pixels are in the staging ring
+    std::vector<VulkanTexture*> createTexturesAndUploadBuffers(
+        utils::ImageLoader& imageLoader, const std::vector<utils::ImageLoader::Handle>& imageHandles,
+        const vk::Format& imgFormat, const vk::ImageTiling& imgTiling,
+        const vk::ImageUsageFlags& imgUsageFlags, const vk::MemoryPropertyFlags& memoryPropertyFlags,
+        const vk::SampleCountFlagBits& imgSampleCountFlags,
+        const vk::ImageAspectFlags& imgAspect
+    );
+
     void transitionImageLayout(
         VulkanTexture* pTexture,
         const vk::ImageLayout& oldLayout, const vk::ImageLayout& newLayout
@@ -43,15 +70,52 @@ public:
     void transferImgBufferToTexture(
         const utils::Image& img, VulkanTexture* pTexture
     );
+    // copies on the transfer queue and generates mips on the graphics queue without blocking,
+    // the texture may be sampled once the returned ticket is ready
+    VulkanUploadTicket transferImgBufferToTextureAsync(
+        const utils::Image& img, VulkanTexture* pTexture
+    );
 
     void generateMipmaps( VulkanTexture* pTexture );
+
+    // decoded images whose format cannot be blitted with linear filtering get their mip chain built on the CPU
+    // with these settings before upload, bAlwaysOnCpu does the same for every decoded image, e.g. for Kaiser
+    // filtering or alpha coverage preservation, sRGB linearization follows the texture format
+    void setCpuMipmapGeneration( const utils::MipmapGenerator::Settings& settings, const bool& bAlwaysOnCpu );
+    // textures created afterwards with mips and a format the downsampler writes get storage usage, their
+    // chains are then built by a single compute dispatch on the graphics queue instead of per level blits,
+    // storage usage may disable framebuffer compression on some hardware
+    void setComputeMipmapGeneration( const bool& bEnable );
     
     VulkanRenderer* getRenderer() const { return m_pVkRenderer; }
     vk::Device* getDevice() const { return &m_pVkRenderer->m_vkLogicalDevice; }
 private:
     vkrender::VulkanRenderer* m_pVkRenderer;
+    utils::MipmapGenerator::Settings m_cpuMipmapSettings;
+    bool m_bCpuMipmapsAlways;
+    // nullptr unless compute mip generation is enabled
+    utils::Uptr<VulkanComputeDownsampler> m_pComputeDownsampler;
+
+    // the container's own format when the device can sample it, requestedFormat for decoded pixels
+    vk::Format selectTextureFormat( const utils::Image& img, const vk::Format& requestedFormat );
+    // one region per level stored in img, bufferOffset is where img.buffer() starts in the source buffer
+    void appendCopyRegions(
+        const utils::Image& img, const vk::DeviceSize& bufferOffset,
+        std::vector<vk::BufferImageCopy>& copyRegions
+    );
+    void validateMipmapSupport( VulkanTexture* pTexture );
+    bool needsCpuMipmaps( const utils::Image& img, const vk::Format& textureFormat );
+    // img with every level filled in, uploaded in place of img so no blits are recorded
+    utils::Uptr<utils::Image> generateCpuMipmaps( const utils::Image& img, const vk::Format& textureFormat );
+    bool usesComputeMipmaps( VulkanTexture* pTexture ) const;
+    void recordMipmapGeneration( vk::CommandBuffer& vkCmdBuffer, VulkanTexture* pTexture );
+    // staging memory of the batch comes from stagingSpan, whose fence the batch submission has to signal
+    void recordTextureBatch(
+        vk::CommandBuffer& vkCmdBuffer, const VulkanStagingSpan& stagingSpan,
+        const std::vector<const utils::Image*>& images, const std::vector<VulkanTexture*>& textures
+    );
 
-    std::vector<VulkanTexture> m_textureArray;
+    std::vector<utils::Uptr<VulkanTexture>> m_textureArray;
 };
 
 } // namespace vkrender
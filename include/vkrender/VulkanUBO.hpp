@@ -3,6 +3,21 @@
 
 #include <glm/glm.hpp>
 
+// written once per frame and bound at a fixed dynamic offset for every draw
+struct VulkanFrameUniforms
+{
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewProjection;
+};
+
+// one slice of the frame's uniform ring per object, bound through its dynamic offset
+struct VulkanObjectUniforms
+{
+    glm::mat4 model;
+};
+
+// the combined block, kept for code that still uploads everything per object
 struct VulkanUniformBufferObject
 {
     glm::mat4 model;
@@ -10,4 +25,12 @@ struct VulkanUniformBufferObject
     glm::mat4 projection;
 };
 
+// per draw data recorded with vkCmdPushConstants, needs no buffer and no descriptor set
+struct VulkanObjectPushConstants
+{
+    glm::mat4 model;
+};
+
+static_assert( sizeof( VulkanObjectPushConstants ) <= 128, "push constants beyond 128 bytes are not portable" );
+
 #endif 
\ No newline at end of file
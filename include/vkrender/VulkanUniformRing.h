@@ -0,0 +1,73 @@
+#ifndef VKRENDER_VULKAN_UNIFORM_RING_H
+#define VKRENDER_VULKAN_UNIFORM_RING_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+#include "vkrender/VulkanMemoryAllocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vulkan/vulkan.hpp>
+
+namespace vkrender
+{
+
+class VulkanRenderer;
+
+struct VulkanUniformSlice
+{
+    vk::Buffer m_vkBuffer;
+    // passed as the dynamic offset of an eUniformBufferDynamic binding
+    std::uint32_t m_dynamicOffset = 0;
+    vk::DeviceSize m_size = 0;
+    void* m_pMapped = nullptr;
+};
+
+// Persistently mapped uniform buffer owned by one frame in flight. Slices are bump allocated at
+// minUniformBufferOffsetAlignment and all bound through a single dynamic descriptor, so per object
+// data costs a memcpy and a dynamic offset instead of a buffer and a descriptor set.
+class VULKANRENDERER_EXPORTS VulkanUniformRing
+{
+public:
+    VulkanUniformRing( VulkanRenderer* pVkRenderer, const vk::DeviceSize& ringSize );
+    VulkanUniformRing( const VulkanUniformRing& ) = delete;
+    VulkanUniformRing& operator=( const VulkanUniformRing& ) = delete;
+    ~VulkanUniformRing();
+
+    // lock free so parallel recorders can share the frame's ring
+    VulkanUniformSlice allocate( const vk::DeviceSize& size );
+
+    template<typename _Data>
+    VulkanUniformSlice push( const _Data& data )
+    {
+        VulkanUniformSlice uniformSlice = allocate( sizeof( _Data ) );
+        std::memcpy( uniformSlice.m_pMapped, &data, sizeof( _Data ) );
+        return uniformSlice;
+    }
+
+    // only once the GPU finished the frame that used the ring
+    void reset();
+
+    // buffer info for an eUniformBufferDynamic binding reading range bytes at each dynamic offset
+    vk::DescriptorBufferInfo descriptorInfo( const vk::DeviceSize& range ) const { return vk::DescriptorBufferInfo{ m_vkBuffer, 0, range }; }
+
+    vk::Buffer buffer() const { return m_vkBuffer; }
+    vk::DeviceSize size() const { return m_ringSize; }
+    vk::DeviceSize alignment() const { return m_alignment; }
+    vk::DeviceSize usedBytes() const { return std::min( m_head.load( std::memory_order_relaxed ), m_ringSize ); }
+    vk::DeviceSize highWaterMark() const { return m_highWaterMark; }
+private:
+    VulkanRenderer* m_pVkRenderer;
+    vk::DeviceSize m_ringSize;
+    vk::DeviceSize m_alignment;
+
+    vk::Buffer m_vkBuffer;
+    VulkanAllocation m_allocation;
+
+    std::atomic<vk::DeviceSize> m_head;
+    vk::DeviceSize m_highWaterMark;
+};
+
+} // namespace vkrender
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef VKRENDER_VULKAN_UPLOAD_SCHEDULER_H
+#define VKRENDER_VULKAN_UPLOAD_SCHEDULER_H
+
+#include "vkrender/VulkanRendererExports.hpp"
+#include "vkrender/VulkanStagingRing.h"
+
+#include <functional>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace vkrender
+{
+
+class VulkanRenderer;
+class VulkanUploadScheduler;
+
+// Future like handle of an upload. The resource may be used by a graphics submission
+// once timelineSemaphore() reaches timelineValue(), either waited on the GPU or through wait()
+class VULKANRENDERER_EXPORTS VulkanUploadTicket
+{
+public:
+    VulkanUploadTicket() = default;
+    VulkanUploadTicket( VulkanUploadScheduler* pScheduler, const std::uint64_t& timelineValue )
+        :m_pScheduler{ pScheduler }
+        ,m_timelineValue{ timelineValue }
+    {}
+
+    bool isValid() const { return m_pScheduler != nullptr; }
+    bool isReady() const;
+    void wait() const;
+
+    vk::Semaphore timelineSemaphore() const;
+    std::uint64_t timelineValue() const { return m_timelineValue; }
+private:
+    VulkanUploadScheduler* m_pScheduler = nullptr;
+    std::uint64_t m_timelineValue = 0;
+};
+
+// Records uploads on the transfer queue and hands the resources over to the graphics queue.
+// Uploads are batched until flush(), batch n signals value n on two timelines: the transfer timeline,
+// only signalled by the transfer queue and waited on by the acquire submission, and the ticket
+// timeline, only signalled once the graphics queue acquired ownership and ran the batch's graphics
+// recorders. Each timeline has a single signalling queue so its values always increase in order.
+class VULKANRENDERER_EXPORTS VulkanUploadScheduler
+{
+public:
+    using GraphicsRecorder = std::function<void(vk::CommandBuffer&)>;
+
+    struct ImageUpload
+    {
+        vk::Image m_vkImage;
+        vk::ImageSubresourceRange m_subresourceRange;
+        // bufferOffset is relative to the start of the uploaded payload
+        std::vector<vk::BufferImageCopy> m_copyRegions;
+        // layout the image is handed to the graphics queue in
+        vk::ImageLayout m_finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+        vk::PipelineStageFlags m_dstStage = vk::PipelineStageFlagBits::eFragmentShader;
+        vk::AccessFlags m_dstAccess = vk::AccessFlagBits::eShaderRead;
+        // optional work recorded on the graphics queue right after the acquire, e.g. mip generation
+        GraphicsRecorder m_graphicsRecorder;
+    };
+
+    VulkanUploadScheduler( VulkanRenderer* pVkRenderer );
+    ~VulkanUploadScheduler();
+
+    VulkanUploadTicket uploadBuffer(
+        const void* pData, const vk::DeviceSize& sizeInBytes,
+        const vk::Buffer& dstBuffer, const vk::DeviceSize& dstOffset,
+        const vk::PipelineStageFlags& dstStage, const vk::AccessFlags& dstAccess
+    );
+    VulkanUploadTicket uploadImage(
+        const void* pData, const vk::DeviceSize& sizeInBytes,
+        const ImageUpload& imageUpload
+    );
+
+    VulkanUploadTicket flush();
+    void waitIdle();
+
+    bool isComplete( const std::uint64_t& timelineValue );
+    void wait( const std::uint64_t& timelineValue );
+
+    vk::Semaphore timelineSemaphore() const { return m_vkTimelineSemaphore; }
+    bool hasOwnershipTransfer() const { return m_bOwnershipTransfer; }
+private:
+    struct UploadBatch
+    {
+        vk::CommandBuffer m_vkTransferCmdBuffer;
+        vk::CommandBuffer m_vkGraphicsCmdBuffer;
+        VulkanStagingSpan m_stagingSpan;
+        std::uint64_t m_readyValue = 0;
+        bool m_bRecording = false;
+
+        std::vector<vk::ImageMemoryBarrier> m_acquireImageBarriers;
+        std::vector<vk::BufferMemoryBarrier> m_acquireBufferBarriers;
+        vk::PipelineStageFlags m_acquireDstStages;
+        std::vector<GraphicsRecorder> m_graphicsRecorders;
+    };
+
+    VulkanRenderer* m_pVkRenderer;
+    vk::Device* m_pLogicalDevice;
+
+    vk::Queue m_vkTransferQueue;
+    vk::Queue m_vkGraphicsQueue;
+    std::uint32_t m_transferFamilyIndex;
+    std::uint32_t m_graphicsFamilyIndex;
+    bool m_bOwnershipTransfer;
+
+    vk::CommandPool m_vkTransferCommandPool;
+    vk::CommandPool m_vkGraphicsCommandPool;
+
+    // ticket timeline, signalled by the last submission of a batch
+    vk::Semaphore m_vkTimelineSemaphore;
+    // transfer to graphics handoff, only created with an ownership transfer
+    vk::Semaphore m_vkTransferSemaphore;
+    std::uint64_t m_lastSubmittedValue;
+
+    UploadBatch m_currentBatch;
+    std::vector<UploadBatch> m_inFlightBatches;
+    std::vector<UploadBatch> m_freeBatches;
+
+    std::recursive_mutex m_schedulerMutex;
+
+    UploadBatch& openBatch();
+    void submitBatch();
+    void submit( const vk::Queue& vkQueue, const vk::SubmitInfo& submitInfo, const vk::Fence& vkFence );
+    void recycleBatches();
+};
+
+} // namespace vkrender
+
+#endif
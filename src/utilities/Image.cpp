@@ -1,23 +1,45 @@
 #include "utilities/Image.h"
+#include "utilities/MappedFile.h"
+#include "utilities/TextureCache.h"
 #include "utilities/VulkanLogger.h"
 
+// failure reasons are per thread so concurrent decodes do not overwrite each other's
+#define STBI_THREAD_LOCAL thread_local
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb/stb_image.h>
 
 #include <spdlog/spdlog.h>
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
 
 namespace utils
 {
 
 Image::Image()
+    :m_imgDimension{ 0, 0 }
+    ,m_buffer{ nullptr }
+    ,m_colorChannels{ 0 }
+    ,m_sourceChannels{ 0 }
+    ,m_mipLevels{ 1 }
+    ,m_vkFormat{ 0 }
+    ,m_blockDimension{ 1, 1 }
 {}
 
 Image::Image( const Dimension& dimension, const uint32_t& channels, ImgBufPtr buffer )
     :m_imgDimension{ dimension }
-    ,m_colorChannels{ channels }
     ,m_buffer{ buffer }
+    ,m_colorChannels{ channels }
+    ,m_sourceChannels{ channels }
+    ,m_mipLevels{ 1 }
+    ,m_vkFormat{ 0 }
+    ,m_blockDimension{ 1, 1 }
 {
     calculateMiplevels();
+    m_storedMipLevels.push_back( MipLevel{ m_imgDimension, 0, static_cast<std::size_t>( m_imgDimension.m_width ) * m_imgDimension.m_height * m_colorChannels } );
 }
 
 Image::~Image()
@@ -25,7 +47,7 @@ Image::~Image()
     clearBuffer();
 }
 
-void Image::loadBuffer( const std::filesystem::path& path )
+void Image::loadBuffer( const std::filesystem::path& path, const uint32_t& desiredChannels )
 {
     if( !std::filesystem::exists(path) )
     {
@@ -33,41 +55,198 @@ void Image::loadBuffer( const std::filesystem::path& path )
 		return;
     }
 
-    int width;
-    int height;
-    int channel;
+    clearBuffer();
+
+    std::string extension = path.extension().string();
+    std::transform( extension.begin(), extension.end(), extension.begin(), []( unsigned char c ){ return static_cast<char>( std::tolower( c ) ); } );
+
+    if( extension == ".ktx2" )
+    {
+        loadKtx2( path );
+        return;
+    }
+
+    if( extension == ".dds" )
+    {
+        loadDds( path );
+        return;
+    }
+
+    if( extension == TextureCache::FILE_EXTENSION )
+    {
+        loadTextureCache( path );
+        return;
+    }
+
+    int width = 0;
+    int height = 0;
+    int channel = 0;
 
     m_buffer = stbi_load(
 		path.string().data(),
 		&width, &height, &channel,
-		STBI_rgb_alpha
+		static_cast<int>( desiredChannels )
 	);
 
-    m_imgDimension.m_width = width;
-    m_imgDimension.m_height = height;
-    m_colorChannels = channel;
-
 	if(!m_buffer)
 	{
-		std::string errorMsg = fmt::format("Failed to load {} image", path.string());
+		std::string errorMsg = fmt::format("Failed to load {} image: {}", path.string(), stbi_failure_reason());
 		LOG_ERROR(errorMsg);
 		throw  std::runtime_error(errorMsg);
 	}
 
+    m_imgDimension.m_width = width;
+    m_imgDimension.m_height = height;
+    m_sourceChannels = channel;
+    m_colorChannels = desiredChannels != 0 ? desiredChannels : m_sourceChannels;
+
     calculateMiplevels();
+    m_storedMipLevels.push_back( MipLevel{ m_imgDimension, 0, static_cast<std::size_t>( width ) * height * m_colorChannels } );
 }
 
 void Image::clearBuffer()
 {
-    if( m_buffer )
+    if( m_pMappedFile )
+    {
+        m_pMappedFile.reset();
+    }
+    else if( !m_payload.empty() )
+    {
+        m_payload.clear();
+        m_payload.shrink_to_fit();
+    }
+    else if( m_buffer )
     {
         stbi_image_free(m_buffer);
     }
+
+    m_buffer = nullptr;
+    m_storedMipLevels.clear();
+    m_vkFormat = 0;
+    m_blockDimension = Dimension{ 1, 1 };
 }
 
 std::size_t Image::sizeInBytes() const
 {
-    return m_imgDimension.m_width * m_imgDimension.m_height * 4;
+    if( m_storedMipLevels.empty() )
+        return 0;
+
+    const MipLevel& lastLevel = m_storedMipLevels.back();
+    return lastLevel.m_offset + lastLevel.m_sizeInBytes;
+}
+
+bool Image::blockFootprint( const uint32_t& vkFormat, Dimension& blockDimension, uint32_t& bytesPerBlock )
+{
+    blockDimension = Dimension{ 4, 4 };
+    bytesPerBlock = 16;
+
+    switch( static_cast<VkFormat>( vkFormat ) )
+    {
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_B8G8R8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+        blockDimension = Dimension{ 1, 1 };
+        bytesPerBlock = 4;
+        return true;
+    case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+    case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+    case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+    case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+    case VK_FORMAT_BC4_UNORM_BLOCK:
+    case VK_FORMAT_BC4_SNORM_BLOCK:
+        bytesPerBlock = 8;
+        return true;
+    case VK_FORMAT_BC2_UNORM_BLOCK:
+    case VK_FORMAT_BC2_SRGB_BLOCK:
+    case VK_FORMAT_BC3_UNORM_BLOCK:
+    case VK_FORMAT_BC3_SRGB_BLOCK:
+    case VK_FORMAT_BC5_UNORM_BLOCK:
+    case VK_FORMAT_BC5_SNORM_BLOCK:
+    case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+    case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+    case VK_FORMAT_BC7_UNORM_BLOCK:
+    case VK_FORMAT_BC7_SRGB_BLOCK:
+        return true;
+    default:
+        break;
+    }
+
+    // every ASTC block is 16 bytes, the unorm and srgb variants of a footprint are adjacent
+    static constexpr std::uint32_t ASTC_FOOTPRINTS[][2] = {
+        { 4, 4 }, { 5, 4 }, { 5, 5 }, { 6, 5 }, { 6, 6 }, { 8, 5 }, { 8, 6 },
+        { 8, 8 }, { 10, 5 }, { 10, 6 }, { 10, 8 }, { 10, 10 }, { 12, 10 }, { 12, 12 }
+    };
+
+    if( vkFormat >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && vkFormat <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK )
+    {
+        const std::uint32_t footprintIndex = ( vkFormat - VK_FORMAT_ASTC_4x4_UNORM_BLOCK ) / 2;
+        blockDimension = Dimension{ ASTC_FOOTPRINTS[footprintIndex][0], ASTC_FOOTPRINTS[footprintIndex][1] };
+        return true;
+    }
+
+    return false;
+}
+
+std::size_t Image::levelSizeInBytes( const Dimension& levelDimension, const Dimension& blockDimension, const uint32_t& bytesPerBlock )
+{
+    return static_cast<std::size_t>( ( levelDimension.m_width + blockDimension.m_width - 1 ) / blockDimension.m_width ) *
+        ( ( levelDimension.m_height + blockDimension.m_height - 1 ) / blockDimension.m_height ) * bytesPerBlock;
+}
+
+void Image::setContainerPayload(
+    const std::filesystem::path& path, const uint32_t& vkFormat, const Dimension& dimension,
+    const std::vector<std::pair<const unsigned char*, std::size_t>>& levels
+)
+{
+    auto l_fail = [&path]( const std::string& reason )
+    {
+        std::string errorMsg = fmt::format( "Failed to load {} image: {}", path.string(), reason );
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    };
+
+    Dimension blockDimension{};
+    std::uint32_t bytesPerBlock = 0;
+    if( !blockFootprint( vkFormat, blockDimension, bytesPerBlock ) )
+        l_fail( fmt::format( "unsupported format {}", vkFormat ) );
+
+    if( dimension.m_width == 0 || dimension.m_height == 0 || levels.empty() )
+        l_fail( "empty image" );
+
+    // copy regions of block compressed images must start on a block boundary, 16 covers every supported block
+    constexpr std::size_t LEVEL_ALIGNMENT = 16;
+
+    std::vector<MipLevel> storedMipLevels;
+    std::size_t payloadSize = 0;
+    for( std::size_t level = 0; level < levels.size(); level++ )
+    {
+        const Dimension levelDimension{
+            std::max( dimension.m_width >> level, 1u ),
+            std::max( dimension.m_height >> level, 1u )
+        };
+        const std::size_t levelSize = levelSizeInBytes( levelDimension, blockDimension, bytesPerBlock );
+
+        if( levels[level].second < levelSize )
+            l_fail( fmt::format( "level {} holds {} bytes, {} expected", level, levels[level].second, levelSize ) );
+
+        payloadSize = ( payloadSize + LEVEL_ALIGNMENT - 1 ) & ~( LEVEL_ALIGNMENT - 1 );
+        storedMipLevels.push_back( MipLevel{ levelDimension, payloadSize, levelSize } );
+        payloadSize += levelSize;
+    }
+
+    m_payload.assign( payloadSize, 0 );
+    for( std::size_t level = 0; level < levels.size(); level++ )
+        std::memcpy( m_payload.data() + storedMipLevels[level].m_offset, levels[level].first, storedMipLevels[level].m_sizeInBytes );
+
+    m_buffer = m_payload.data();
+    m_imgDimension = dimension;
+    m_vkFormat = vkFormat;
+    m_blockDimension = blockDimension;
+    m_storedMipLevels = std::move( storedMipLevels );
+    m_mipLevels = static_cast<std::uint32_t>( m_storedMipLevels.size() );
+    m_colorChannels = isBlockCompressed() ? 0 : bytesPerBlock;
+    m_sourceChannels = m_colorChannels;
 }
 
 void Image::calculateMiplevels()
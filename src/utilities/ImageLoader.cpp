@@ -0,0 +1,187 @@
+#include "utilities/ImageLoader.h"
+#include "utilities/VulkanLogger.h"
+
+#include <chrono>
+#include <exception>
+
+namespace utils
+{
+
+ImageLoader::ImageLoader( ThreadPool* pThreadPool )
+    :m_pThreadPool{ pThreadPool }
+    ,m_nextHandle{ INVALID_HANDLE + 1 }
+    ,m_pendingCount{ 0 }
+{}
+
+ImageLoader::~ImageLoader()
+{
+    // the jobs reference this loader
+    waitAll();
+
+    LOG_DEBUG( fmt::format(
+        "Image Loader Destroyed decoded: {} failed: {} decoded MB: {:.1f}",
+        m_statistics.m_decodedCount, m_statistics.m_failedCount, m_statistics.m_decodedBytes / ( 1024.0 * 1024.0 )
+    ) );
+}
+
+ImageLoader::Handle ImageLoader::load( const std::filesystem::path& path, const std::uint32_t& desiredChannels, const JobPriority& priority )
+{
+    Handle handle = INVALID_HANDLE;
+    {
+        std::lock_guard<std::mutex> lock( m_requestMutex );
+        handle = m_nextHandle++;
+        m_requests[handle].m_path = path;
+        m_pendingCount++;
+    }
+
+    m_pThreadPool->submit( [this, handle, path, desiredChannels](){ decode( handle, path, desiredChannels ); }, priority );
+
+    return handle;
+}
+
+ImageLoader::State ImageLoader::state( const Handle& handle )
+{
+    std::lock_guard<std::mutex> lock( m_requestMutex );
+
+    auto requestItr = m_requests.find( handle );
+    return requestItr != m_requests.end() ? requestItr->second.m_state : State::eFailed;
+}
+
+const Image* ImageLoader::image( const Handle& handle )
+{
+    std::lock_guard<std::mutex> lock( m_requestMutex );
+
+    auto requestItr = m_requests.find( handle );
+    if( requestItr == m_requests.end() || requestItr->second.m_state != State::eReady )
+        return nullptr;
+
+    return requestItr->second.m_pImage.get();
+}
+
+const Image* ImageLoader::wait( const Handle& handle )
+{
+    std::unique_lock<std::mutex> lock( m_requestMutex );
+
+    // looked up on every wake up, a released handle is erased by its decode job
+    auto requestItr = m_requests.find( handle );
+    m_finishedCondition.wait( lock, [this, &handle, &requestItr]()
+    {
+        requestItr = m_requests.find( handle );
+        return requestItr == m_requests.end() || requestItr->second.m_state != State::ePending;
+    } );
+
+    if( requestItr == m_requests.end() || requestItr->second.m_state != State::eReady )
+        return nullptr;
+
+    return requestItr->second.m_pImage.get();
+}
+
+std::vector<ImageLoader::Handle> ImageLoader::waitAny( const std::vector<Handle>& handles )
+{
+    std::vector<Handle> finishedHandles;
+
+    std::unique_lock<std::mutex> lock( m_requestMutex );
+    m_finishedCondition.wait( lock, [this, &handles, &finishedHandles]()
+    {
+        finishedHandles.clear();
+        for( const Handle& handle : handles )
+        {
+            auto requestItr = m_requests.find( handle );
+            if( requestItr == m_requests.end() || requestItr->second.m_state != State::ePending )
+                finishedHandles.push_back( handle );
+        }
+        return !finishedHandles.empty() || handles.empty();
+    } );
+
+    return finishedHandles;
+}
+
+void ImageLoader::waitAll()
+{
+    std::unique_lock<std::mutex> lock( m_requestMutex );
+    m_finishedCondition.wait( lock, [this](){ return m_pendingCount == 0; } );
+}
+
+void ImageLoader::release( const Handle& handle )
+{
+    // pixels are freed outside the lock
+    Uptr<Image> pImage;
+    {
+        std::lock_guard<std::mutex> lock( m_requestMutex );
+
+        auto requestItr = m_requests.find( handle );
+        if( requestItr == m_requests.end() )
+            return;
+
+        if( requestItr->second.m_state == State::ePending )
+        {
+            requestItr->second.m_bReleased = true;
+            return;
+        }
+
+        pImage = std::move( requestItr->second.m_pImage );
+        m_requests.erase( requestItr );
+    }
+}
+
+ImageLoader::Statistics ImageLoader::statistics()
+{
+    std::lock_guard<std::mutex> lock( m_requestMutex );
+    return m_statistics;
+}
+
+void ImageLoader::decode( const Handle& handle, const std::filesystem::path& path, const std::uint32_t& desiredChannels )
+{
+    const auto decodeBegin = std::chrono::steady_clock::now();
+
+    Uptr<Image> pImage = std::make_unique<Image>();
+    bool bDecoded = false;
+
+    try
+    {
+        pImage->loadBuffer( path, desiredChannels );
+        // a missing file leaves the buffer empty without throwing
+        bDecoded = pImage->buffer() != nullptr;
+    }
+    catch( const std::exception& )
+    {
+        // loadBuffer already logged the failure
+    }
+
+    const auto decodeNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - decodeBegin ).count();
+
+    std::error_code fileSizeError;
+    const std::uintmax_t fileBytes = std::filesystem::file_size( path, fileSizeError );
+
+    {
+        std::lock_guard<std::mutex> lock( m_requestMutex );
+
+        // a released request is dropped here, its pixels are freed with pImage outside the lock
+        Request& request = m_requests[handle];
+        request.m_state = bDecoded ? State::eReady : State::eFailed;
+
+        if( bDecoded )
+        {
+            m_statistics.m_decodedCount++;
+            m_statistics.m_fileBytes += fileSizeError ? 0 : fileBytes;
+            m_statistics.m_decodedBytes += pImage->sizeInBytes();
+            m_statistics.m_decodeNanoseconds += static_cast<std::uint64_t>( decodeNanoseconds );
+        }
+        else
+        {
+            m_statistics.m_failedCount++;
+        }
+
+        if( request.m_bReleased )
+            m_requests.erase( handle );
+        else
+            request.m_pImage = std::move( pImage );
+
+        m_pendingCount--;
+
+        // notified under the lock, the destructor may run as soon as the last pending decode releases it
+        m_finishedCondition.notify_all();
+    }
+}
+
+} // namespace utils
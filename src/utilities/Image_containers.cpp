@@ -0,0 +1,321 @@
+#include "utilities/Image.h"
+#include "utilities/MappedFile.h"
+#include "utilities/TextureCache.h"
+#include "utilities/VulkanLogger.h"
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+
+namespace utils
+{
+
+namespace
+{
+
+constexpr std::array<unsigned char, 12> KTX2_IDENTIFIER = {
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+};
+
+struct Ktx2Header
+{
+    std::uint32_t m_vkFormat;
+    std::uint32_t m_typeSize;
+    std::uint32_t m_pixelWidth;
+    std::uint32_t m_pixelHeight;
+    std::uint32_t m_pixelDepth;
+    std::uint32_t m_layerCount;
+    std::uint32_t m_faceCount;
+    std::uint32_t m_levelCount;
+    std::uint32_t m_supercompressionScheme;
+    std::uint32_t m_dfdByteOffset;
+    std::uint32_t m_dfdByteLength;
+    std::uint32_t m_kvdByteOffset;
+    std::uint32_t m_kvdByteLength;
+    // 64 bit fields at a 4 byte aligned offset in the file, split to keep the struct unpadded
+    std::uint32_t m_sgdByteOffset[2];
+    std::uint32_t m_sgdByteLength[2];
+};
+
+struct Ktx2LevelIndex
+{
+    std::uint64_t m_byteOffset;
+    std::uint64_t m_byteLength;
+    std::uint64_t m_uncompressedByteLength;
+};
+
+constexpr std::uint32_t DDS_MAGIC = 0x20534444; // "DDS "
+constexpr std::uint32_t DDS_MIPMAPCOUNT_FLAG = 0x20000;
+constexpr std::uint32_t DDS_FOURCC_FLAG = 0x4;
+constexpr std::uint32_t DDS_CUBEMAP_FLAG = 0x200;
+constexpr std::uint32_t DDS_VOLUME_FLAG = 0x200000;
+
+struct DdsPixelFormat
+{
+    std::uint32_t m_size;
+    std::uint32_t m_flags;
+    std::uint32_t m_fourCC;
+    std::uint32_t m_rgbBitCount;
+    std::uint32_t m_rBitMask;
+    std::uint32_t m_gBitMask;
+    std::uint32_t m_bBitMask;
+    std::uint32_t m_aBitMask;
+};
+
+struct DdsHeader
+{
+    std::uint32_t m_size;
+    std::uint32_t m_flags;
+    std::uint32_t m_height;
+    std::uint32_t m_width;
+    std::uint32_t m_pitchOrLinearSize;
+    std::uint32_t m_depth;
+    std::uint32_t m_mipMapCount;
+    std::uint32_t m_reserved1[11];
+    DdsPixelFormat m_pixelFormat;
+    std::uint32_t m_caps;
+    std::uint32_t m_caps2;
+    std::uint32_t m_caps3;
+    std::uint32_t m_caps4;
+    std::uint32_t m_reserved2;
+};
+
+struct DdsHeaderDxt10
+{
+    std::uint32_t m_dxgiFormat;
+    std::uint32_t m_resourceDimension;
+    std::uint32_t m_miscFlag;
+    std::uint32_t m_arraySize;
+    std::uint32_t m_miscFlags2;
+};
+
+static_assert( sizeof( Ktx2Header ) == 68, "KTX2 header layout" );
+static_assert( sizeof( DdsHeader ) == 124, "DDS header layout" );
+
+constexpr std::uint32_t makeFourCC( const char a, const char b, const char c, const char d )
+{
+    return static_cast<std::uint32_t>( a ) | ( static_cast<std::uint32_t>( b ) << 8 ) |
+        ( static_cast<std::uint32_t>( c ) << 16 ) | ( static_cast<std::uint32_t>( d ) << 24 );
+}
+
+VkFormat ddsFourCCToVkFormat( const std::uint32_t& fourCC )
+{
+    switch( fourCC )
+    {
+    case makeFourCC( 'D', 'X', 'T', '1' ): return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+    case makeFourCC( 'D', 'X', 'T', '3' ): return VK_FORMAT_BC2_UNORM_BLOCK;
+    case makeFourCC( 'D', 'X', 'T', '5' ): return VK_FORMAT_BC3_UNORM_BLOCK;
+    case makeFourCC( 'A', 'T', 'I', '1' ):
+    case makeFourCC( 'B', 'C', '4', 'U' ): return VK_FORMAT_BC4_UNORM_BLOCK;
+    case makeFourCC( 'A', 'T', 'I', '2' ):
+    case makeFourCC( 'B', 'C', '5', 'U' ): return VK_FORMAT_BC5_UNORM_BLOCK;
+    default: return VK_FORMAT_UNDEFINED;
+    }
+}
+
+VkFormat dxgiToVkFormat( const std::uint32_t& dxgiFormat )
+{
+    switch( dxgiFormat )
+    {
+    case 28: return VK_FORMAT_R8G8B8A8_UNORM;
+    case 29: return VK_FORMAT_R8G8B8A8_SRGB;
+    case 71: return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+    case 72: return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+    case 74: return VK_FORMAT_BC2_UNORM_BLOCK;
+    case 75: return VK_FORMAT_BC2_SRGB_BLOCK;
+    case 77: return VK_FORMAT_BC3_UNORM_BLOCK;
+    case 78: return VK_FORMAT_BC3_SRGB_BLOCK;
+    case 80: return VK_FORMAT_BC4_UNORM_BLOCK;
+    case 81: return VK_FORMAT_BC4_SNORM_BLOCK;
+    case 83: return VK_FORMAT_BC5_UNORM_BLOCK;
+    case 84: return VK_FORMAT_BC5_SNORM_BLOCK;
+    case 87: return VK_FORMAT_B8G8R8A8_UNORM;
+    case 91: return VK_FORMAT_B8G8R8A8_SRGB;
+    case 95: return VK_FORMAT_BC6H_UFLOAT_BLOCK;
+    case 96: return VK_FORMAT_BC6H_SFLOAT_BLOCK;
+    case 98: return VK_FORMAT_BC7_UNORM_BLOCK;
+    case 99: return VK_FORMAT_BC7_SRGB_BLOCK;
+    default: return VK_FORMAT_UNDEFINED;
+    }
+}
+
+std::vector<unsigned char> readFile( const std::filesystem::path& path )
+{
+    std::ifstream file( path, std::ios::binary | std::ios::ate );
+    if( !file.is_open() )
+    {
+        std::string errorMsg = fmt::format( "Failed to open {}", path.string() );
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    std::vector<unsigned char> fileData( static_cast<std::size_t>( file.tellg() ) );
+    file.seekg( 0 );
+    file.read( reinterpret_cast<char*>( fileData.data() ), static_cast<std::streamsize>( fileData.size() ) );
+
+    return fileData;
+}
+
+[[noreturn]] void failContainer( const std::filesystem::path& path, const std::string& reason )
+{
+    std::string errorMsg = fmt::format( "Failed to load {} image: {}", path.string(), reason );
+    LOG_ERROR(errorMsg);
+    throw std::runtime_error(errorMsg);
+}
+
+} // namespace
+
+void Image::loadKtx2( const std::filesystem::path& path )
+{
+    const std::vector<unsigned char> fileData = readFile( path );
+
+    if( fileData.size() < KTX2_IDENTIFIER.size() + sizeof( Ktx2Header ) ||
+        !std::equal( KTX2_IDENTIFIER.begin(), KTX2_IDENTIFIER.end(), fileData.begin() ) )
+    {
+        failContainer( path, "not a KTX2 file" );
+    }
+
+    Ktx2Header header{};
+    std::memcpy( &header, fileData.data() + KTX2_IDENTIFIER.size(), sizeof( Ktx2Header ) );
+
+    // Basis Universal and zstd payloads need a transcoder, bake them to a BCn format first
+    if( header.m_supercompressionScheme != 0 || header.m_vkFormat == VK_FORMAT_UNDEFINED )
+        failContainer( path, fmt::format( "supercompression scheme {} is not supported", header.m_supercompressionScheme ) );
+
+    if( header.m_pixelDepth > 1 || header.m_layerCount > 1 || header.m_faceCount != 1 )
+        failContainer( path, "only single 2D images are supported" );
+
+    // 0 asks the loader to generate the chain, only the base level is stored then
+    const std::uint32_t levelCount = std::max( header.m_levelCount, 1u );
+    const std::size_t levelIndexOffset = KTX2_IDENTIFIER.size() + sizeof( Ktx2Header );
+
+    if( levelCount > 32 || fileData.size() < levelIndexOffset + levelCount * sizeof( Ktx2LevelIndex ) )
+        failContainer( path, "truncated level index" );
+
+    std::vector<std::pair<const unsigned char*, std::size_t>> levels;
+    for( std::uint32_t level = 0; level < levelCount; level++ )
+    {
+        Ktx2LevelIndex levelIndex{};
+        std::memcpy( &levelIndex, fileData.data() + levelIndexOffset + level * sizeof( Ktx2LevelIndex ), sizeof( Ktx2LevelIndex ) );
+
+        // offset and length come from the file, checked one at a time so their sum cannot wrap around
+        if( levelIndex.m_byteOffset > fileData.size() || levelIndex.m_byteLength > fileData.size() - levelIndex.m_byteOffset )
+            failContainer( path, fmt::format( "level {} lies outside the file", level ) );
+
+        levels.emplace_back( fileData.data() + levelIndex.m_byteOffset, static_cast<std::size_t>( levelIndex.m_byteLength ) );
+    }
+
+    setContainerPayload( path, header.m_vkFormat, Dimension{ header.m_pixelWidth, header.m_pixelHeight }, levels );
+
+    if( header.m_levelCount == 0 && !isBlockCompressed() )
+        calculateMiplevels();
+}
+
+void Image::loadDds( const std::filesystem::path& path )
+{
+    const std::vector<unsigned char> fileData = readFile( path );
+
+    std::uint32_t magic = 0;
+    if( fileData.size() >= sizeof( magic ) + sizeof( DdsHeader ) )
+        std::memcpy( &magic, fileData.data(), sizeof( magic ) );
+
+    if( magic != DDS_MAGIC )
+        failContainer( path, "not a DDS file" );
+
+    DdsHeader header{};
+    std::memcpy( &header, fileData.data() + sizeof( magic ), sizeof( DdsHeader ) );
+    std::size_t dataOffset = sizeof( magic ) + sizeof( DdsHeader );
+
+    if( ( header.m_caps2 & ( DDS_CUBEMAP_FLAG | DDS_VOLUME_FLAG ) ) != 0 )
+        failContainer( path, "only single 2D images are supported" );
+
+    VkFormat vkFormat = VK_FORMAT_UNDEFINED;
+    if( ( header.m_pixelFormat.m_flags & DDS_FOURCC_FLAG ) && header.m_pixelFormat.m_fourCC == makeFourCC( 'D', 'X', '1', '0' ) )
+    {
+        DdsHeaderDxt10 headerDxt10{};
+        if( fileData.size() < dataOffset + sizeof( DdsHeaderDxt10 ) )
+            failContainer( path, "truncated DX10 header" );
+
+        std::memcpy( &headerDxt10, fileData.data() + dataOffset, sizeof( DdsHeaderDxt10 ) );
+        dataOffset += sizeof( DdsHeaderDxt10 );
+
+        if( headerDxt10.m_arraySize > 1 )
+            failContainer( path, "only single 2D images are supported" );
+
+        vkFormat = dxgiToVkFormat( headerDxt10.m_dxgiFormat );
+    }
+    else if( header.m_pixelFormat.m_flags & DDS_FOURCC_FLAG )
+    {
+        vkFormat = ddsFourCCToVkFormat( header.m_pixelFormat.m_fourCC );
+    }
+
+    if( vkFormat == VK_FORMAT_UNDEFINED )
+        failContainer( path, "unsupported pixel format" );
+
+    Dimension blockDimension{};
+    std::uint32_t bytesPerBlock = 0;
+    blockFootprint( vkFormat, blockDimension, bytesPerBlock );
+
+    const std::uint32_t levelCount = ( header.m_flags & DDS_MIPMAPCOUNT_FLAG ) ? std::max( header.m_mipMapCount, 1u ) : 1u;
+    if( levelCount > 32 )
+        failContainer( path, "too many mip levels" );
+
+    // levels follow each other tightly packed, base level first
+    std::vector<std::pair<const unsigned char*, std::size_t>> levels;
+    for( std::uint32_t level = 0; level < levelCount; level++ )
+    {
+        const Dimension levelDimension{ std::max( header.m_width >> level, 1u ), std::max( header.m_height >> level, 1u ) };
+        const std::size_t levelSize = levelSizeInBytes( levelDimension, blockDimension, bytesPerBlock );
+
+        // dataOffset never passes the end of the file, the level size comes from the header dimensions
+        if( levelSize > fileData.size() - dataOffset )
+            failContainer( path, fmt::format( "level {} lies outside the file", level ) );
+
+        levels.emplace_back( fileData.data() + dataOffset, levelSize );
+        dataOffset += levelSize;
+    }
+
+    setContainerPayload( path, vkFormat, Dimension{ header.m_width, header.m_height }, levels );
+}
+
+void Image::loadTextureCache( const std::filesystem::path& path )
+{
+    Uptr<MappedFile> pMappedFile = std::make_unique<MappedFile>();
+    pMappedFile->open( path );
+
+    TextureCacheHeader header{};
+    const std::vector<TextureCacheLevel> levels = TextureCache::readLevels( path, pMappedFile->data(), pMappedFile->size(), header );
+
+    Dimension blockDimension{};
+    std::uint32_t bytesPerBlock = 0;
+    if( !blockFootprint( header.m_vkFormat, blockDimension, bytesPerBlock ) )
+        failContainer( path, fmt::format( "unsupported format {}", header.m_vkFormat ) );
+
+    // offsets are relative to the base level so the mapped range from it onwards is the payload
+    std::vector<MipLevel> storedMipLevels;
+    for( std::size_t level = 0; level < levels.size(); level++ )
+    {
+        const Dimension levelDimension{ levels[level].m_width, levels[level].m_height };
+        const std::size_t levelSize = levelSizeInBytes( levelDimension, blockDimension, bytesPerBlock );
+
+        if( levels[level].m_sizeInBytes != levelSize )
+            failContainer( path, fmt::format( "level {} holds {} bytes, {} expected", level, levels[level].m_sizeInBytes, levelSize ) );
+
+        storedMipLevels.push_back( MipLevel{ levelDimension, static_cast<std::size_t>( levels[level].m_offset - levels[0].m_offset ), levelSize } );
+    }
+
+    m_pMappedFile = std::move( pMappedFile );
+    m_buffer = const_cast<ImgBufPtr>( m_pMappedFile->data() + levels[0].m_offset );
+    m_imgDimension = Dimension{ header.m_width, header.m_height };
+    m_vkFormat = header.m_vkFormat;
+    m_blockDimension = blockDimension;
+    m_storedMipLevels = std::move( storedMipLevels );
+    m_mipLevels = static_cast<std::uint32_t>( m_storedMipLevels.size() );
+    m_colorChannels = isBlockCompressed() ? 0 : bytesPerBlock;
+    m_sourceChannels = m_colorChannels;
+}
+
+} // namespace utils
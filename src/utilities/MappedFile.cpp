@@ -0,0 +1,108 @@
+#include "utilities/MappedFile.h"
+#include "utilities/VulkanLogger.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace utils
+{
+
+MappedFile::MappedFile()
+    :m_pData{ nullptr }
+    ,m_size{ 0 }
+#ifdef WIN32
+    ,m_fileHandle{ INVALID_HANDLE_VALUE }
+    ,m_mappingHandle{ nullptr }
+#endif
+{}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+void MappedFile::open( const std::filesystem::path& path )
+{
+    close();
+
+    auto l_fail = [this, &path]( const std::string& reason )
+    {
+        close();
+        std::string errorMsg = fmt::format( "Failed to map {}: {}", path.string(), reason );
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    };
+
+#ifdef WIN32
+    m_fileHandle = CreateFileW( path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+    if( m_fileHandle == INVALID_HANDLE_VALUE )
+        l_fail( "cannot open file" );
+
+    LARGE_INTEGER fileSize{};
+    if( !GetFileSizeEx( m_fileHandle, &fileSize ) || fileSize.QuadPart == 0 )
+        l_fail( "empty file" );
+
+    m_mappingHandle = CreateFileMappingW( m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    if( !m_mappingHandle )
+        l_fail( "cannot create file mapping" );
+
+    m_pData = static_cast<const unsigned char*>( MapViewOfFile( m_mappingHandle, FILE_MAP_READ, 0, 0, 0 ) );
+    if( !m_pData )
+        l_fail( "cannot map view of file" );
+
+    m_size = static_cast<std::size_t>( fileSize.QuadPart );
+#else
+    const int fileDescriptor = ::open( path.string().c_str(), O_RDONLY );
+    if( fileDescriptor < 0 )
+        l_fail( "cannot open file" );
+
+    struct stat fileStat{};
+    if( fstat( fileDescriptor, &fileStat ) != 0 || fileStat.st_size == 0 )
+    {
+        ::close( fileDescriptor );
+        l_fail( "empty file" );
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    void* pMapping = mmap( nullptr, static_cast<std::size_t>( fileStat.st_size ), PROT_READ, MAP_PRIVATE, fileDescriptor, 0 );
+    ::close( fileDescriptor );
+
+    if( pMapping == MAP_FAILED )
+        l_fail( "mmap failed" );
+
+    // levels are read front to back once when they are copied to staging
+    madvise( pMapping, static_cast<std::size_t>( fileStat.st_size ), MADV_SEQUENTIAL );
+
+    m_pData = static_cast<const unsigned char*>( pMapping );
+    m_size = static_cast<std::size_t>( fileStat.st_size );
+#endif
+}
+
+void MappedFile::close()
+{
+#ifdef WIN32
+    if( m_pData )
+        UnmapViewOfFile( m_pData );
+    if( m_mappingHandle )
+        CloseHandle( m_mappingHandle );
+    if( m_fileHandle != INVALID_HANDLE_VALUE )
+        CloseHandle( m_fileHandle );
+
+    m_mappingHandle = nullptr;
+    m_fileHandle = INVALID_HANDLE_VALUE;
+#else
+    if( m_pData )
+        munmap( const_cast<unsigned char*>( m_pData ), m_size );
+#endif
+
+    m_pData = nullptr;
+    m_size = 0;
+}
+
+} // namespace utils
@@ -0,0 +1,602 @@
+#include "utilities/MipmapGenerator.h"
+#include "utilities/Image.h"
+#include "utilities/ThreadPool.h"
+#include "utilities/VulkanLogger.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define UTILS_MIPMAP_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define UTILS_MIPMAP_NEON
+#endif
+
+// UTILS_MIPMAP_AVX2 is defined by the build on x86 targets, where MipmapGenerator_avx2.cpp is compiled with AVX2
+// enabled. Only that file may contain AVX2 instructions, they run after the CPU was checked for support
+#if defined(UTILS_MIPMAP_AVX2) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <vector>
+
+namespace utils
+{
+
+#if defined(UTILS_MIPMAP_AVX2)
+// defined in MipmapGenerator_avx2.cpp, each returns how far it got so the caller finishes the row
+namespace mipmap_avx2
+{
+std::uint32_t boxEvenRow( const float* pRow0, const float* pRow1, float* pTarget, const std::uint32_t& targetWidth );
+std::size_t accumulateRow( float* pTarget, const float* pSource, const float& weight, const std::size_t& floatCount );
+} // namespace mipmap_avx2
+#endif
+
+namespace
+{
+
+constexpr std::uint32_t CHANNELS = 4;
+// levels below this many destination texels are not worth a trip through the pool
+constexpr std::size_t PARALLEL_TEXEL_THRESHOLD = 64 * 1024;
+constexpr float PI = 3.14159265358979f;
+constexpr std::uint32_t SRGB_GUESS_ENTRIES = 4096;
+
+struct Tap
+{
+    std::uint32_t m_index;
+    float m_weight;
+};
+
+// source texels and weights of every destination texel along one axis
+struct AxisTaps
+{
+    std::vector<std::uint32_t> m_begin;
+    std::vector<Tap> m_taps;
+};
+
+struct ConversionTables
+{
+    std::array<float, 256> m_unormToFloat;
+    std::array<float, 256> m_srgbToLinear;
+    // linear value at which each sRGB byte starts, encoding rounds exactly like the curve
+    std::array<float, 256> m_srgbThresholds;
+    // byte for a coarse linear value, at most one step away from the exact one
+    std::array<unsigned char, SRGB_GUESS_ENTRIES> m_srgbGuess;
+};
+
+float srgbToLinear( const float& value )
+{
+    return value <= 0.04045f ? value / 12.92f : std::pow( ( value + 0.055f ) / 1.055f, 2.4f );
+}
+
+const ConversionTables& conversionTables()
+{
+    static const ConversionTables tables = []() {
+        ConversionTables newTables{};
+        for( std::uint32_t value = 0; value < 256; value++ )
+        {
+            newTables.m_unormToFloat[value] = value / 255.0f;
+            newTables.m_srgbToLinear[value] = srgbToLinear( value / 255.0f );
+            newTables.m_srgbThresholds[value] = value == 0 ? 0.0f : srgbToLinear( ( value - 0.5f ) / 255.0f );
+        }
+        for( std::uint32_t entry = 0; entry < SRGB_GUESS_ENTRIES; entry++ )
+        {
+            const float linear = static_cast<float>( entry ) / ( SRGB_GUESS_ENTRIES - 1 );
+            newTables.m_srgbGuess[entry] = static_cast<unsigned char>( std::upper_bound( newTables.m_srgbThresholds.begin() + 1, newTables.m_srgbThresholds.end(), linear ) - newTables.m_srgbThresholds.begin() - 1 );
+        }
+        return newTables;
+    }();
+    return tables;
+}
+
+unsigned char encodeSrgb( const float& value, const ConversionTables& tables )
+{
+    const float clamped = std::clamp( value, 0.0f, 1.0f );
+    std::uint32_t encoded = tables.m_srgbGuess[static_cast<std::uint32_t>( clamped * ( SRGB_GUESS_ENTRIES - 1 ) )];
+    while( encoded < 255 && clamped >= tables.m_srgbThresholds[encoded + 1] )
+        encoded++;
+    while( encoded > 0 && clamped < tables.m_srgbThresholds[encoded] )
+        encoded--;
+    return static_cast<unsigned char>( encoded );
+}
+
+float besselI0( const float& x )
+{
+    // power series, converges quickly for the window shapes in use
+    float sum = 1.0f;
+    float term = 1.0f;
+    const float halfSquared = x * x * 0.25f;
+    for( std::uint32_t k = 1; k < 32 && term > sum * 1e-7f; k++ )
+    {
+        term *= halfSquared / static_cast<float>( k * k );
+        sum += term;
+    }
+    return sum;
+}
+
+float kaiserSinc( const float& distance, const MipmapGenerator::Settings& settings )
+{
+    const float windowPosition = distance / settings.m_kaiserWidth;
+    if( std::abs( windowPosition ) >= 1.0f )
+        return 0.0f;
+
+    const float sinc = std::abs( distance ) < 1e-6f ? 1.0f : std::sin( PI * distance ) / ( PI * distance );
+    return sinc * besselI0( settings.m_kaiserAlpha * std::sqrt( 1.0f - windowPosition * windowPosition ) ) / besselI0( settings.m_kaiserAlpha );
+}
+
+AxisTaps buildTaps( const std::uint32_t& sourceSize, const std::uint32_t& targetSize, const MipmapGenerator::Settings& settings )
+{
+    AxisTaps axisTaps;
+    const float scale = static_cast<float>( sourceSize ) / static_cast<float>( targetSize );
+
+    for( std::uint32_t target = 0; target < targetSize; target++ )
+    {
+        axisTaps.m_begin.push_back( static_cast<std::uint32_t>( axisTaps.m_taps.size() ) );
+        const std::size_t firstTap = axisTaps.m_taps.size();
+
+        if( settings.m_filter == MipmapGenerator::Filter::eBox )
+        {
+            // overlap of each source texel with the footprint, odd sizes get three fractional taps
+            const float footprintBegin = target * scale;
+            const float footprintEnd = footprintBegin + scale;
+            for( std::uint32_t source = static_cast<std::uint32_t>( footprintBegin ); source < sourceSize && source < footprintEnd; source++ )
+            {
+                const float overlap = std::min( footprintEnd, source + 1.0f ) - std::max( footprintBegin, static_cast<float>( source ) );
+                if( overlap > 0.0f )
+                    axisTaps.m_taps.push_back( Tap{ source, overlap / scale } );
+            }
+        }
+        else
+        {
+            // windowed sinc at the target Nyquist rate, edge texels are repeated
+            const float center = ( target + 0.5f ) * scale;
+            const float radius = settings.m_kaiserWidth * scale;
+            const std::int32_t first = static_cast<std::int32_t>( std::floor( center - radius ) );
+            const std::int32_t last = static_cast<std::int32_t>( std::ceil( center + radius ) );
+
+            float weightSum = 0.0f;
+            for( std::int32_t source = first; source <= last; source++ )
+            {
+                const float weight = kaiserSinc( ( source + 0.5f - center ) / scale, settings );
+                if( weight == 0.0f )
+                    continue;
+
+                const std::uint32_t clampedSource = static_cast<std::uint32_t>( std::clamp( source, 0, static_cast<std::int32_t>( sourceSize ) - 1 ) );
+                axisTaps.m_taps.push_back( Tap{ clampedSource, weight } );
+                weightSum += weight;
+            }
+
+            for( std::size_t tap = firstTap; tap < axisTaps.m_taps.size(); tap++ )
+                axisTaps.m_taps[tap].m_weight /= weightSum;
+        }
+    }
+
+    axisTaps.m_begin.push_back( static_cast<std::uint32_t>( axisTaps.m_taps.size() ) );
+    return axisTaps;
+}
+
+// 2x2 average of RGBA float texels for even sized levels
+void boxEvenRow( const float* pRow0, const float* pRow1, float* pTarget, const std::uint32_t& targetWidth, const MipmapGenerator::SimdPath& simdPath )
+{
+    std::uint32_t x = 0;
+#if defined(UTILS_MIPMAP_AVX2)
+    if( simdPath == MipmapGenerator::SimdPath::eAvx2 )
+        x = mipmap_avx2::boxEvenRow( pRow0, pRow1, pTarget, targetWidth );
+#endif
+#if defined(UTILS_MIPMAP_SSE2)
+    const __m128 quarter = _mm_set1_ps( 0.25f );
+    for( ; simdPath != MipmapGenerator::SimdPath::eScalar && x < targetWidth; x++ )
+    {
+        const __m128 sum0 = _mm_add_ps( _mm_loadu_ps( pRow0 + x * 8 ), _mm_loadu_ps( pRow0 + x * 8 + 4 ) );
+        const __m128 sum1 = _mm_add_ps( _mm_loadu_ps( pRow1 + x * 8 ), _mm_loadu_ps( pRow1 + x * 8 + 4 ) );
+        _mm_storeu_ps( pTarget + x * 4, _mm_mul_ps( _mm_add_ps( sum0, sum1 ), quarter ) );
+    }
+#elif defined(UTILS_MIPMAP_NEON)
+    for( ; simdPath != MipmapGenerator::SimdPath::eScalar && x < targetWidth; x++ )
+    {
+        const float32x4_t sum0 = vaddq_f32( vld1q_f32( pRow0 + x * 8 ), vld1q_f32( pRow0 + x * 8 + 4 ) );
+        const float32x4_t sum1 = vaddq_f32( vld1q_f32( pRow1 + x * 8 ), vld1q_f32( pRow1 + x * 8 + 4 ) );
+        vst1q_f32( pTarget + x * 4, vmulq_n_f32( vaddq_f32( sum0, sum1 ), 0.25f ) );
+    }
+#endif
+    for( ; x < targetWidth; x++ )
+    {
+        for( std::uint32_t channel = 0; channel < CHANNELS; channel++ )
+        {
+            pTarget[x * 4 + channel] = 0.25f * (
+                pRow0[x * 8 + channel] + pRow0[x * 8 + 4 + channel] +
+                pRow1[x * 8 + channel] + pRow1[x * 8 + 4 + channel]
+            );
+        }
+    }
+}
+
+// weighted sum of source texels for each destination texel of a row
+void filterRowHorizontal( const float* pSource, float* pTarget, const AxisTaps& axisTaps, const MipmapGenerator::SimdPath& simdPath )
+{
+    const std::size_t targetWidth = axisTaps.m_begin.size() - 1;
+    for( std::size_t x = 0; x < targetWidth; x++ )
+    {
+        const Tap* pTap = axisTaps.m_taps.data() + axisTaps.m_begin[x];
+        const Tap* pTapEnd = axisTaps.m_taps.data() + axisTaps.m_begin[x + 1];
+#if defined(UTILS_MIPMAP_SSE2)
+        if( simdPath != MipmapGenerator::SimdPath::eScalar )
+        {
+            __m128 sum = _mm_setzero_ps();
+            for( ; pTap != pTapEnd; pTap++ )
+                sum = _mm_add_ps( sum, _mm_mul_ps( _mm_loadu_ps( pSource + pTap->m_index * 4 ), _mm_set1_ps( pTap->m_weight ) ) );
+            _mm_storeu_ps( pTarget + x * 4, sum );
+            continue;
+        }
+#elif defined(UTILS_MIPMAP_NEON)
+        if( simdPath != MipmapGenerator::SimdPath::eScalar )
+        {
+            float32x4_t sum = vdupq_n_f32( 0.0f );
+            for( ; pTap != pTapEnd; pTap++ )
+                sum = vmlaq_n_f32( sum, vld1q_f32( pSource + pTap->m_index * 4 ), pTap->m_weight );
+            vst1q_f32( pTarget + x * 4, sum );
+            continue;
+        }
+#endif
+        float sum[CHANNELS] = {};
+        for( ; pTap != pTapEnd; pTap++ )
+        {
+            for( std::uint32_t channel = 0; channel < CHANNELS; channel++ )
+                sum[channel] += pSource[pTap->m_index * 4 + channel] * pTap->m_weight;
+        }
+        std::memcpy( pTarget + x * 4, sum, sizeof( sum ) );
+    }
+}
+
+// pTarget += weight * pSource over floatCount floats
+void accumulateRow( float* pTarget, const float* pSource, const float& weight, const std::size_t& floatCount, const MipmapGenerator::SimdPath& simdPath )
+{
+    std::size_t i = 0;
+#if defined(UTILS_MIPMAP_AVX2)
+    if( simdPath == MipmapGenerator::SimdPath::eAvx2 )
+        i = mipmap_avx2::accumulateRow( pTarget, pSource, weight, floatCount );
+#endif
+#if defined(UTILS_MIPMAP_SSE2)
+    const __m128 weight4 = _mm_set1_ps( weight );
+    for( ; simdPath != MipmapGenerator::SimdPath::eScalar && i + 4 <= floatCount; i += 4 )
+        _mm_storeu_ps( pTarget + i, _mm_add_ps( _mm_loadu_ps( pTarget + i ), _mm_mul_ps( _mm_loadu_ps( pSource + i ), weight4 ) ) );
+#elif defined(UTILS_MIPMAP_NEON)
+    for( ; simdPath != MipmapGenerator::SimdPath::eScalar && i + 4 <= floatCount; i += 4 )
+        vst1q_f32( pTarget + i, vmlaq_n_f32( vld1q_f32( pTarget + i ), vld1q_f32( pSource + i ), weight ) );
+#endif
+    for( ; i < floatCount; i++ )
+        pTarget[i] += pSource[i] * weight;
+}
+
+// float texels to 8 bit unorm, alpha scaled for coverage preservation
+void encodeUnormRow( const float* pSource, unsigned char* pTarget, const std::size_t& texelCount, const float& alphaScale, const MipmapGenerator::SimdPath& simdPath )
+{
+    std::size_t texel = 0;
+#if defined(UTILS_MIPMAP_SSE2)
+    const __m128 scale = _mm_setr_ps( 255.0f, 255.0f, 255.0f, 255.0f * alphaScale );
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 maximum = _mm_set1_ps( 255.0f );
+    for( ; simdPath != MipmapGenerator::SimdPath::eScalar && texel + 4 <= texelCount; texel += 4 )
+    {
+        __m128i texels[4];
+        for( std::uint32_t i = 0; i < 4; i++ )
+        {
+            const __m128 scaled = _mm_min_ps( _mm_max_ps( _mm_mul_ps( _mm_loadu_ps( pSource + ( texel + i ) * 4 ), scale ), zero ), maximum );
+            texels[i] = _mm_cvtps_epi32( scaled );
+        }
+        const __m128i packed = _mm_packus_epi16( _mm_packs_epi32( texels[0], texels[1] ), _mm_packs_epi32( texels[2], texels[3] ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( pTarget + texel * 4 ), packed );
+    }
+#elif defined(UTILS_MIPMAP_NEON)
+    const float scaleValues[4] = { 255.0f, 255.0f, 255.0f, 255.0f * alphaScale };
+    const float32x4_t scale = vld1q_f32( scaleValues );
+    const float32x4_t maximum = vdupq_n_f32( 255.0f );
+    for( ; simdPath != MipmapGenerator::SimdPath::eScalar && texel + 2 <= texelCount; texel += 2 )
+    {
+        const float32x4_t scaled0 = vminq_f32( vmaxq_f32( vmulq_f32( vld1q_f32( pSource + texel * 4 ), scale ), vdupq_n_f32( 0.0f ) ), maximum );
+        const float32x4_t scaled1 = vminq_f32( vmaxq_f32( vmulq_f32( vld1q_f32( pSource + texel * 4 + 4 ), scale ), vdupq_n_f32( 0.0f ) ), maximum );
+        const uint16x8_t halves = vcombine_u16(
+            vmovn_u32( vcvtq_u32_f32( vaddq_f32( scaled0, vdupq_n_f32( 0.5f ) ) ) ),
+            vmovn_u32( vcvtq_u32_f32( vaddq_f32( scaled1, vdupq_n_f32( 0.5f ) ) ) )
+        );
+        vst1_u8( pTarget + texel * 4, vmovn_u16( halves ) );
+    }
+#endif
+    for( ; texel < texelCount; texel++ )
+    {
+        for( std::uint32_t channel = 0; channel < CHANNELS; channel++ )
+        {
+            const float value = pSource[texel * 4 + channel] * ( channel == 3 ? alphaScale : 1.0f );
+            pTarget[texel * 4 + channel] = static_cast<unsigned char>( std::clamp( value * 255.0f + 0.5f, 0.0f, 255.0f ) );
+        }
+    }
+}
+
+void encodeSrgbRow( const float* pSource, unsigned char* pTarget, const std::size_t& texelCount, const float& alphaScale, const ConversionTables& tables )
+{
+    for( std::size_t texel = 0; texel < texelCount; texel++ )
+    {
+        for( std::uint32_t channel = 0; channel < 3; channel++ )
+            pTarget[texel * 4 + channel] = encodeSrgb( pSource[texel * 4 + channel], tables );
+
+        pTarget[texel * 4 + 3] = static_cast<unsigned char>( std::clamp( pSource[texel * 4 + 3] * alphaScale * 255.0f + 0.5f, 0.0f, 255.0f ) );
+    }
+}
+
+#if defined(UTILS_MIPMAP_AVX2)
+bool cpuSupportsAvx2()
+{
+#if defined(_MSC_VER)
+    int registers[4];
+    __cpuid( registers, 0 );
+    if( registers[0] < 7 )
+        return false;
+
+    // the OS has to save the YMM registers on context switches
+    __cpuid( registers, 1 );
+    if( ( registers[2] & ( 1 << 27 ) ) == 0 || ( _xgetbv( 0 ) & 0x6 ) != 0x6 )
+        return false;
+
+    __cpuidex( registers, 7, 0 );
+    return ( registers[1] & ( 1 << 5 ) ) != 0;
+#else
+    // checks OS support of the YMM registers as well
+    return __builtin_cpu_supports( "avx2" );
+#endif
+}
+#endif
+
+float levelCoverage( const float* pTexels, const std::size_t& texelCount, const float& cutoff, const float& alphaScale )
+{
+    std::size_t covered = 0;
+    for( std::size_t texel = 0; texel < texelCount; texel++ )
+        covered += pTexels[texel * 4 + 3] * alphaScale > cutoff ? 1 : 0;
+    return static_cast<float>( covered ) / static_cast<float>( texelCount );
+}
+
+// alpha scale that brings the level's coverage back to the base level's, searched on the cutoff it is equivalent to
+float coverageAlphaScale( const float* pTexels, const std::size_t& texelCount, const float& cutoff, const float& targetCoverage )
+{
+    float lowCutoff = 0.0f;
+    float highCutoff = 1.0f;
+    for( std::uint32_t iteration = 0; iteration < 12; iteration++ )
+    {
+        const float midCutoff = 0.5f * ( lowCutoff + highCutoff );
+        if( levelCoverage( pTexels, texelCount, midCutoff, 1.0f ) > targetCoverage )
+            lowCutoff = midCutoff;
+        else
+            highCutoff = midCutoff;
+    }
+
+    const float levelCutoff = 0.5f * ( lowCutoff + highCutoff );
+    return levelCutoff > 0.0f ? cutoff / levelCutoff : 1.0f;
+}
+
+} // namespace
+
+MipmapGenerator::MipmapGenerator( ThreadPool* pThreadPool )
+    :m_pThreadPool{ pThreadPool }
+{}
+
+void MipmapGenerator::generate( const Image& src, const Settings& settings, Image& dst ) const
+{
+    if( src.vkFormat() != 0 || src.colorChannels() != CHANNELS || !src.buffer() || &src == &dst )
+    {
+        std::string errorMsg = fmt::format( "mip chains are generated from decoded {} channel images only", CHANNELS );
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    const ConversionTables& tables = conversionTables();
+    const SimdPath simdPath = std::min( settings.m_maxSimdPath, bestSimdPath() );
+    const std::array<float, 256>& colorToFloat = settings.m_bSrgb ? tables.m_srgbToLinear : tables.m_unormToFloat;
+
+    // tightly packed, 4 byte texels keep every level offset valid for buffer to image copies
+    std::vector<Image::MipLevel> mipLevels;
+    std::size_t payloadSize = 0;
+    for( std::uint32_t level = 0; level < src.miplevels(); level++ )
+    {
+        const Dimension levelDimension{
+            std::max( src.dimension().m_width >> level, 1u ),
+            std::max( src.dimension().m_height >> level, 1u )
+        };
+        const std::size_t levelSize = static_cast<std::size_t>( levelDimension.m_width ) * levelDimension.m_height * CHANNELS;
+        mipLevels.push_back( Image::MipLevel{ levelDimension, payloadSize, levelSize } );
+        payloadSize += levelSize;
+    }
+
+    std::vector<unsigned char> payload( payloadSize );
+    std::memcpy( payload.data(), src.buffer(), mipLevels[0].m_sizeInBytes );
+
+    const unsigned char* pBase = src.buffer();
+    const Dimension baseDimension = src.dimension();
+    const bool bPreserveCoverage = settings.m_alphaCoverageCutoff > 0.0f;
+
+    float baseCoverage = 0.0f;
+    if( bPreserveCoverage )
+    {
+        const std::size_t baseTexels = static_cast<std::size_t>( baseDimension.m_width ) * baseDimension.m_height;
+        std::size_t covered = 0;
+        for( std::size_t texel = 0; texel < baseTexels; texel++ )
+            covered += tables.m_unormToFloat[pBase[texel * 4 + 3]] > settings.m_alphaCoverageCutoff ? 1 : 0;
+        baseCoverage = static_cast<float>( covered ) / static_cast<float>( baseTexels );
+    }
+
+    // the base level is converted row by row as it is read, later levels stay in float until the chain is done
+    std::vector<float> previousLevel;
+    std::vector<float> currentLevel;
+    std::vector<float> horizontalPass;
+
+    auto l_sourceRow = [&]( const Dimension& sourceDimension, const std::uint32_t& y, std::vector<float>& scratch ) -> const float* {
+        if( !previousLevel.empty() )
+            return previousLevel.data() + static_cast<std::size_t>( y ) * sourceDimension.m_width * CHANNELS;
+
+        scratch.resize( static_cast<std::size_t>( sourceDimension.m_width ) * CHANNELS );
+        const unsigned char* pRow = pBase + static_cast<std::size_t>( y ) * sourceDimension.m_width * CHANNELS;
+        for( std::size_t texel = 0; texel < sourceDimension.m_width; texel++ )
+        {
+            scratch[texel * 4] = colorToFloat[pRow[texel * 4]];
+            scratch[texel * 4 + 1] = colorToFloat[pRow[texel * 4 + 1]];
+            scratch[texel * 4 + 2] = colorToFloat[pRow[texel * 4 + 2]];
+            scratch[texel * 4 + 3] = tables.m_unormToFloat[pRow[texel * 4 + 3]];
+        }
+        return scratch.data();
+    };
+
+    for( std::size_t level = 1; level < mipLevels.size(); level++ )
+    {
+        const Dimension sourceDimension = mipLevels[level - 1].m_dimension;
+        const Dimension targetDimension = mipLevels[level].m_dimension;
+        const std::size_t targetRowFloats = static_cast<std::size_t>( targetDimension.m_width ) * CHANNELS;
+        currentLevel.assign( targetRowFloats * targetDimension.m_height, 0.0f );
+
+        const bool bEvenBox = settings.m_filter == Filter::eBox &&
+            sourceDimension.m_width % 2 == 0 && sourceDimension.m_height % 2 == 0;
+
+        if( bEvenBox )
+        {
+            parallelRows( targetDimension.m_height, targetDimension.m_width, [&]( std::uint32_t firstRow, std::uint32_t endRow ) {
+                std::vector<float> scratch0;
+                std::vector<float> scratch1;
+                for( std::uint32_t y = firstRow; y < endRow; y++ )
+                {
+                    const float* pRow0 = l_sourceRow( sourceDimension, y * 2, scratch0 );
+                    const float* pRow1 = l_sourceRow( sourceDimension, y * 2 + 1, scratch1 );
+                    boxEvenRow( pRow0, pRow1, currentLevel.data() + y * targetRowFloats, targetDimension.m_width, simdPath );
+                }
+            } );
+        }
+        else
+        {
+            // separable, horizontal over every source row then vertical over the filtered rows
+            const AxisTaps horizontalTaps = buildTaps( sourceDimension.m_width, targetDimension.m_width, settings );
+            const AxisTaps verticalTaps = buildTaps( sourceDimension.m_height, targetDimension.m_height, settings );
+            horizontalPass.resize( targetRowFloats * sourceDimension.m_height );
+
+            parallelRows( sourceDimension.m_height, targetDimension.m_width, [&]( std::uint32_t firstRow, std::uint32_t endRow ) {
+                std::vector<float> scratch;
+                for( std::uint32_t y = firstRow; y < endRow; y++ )
+                    filterRowHorizontal( l_sourceRow( sourceDimension, y, scratch ), horizontalPass.data() + y * targetRowFloats, horizontalTaps, simdPath );
+            } );
+
+            parallelRows( targetDimension.m_height, targetDimension.m_width, [&]( std::uint32_t firstRow, std::uint32_t endRow ) {
+                for( std::uint32_t y = firstRow; y < endRow; y++ )
+                {
+                    for( std::uint32_t tap = verticalTaps.m_begin[y]; tap < verticalTaps.m_begin[y + 1]; tap++ )
+                    {
+                        const Tap& verticalTap = verticalTaps.m_taps[tap];
+                        accumulateRow(
+                            currentLevel.data() + y * targetRowFloats,
+                            horizontalPass.data() + verticalTap.m_index * targetRowFloats,
+                            verticalTap.m_weight, targetRowFloats, simdPath
+                        );
+                    }
+                }
+            } );
+        }
+
+        // the scale only applies to the stored level, the next level is filtered from the unscaled alpha
+        const std::size_t targetTexels = static_cast<std::size_t>( targetDimension.m_width ) * targetDimension.m_height;
+        const float alphaScale = bPreserveCoverage ?
+            coverageAlphaScale( currentLevel.data(), targetTexels, settings.m_alphaCoverageCutoff, baseCoverage ) : 1.0f;
+
+        unsigned char* pTarget = payload.data() + mipLevels[level].m_offset;
+        parallelRows( targetDimension.m_height, targetDimension.m_width, [&]( std::uint32_t firstRow, std::uint32_t endRow ) {
+            for( std::uint32_t y = firstRow; y < endRow; y++ )
+            {
+                const float* pSourceRow = currentLevel.data() + y * targetRowFloats;
+                unsigned char* pTargetRow = pTarget + y * targetRowFloats;
+                if( settings.m_bSrgb )
+                    encodeSrgbRow( pSourceRow, pTargetRow, targetDimension.m_width, alphaScale, tables );
+                else
+                    encodeUnormRow( pSourceRow, pTargetRow, targetDimension.m_width, alphaScale, simdPath );
+            }
+        } );
+
+        previousLevel.swap( currentLevel );
+    }
+
+    dst.clearBuffer();
+    dst.m_payload = std::move( payload );
+    dst.m_buffer = dst.m_payload.data();
+    dst.m_imgDimension = baseDimension;
+    dst.m_colorChannels = CHANNELS;
+    dst.m_sourceChannels = src.sourceChannels();
+    dst.m_storedMipLevels = std::move( mipLevels );
+    dst.m_mipLevels = static_cast<std::uint32_t>( dst.m_storedMipLevels.size() );
+}
+
+MipmapGenerator::SimdPath MipmapGenerator::bestSimdPath()
+{
+#if defined(UTILS_MIPMAP_AVX2)
+    static const bool bAvx2 = cpuSupportsAvx2();
+    if( bAvx2 )
+        return SimdPath::eAvx2;
+#endif
+#if defined(UTILS_MIPMAP_SSE2) || defined(UTILS_MIPMAP_NEON)
+    return SimdPath::eVector;
+#else
+    return SimdPath::eScalar;
+#endif
+}
+
+const char* MipmapGenerator::simdPathName( const SimdPath& simdPath )
+{
+    switch( simdPath )
+    {
+    case SimdPath::eAvx2:
+        return "AVX2";
+    case SimdPath::eVector:
+#if defined(UTILS_MIPMAP_NEON)
+        return "NEON";
+#else
+        return "SSE2";
+#endif
+    default:
+        return "scalar";
+    }
+}
+
+const char* MipmapGenerator::simdPath()
+{
+    return simdPathName( bestSimdPath() );
+}
+
+void MipmapGenerator::parallelRows(
+    const std::uint32_t& rowCount, const std::size_t& texelsPerRow,
+    const std::function<void( std::uint32_t, std::uint32_t )>& rowJob
+) const
+{
+    if( !m_pThreadPool || m_pThreadPool->workerCount() < 2 || rowCount * texelsPerRow < PARALLEL_TEXEL_THRESHOLD )
+    {
+        rowJob( 0, rowCount );
+        return;
+    }
+
+    // a few bands per worker balance uneven progress, the calling thread takes bands too
+    const std::uint32_t bandCount = std::min( rowCount, m_pThreadPool->workerCount() * 4 );
+    const std::uint32_t rowsPerBand = ( rowCount + bandCount - 1 ) / bandCount;
+    std::atomic<std::uint32_t> nextBand{ 0 };
+
+    auto l_takeBands = [&]() {
+        for( std::uint32_t band = nextBand++; band * rowsPerBand < rowCount; band = nextBand++ )
+            rowJob( band * rowsPerBand, std::min( rowCount, ( band + 1 ) * rowsPerBand ) );
+    };
+
+    std::vector<std::future<void>> helpers;
+    for( std::uint32_t worker = 0; worker < m_pThreadPool->workerCount(); worker++ )
+        helpers.push_back( m_pThreadPool->submit( l_takeBands, JobPriority::eHigh ) );
+
+    l_takeBands();
+
+    for( std::future<void>& helper : helpers )
+        helper.get();
+}
+
+} // namespace utils
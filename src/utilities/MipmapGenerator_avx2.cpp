@@ -0,0 +1,49 @@
+// Built with AVX2 enabled on x86 targets, MipmapGenerator only calls into it once the CPU reported AVX2 support.
+// The kernels add in the same order as the SSE2 ones so both paths produce the same bits.
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace utils
+{
+
+namespace mipmap_avx2
+{
+
+// two destination texels per iteration from four source texels of each row
+std::uint32_t boxEvenRow( const float* pRow0, const float* pRow1, float* pTarget, const std::uint32_t& targetWidth )
+{
+    const __m256 quarter = _mm256_set1_ps( 0.25f );
+    std::uint32_t x = 0;
+    for( ; x + 2 <= targetWidth; x += 2 )
+    {
+        const __m256 row0Low = _mm256_loadu_ps( pRow0 + x * 8 );
+        const __m256 row0High = _mm256_loadu_ps( pRow0 + x * 8 + 8 );
+        const __m256 row1Low = _mm256_loadu_ps( pRow1 + x * 8 );
+        const __m256 row1High = _mm256_loadu_ps( pRow1 + x * 8 + 8 );
+
+        // even source texels of the two destination texels plus the odd ones, per row
+        const __m256 sum0 = _mm256_add_ps( _mm256_permute2f128_ps( row0Low, row0High, 0x20 ), _mm256_permute2f128_ps( row0Low, row0High, 0x31 ) );
+        const __m256 sum1 = _mm256_add_ps( _mm256_permute2f128_ps( row1Low, row1High, 0x20 ), _mm256_permute2f128_ps( row1Low, row1High, 0x31 ) );
+        _mm256_storeu_ps( pTarget + x * 4, _mm256_mul_ps( _mm256_add_ps( sum0, sum1 ), quarter ) );
+    }
+    return x;
+}
+
+std::size_t accumulateRow( float* pTarget, const float* pSource, const float& weight, const std::size_t& floatCount )
+{
+    const __m256 weight8 = _mm256_set1_ps( weight );
+    std::size_t i = 0;
+    for( ; i + 8 <= floatCount; i += 8 )
+        _mm256_storeu_ps( pTarget + i, _mm256_add_ps( _mm256_loadu_ps( pTarget + i ), _mm256_mul_ps( _mm256_loadu_ps( pSource + i ), weight8 ) ) );
+    return i;
+}
+
+} // namespace mipmap_avx2
+
+} // namespace utils
+
+#endif
@@ -0,0 +1,105 @@
+#include "utilities/TextureCache.h"
+#include "utilities/VulkanLogger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace utils
+{
+
+static_assert( sizeof( TextureCacheHeader ) == 32, "texture cache header layout" );
+static_assert( sizeof( TextureCacheLevel ) == 24, "texture cache level layout" );
+
+void TextureCache::write( const std::filesystem::path& path, const std::uint32_t& vkFormat, const std::vector<Level>& levels )
+{
+    auto l_fail = [&path]( const std::string& reason )
+    {
+        std::string errorMsg = fmt::format( "Failed to write {}: {}", path.string(), reason );
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    };
+
+    if( levels.empty() )
+        l_fail( "no levels" );
+
+    TextureCacheHeader header{};
+    std::memcpy( header.m_magic, MAGIC, sizeof( MAGIC ) );
+    header.m_version = VERSION;
+    header.m_vkFormat = vkFormat;
+    header.m_width = levels[0].m_dimension.m_width;
+    header.m_height = levels[0].m_dimension.m_height;
+    header.m_levelCount = static_cast<std::uint32_t>( levels.size() );
+
+    std::vector<TextureCacheLevel> levelTable( levels.size() );
+    std::uint64_t offset = sizeof( TextureCacheHeader ) + levels.size() * sizeof( TextureCacheLevel );
+    for( std::size_t i = 0; i < levels.size(); i++ )
+    {
+        offset = ( offset + LEVEL_ALIGNMENT - 1 ) & ~( LEVEL_ALIGNMENT - 1 );
+        levelTable[i].m_offset = offset;
+        levelTable[i].m_sizeInBytes = levels[i].m_sizeInBytes;
+        levelTable[i].m_width = levels[i].m_dimension.m_width;
+        levelTable[i].m_height = levels[i].m_dimension.m_height;
+        offset += levels[i].m_sizeInBytes;
+    }
+
+    std::ofstream file( path, std::ios::binary | std::ios::trunc );
+    if( !file.is_open() )
+        l_fail( "cannot open file" );
+
+    file.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+    file.write( reinterpret_cast<const char*>( levelTable.data() ), static_cast<std::streamsize>( levelTable.size() * sizeof( TextureCacheLevel ) ) );
+
+    const char padding[LEVEL_ALIGNMENT] = {};
+    for( std::size_t i = 0; i < levels.size(); i++ )
+    {
+        const std::uint64_t written = static_cast<std::uint64_t>( file.tellp() );
+        file.write( padding, static_cast<std::streamsize>( levelTable[i].m_offset - written ) );
+        file.write( reinterpret_cast<const char*>( levels[i].m_pData ), static_cast<std::streamsize>( levels[i].m_sizeInBytes ) );
+    }
+
+    if( !file.good() )
+        l_fail( "write error" );
+}
+
+std::vector<TextureCacheLevel> TextureCache::readLevels( const std::filesystem::path& path, const unsigned char* pData, const std::size_t& size, TextureCacheHeader& header )
+{
+    auto l_fail = [&path]( const std::string& reason )
+    {
+        std::string errorMsg = fmt::format( "Failed to load {} texture cache: {}", path.string(), reason );
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    };
+
+    if( size < sizeof( TextureCacheHeader ) )
+        l_fail( "truncated header" );
+
+    std::memcpy( &header, pData, sizeof( TextureCacheHeader ) );
+
+    if( std::memcmp( header.m_magic, MAGIC, sizeof( MAGIC ) ) != 0 )
+        l_fail( "not a texture cache" );
+
+    // rebake on version changes rather than reading older layouts
+    if( header.m_version != VERSION )
+        l_fail( fmt::format( "version {} does not match {}, rebake the texture", header.m_version, VERSION ) );
+
+    if( header.m_levelCount == 0 || header.m_levelCount > 32 || size < sizeof( TextureCacheHeader ) + header.m_levelCount * sizeof( TextureCacheLevel ) )
+        l_fail( "truncated level table" );
+
+    std::vector<TextureCacheLevel> levels( header.m_levelCount );
+    std::memcpy( levels.data(), pData + sizeof( TextureCacheHeader ), levels.size() * sizeof( TextureCacheLevel ) );
+
+    for( std::size_t i = 0; i < levels.size(); i++ )
+    {
+        // checked one at a time so a crafted offset and size cannot wrap around past the end
+        if( levels[i].m_offset % LEVEL_ALIGNMENT != 0 || levels[i].m_offset > size || levels[i].m_sizeInBytes > size - levels[i].m_offset )
+            l_fail( fmt::format( "level {} lies outside the file", i ) );
+
+        if( i > 0 && levels[i].m_offset < levels[i - 1].m_offset + levels[i - 1].m_sizeInBytes )
+            l_fail( fmt::format( "level {} overlaps the previous level", i ) );
+    }
+
+    return levels;
+}
+
+} // namespace utils
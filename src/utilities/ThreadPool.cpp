@@ -0,0 +1,82 @@
+#include "utilities/ThreadPool.h"
+
+#include <algorithm>
+
+namespace utils
+{
+
+ThreadPool::ThreadPool( const std::uint32_t& numOfThreads )
+    :m_bStop{ false }
+{
+    const std::uint32_t workerCount = std::max( numOfThreads, 1u );
+
+    m_workers.reserve( workerCount );
+    for( std::uint32_t i = 0u; i < workerCount; i++ )
+        m_workers.emplace_back( &ThreadPool::workerLoop, this );
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_jobMutex );
+        m_bStop = true;
+    }
+    m_jobCondition.notify_all();
+
+    // queued jobs are still drained, their futures would otherwise never become ready
+    for( std::thread& worker : m_workers )
+        worker.join();
+}
+
+std::uint32_t ThreadPool::defaultThreadCount()
+{
+    const std::uint32_t hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1u ? hardwareThreads - 1u : 1u;
+}
+
+void ThreadPool::enqueue( std::function<void()>&& job, const JobPriority& priority )
+{
+    {
+        std::lock_guard<std::mutex> lock( m_jobMutex );
+        m_jobs[ static_cast<std::size_t>( priority ) ].push_back( std::move( job ) );
+    }
+    m_jobCondition.notify_one();
+}
+
+bool ThreadPool::hasPendingJobs() const
+{
+    for( const auto& jobQueue : m_jobs )
+    {
+        if( !jobQueue.empty() )
+            return true;
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop()
+{
+    while( true )
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock( m_jobMutex );
+            m_jobCondition.wait( lock, [this](){ return m_bStop || hasPendingJobs(); } );
+
+            if( !hasPendingJobs() )
+                return;
+
+            for( auto& jobQueue : m_jobs )
+            {
+                if( jobQueue.empty() )
+                    continue;
+
+                job = std::move( jobQueue.front() );
+                jobQueue.pop_front();
+                break;
+            }
+        }
+        job();
+    }
+}
+
+} // namespace utils
@@ -0,0 +1,166 @@
+#include "vkrender/VulkanBindlessTable.h"
+#include "utilities/VulkanLogger.h"
+
+namespace vkrender
+{
+
+std::uint32_t VulkanBindlessTable::SlotArray::acquire()
+{
+    if( !m_freeSlots.empty() )
+    {
+        const std::uint32_t slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        return slot;
+    }
+
+    if( m_nextUnused < m_capacity )
+        return m_nextUnused++;
+
+    return INVALID_SLOT;
+}
+
+VulkanBindlessTable::VulkanBindlessTable(
+    vk::Device* pLogicalDevice, VulkanDescriptorLayoutCache* pLayoutCache,
+    const std::uint32_t& framesInFlight,
+    const std::uint32_t& maxSampledImages,
+    const std::uint32_t& maxSamplers
+)
+    :m_pLogicalDevice{ pLogicalDevice }
+    ,m_framesInFlight{ framesInFlight }
+    ,m_frameNumber{ 0 }
+{
+    m_sampledImages.m_capacity = maxSampledImages;
+    m_samplers.m_capacity = maxSamplers;
+
+    std::vector<vk::DescriptorSetLayoutBinding> layoutBindings( 2 );
+    layoutBindings[0].binding = SAMPLED_IMAGE_BINDING;
+    layoutBindings[0].descriptorType = vk::DescriptorType::eSampledImage;
+    layoutBindings[0].descriptorCount = maxSampledImages;
+    layoutBindings[0].stageFlags = vk::ShaderStageFlagBits::eAll;
+    layoutBindings[1].binding = SAMPLER_BINDING;
+    layoutBindings[1].descriptorType = vk::DescriptorType::eSampler;
+    layoutBindings[1].descriptorCount = maxSamplers;
+    layoutBindings[1].stageFlags = vk::ShaderStageFlagBits::eAll;
+
+    // slots are written while earlier frames still execute with the set bound, unwritten slots are never read
+    const vk::DescriptorBindingFlags bindingFlags =
+        vk::DescriptorBindingFlagBits::ePartiallyBound |
+        vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+        vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending;
+
+    m_vkDescriptorSetLayout = pLayoutCache->acquire(
+        layoutBindings,
+        vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool,
+        { bindingFlags, bindingFlags }
+    );
+
+    m_pDescriptorAllocator = std::make_unique<VulkanDescriptorAllocator>(
+        m_pLogicalDevice, 1u,
+        std::vector<VulkanDescriptorAllocator::PoolSizeRatio>{
+            { vk::DescriptorType::eSampledImage, static_cast<float>( maxSampledImages ) },
+            { vk::DescriptorType::eSampler, static_cast<float>( maxSamplers ) }
+        },
+        vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind
+    );
+    m_vkDescriptorSet = m_pDescriptorAllocator->allocate( m_vkDescriptorSetLayout );
+
+    LOG_INFO( fmt::format( "Bindless Table created with {} image slots and {} sampler slots", maxSampledImages, maxSamplers ) );
+}
+
+VulkanBindlessTable::~VulkanBindlessTable()
+{
+    LOG_DEBUG( fmt::format(
+        "Bindless Table Destroyed image slots used: {} sampler slots used: {}",
+        m_sampledImages.m_nextUnused, m_samplers.m_nextUnused
+    ) );
+}
+
+std::uint32_t VulkanBindlessTable::registerSampledImage( const vk::ImageView& vkImageView, const vk::ImageLayout& imageLayout )
+{
+    std::lock_guard<std::mutex> lock( m_tableMutex );
+
+    const std::uint32_t slot = m_sampledImages.acquire();
+    if( slot == INVALID_SLOT )
+    {
+        std::string errorMsg = fmt::format( "Bindless Table is out of image slots, capacity {}", m_sampledImages.m_capacity );
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    writeDescriptor( SAMPLED_IMAGE_BINDING, slot, vk::DescriptorType::eSampledImage, vk::DescriptorImageInfo{ nullptr, vkImageView, imageLayout } );
+    return slot;
+}
+
+std::uint32_t VulkanBindlessTable::registerSampler( const vk::Sampler& vkSampler )
+{
+    std::lock_guard<std::mutex> lock( m_tableMutex );
+
+    const std::uint32_t slot = m_samplers.acquire();
+    if( slot == INVALID_SLOT )
+    {
+        std::string errorMsg = fmt::format( "Bindless Table is out of sampler slots, capacity {}", m_samplers.m_capacity );
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    writeDescriptor( SAMPLER_BINDING, slot, vk::DescriptorType::eSampler, vk::DescriptorImageInfo{ vkSampler, nullptr, vk::ImageLayout::eUndefined } );
+    return slot;
+}
+
+void VulkanBindlessTable::releaseSampledImage( const std::uint32_t& slot )
+{
+    std::lock_guard<std::mutex> lock( m_tableMutex );
+    m_sampledImages.m_retiredSlots.emplace_back( slot, m_frameNumber );
+}
+
+void VulkanBindlessTable::releaseSampler( const std::uint32_t& slot )
+{
+    std::lock_guard<std::mutex> lock( m_tableMutex );
+    m_samplers.m_retiredSlots.emplace_back( slot, m_frameNumber );
+}
+
+void VulkanBindlessTable::beginFrame( const std::uint64_t& frameNumber )
+{
+    std::lock_guard<std::mutex> lock( m_tableMutex );
+
+    m_frameNumber = frameNumber;
+    recycle( m_sampledImages );
+    recycle( m_samplers );
+}
+
+void VulkanBindlessTable::bind( vk::CommandBuffer& vkCmdBuffer, const vk::PipelineLayout& vkPipelineLayout, const std::uint32_t& setIndex, const vk::PipelineBindPoint& bindPoint ) const
+{
+    vkCmdBuffer.bindDescriptorSets( bindPoint, vkPipelineLayout, setIndex, 1, &m_vkDescriptorSet, 0, nullptr );
+}
+
+std::uint32_t VulkanBindlessTable::sampledImageCount()
+{
+    std::lock_guard<std::mutex> lock( m_tableMutex );
+    return m_sampledImages.m_nextUnused - static_cast<std::uint32_t>( m_sampledImages.m_freeSlots.size() + m_sampledImages.m_retiredSlots.size() );
+}
+
+void VulkanBindlessTable::recycle( SlotArray& slotArray )
+{
+    // a slot released while recording frame n may be read until frame n + framesInFlight begins
+    while( !slotArray.m_retiredSlots.empty() && slotArray.m_retiredSlots.front().second + m_framesInFlight <= m_frameNumber )
+    {
+        slotArray.m_freeSlots.push_back( slotArray.m_retiredSlots.front().first );
+        slotArray.m_retiredSlots.pop_front();
+    }
+}
+
+void VulkanBindlessTable::writeDescriptor( const std::uint32_t& binding, const std::uint32_t& slot, const vk::DescriptorType& descriptorType, const vk::DescriptorImageInfo& imageInfo )
+{
+    vk::WriteDescriptorSet writeDescriptorSet{};
+    writeDescriptorSet.dstSet = m_vkDescriptorSet;
+    writeDescriptorSet.dstBinding = binding;
+    writeDescriptorSet.dstArrayElement = slot;
+    writeDescriptorSet.descriptorCount = 1;
+    writeDescriptorSet.descriptorType = descriptorType;
+    writeDescriptorSet.pImageInfo = &imageInfo;
+
+    m_pLogicalDevice->updateDescriptorSets( 1, &writeDescriptorSet, 0, nullptr );
+    m_pDescriptorAllocator->recordWrites( 1u );
+}
+
+} // namespace vkrender
@@ -1,10 +1,46 @@
 #include "vkrender/VulkanCommandBuffer.h"
+#include "utilities/VulkanLogger.h"
+
+#include <limits>
 
 namespace vkrender
 {
 
+bool VulkanSubmitToken::isReady() const
+{
+    return m_pCmdBuffer == nullptr || m_pCmdBuffer->isComplete( m_submitIndex );
+}
+
+void VulkanSubmitToken::wait() const
+{
+    if( m_pCmdBuffer )
+        m_pCmdBuffer->wait( m_submitIndex );
+}
+
+VulkanImmediateCmdBuffer::~VulkanImmediateCmdBuffer()
+{
+    if( m_vkCompletionFence )
+    {
+        wait( m_submitCount );
+        m_pLogicalDevice->destroyFence( m_vkCompletionFence );
+    }
+}
+
+void VulkanImmediateCmdBuffer::allocate()
+{
+    VulkanCmdBuffer::allocate();
+
+    m_vkCompletionFence = m_pLogicalDevice->createFence( vk::FenceCreateInfo{} );
+}
+
 vk::CommandBuffer* VulkanImmediateCmdBuffer::beginCmdBuffer()
 {
+    // held until the submission, another thread must not reset the buffer before it reached the queue
+    m_recordingLock = std::unique_lock<std::mutex>{ *m_pCommandPoolMutex };
+
+    wait( m_submitCount );
+    m_pLogicalDevice->resetFences( m_vkCompletionFence );
+
     m_vkCmdBuffer.reset( {} );
 
     vk::CommandBufferBeginInfo beginInfo{};
@@ -16,6 +52,11 @@ vk::CommandBuffer* VulkanImmediateCmdBuffer::beginCmdBuffer()
 }
 
 void VulkanImmediateCmdBuffer::endCmdBuffer()
+{
+    submitAsync().wait();
+}
+
+VulkanSubmitToken VulkanImmediateCmdBuffer::submitAsync()
 {
     m_vkCmdBuffer.end();
 
@@ -23,12 +64,64 @@ void VulkanImmediateCmdBuffer::endCmdBuffer()
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &m_vkCmdBuffer;
 
-    vk::Result opResult = m_pSubmitionQueue->submit( 1, &submitInfo, {} );
-    m_pLogicalDevice->waitIdle();
+    vk::Result opResult;
+    {
+        std::lock_guard<std::mutex> queueLock{ *m_pQueueMutex };
+        opResult = m_pSubmitionQueue->submit( 1, &submitInfo, m_vkCompletionFence );
+
+        // an empty submission signals the caller's fence once everything before it on the queue completed
+        if( opResult == vk::Result::eSuccess && m_vkSignalFence )
+            opResult = m_pSubmitionQueue->submit( 0, nullptr, m_vkSignalFence );
+    }
+    m_vkSignalFence = vk::Fence{};
+    if( opResult == vk::Result::eSuccess )
+        m_submitCount++;
+    const std::uint64_t submitIndex = m_submitCount;
+    m_recordingLock = std::unique_lock<std::mutex>{};
+
+    if( opResult != vk::Result::eSuccess )
+    {
+        std::string errorMsg = "Failed to submit immediate command buffer";
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    return VulkanSubmitToken{ this, submitIndex };
+}
+
+bool VulkanImmediateCmdBuffer::isComplete( const std::uint64_t& submitIndex )
+{
+    if( submitIndex <= m_completedCount )
+        return true;
+
+    if( m_pLogicalDevice->getFenceStatus( m_vkCompletionFence ) != vk::Result::eSuccess )
+        return false;
+
+    // only the latest submission can be in flight, the fence always refers to it
+    m_completedCount = m_submitCount;
+    return true;
+}
+
+void VulkanImmediateCmdBuffer::wait( const std::uint64_t& submitIndex )
+{
+    if( submitIndex <= m_completedCount )
+        return;
+
+    vk::Result waitResult = m_pLogicalDevice->waitForFences( 1, &m_vkCompletionFence, VK_TRUE, std::numeric_limits<std::uint64_t>::max() );
+    if( waitResult != vk::Result::eSuccess )
+    {
+        std::string errorMsg = "Failed to wait for immediate command buffer fence";
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    m_completedCount = m_submitCount;
 }
 
 vk::CommandBuffer* VulkanTemporaryCmdBuffer::beginCmdBuffer()
 {
+    m_recordingLock = std::unique_lock<std::mutex>{ *m_pCommandPoolMutex };
+
     vk::CommandBufferBeginInfo beginInfo{};
     beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
 
@@ -40,14 +133,29 @@ vk::CommandBuffer* VulkanTemporaryCmdBuffer::beginCmdBuffer()
 void VulkanTemporaryCmdBuffer::endCmdBuffer()
 {
     m_vkCmdBuffer.end();
+    m_recordingLock = std::unique_lock<std::mutex>{};
 
     vk::SubmitInfo submitInfo{};
 	submitInfo.commandBufferCount = 1;
 	submitInfo.pCommandBuffers = &m_vkCmdBuffer;
 
-	vk::Result opResult = m_pSubmitionQueue->submit( 1, &submitInfo, nullptr );
-	m_pSubmitionQueue->waitIdle();
-
+	vk::Result opResult;
+	{
+		std::lock_guard<std::mutex> queueLock{ *m_pQueueMutex };
+		opResult = m_pSubmitionQueue->submit( 1, &submitInfo, m_vkSignalFence );
+		if( opResult == vk::Result::eSuccess )
+			m_pSubmitionQueue->waitIdle();
+	}
+	m_vkSignalFence = vk::Fence{};
+
+	if( opResult != vk::Result::eSuccess )
+	{
+		std::string errorMsg = "Failed to submit temporary command buffer";
+		LOG_ERROR(errorMsg);
+		throw std::runtime_error(errorMsg);
+	}
+
+	std::lock_guard<std::mutex> poolLock{ *m_pCommandPoolMutex };
 	m_pLogicalDevice->freeCommandBuffers( *m_pCommandPool, 1, &m_vkCmdBuffer );
 }
 
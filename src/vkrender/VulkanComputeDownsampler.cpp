@@ -0,0 +1,480 @@
+#include "vkrender/VulkanComputeDownsampler.h"
+#include "vkrender/VulkanRenderer.h"
+#include "vkrender/VulkanTexture.h"
+#include "utilities/VulkanLogger.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace vkrender
+{
+
+namespace
+{
+
+// SinglePassDownsampler.comp compiled once per storage image format qualifier
+const std::uint32_t SPD_RGBA8_SPIRV[] = {
+#include "SinglePassDownsampler_rgba8.inc"
+};
+
+const std::uint32_t SPD_RGBA16F_SPIRV[] = {
+#include "SinglePassDownsampler_rgba16f.inc"
+};
+
+constexpr std::uint32_t TILE_SIZE = 64;
+// mip 6 of larger sources no longer fits the single group reducing it further
+constexpr std::uint32_t MAX_SINGLE_TILE_MIP6_SOURCE = 4096;
+constexpr std::uint32_t GROUP_LEVELS = 6;
+
+constexpr std::uint32_t SRC_LEVEL_BINDING = 0;
+constexpr std::uint32_t DST_MIPS_BINDING = 1;
+constexpr std::uint32_t COUNTERS_BINDING = 2;
+
+} // namespace
+
+VulkanComputeDownsampler::VulkanComputeDownsampler( VulkanRenderer* pVkRenderer )
+    :m_pVkRenderer{ pVkRenderer }
+    ,m_pLogicalDevice{ pVkRenderer->getDevice() }
+    ,m_nextCounter{ 0 }
+{
+    createPipelines();
+
+    // groups only ever bring a counter back to 0, it is zeroed once here
+    m_pVkRenderer->createBuffer(
+        COUNTER_SLOTS * sizeof( std::uint32_t ),
+        vk::BufferUsageFlagBits::eStorageBuffer, vk::SharingMode::eExclusive,
+        VulkanMemoryUsage::eDynamic,
+        m_vkCounterBuffer, m_counterAllocation,
+        "downsampler counters"
+    );
+
+    if( m_counterAllocation.m_pMapped == nullptr )
+    {
+        std::string errorMsg = "Downsampler counter memory is not host mapped";
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    std::memset( m_counterAllocation.m_pMapped, 0, COUNTER_SLOTS * sizeof( std::uint32_t ) );
+    LOG_INFO("Compute Downsampler created");
+}
+
+VulkanComputeDownsampler::~VulkanComputeDownsampler()
+{
+    if( VulkanDeletionQueue* pDeletionQueue = m_pVkRenderer->getDeletionQueue() )
+    {
+        for( const vk::Pipeline& vkPipeline : m_vkPipelines )
+            pDeletionQueue->destroyPipeline( vkPipeline );
+        pDeletionQueue->destroyPipelineLayout( m_vkPipelineLayout );
+        pDeletionQueue->destroyBuffer( m_vkCounterBuffer, m_counterAllocation );
+        return;
+    }
+
+    for( const vk::Pipeline& vkPipeline : m_vkPipelines )
+        m_pLogicalDevice->destroyPipeline( vkPipeline );
+    m_pLogicalDevice->destroyPipelineLayout( m_vkPipelineLayout );
+    m_pVkRenderer->destroyBuffer( m_vkCounterBuffer, m_counterAllocation );
+}
+
+bool VulkanComputeDownsampler::isFormatSupported( const vk::Format& format ) const
+{
+    vk::Format storageFormat;
+    StorageFormat shaderFormat;
+    if( !storageFormatOf( format, storageFormat, shaderFormat ) )
+        return false;
+
+    const VulkanDeviceCapabilities* pDeviceCapabilities = m_pVkRenderer->getDeviceCapabilities();
+    const bool bSampled = static_cast<bool>( pDeviceCapabilities->formatProperties( format ).optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImage );
+    const bool bStorage = static_cast<bool>( pDeviceCapabilities->formatProperties( storageFormat ).optimalTilingFeatures & vk::FormatFeatureFlagBits::eStorageImage );
+    return bSampled && bStorage;
+}
+
+vk::ImageCreateFlags VulkanComputeDownsampler::requiredCreateFlags( const vk::Format& format )
+{
+    vk::Format storageFormat;
+    StorageFormat shaderFormat;
+    if( !storageFormatOf( format, storageFormat, shaderFormat ) || storageFormat == format )
+        return {};
+
+    // sRGB formats are rarely storage capable, the image is stored through its UNORM alias instead
+    return vk::ImageCreateFlagBits::eMutableFormat | vk::ImageCreateFlagBits::eExtendedUsage;
+}
+
+void VulkanComputeDownsampler::record(
+    vk::CommandBuffer& vkCmdBuffer, const std::vector<VulkanTexture*>& textures,
+    const vk::PipelineStageFlags& dstStage, const vk::AccessFlags& dstAccess
+)
+{
+    auto l_imageBarrier = [](
+        VulkanTexture* pTexture, const std::uint32_t& baseMipLevel, const std::uint32_t& levelCount,
+        const vk::ImageLayout& oldLayout, const vk::ImageLayout& newLayout,
+        const vk::AccessFlags& srcAccessMask, const vk::AccessFlags& dstAccessMask
+    ) -> vk::ImageMemoryBarrier {
+        vk::ImageMemoryBarrier imgBarrier{};
+        imgBarrier.image = pTexture->m_vkImage;
+        imgBarrier.oldLayout = oldLayout;
+        imgBarrier.newLayout = newLayout;
+        imgBarrier.srcAccessMask = srcAccessMask;
+        imgBarrier.dstAccessMask = dstAccessMask;
+        imgBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imgBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imgBarrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+        imgBarrier.subresourceRange.baseMipLevel = baseMipLevel;
+        imgBarrier.subresourceRange.levelCount = levelCount;
+        imgBarrier.subresourceRange.baseArrayLayer = 0;
+        imgBarrier.subresourceRange.layerCount = 1;
+        return imgBarrier;
+    };
+
+    std::vector<std::vector<Pass>> texturePasses;
+    texturePasses.reserve( textures.size() );
+    std::size_t passCount = 0;
+    std::size_t maxPasses = 0;
+
+    // level 0 is only read, every level below it is written through a storage view
+    std::vector<vk::ImageMemoryBarrier> imgBarriers;
+    for( VulkanTexture* pTexture : textures )
+    {
+        if( !isFormatSupported( pTexture->m_vkImgFormat ) || !( pTexture->m_vkImgUsageFlags & vk::ImageUsageFlagBits::eStorage ) )
+        {
+            std::string errorMsg = fmt::format( "{} texture was not created for compute mip generation", vk::to_string( pTexture->m_vkImgFormat ) );
+            LOG_ERROR(errorMsg);
+            throw std::runtime_error(errorMsg);
+        }
+
+        std::vector<Pass>& passes = texturePasses.emplace_back( splitPasses( pTexture ) );
+        passCount += passes.size();
+        maxPasses = std::max( maxPasses, passes.size() );
+
+        // level 0 is final after this barrier, it is made visible to the consumers as well
+        imgBarriers.push_back( l_imageBarrier(
+            pTexture, 0, 1,
+            vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal,
+            vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eShaderRead | dstAccess
+        ) );
+
+        if( pTexture->m_miplevels > 1 )
+        {
+            imgBarriers.push_back( l_imageBarrier(
+                pTexture, 1, pTexture->m_miplevels - 1,
+                vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eGeneral,
+                vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite
+            ) );
+        }
+    }
+
+    vkCmdBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader | dstStage, {},
+        0, nullptr,
+        0, nullptr,
+        static_cast<std::uint32_t>( imgBarriers.size() ), imgBarriers.data()
+    );
+
+    if( passCount == 0 )
+        return;
+
+    // one set per dispatch from a pool that retires with the views once the batch executed
+    std::vector<vk::DescriptorPoolSize> poolSizes{
+        vk::DescriptorPoolSize{ vk::DescriptorType::eSampledImage, static_cast<std::uint32_t>( passCount ) },
+        vk::DescriptorPoolSize{ vk::DescriptorType::eStorageImage, static_cast<std::uint32_t>( passCount * MAX_DOWNSAMPLED_MIPS ) },
+        vk::DescriptorPoolSize{ vk::DescriptorType::eStorageBuffer, static_cast<std::uint32_t>( passCount ) }
+    };
+
+    vk::DescriptorPoolCreateInfo descPoolInfo{};
+    descPoolInfo.maxSets = static_cast<std::uint32_t>( passCount );
+    descPoolInfo.poolSizeCount = static_cast<std::uint32_t>( poolSizes.size() );
+    descPoolInfo.pPoolSizes = poolSizes.data();
+    vk::DescriptorPool vkDescriptorPool = m_pLogicalDevice->createDescriptorPool( descPoolInfo );
+
+    std::vector<vk::DescriptorSetLayout> setLayouts( passCount, m_vkDescriptorSetLayout );
+    vk::DescriptorSetAllocateInfo setAllocInfo{};
+    setAllocInfo.descriptorPool = vkDescriptorPool;
+    setAllocInfo.descriptorSetCount = static_cast<std::uint32_t>( setLayouts.size() );
+    setAllocInfo.pSetLayouts = setLayouts.data();
+    std::vector<vk::DescriptorSet> descriptorSets = m_pLogicalDevice->allocateDescriptorSets( setAllocInfo );
+
+    // image infos are written in place, the vectors must not reallocate before the update
+    std::vector<vk::ImageView> levelViews;
+    std::vector<vk::DescriptorImageInfo> srcImageInfos;
+    std::vector<vk::DescriptorImageInfo> dstImageInfos;
+    std::vector<vk::WriteDescriptorSet> descriptorWrites;
+    srcImageInfos.reserve( passCount );
+    dstImageInfos.reserve( passCount * MAX_DOWNSAMPLED_MIPS );
+    descriptorWrites.reserve( passCount * 3 );
+
+    const vk::DescriptorBufferInfo counterBufferInfo{ m_vkCounterBuffer, 0, VK_WHOLE_SIZE };
+
+    std::size_t setIndex = 0;
+    for( std::vector<Pass>& passes : texturePasses )
+    {
+        if( passes.empty() )
+            continue;
+
+        VulkanTexture* pTexture = passes.front().m_pTexture;
+
+        vk::Format storageFormat;
+        StorageFormat shaderFormat;
+        storageFormatOf( pTexture->m_vkImgFormat, storageFormat, shaderFormat );
+
+        // views of every written level, shared by the passes of the texture
+        const std::size_t firstStorageView = levelViews.size();
+        for( std::uint32_t level = 1; level < pTexture->m_miplevels; level++ )
+            levelViews.push_back( createLevelView( pTexture, level, storageFormat, vk::ImageUsageFlagBits::eStorage ) );
+
+        for( const Pass& pass : passes )
+        {
+            const vk::DescriptorSet& vkDescriptorSet = descriptorSets[setIndex++];
+
+            levelViews.push_back( createLevelView( pTexture, pass.m_baseLevel, pTexture->m_vkImgFormat, vk::ImageUsageFlagBits::eSampled ) );
+            srcImageInfos.push_back( vk::DescriptorImageInfo{ nullptr, levelViews.back(), vk::ImageLayout::eShaderReadOnlyOptimal } );
+
+            // slots past the pass are never written but must hold a valid view
+            const std::size_t firstDstInfo = dstImageInfos.size();
+            for( std::uint32_t mip = 0; mip < MAX_DOWNSAMPLED_MIPS; mip++ )
+            {
+                const std::uint32_t level = pass.m_baseLevel + 1 + std::min( mip, pass.m_mipCount - 1 );
+                dstImageInfos.push_back( vk::DescriptorImageInfo{ nullptr, levelViews[firstStorageView + level - 1], vk::ImageLayout::eGeneral } );
+            }
+
+            vk::WriteDescriptorSet descriptorWrite{};
+            descriptorWrite.dstSet = vkDescriptorSet;
+            descriptorWrite.dstArrayElement = 0;
+
+            descriptorWrite.dstBinding = SRC_LEVEL_BINDING;
+            descriptorWrite.descriptorType = vk::DescriptorType::eSampledImage;
+            descriptorWrite.descriptorCount = 1;
+            descriptorWrite.pImageInfo = &srcImageInfos.back();
+            descriptorWrites.push_back( descriptorWrite );
+
+            descriptorWrite.dstBinding = DST_MIPS_BINDING;
+            descriptorWrite.descriptorType = vk::DescriptorType::eStorageImage;
+            descriptorWrite.descriptorCount = MAX_DOWNSAMPLED_MIPS;
+            descriptorWrite.pImageInfo = &dstImageInfos[firstDstInfo];
+            descriptorWrites.push_back( descriptorWrite );
+
+            descriptorWrite.dstBinding = COUNTERS_BINDING;
+            descriptorWrite.descriptorType = vk::DescriptorType::eStorageBuffer;
+            descriptorWrite.descriptorCount = 1;
+            descriptorWrite.pImageInfo = nullptr;
+            descriptorWrite.pBufferInfo = &counterBufferInfo;
+            descriptorWrites.push_back( descriptorWrite );
+        }
+    }
+
+    m_pLogicalDevice->updateDescriptorSets( descriptorWrites, {} );
+
+    // passes of the same index run back to back, the next index first waits for the level it reads
+    vk::Pipeline vkBoundPipeline{};
+    std::size_t dispatchCount = 0;
+    for( std::size_t passIndex = 0; passIndex < maxPasses; passIndex++ )
+    {
+        if( passIndex > 0 )
+        {
+            imgBarriers.clear();
+            for( const std::vector<Pass>& passes : texturePasses )
+            {
+                if( passIndex < passes.size() )
+                {
+                    imgBarriers.push_back( l_imageBarrier(
+                        passes[passIndex].m_pTexture, passes[passIndex].m_baseLevel, 1,
+                        vk::ImageLayout::eGeneral, vk::ImageLayout::eShaderReadOnlyOptimal,
+                        vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eShaderRead
+                    ) );
+                }
+            }
+
+            vkCmdBuffer.pipelineBarrier(
+                vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader, {},
+                0, nullptr,
+                0, nullptr,
+                static_cast<std::uint32_t>( imgBarriers.size() ), imgBarriers.data()
+            );
+        }
+
+        setIndex = 0;
+        for( const std::vector<Pass>& passes : texturePasses )
+        {
+            if( passIndex >= passes.size() )
+            {
+                setIndex += passes.size();
+                continue;
+            }
+
+            const Pass& pass = passes[passIndex];
+            VulkanTexture* pTexture = pass.m_pTexture;
+
+            vk::Format storageFormat;
+            StorageFormat shaderFormat;
+            storageFormatOf( pTexture->m_vkImgFormat, storageFormat, shaderFormat );
+
+            const vk::Pipeline& vkPipeline = m_vkPipelines[static_cast<std::uint32_t>( shaderFormat )];
+            if( vkPipeline != vkBoundPipeline )
+            {
+                vkCmdBuffer.bindPipeline( vk::PipelineBindPoint::eCompute, vkPipeline );
+                vkBoundPipeline = vkPipeline;
+            }
+
+            vkCmdBuffer.bindDescriptorSets( vk::PipelineBindPoint::eCompute, m_vkPipelineLayout, 0, 1, &descriptorSets[setIndex + passIndex], 0, nullptr );
+            setIndex += passes.size();
+
+            // a counter is only reused once every slot was handed out, dispatches of this buffer reusing one are ordered
+            if( dispatchCount > 0 && dispatchCount % COUNTER_SLOTS == 0 )
+            {
+                vk::MemoryBarrier counterBarrier{ vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite };
+                vkCmdBuffer.pipelineBarrier(
+                    vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader, {},
+                    1, &counterBarrier,
+                    0, nullptr,
+                    0, nullptr
+                );
+            }
+
+            PushConstants pushConstants{};
+            pushConstants.m_srcWidth = static_cast<std::int32_t>( std::max( 1u, pTexture->m_texDimension.m_width >> pass.m_baseLevel ) );
+            pushConstants.m_srcHeight = static_cast<std::int32_t>( std::max( 1u, pTexture->m_texDimension.m_height >> pass.m_baseLevel ) );
+            pushConstants.m_mipCount = pass.m_mipCount;
+            pushConstants.m_counterIndex = m_nextCounter.fetch_add( 1, std::memory_order_relaxed ) % COUNTER_SLOTS;
+            pushConstants.m_bSrgb = storageFormat != pTexture->m_vkImgFormat ? 1u : 0u;
+
+            const std::uint32_t groupCountX = ( static_cast<std::uint32_t>( pushConstants.m_srcWidth ) + TILE_SIZE - 1 ) / TILE_SIZE;
+            const std::uint32_t groupCountY = ( static_cast<std::uint32_t>( pushConstants.m_srcHeight ) + TILE_SIZE - 1 ) / TILE_SIZE;
+            pushConstants.m_workGroupCount = groupCountX * groupCountY;
+
+            vkCmdBuffer.pushConstants( m_vkPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof( PushConstants ), &pushConstants );
+            vkCmdBuffer.dispatch( groupCountX, groupCountY, 1 );
+            dispatchCount++;
+        }
+    }
+
+    // every level written by a pass and not read by a later one
+    imgBarriers.clear();
+    for( const std::vector<Pass>& passes : texturePasses )
+    {
+        for( const Pass& pass : passes )
+        {
+            const bool bLastPass = &pass == &passes.back();
+            // the last level of a non final pass is the next pass' source
+            const std::uint32_t writtenLevels = bLastPass ? pass.m_mipCount : pass.m_mipCount - 1;
+            if( writtenLevels == 0 )
+                continue;
+
+            imgBarriers.push_back( l_imageBarrier(
+                pass.m_pTexture, pass.m_baseLevel + 1, writtenLevels,
+                vk::ImageLayout::eGeneral, vk::ImageLayout::eShaderReadOnlyOptimal,
+                vk::AccessFlagBits::eShaderWrite, dstAccess
+            ) );
+        }
+    }
+
+    // pass sources are in their final layout already, the memory barrier makes their writes visible to dstStage
+    vk::MemoryBarrier sourceBarrier{ vk::AccessFlagBits::eShaderWrite, dstAccess };
+    vkCmdBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eComputeShader, dstStage, {},
+        1, &sourceBarrier,
+        0, nullptr,
+        static_cast<std::uint32_t>( imgBarriers.size() ), imgBarriers.data()
+    );
+
+    VulkanDeletionQueue* pDeletionQueue = m_pVkRenderer->getDeletionQueue();
+    for( const vk::ImageView& vkImageView : levelViews )
+        pDeletionQueue->destroyImageView( vkImageView );
+    pDeletionQueue->destroyDescriptorPool( vkDescriptorPool );
+}
+
+bool VulkanComputeDownsampler::storageFormatOf( const vk::Format& format, vk::Format& storageFormat, StorageFormat& shaderFormat )
+{
+    switch( format )
+    {
+    case vk::Format::eR8G8B8A8Unorm:
+    case vk::Format::eR8G8B8A8Srgb:
+        storageFormat = vk::Format::eR8G8B8A8Unorm;
+        shaderFormat = StorageFormat::eRgba8;
+        return true;
+    case vk::Format::eR16G16B16A16Sfloat:
+        storageFormat = vk::Format::eR16G16B16A16Sfloat;
+        shaderFormat = StorageFormat::eRgba16f;
+        return true;
+    default:
+        return false;
+    }
+}
+
+std::vector<VulkanComputeDownsampler::Pass> VulkanComputeDownsampler::splitPasses( VulkanTexture* pTexture )
+{
+    std::vector<Pass> passes;
+
+    std::uint32_t baseLevel = 0;
+    while( baseLevel + 1 < pTexture->m_miplevels )
+    {
+        const std::uint32_t srcWidth = std::max( 1u, pTexture->m_texDimension.m_width >> baseLevel );
+        const std::uint32_t srcHeight = std::max( 1u, pTexture->m_texDimension.m_height >> baseLevel );
+        const std::uint32_t maxMips = std::max( srcWidth, srcHeight ) > MAX_SINGLE_TILE_MIP6_SOURCE ? GROUP_LEVELS : MAX_DOWNSAMPLED_MIPS;
+
+        const std::uint32_t mipCount = std::min( maxMips, pTexture->m_miplevels - 1 - baseLevel );
+        passes.push_back( Pass{ pTexture, baseLevel, mipCount } );
+        baseLevel += mipCount;
+    }
+
+    return passes;
+}
+
+void VulkanComputeDownsampler::createPipelines()
+{
+    std::vector<vk::DescriptorSetLayoutBinding> bindings{
+        vk::DescriptorSetLayoutBinding{ SRC_LEVEL_BINDING, vk::DescriptorType::eSampledImage, 1, vk::ShaderStageFlagBits::eCompute },
+        vk::DescriptorSetLayoutBinding{ DST_MIPS_BINDING, vk::DescriptorType::eStorageImage, MAX_DOWNSAMPLED_MIPS, vk::ShaderStageFlagBits::eCompute },
+        vk::DescriptorSetLayoutBinding{ COUNTERS_BINDING, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute }
+    };
+    m_vkDescriptorSetLayout = m_pVkRenderer->getDescriptorLayoutCache()->acquire( bindings );
+
+    vk::PushConstantRange pushConstantRange{ vk::ShaderStageFlagBits::eCompute, 0, sizeof( PushConstants ) };
+
+    vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &m_vkDescriptorSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+    m_vkPipelineLayout = m_pLogicalDevice->createPipelineLayout( pipelineLayoutInfo );
+
+    auto l_createPipeline = [this]( const std::uint32_t* pSpirv, const std::size_t& spirvSize ) -> vk::Pipeline {
+        vk::ShaderModuleCreateInfo shaderModuleInfo{};
+        shaderModuleInfo.codeSize = spirvSize;
+        shaderModuleInfo.pCode = pSpirv;
+        vk::ShaderModule vkShaderModule = m_pLogicalDevice->createShaderModule( shaderModuleInfo );
+
+        vk::ComputePipelineCreateInfo computePipelineInfo{};
+        computePipelineInfo.stage.stage = vk::ShaderStageFlagBits::eCompute;
+        computePipelineInfo.stage.module = vkShaderModule;
+        computePipelineInfo.stage.pName = "main";
+        computePipelineInfo.layout = m_vkPipelineLayout;
+
+        vk::Pipeline vkPipeline = m_pVkRenderer->getPipelineCache()->createComputePipeline( computePipelineInfo );
+        m_pLogicalDevice->destroyShaderModule( vkShaderModule );
+        return vkPipeline;
+    };
+
+    m_vkPipelines[static_cast<std::uint32_t>( StorageFormat::eRgba8 )] = l_createPipeline( SPD_RGBA8_SPIRV, sizeof( SPD_RGBA8_SPIRV ) );
+    m_vkPipelines[static_cast<std::uint32_t>( StorageFormat::eRgba16f )] = l_createPipeline( SPD_RGBA16F_SPIRV, sizeof( SPD_RGBA16F_SPIRV ) );
+}
+
+vk::ImageView VulkanComputeDownsampler::createLevelView( VulkanTexture* pTexture, const std::uint32_t& level, const vk::Format& viewFormat, const vk::ImageUsageFlags& viewUsage )
+{
+    // extended usage images only allow the usages the view format supports
+    vk::ImageViewUsageCreateInfo viewUsageInfo{};
+    viewUsageInfo.usage = viewUsage;
+
+    vk::ImageViewCreateInfo imgViewCreateInfo{};
+    imgViewCreateInfo.pNext = &viewUsageInfo;
+    imgViewCreateInfo.image = pTexture->m_vkImage;
+    imgViewCreateInfo.viewType = vk::ImageViewType::e2D;
+    imgViewCreateInfo.format = viewFormat;
+    imgViewCreateInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    imgViewCreateInfo.subresourceRange.baseMipLevel = level;
+    imgViewCreateInfo.subresourceRange.levelCount = 1;
+    imgViewCreateInfo.subresourceRange.baseArrayLayer = 0;
+    imgViewCreateInfo.subresourceRange.layerCount = 1;
+
+    return m_pLogicalDevice->createImageView( imgViewCreateInfo );
+}
+
+} // namespace vkrender
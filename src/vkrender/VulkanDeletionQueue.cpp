@@ -0,0 +1,256 @@
+#include "vkrender/VulkanDeletionQueue.h"
+#include "utilities/VulkanLogger.h"
+
+#include <algorithm>
+
+namespace vkrender
+{
+
+VulkanDeletionQueue::VulkanDeletionQueue( vk::Device* pLogicalDevice, VulkanMemoryAllocator* pMemoryAllocator, const std::uint32_t& framesInFlight )
+    :m_pLogicalDevice{ pLogicalDevice }
+    ,m_pMemoryAllocator{ pMemoryAllocator }
+    ,m_framesInFlight{ std::max( framesInFlight, 1u ) }
+    ,m_frameNumber{ 0 }
+    ,m_pendingCount{ 0 }
+{}
+
+VulkanDeletionQueue::~VulkanDeletionQueue()
+{
+    flush();
+
+    LOG_DEBUG( fmt::format(
+        "Deletion Queue Destroyed queued: {} destroyed: {} batches: {} max pending: {}",
+        m_statistics.m_queuedCount, m_statistics.m_destroyedCount, m_statistics.m_batchCount, m_statistics.m_maxPendingCount
+    ) );
+}
+
+void VulkanDeletionQueue::destroyBuffer( const vk::Buffer& vkBuffer, const VulkanAllocation& allocation, const VulkanUploadTicket& lastUse )
+{
+    std::lock_guard<std::mutex> lock( m_queueMutex );
+    batchFor( lastUse ).m_buffers.emplace_back( vkBuffer, allocation );
+    onQueued();
+}
+
+void VulkanDeletionQueue::destroyImage( const vk::Image& vkImage, const VulkanAllocation& allocation, const VulkanUploadTicket& lastUse )
+{
+    std::lock_guard<std::mutex> lock( m_queueMutex );
+    batchFor( lastUse ).m_images.emplace_back( vkImage, allocation );
+    onQueued();
+}
+
+void VulkanDeletionQueue::destroyImageView( const vk::ImageView& vkImageView, const VulkanUploadTicket& lastUse )
+{
+    std::lock_guard<std::mutex> lock( m_queueMutex );
+    batchFor( lastUse ).m_vkImageViews.push_back( vkImageView );
+    onQueued();
+}
+
+void VulkanDeletionQueue::freeMemory( const VulkanAllocation& allocation, const VulkanUploadTicket& lastUse )
+{
+    std::lock_guard<std::mutex> lock( m_queueMutex );
+    batchFor( lastUse ).m_allocations.push_back( allocation );
+    onQueued();
+}
+
+void VulkanDeletionQueue::destroyPipeline( const vk::Pipeline& vkPipeline, const VulkanUploadTicket& lastUse )
+{
+    std::lock_guard<std::mutex> lock( m_queueMutex );
+    batchFor( lastUse ).m_vkPipelines.push_back( vkPipeline );
+    onQueued();
+}
+
+void VulkanDeletionQueue::destroyPipelineLayout( const vk::PipelineLayout& vkPipelineLayout, const VulkanUploadTicket& lastUse )
+{
+    std::lock_guard<std::mutex> lock( m_queueMutex );
+    batchFor( lastUse ).m_vkPipelineLayouts.push_back( vkPipelineLayout );
+    onQueued();
+}
+
+void VulkanDeletionQueue::destroyDescriptorPool( const vk::DescriptorPool& vkDescriptorPool, const VulkanUploadTicket& lastUse )
+{
+    std::lock_guard<std::mutex> lock( m_queueMutex );
+    batchFor( lastUse ).m_vkDescriptorPools.push_back( vkDescriptorPool );
+    onQueued();
+}
+
+void VulkanDeletionQueue::freeDescriptorSets( VulkanDescriptorAllocator* pDescriptorAllocator, const std::vector<vk::DescriptorSet>& vkDescriptorSets, const VulkanUploadTicket& lastUse )
+{
+    if( vkDescriptorSets.empty() )
+        return;
+
+    std::lock_guard<std::mutex> lock( m_queueMutex );
+    batchFor( lastUse ).m_descriptorSets.emplace_back( pDescriptorAllocator, vkDescriptorSets );
+    onQueued();
+}
+
+void VulkanDeletionQueue::freeCommandBuffers(
+    const vk::CommandPool& vkCommandPool, std::mutex* pCommandPoolMutex,
+    const std::vector<vk::CommandBuffer>& vkCmdBuffers, const VulkanUploadTicket& lastUse
+)
+{
+    if( vkCmdBuffers.empty() )
+        return;
+
+    std::lock_guard<std::mutex> lock( m_queueMutex );
+    batchFor( lastUse ).m_cmdBuffers.push_back( CommandBuffers{ vkCommandPool, pCommandPoolMutex, vkCmdBuffers } );
+    onQueued();
+}
+
+void VulkanDeletionQueue::collect( const std::uint64_t& frameNumber )
+{
+    std::vector<Batch> retiredBatches;
+
+    {
+        std::lock_guard<std::mutex> lock( m_queueMutex );
+        m_frameNumber = frameNumber;
+
+        // a resource last used while recording frame n may be read until frame n + framesInFlight begins
+        while( !m_frameBatches.empty() && m_frameBatches.front().m_retireValue + m_framesInFlight <= frameNumber )
+        {
+            retiredBatches.push_back( std::move( m_frameBatches.front() ) );
+            m_frameBatches.pop_front();
+        }
+
+        // the counter is read once per semaphore, an unsubmitted ticket value is above it since the
+        // graphics queue is the timeline's only signaller
+        vk::Semaphore vkTimelineSemaphore;
+        std::uint64_t completedValue = 0;
+
+        for( auto itBatch = m_timelineBatches.begin(); itBatch != m_timelineBatches.end(); )
+        {
+            if( itBatch->m_lastUse.timelineSemaphore() != vkTimelineSemaphore )
+            {
+                vkTimelineSemaphore = itBatch->m_lastUse.timelineSemaphore();
+                completedValue = m_pLogicalDevice->getSemaphoreCounterValue( vkTimelineSemaphore );
+            }
+
+            if( completedValue >= itBatch->m_retireValue )
+            {
+                retiredBatches.push_back( std::move( *itBatch ) );
+                itBatch = m_timelineBatches.erase( itBatch );
+            }
+            else
+            {
+                ++itBatch;
+            }
+        }
+
+        for( const Batch& batch : retiredBatches )
+            m_pendingCount -= batch.m_resources.m_count;
+    }
+
+    // destruction happens outside the lock so other threads can keep queueing
+    for( Batch& batch : retiredBatches )
+        destroyResources( batch.m_resources );
+}
+
+void VulkanDeletionQueue::flush()
+{
+    std::deque<Batch> frameBatches;
+    std::deque<Batch> timelineBatches;
+
+    {
+        std::lock_guard<std::mutex> lock( m_queueMutex );
+        frameBatches.swap( m_frameBatches );
+        timelineBatches.swap( m_timelineBatches );
+        m_pendingCount = 0;
+    }
+
+    for( Batch& batch : frameBatches )
+        destroyResources( batch.m_resources );
+    for( Batch& batch : timelineBatches )
+        destroyResources( batch.m_resources );
+}
+
+std::size_t VulkanDeletionQueue::pendingCount()
+{
+    std::lock_guard<std::mutex> lock( m_queueMutex );
+    return m_pendingCount;
+}
+
+VulkanDeletionQueue::Statistics VulkanDeletionQueue::statistics()
+{
+    std::lock_guard<std::mutex> lock( m_queueMutex );
+    return m_statistics;
+}
+
+VulkanDeletionQueue::Resources& VulkanDeletionQueue::batchFor( const VulkanUploadTicket& lastUse )
+{
+    if( lastUse.isValid() )
+    {
+        // tickets of one scheduler share a semaphore, resources retiring at the same value share a batch
+        if( m_timelineBatches.empty() ||
+            m_timelineBatches.back().m_retireValue != lastUse.timelineValue() ||
+            m_timelineBatches.back().m_lastUse.timelineSemaphore() != lastUse.timelineSemaphore() )
+        {
+            Batch& batch = m_timelineBatches.emplace_back();
+            batch.m_retireValue = lastUse.timelineValue();
+            batch.m_lastUse = lastUse;
+        }
+
+        m_timelineBatches.back().m_resources.m_count++;
+        return m_timelineBatches.back().m_resources;
+    }
+
+    if( m_frameBatches.empty() || m_frameBatches.back().m_retireValue != m_frameNumber )
+        m_frameBatches.emplace_back().m_retireValue = m_frameNumber;
+
+    m_frameBatches.back().m_resources.m_count++;
+    return m_frameBatches.back().m_resources;
+}
+
+void VulkanDeletionQueue::onQueued()
+{
+    m_pendingCount++;
+    m_statistics.m_queuedCount++;
+    m_statistics.m_maxPendingCount = std::max<std::uint64_t>( m_statistics.m_maxPendingCount, m_pendingCount );
+}
+
+void VulkanDeletionQueue::destroyResources( Resources& resources )
+{
+    if( resources.m_count == 0 )
+        return;
+
+    // views before the images they reference, pipelines before their layouts
+    for( const vk::ImageView& vkImageView : resources.m_vkImageViews )
+        m_pLogicalDevice->destroyImageView( vkImageView );
+
+    for( auto& [vkImage, allocation] : resources.m_images )
+    {
+        m_pLogicalDevice->destroyImage( vkImage );
+        m_pMemoryAllocator->free( allocation );
+    }
+
+    for( auto& [vkBuffer, allocation] : resources.m_buffers )
+    {
+        m_pLogicalDevice->destroyBuffer( vkBuffer );
+        m_pMemoryAllocator->free( allocation );
+    }
+
+    for( VulkanAllocation& allocation : resources.m_allocations )
+        m_pMemoryAllocator->free( allocation );
+
+    for( const vk::Pipeline& vkPipeline : resources.m_vkPipelines )
+        m_pLogicalDevice->destroyPipeline( vkPipeline );
+
+    for( const vk::PipelineLayout& vkPipelineLayout : resources.m_vkPipelineLayouts )
+        m_pLogicalDevice->destroyPipelineLayout( vkPipelineLayout );
+
+    for( const auto& [pDescriptorAllocator, vkDescriptorSets] : resources.m_descriptorSets )
+        pDescriptorAllocator->free( vkDescriptorSets );
+
+    for( const vk::DescriptorPool& vkDescriptorPool : resources.m_vkDescriptorPools )
+        m_pLogicalDevice->destroyDescriptorPool( vkDescriptorPool );
+
+    for( const CommandBuffers& cmdBuffers : resources.m_cmdBuffers )
+    {
+        std::lock_guard<std::mutex> poolLock{ *cmdBuffers.m_pCommandPoolMutex };
+        m_pLogicalDevice->freeCommandBuffers( cmdBuffers.m_vkCommandPool, cmdBuffers.m_vkCmdBuffers );
+    }
+
+    std::lock_guard<std::mutex> lock( m_queueMutex );
+    m_statistics.m_destroyedCount += resources.m_count;
+    m_statistics.m_batchCount++;
+}
+
+} // namespace vkrender
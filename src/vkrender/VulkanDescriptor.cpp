@@ -1,24 +1,40 @@
 #include "vkrender/VulkanDescriptor.h"
+#include "vkrender/VulkanDeletionQueue.h"
+#include "utilities/VulkanLogger.h"
+
+#include <algorithm>
 
 namespace vkrender
 {
 
 VulkanDescriptor::VulkanDescriptor( 
-    vk::Device* pLogicalDevice, const std::uint32_t& numOfSetsPerPool
+    vk::Device* pLogicalDevice,
+    VulkanDescriptorLayoutCache* pLayoutCache, VulkanDescriptorAllocator* pDescriptorAllocator,
+    const std::uint32_t& numOfSets,
+    VulkanDeletionQueue* pDeletionQueue
 )
     :m_pLogicalDevice{ pLogicalDevice }
-    ,m_numOfSetsPerPool{ numOfSetsPerPool }
+    ,m_pLayoutCache{ pLayoutCache }
+    ,m_pDescriptorAllocator{ pDescriptorAllocator }
+    ,m_pDeletionQueue{ pDeletionQueue }
+    ,m_numOfSets{ numOfSets }
 {}
 
 VulkanDescriptor::~VulkanDescriptor()
 {
-    destroyDescriptorSet();
+    // sets of allocators that only reset are reclaimed with the next reset
+    if( m_vkDescriptorSets.empty() || !m_pDescriptorAllocator->freesSets() )
+        return;
+
+    if( m_pDeletionQueue )
+        m_pDeletionQueue->freeDescriptorSets( m_pDescriptorAllocator, m_vkDescriptorSets );
+    else
+        m_pDescriptorAllocator->free( m_vkDescriptorSets );
 }
 
 void VulkanDescriptor::allocateDescriptorSets( const DescriptorBindingArray& bindings )
 {
-    createDescriptorPool( bindings );
-    createDescriptorPool( bindings );
+    createDescriptorSetLayout( bindings );
     createDescriptorSets();
     m_vkWriteDescriptorSets.resize( bindings.size() );
 }
@@ -30,13 +46,61 @@ vk::WriteDescriptorSet* VulkanDescriptor::getWriteDescriptor( const std::uint32_
 
 void VulkanDescriptor::updateDescriptorSets()
 {
-    for( std::uint32_t i = 0; i < m_numOfSetsPerPool; i++ )
+    std::vector<vk::WriteDescriptorSet> vkWriteDescriptorSets;
+    appendPendingWrites( vkWriteDescriptorSets );
+
+    if( vkWriteDescriptorSets.empty() )
+        return;
+
+    m_pLogicalDevice->updateDescriptorSets(
+        static_cast<std::uint32_t>( vkWriteDescriptorSets.size() ), vkWriteDescriptorSets.data(),
+        0, nullptr
+    );
+    m_pDescriptorAllocator->recordWrites( static_cast<std::uint32_t>( vkWriteDescriptorSets.size() ) );
+}
+
+void VulkanDescriptor::updateDescriptorSetsBatched( vk::Device* pLogicalDevice, const std::vector<VulkanDescriptor*>& descriptors )
+{
+    std::vector<vk::WriteDescriptorSet> vkWriteDescriptorSets;
+    for( const VulkanDescriptor* pDescriptor : descriptors )
+    {
+        const std::size_t firstWrite = vkWriteDescriptorSets.size();
+        pDescriptor->appendPendingWrites( vkWriteDescriptorSets );
+        pDescriptor->m_pDescriptorAllocator->recordWrites( static_cast<std::uint32_t>( vkWriteDescriptorSets.size() - firstWrite ) );
+    }
+
+    if( vkWriteDescriptorSets.empty() )
+        return;
+
+    pLogicalDevice->updateDescriptorSets(
+        static_cast<std::uint32_t>( vkWriteDescriptorSets.size() ), vkWriteDescriptorSets.data(),
+        0, nullptr
+    );
+}
+
+void VulkanDescriptor::setUpdateTemplate( const std::vector<vk::DescriptorUpdateTemplateEntry>& templateEntries )
+{
+    m_vkUpdateTemplate = m_pLayoutCache->acquireUpdateTemplate( m_vkDescriptorSetLayout, templateEntries );
+}
+
+void VulkanDescriptor::updateDescriptorSet( const std::uint32_t& setIndex, const void* pTemplateData )
+{
+    if( !m_vkUpdateTemplate )
     {
-        m_pLogicalDevice->updateDescriptorSets(
-            m_vkWriteDescriptorSets.size(), m_vkWriteDescriptorSets.data(),
-            0, nullptr
-        );
+        std::string errorMsg = "updateDescriptorSet called without an update template";
+        LOG_ERROR(errorMsg);
+        throw std::logic_error(errorMsg);
     }
+
+    m_pLogicalDevice->updateDescriptorSetWithTemplate( m_vkDescriptorSets[setIndex], m_vkUpdateTemplate, pTemplateData );
+    m_pDescriptorAllocator->recordWrites( 1u );
+}
+
+void VulkanDescriptor::updateDescriptorSets( const void* pTemplateData, const std::size_t& dataStride )
+{
+    const std::uint8_t* pSetData = static_cast<const std::uint8_t*>( pTemplateData );
+    for( std::uint32_t i = 0; i < m_numOfSets; i++ )
+        updateDescriptorSet( i, pSetData + i * dataStride );
 }
 
 void VulkanDescriptor::createDescriptorSetLayout( const DescriptorBindingArray& bindings )
@@ -55,50 +119,41 @@ void VulkanDescriptor::createDescriptorSetLayout( const DescriptorBindingArray&
         descSetLayoutBinding.pImmutableSamplers = nullptr;
     }
 
-    vk::DescriptorSetLayoutCreateInfo descLayoutInfo{};
-    descLayoutInfo.bindingCount = numOfBindings;
-    descLayoutInfo.pBindings = vkDescSetLayoutBindings.data();
-
-    m_vkDescriptorSetLayout = m_pLogicalDevice->createDescriptorSetLayout( descLayoutInfo );
-}
-
-void VulkanDescriptor::createDescriptorPool( const DescriptorBindingArray& bindings )
-{
-    const std::uint32_t numOfBindings = static_cast<std::uint32_t>( bindings.size() );
-
-    std::vector<vk::DescriptorPoolSize> vkDescPoolSizes{ numOfBindings };
-    
-    for( std::uint32_t i = 0u; i < numOfBindings; i++ )
-    {
-        vk::DescriptorPoolSize& descPoolSize = vkDescPoolSizes[i];
-        descPoolSize.type = bindings[i].m_bindingType;
-        descPoolSize.descriptorCount = m_numOfSetsPerPool;        
-    }
-
-    vk::DescriptorPoolCreateInfo descPoolInfo{};
-    descPoolInfo.poolSizeCount = numOfBindings;
-    descPoolInfo.pPoolSizes = vkDescPoolSizes.data();
-    descPoolInfo.maxSets = m_numOfSetsPerPool;
+    m_vkBindingTypes.resize( numOfBindings );
+    for( std::uint32_t i = 0; i < numOfBindings; i++ )
+        m_vkBindingTypes[i] = bindings[i].m_bindingType;
 
-    m_vkDescriptorPool = m_pLogicalDevice->createDescriptorPool( descPoolInfo );
+    m_vkDescriptorSetLayout = m_pLayoutCache->acquire( vkDescSetLayoutBindings );
 }
 
 void VulkanDescriptor::createDescriptorSets()
 {
-    std::vector<vk::DescriptorSetLayout> descLayouts{ m_numOfSetsPerPool, m_vkDescriptorSetLayout };
+    std::vector<vk::DescriptorSetLayout> descLayouts{ m_numOfSets, m_vkDescriptorSetLayout };
 
-    vk::DescriptorSetAllocateInfo descSetAllocInfo{};
-    descSetAllocInfo.descriptorPool = m_vkDescriptorPool;
-    descSetAllocInfo.descriptorSetCount = m_numOfSetsPerPool;
-    descSetAllocInfo.pSetLayouts = descLayouts.data();
-
-    m_vkDescriptorSets = m_pLogicalDevice->allocateDescriptorSets( descSetAllocInfo );
+    m_vkDescriptorSets = m_pDescriptorAllocator->allocate( descLayouts );
 }
 
-void VulkanDescriptor::destroyDescriptorSet()
+void VulkanDescriptor::appendPendingWrites( std::vector<vk::WriteDescriptorSet>& vkWriteDescriptorSets ) const
 {
-    m_pLogicalDevice->destroyDescriptorPool( m_vkDescriptorPool );
-    m_pLogicalDevice->destroyDescriptorSetLayout( m_vkDescriptorSetLayout );
+    vkWriteDescriptorSets.reserve( vkWriteDescriptorSets.size() + m_vkDescriptorSets.size() * m_vkWriteDescriptorSets.size() );
+
+    for( const vk::DescriptorSet& vkDescriptorSet : m_vkDescriptorSets )
+    {
+        for( std::uint32_t bindingIndex = 0; bindingIndex < m_vkWriteDescriptorSets.size(); bindingIndex++ )
+        {
+            const vk::WriteDescriptorSet& bindingWrite = m_vkWriteDescriptorSets[bindingIndex];
+
+            // bindings the caller never filled in are left untouched
+            if( !bindingWrite.pBufferInfo && !bindingWrite.pImageInfo && !bindingWrite.pTexelBufferView )
+                continue;
+
+            vk::WriteDescriptorSet& setWrite = vkWriteDescriptorSets.emplace_back( bindingWrite );
+            setWrite.dstSet = vkDescriptorSet;
+            setWrite.dstBinding = bindingIndex;
+            setWrite.descriptorType = m_vkBindingTypes[bindingIndex];
+            setWrite.descriptorCount = std::max( bindingWrite.descriptorCount, 1u );
+        }
+    }
 }
 
-} // namespace vkrender 
\ No newline at end of file
+} // namespace vkrender
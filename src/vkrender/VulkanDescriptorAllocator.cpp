@@ -0,0 +1,212 @@
+#include "vkrender/VulkanDescriptorAllocator.h"
+#include "utilities/VulkanLogger.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vkrender
+{
+
+const std::vector<VulkanDescriptorAllocator::PoolSizeRatio> VulkanDescriptorAllocator::DEFAULT_POOL_SIZE_RATIOS{
+    { vk::DescriptorType::eSampler, 0.5f },
+    { vk::DescriptorType::eCombinedImageSampler, 4.0f },
+    { vk::DescriptorType::eSampledImage, 4.0f },
+    { vk::DescriptorType::eStorageImage, 1.0f },
+    { vk::DescriptorType::eUniformTexelBuffer, 0.5f },
+    { vk::DescriptorType::eStorageTexelBuffer, 0.5f },
+    { vk::DescriptorType::eUniformBuffer, 2.0f },
+    { vk::DescriptorType::eStorageBuffer, 2.0f },
+    { vk::DescriptorType::eUniformBufferDynamic, 1.0f },
+    { vk::DescriptorType::eStorageBufferDynamic, 1.0f },
+    { vk::DescriptorType::eInputAttachment, 0.5f }
+};
+
+VulkanDescriptorAllocator::VulkanDescriptorAllocator(
+    vk::Device* pLogicalDevice,
+    const std::uint32_t& setsPerPool,
+    const std::vector<PoolSizeRatio>& poolSizeRatios,
+    const vk::DescriptorPoolCreateFlags& poolCreateFlags
+)
+    :m_pLogicalDevice{ pLogicalDevice }
+    ,m_setsPerPool{ std::max( setsPerPool, 1u ) }
+    ,m_poolSizeRatios{ poolSizeRatios }
+    ,m_vkPoolCreateFlags{ poolCreateFlags }
+    ,m_writeCount{ 0 }
+{}
+
+VulkanDescriptorAllocator::~VulkanDescriptorAllocator()
+{
+    if( m_vkCurrentPool )
+        m_pLogicalDevice->destroyDescriptorPool( m_vkCurrentPool );
+    for( vk::DescriptorPool& vkDescriptorPool : m_vkUsedPools )
+        m_pLogicalDevice->destroyDescriptorPool( vkDescriptorPool );
+    for( vk::DescriptorPool& vkDescriptorPool : m_vkFreePools )
+        m_pLogicalDevice->destroyDescriptorPool( vkDescriptorPool );
+
+    LOG_DEBUG( fmt::format(
+        "Descriptor Allocator Destroyed pools: {} allocations: {} frees: {} exhausted pools: {} writes: {}",
+        m_statistics.m_poolCount, m_statistics.m_allocationCount, m_statistics.m_freeCount, m_statistics.m_poolExhaustedCount, writeCount()
+    ) );
+}
+
+vk::DescriptorSet VulkanDescriptorAllocator::allocate( const vk::DescriptorSetLayout& vkDescriptorSetLayout, const void* pNext )
+{
+    return allocate( std::vector<vk::DescriptorSetLayout>{ vkDescriptorSetLayout }, pNext ).front();
+}
+
+std::vector<vk::DescriptorSet> VulkanDescriptorAllocator::allocate( const std::vector<vk::DescriptorSetLayout>& vkDescriptorSetLayouts, const void* pNext )
+{
+    std::vector<vk::DescriptorSet> vkDescriptorSets( vkDescriptorSetLayouts.size() );
+    if( vkDescriptorSetLayouts.empty() )
+        return vkDescriptorSets;
+
+    std::lock_guard<std::mutex> lock( m_allocatorMutex );
+
+    if( !m_vkCurrentPool )
+        m_vkCurrentPool = grabPool();
+
+    vk::DescriptorSetAllocateInfo descSetAllocInfo{};
+    descSetAllocInfo.pNext = pNext;
+    descSetAllocInfo.descriptorPool = m_vkCurrentPool;
+    descSetAllocInfo.descriptorSetCount = static_cast<std::uint32_t>( vkDescriptorSetLayouts.size() );
+    descSetAllocInfo.pSetLayouts = vkDescriptorSetLayouts.data();
+
+    vk::Result allocResult = m_pLogicalDevice->allocateDescriptorSets( &descSetAllocInfo, vkDescriptorSets.data() );
+
+    // an exhausted or fragmented pool is retired until the next reset, the allocation is retried once on a fresh pool
+    if( allocResult == vk::Result::eErrorOutOfPoolMemory || allocResult == vk::Result::eErrorFragmentedPool )
+    {
+        m_statistics.m_poolExhaustedCount++;
+
+        m_vkUsedPools.push_back( m_vkCurrentPool );
+        m_vkCurrentPool = grabPool();
+
+        descSetAllocInfo.descriptorPool = m_vkCurrentPool;
+        allocResult = m_pLogicalDevice->allocateDescriptorSets( &descSetAllocInfo, vkDescriptorSets.data() );
+    }
+
+    if( allocResult != vk::Result::eSuccess )
+    {
+        std::string errorMsg = fmt::format(
+            "Failed to allocate {} descriptor sets: {}",
+            vkDescriptorSetLayouts.size(), vk::to_string( allocResult )
+        );
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    if( freesSets() )
+    {
+        for( const vk::DescriptorSet& vkDescriptorSet : vkDescriptorSets )
+            m_setPools.emplace( static_cast<VkDescriptorSet>( vkDescriptorSet ), descSetAllocInfo.descriptorPool );
+    }
+
+    m_statistics.m_allocationCount += vkDescriptorSets.size();
+    return vkDescriptorSets;
+}
+
+void VulkanDescriptorAllocator::free( const std::vector<vk::DescriptorSet>& vkDescriptorSets )
+{
+    if( !freesSets() )
+    {
+        std::string errorMsg = "Descriptor sets can only be freed from pools created with eFreeDescriptorSet";
+        LOG_ERROR(errorMsg);
+        throw std::logic_error(errorMsg);
+    }
+
+    std::lock_guard<std::mutex> lock( m_allocatorMutex );
+
+    for( const vk::DescriptorSet& vkDescriptorSet : vkDescriptorSets )
+    {
+        auto poolItr = m_setPools.find( static_cast<VkDescriptorSet>( vkDescriptorSet ) );
+        if( poolItr == m_setPools.end() )
+            continue;
+
+        const vk::DescriptorPool vkDescriptorPool = poolItr->second;
+        m_setPools.erase( poolItr );
+
+        m_pLogicalDevice->freeDescriptorSets( vkDescriptorPool, vkDescriptorSet );
+        m_statistics.m_freeCount++;
+
+        // a retired pool has room again, it is handed out before a new pool is created
+        auto usedItr = std::find( m_vkUsedPools.begin(), m_vkUsedPools.end(), vkDescriptorPool );
+        if( usedItr != m_vkUsedPools.end() )
+        {
+            m_vkFreePools.push_back( vkDescriptorPool );
+            m_vkUsedPools.erase( usedItr );
+        }
+    }
+}
+
+void VulkanDescriptorAllocator::reset()
+{
+    std::lock_guard<std::mutex> lock( m_allocatorMutex );
+
+    if( m_vkCurrentPool )
+    {
+        m_vkUsedPools.push_back( m_vkCurrentPool );
+        m_vkCurrentPool = nullptr;
+    }
+
+    for( vk::DescriptorPool& vkDescriptorPool : m_vkUsedPools )
+    {
+        m_pLogicalDevice->resetDescriptorPool( vkDescriptorPool );
+        m_vkFreePools.push_back( vkDescriptorPool );
+    }
+    m_vkUsedPools.clear();
+
+    // pools that got room back through free() may still hold live sets
+    if( freesSets() )
+    {
+        for( vk::DescriptorPool& vkDescriptorPool : m_vkFreePools )
+            m_pLogicalDevice->resetDescriptorPool( vkDescriptorPool );
+        m_setPools.clear();
+    }
+}
+
+VulkanDescriptorAllocator::Statistics VulkanDescriptorAllocator::statistics()
+{
+    std::lock_guard<std::mutex> lock( m_allocatorMutex );
+
+    Statistics statistics = m_statistics;
+    statistics.m_writeCount = writeCount();
+    return statistics;
+}
+
+vk::DescriptorPool VulkanDescriptorAllocator::grabPool()
+{
+    if( m_vkFreePools.empty() )
+        return createPool();
+
+    vk::DescriptorPool vkDescriptorPool = m_vkFreePools.back();
+    m_vkFreePools.pop_back();
+    return vkDescriptorPool;
+}
+
+vk::DescriptorPool VulkanDescriptorAllocator::createPool()
+{
+    std::vector<vk::DescriptorPoolSize> vkDescPoolSizes;
+    vkDescPoolSizes.reserve( m_poolSizeRatios.size() );
+
+    for( const PoolSizeRatio& poolSizeRatio : m_poolSizeRatios )
+    {
+        const std::uint32_t descriptorCount = static_cast<std::uint32_t>( std::ceil( poolSizeRatio.m_ratio * static_cast<float>( m_setsPerPool ) ) );
+        if( descriptorCount > 0u )
+            vkDescPoolSizes.push_back( vk::DescriptorPoolSize{ poolSizeRatio.m_descriptorType, descriptorCount } );
+    }
+
+    vk::DescriptorPoolCreateInfo descPoolInfo{};
+    descPoolInfo.flags = m_vkPoolCreateFlags;
+    descPoolInfo.maxSets = m_setsPerPool;
+    descPoolInfo.poolSizeCount = static_cast<std::uint32_t>( vkDescPoolSizes.size() );
+    descPoolInfo.pPoolSizes = vkDescPoolSizes.data();
+
+    vk::DescriptorPool vkDescriptorPool = m_pLogicalDevice->createDescriptorPool( descPoolInfo );
+    m_statistics.m_poolCount++;
+
+    LOG_DEBUG( fmt::format( "Descriptor Pool created, {} pools in use", m_statistics.m_poolCount ) );
+
+    return vkDescriptorPool;
+}
+
+} // namespace vkrender
@@ -0,0 +1,225 @@
+#include "vkrender/VulkanDescriptorLayoutCache.h"
+#include "utilities/VulkanLogger.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace vkrender
+{
+
+namespace
+{
+    void hashCombine( std::size_t& hashResult, const std::size_t& valueHash )
+    {
+        hashResult ^= valueHash + 0x9e3779b97f4a7c15ull + ( hashResult << 6 ) + ( hashResult >> 2 );
+    }
+}
+
+bool DescriptorLayoutKey::Binding::operator==( const Binding& other ) const
+{
+    return m_binding == other.m_binding &&
+        m_descriptorType == other.m_descriptorType &&
+        m_descriptorCount == other.m_descriptorCount &&
+        m_stageFlags == other.m_stageFlags &&
+        m_bindingFlags == other.m_bindingFlags &&
+        m_immutableSamplers == other.m_immutableSamplers;
+}
+
+bool DescriptorLayoutKey::operator==( const DescriptorLayoutKey& other ) const
+{
+    return m_createFlags == other.m_createFlags && m_bindings == other.m_bindings;
+}
+
+std::size_t DescriptorLayoutKey::hash() const
+{
+    std::size_t hashResult = std::hash<std::uint32_t>{}( static_cast<std::uint32_t>( m_createFlags ) );
+    for( const Binding& binding : m_bindings )
+    {
+        hashCombine( hashResult, binding.m_binding );
+        hashCombine( hashResult, static_cast<std::size_t>( binding.m_descriptorType ) );
+        hashCombine( hashResult, binding.m_descriptorCount );
+        hashCombine( hashResult, static_cast<std::uint32_t>( binding.m_stageFlags ) );
+        hashCombine( hashResult, static_cast<std::uint32_t>( binding.m_bindingFlags ) );
+        for( const vk::Sampler& immutableSampler : binding.m_immutableSamplers )
+            hashCombine( hashResult, std::hash<VkSampler>{}( static_cast<VkSampler>( immutableSampler ) ) );
+    }
+    return hashResult;
+}
+
+bool DescriptorUpdateTemplateKey::operator==( const DescriptorUpdateTemplateKey& other ) const
+{
+    return m_vkDescriptorSetLayout == other.m_vkDescriptorSetLayout && m_templateEntries == other.m_templateEntries;
+}
+
+std::size_t DescriptorUpdateTemplateKey::hash() const
+{
+    std::size_t hashResult = std::hash<VkDescriptorSetLayout>{}( static_cast<VkDescriptorSetLayout>( m_vkDescriptorSetLayout ) );
+    for( const vk::DescriptorUpdateTemplateEntry& templateEntry : m_templateEntries )
+    {
+        hashCombine( hashResult, templateEntry.dstBinding );
+        hashCombine( hashResult, templateEntry.dstArrayElement );
+        hashCombine( hashResult, templateEntry.descriptorCount );
+        hashCombine( hashResult, static_cast<std::size_t>( templateEntry.descriptorType ) );
+        hashCombine( hashResult, templateEntry.offset );
+        hashCombine( hashResult, templateEntry.stride );
+    }
+    return hashResult;
+}
+
+VulkanDescriptorLayoutCache::VulkanDescriptorLayoutCache( vk::Device* pLogicalDevice )
+    :m_pLogicalDevice{ pLogicalDevice }
+{}
+
+VulkanDescriptorLayoutCache::~VulkanDescriptorLayoutCache()
+{
+    for( auto& [templateKey, vkUpdateTemplate] : m_updateTemplates )
+        m_pLogicalDevice->destroyDescriptorUpdateTemplate( vkUpdateTemplate );
+
+    for( auto& [layoutKey, vkDescriptorSetLayout] : m_layouts )
+        m_pLogicalDevice->destroyDescriptorSetLayout( vkDescriptorSetLayout );
+
+    LOG_DEBUG( fmt::format( "Descriptor Layout Cache Destroyed layouts: {} update templates: {}", m_layouts.size(), m_updateTemplates.size() ) );
+}
+
+vk::DescriptorSetLayout VulkanDescriptorLayoutCache::acquire(
+    const std::vector<vk::DescriptorSetLayoutBinding>& bindings,
+    const vk::DescriptorSetLayoutCreateFlags& createFlags,
+    const std::vector<vk::DescriptorBindingFlags>& bindingFlags
+)
+{
+    if( !bindingFlags.empty() && bindingFlags.size() != bindings.size() )
+    {
+        std::string errorMsg = fmt::format( "{} binding flags given for {} bindings", bindingFlags.size(), bindings.size() );
+        LOG_ERROR(errorMsg);
+        throw std::invalid_argument(errorMsg);
+    }
+
+    DescriptorLayoutKey layoutKey{};
+    layoutKey.m_createFlags = createFlags;
+    layoutKey.m_bindings.reserve( bindings.size() );
+
+    for( std::size_t i = 0; i < bindings.size(); i++ )
+    {
+        const vk::DescriptorSetLayoutBinding& layoutBinding = bindings[i];
+
+        DescriptorLayoutKey::Binding keyBinding{};
+        keyBinding.m_binding = layoutBinding.binding;
+        keyBinding.m_descriptorType = layoutBinding.descriptorType;
+        keyBinding.m_descriptorCount = layoutBinding.descriptorCount;
+        keyBinding.m_stageFlags = layoutBinding.stageFlags;
+        keyBinding.m_bindingFlags = bindingFlags.empty() ? vk::DescriptorBindingFlags{} : bindingFlags[i];
+        if( layoutBinding.pImmutableSamplers )
+            keyBinding.m_immutableSamplers.assign( layoutBinding.pImmutableSamplers, layoutBinding.pImmutableSamplers + layoutBinding.descriptorCount );
+
+        layoutKey.m_bindings.push_back( std::move( keyBinding ) );
+    }
+
+    // the same signature declared in a different order must map to the same layout
+    std::sort( layoutKey.m_bindings.begin(), layoutKey.m_bindings.end(), []( const auto& lhs, const auto& rhs ){
+        return lhs.m_binding < rhs.m_binding;
+    } );
+
+    std::lock_guard<std::mutex> lock( m_cacheMutex );
+
+    auto layoutItr = m_layouts.find( layoutKey );
+    if( layoutItr != m_layouts.end() )
+        return layoutItr->second;
+
+    vk::DescriptorSetLayout vkDescriptorSetLayout = createLayout( layoutKey );
+    layoutItr = m_layouts.emplace( std::move( layoutKey ), vkDescriptorSetLayout ).first;
+    m_layoutKeys.emplace( static_cast<VkDescriptorSetLayout>( vkDescriptorSetLayout ), &layoutItr->first );
+
+    return vkDescriptorSetLayout;
+}
+
+std::vector<vk::DescriptorSetLayout> VulkanDescriptorLayoutCache::acquire( const VulkanPipelineLayoutReflection& layoutReflection )
+{
+    std::vector<vk::DescriptorSetLayout> vkDescriptorSetLayouts;
+    vkDescriptorSetLayouts.reserve( layoutReflection.m_setLayoutBindings.size() );
+
+    for( const std::vector<vk::DescriptorSetLayoutBinding>& setBindings : layoutReflection.m_setLayoutBindings )
+        vkDescriptorSetLayouts.push_back( acquire( setBindings ) );
+
+    return vkDescriptorSetLayouts;
+}
+
+vk::DescriptorUpdateTemplate VulkanDescriptorLayoutCache::acquireUpdateTemplate(
+    const vk::DescriptorSetLayout& vkDescriptorSetLayout,
+    const std::vector<vk::DescriptorUpdateTemplateEntry>& templateEntries
+)
+{
+    DescriptorUpdateTemplateKey templateKey{ vkDescriptorSetLayout, templateEntries };
+
+    std::lock_guard<std::mutex> lock( m_cacheMutex );
+
+    auto templateItr = m_updateTemplates.find( templateKey );
+    if( templateItr != m_updateTemplates.end() )
+        return templateItr->second;
+
+    vk::DescriptorUpdateTemplateCreateInfo templateCreateInfo{};
+    templateCreateInfo.descriptorUpdateEntryCount = static_cast<std::uint32_t>( templateEntries.size() );
+    templateCreateInfo.pDescriptorUpdateEntries = templateEntries.data();
+    templateCreateInfo.templateType = vk::DescriptorUpdateTemplateType::eDescriptorSet;
+    templateCreateInfo.descriptorSetLayout = vkDescriptorSetLayout;
+
+    vk::DescriptorUpdateTemplate vkUpdateTemplate = m_pLogicalDevice->createDescriptorUpdateTemplate( templateCreateInfo );
+    m_updateTemplates.emplace( std::move( templateKey ), vkUpdateTemplate );
+
+    LOG_DEBUG( fmt::format( "Descriptor Update Template created with {} entries", templateEntries.size() ) );
+
+    return vkUpdateTemplate;
+}
+
+const DescriptorLayoutKey* VulkanDescriptorLayoutCache::find( const vk::DescriptorSetLayout& vkDescriptorSetLayout )
+{
+    std::lock_guard<std::mutex> lock( m_cacheMutex );
+
+    auto keyItr = m_layoutKeys.find( static_cast<VkDescriptorSetLayout>( vkDescriptorSetLayout ) );
+    return keyItr != m_layoutKeys.end() ? keyItr->second : nullptr;
+}
+
+std::size_t VulkanDescriptorLayoutCache::size()
+{
+    std::lock_guard<std::mutex> lock( m_cacheMutex );
+    return m_layouts.size();
+}
+
+vk::DescriptorSetLayout VulkanDescriptorLayoutCache::createLayout( const DescriptorLayoutKey& layoutKey )
+{
+    std::vector<vk::DescriptorSetLayoutBinding> vkLayoutBindings( layoutKey.m_bindings.size() );
+    std::vector<vk::DescriptorBindingFlags> vkBindingFlags( layoutKey.m_bindings.size() );
+    bool bHasBindingFlags = false;
+
+    for( std::size_t i = 0; i < layoutKey.m_bindings.size(); i++ )
+    {
+        const DescriptorLayoutKey::Binding& keyBinding = layoutKey.m_bindings[i];
+
+        vk::DescriptorSetLayoutBinding& layoutBinding = vkLayoutBindings[i];
+        layoutBinding.binding = keyBinding.m_binding;
+        layoutBinding.descriptorType = keyBinding.m_descriptorType;
+        layoutBinding.descriptorCount = keyBinding.m_descriptorCount;
+        layoutBinding.stageFlags = keyBinding.m_stageFlags;
+        layoutBinding.pImmutableSamplers = keyBinding.m_immutableSamplers.empty() ? nullptr : keyBinding.m_immutableSamplers.data();
+
+        vkBindingFlags[i] = keyBinding.m_bindingFlags;
+        bHasBindingFlags |= static_cast<bool>( keyBinding.m_bindingFlags );
+    }
+
+    vk::DescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+    bindingFlagsInfo.bindingCount = static_cast<std::uint32_t>( vkBindingFlags.size() );
+    bindingFlagsInfo.pBindingFlags = vkBindingFlags.data();
+
+    vk::DescriptorSetLayoutCreateInfo descLayoutInfo{};
+    descLayoutInfo.pNext = bHasBindingFlags ? &bindingFlagsInfo : nullptr;
+    descLayoutInfo.flags = layoutKey.m_createFlags;
+    descLayoutInfo.bindingCount = static_cast<std::uint32_t>( vkLayoutBindings.size() );
+    descLayoutInfo.pBindings = vkLayoutBindings.data();
+
+    vk::DescriptorSetLayout vkDescriptorSetLayout = m_pLogicalDevice->createDescriptorSetLayout( descLayoutInfo );
+
+    LOG_DEBUG( fmt::format( "Descriptor Set Layout created with {} bindings", vkLayoutBindings.size() ) );
+
+    return vkDescriptorSetLayout;
+}
+
+} // namespace vkrender
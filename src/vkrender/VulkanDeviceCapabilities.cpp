@@ -0,0 +1,189 @@
+#include "vkrender/VulkanDeviceCapabilities.h"
+#include "vkrender/VulkanHelpers.h"
+#include "utilities/VulkanLogger.h"
+
+namespace vkrender
+{
+
+namespace
+{
+
+std::uint32_t countFlags( const vk::MemoryPropertyFlags& flags )
+{
+    std::uint32_t bits = static_cast<std::uint32_t>( static_cast<VkMemoryPropertyFlags>( flags ) );
+    std::uint32_t count = 0;
+    while( bits != 0u )
+    {
+        bits &= bits - 1u;
+        count++;
+    }
+    return count;
+}
+
+} // namespace
+
+VulkanDeviceCapabilities::VulkanDeviceCapabilities( const vk::PhysicalDevice& vkPhysicalDevice, vk::SurfaceKHR* pVkSurface )
+    :m_vkPhysicalDevice{ vkPhysicalDevice }
+    ,m_vkFeatures{ vkPhysicalDevice.getFeatures() }
+    ,m_vkMemoryProperties{ vkPhysicalDevice.getMemoryProperties() }
+    ,m_queueFamilies{ VulkanHelpers::queryQueueFamilies( vkPhysicalDevice, pVkSurface ) }
+    ,m_queueFamilyIndices{ VulkanHelpers::selectQueueFamilies( m_queueFamilies ) }
+    ,m_bResizableBar{ false }
+{
+    auto propertiesChain = m_vkPhysicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceVulkan12Properties>();
+    m_vkProperties = propertiesChain.get<vk::PhysicalDeviceProperties2>().properties;
+    m_vkVulkan12Properties = propertiesChain.get<vk::PhysicalDeviceVulkan12Properties>();
+    m_vkVulkan12Properties.pNext = nullptr;
+
+    for( std::uint32_t i = 0u; i < m_vkMemoryProperties.memoryTypeCount; i++ )
+    {
+        const vk::MemoryType& memoryType = m_vkMemoryProperties.memoryTypes[i];
+        const bool bBarType =
+            ( memoryType.propertyFlags & vk::MemoryPropertyFlagBits::eDeviceLocal ) &&
+            ( memoryType.propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible );
+
+        if( bBarType && m_vkMemoryProperties.memoryHeaps[memoryType.heapIndex].size > LEGACY_BAR_SIZE )
+            m_bResizableBar = true;
+    }
+
+    m_coreFormatProperties.resize( static_cast<std::size_t>( VK_FORMAT_ASTC_12x12_SRGB_BLOCK ) + 1 );
+    for( std::size_t i = 0; i < m_coreFormatProperties.size(); i++ )
+        m_coreFormatProperties[i] = m_vkPhysicalDevice.getFormatProperties( static_cast<vk::Format>( i ) );
+
+    LOG_INFO( fmt::format(
+        "Device Capabilities cached: {} memory types, {} heaps, {} queue families, resizable BAR {}",
+        m_vkMemoryProperties.memoryTypeCount, m_vkMemoryProperties.memoryHeapCount, m_queueFamilies.size(), m_bResizableBar ? "available" : "unavailable"
+    ) );
+
+    for( const QueueFamilyInfo& queueFamily : m_queueFamilies )
+    {
+        LOG_DEBUG( fmt::format(
+            "Queue Family {}: {} queues: {} timestamp bits: {} present: {}",
+            queueFamily.m_index, vk::to_string( queueFamily.m_queueFlags ), queueFamily.m_queueCount,
+            queueFamily.m_timestampValidBits, queueFamily.m_bPresentSupport
+        ) );
+    }
+}
+
+bool VulkanDeviceCapabilities::supportsTimestamps( const std::uint32_t& queueFamilyIndex ) const
+{
+    return queueFamilyIndex < m_queueFamilies.size() && m_queueFamilies[queueFamilyIndex].m_timestampValidBits > 0u;
+}
+
+vk::FormatProperties VulkanDeviceCapabilities::formatProperties( const vk::Format& format ) const
+{
+    const std::size_t formatIndex = static_cast<std::size_t>( format );
+    if( formatIndex < m_coreFormatProperties.size() )
+        return m_coreFormatProperties[formatIndex];
+
+    std::lock_guard<std::mutex> lock( m_formatMutex );
+
+    auto formatItr = m_extensionFormatProperties.find( static_cast<VkFormat>( format ) );
+    if( formatItr == m_extensionFormatProperties.end() )
+        formatItr = m_extensionFormatProperties.emplace( static_cast<VkFormat>( format ), m_vkPhysicalDevice.getFormatProperties( format ) ).first;
+
+    return formatItr->second;
+}
+
+std::optional<std::uint32_t> VulkanDeviceCapabilities::findMemoryType( const std::uint32_t& memoryTypeBits, const MemoryTypePolicy& policy ) const
+{
+    std::optional<std::uint32_t> bestTypeIndex;
+    std::int32_t bestScore = 0;
+
+    for( std::uint32_t i = 0u; i < m_vkMemoryProperties.memoryTypeCount; i++ )
+    {
+        const vk::MemoryPropertyFlags propertyFlags = m_vkMemoryProperties.memoryTypes[i].propertyFlags;
+
+        if( !( memoryTypeBits & ( 1u << i ) ) || ( propertyFlags & policy.m_required ) != policy.m_required )
+            continue;
+
+        // ties keep the lowest index, drivers list their preferred types first
+        const std::int32_t score =
+            static_cast<std::int32_t>( countFlags( propertyFlags & policy.m_preferred ) ) * 32 -
+            static_cast<std::int32_t>( countFlags( propertyFlags & policy.m_avoided ) );
+
+        if( !bestTypeIndex.has_value() || score > bestScore )
+        {
+            bestTypeIndex = i;
+            bestScore = score;
+        }
+    }
+
+    return bestTypeIndex;
+}
+
+std::uint32_t VulkanDeviceCapabilities::findMemoryType( const std::uint32_t& memoryTypeBits, const VulkanMemoryUsage& usage ) const
+{
+    const MemoryTypePolicy policy = memoryTypePolicy( usage );
+
+    std::optional<std::uint32_t> memoryTypeIndex = findMemoryType( memoryTypeBits, policy );
+
+    // device local is only a requirement when the device has such a type for the resource, e.g. not on some software rasterizers
+    if( !memoryTypeIndex.has_value() && ( policy.m_required & vk::MemoryPropertyFlagBits::eDeviceLocal ) )
+    {
+        MemoryTypePolicy relaxedPolicy = policy;
+        relaxedPolicy.m_required &= ~vk::MemoryPropertyFlags{ vk::MemoryPropertyFlagBits::eDeviceLocal };
+        relaxedPolicy.m_preferred |= vk::MemoryPropertyFlagBits::eDeviceLocal;
+        memoryTypeIndex = findMemoryType( memoryTypeBits, relaxedPolicy );
+    }
+
+    if( !memoryTypeIndex.has_value() )
+    {
+        std::string errorMsg = fmt::format(
+            "No memory type in bits {:#x} satisfies {}",
+            memoryTypeBits, vk::to_string( policy.m_required )
+        );
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    return memoryTypeIndex.value();
+}
+
+VulkanDeviceCapabilities::MemoryTypePolicy VulkanDeviceCapabilities::memoryTypePolicy( const VulkanMemoryUsage& usage )
+{
+    MemoryTypePolicy policy{};
+
+    switch( usage )
+    {
+    case VulkanMemoryUsage::eGpuOnly:
+        policy.m_required = vk::MemoryPropertyFlagBits::eDeviceLocal;
+        policy.m_avoided = vk::MemoryPropertyFlagBits::eHostVisible;
+        break;
+    case VulkanMemoryUsage::eUpload:
+        policy.m_required = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+        policy.m_avoided = vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eHostCached;
+        break;
+    case VulkanMemoryUsage::eDynamic:
+        // falls back to plain host visible memory when there is no BAR heap
+        policy.m_required = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+        policy.m_preferred = vk::MemoryPropertyFlagBits::eDeviceLocal;
+        policy.m_avoided = vk::MemoryPropertyFlagBits::eHostCached;
+        break;
+    case VulkanMemoryUsage::eReadback:
+        policy.m_required = vk::MemoryPropertyFlagBits::eHostVisible;
+        policy.m_preferred = vk::MemoryPropertyFlagBits::eHostCached;
+        policy.m_avoided = vk::MemoryPropertyFlagBits::eDeviceLocal;
+        break;
+    }
+
+    return policy;
+}
+
+vk::SampleCountFlagBits VulkanDeviceCapabilities::maxUsableSampleCount() const
+{
+    const vk::SampleCountFlags counts = m_vkProperties.limits.framebufferColorSampleCounts & m_vkProperties.limits.framebufferDepthSampleCounts;
+
+    for( const vk::SampleCountFlagBits sampleCount : {
+        vk::SampleCountFlagBits::e64, vk::SampleCountFlagBits::e32, vk::SampleCountFlagBits::e16,
+        vk::SampleCountFlagBits::e8, vk::SampleCountFlagBits::e4, vk::SampleCountFlagBits::e2
+    } )
+    {
+        if( counts & sampleCount )
+            return sampleCount;
+    }
+
+    return vk::SampleCountFlagBits::e1;
+}
+
+} // namespace vkrender
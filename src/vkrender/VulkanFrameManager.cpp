@@ -0,0 +1,259 @@
+#include "vkrender/VulkanFrameManager.h"
+#include "vkrender/VulkanRenderer.h"
+#include "vkrender/VulkanHelpers.h"
+#include "utilities/VulkanLogger.h"
+
+#include <chrono>
+#include <limits>
+
+namespace vkrender
+{
+
+VulkanFrameManager::VulkanFrameManager(
+    VulkanRenderer* pVkRenderer,
+    const std::uint32_t& framesInFlight,
+    const vk::DeviceSize& uniformBufferSize
+)
+    :m_pVkRenderer{ pVkRenderer }
+    ,m_pLogicalDevice{ pVkRenderer->getDevice() }
+    ,m_frameNumber{ 0 }
+    ,m_bFrameActive{ false }
+{
+    if( framesInFlight == 0 )
+    {
+        std::string errorMsg = "Frame Manager needs at least one frame in flight";
+        LOG_ERROR(errorMsg);
+        throw std::invalid_argument(errorMsg);
+    }
+
+    const QueueFamilyIndices& queueFamilyIndices = pVkRenderer->getDeviceCapabilities()->queueFamilyIndices();
+
+    m_frames.resize( framesInFlight );
+    for( VulkanFrameContext& frame : m_frames )
+        createFrameContext( frame, queueFamilyIndices.m_graphicsFamily.value(), uniformBufferSize );
+
+    LOG_INFO( fmt::format( "Frame Manager created with {} frames in flight", framesInFlight ) );
+}
+
+VulkanFrameManager::~VulkanFrameManager()
+{
+    waitIdle();
+
+    for( VulkanFrameContext& frame : m_frames )
+        destroyFrameContext( frame );
+
+    LOG_DEBUG( fmt::format(
+        "Frame Manager Destroyed frames: {} fence wait total: {:.3f}ms max: {:.3f}ms descriptor writes: {}",
+        m_statistics.m_frameCount, m_statistics.m_totalFenceWaitMs, m_statistics.m_maxFenceWaitMs, m_statistics.m_totalDescriptorWrites
+    ) );
+}
+
+VulkanFrameContext* VulkanFrameManager::beginFrame()
+{
+    if( m_bFrameActive )
+    {
+        std::string errorMsg = "beginFrame called twice without endFrame";
+        LOG_ERROR(errorMsg);
+        throw std::logic_error(errorMsg);
+    }
+
+    VulkanFrameContext& frame = *currentFrame();
+
+    waitForFrameFence( frame );
+
+    if( VulkanBindlessTable* pBindlessTable = m_pVkRenderer->getBindlessTable() )
+        pBindlessTable->beginFrame( m_frameNumber );
+    m_pVkRenderer->m_pDeletionQueue->collect( m_frameNumber );
+    countDescriptorWrites();
+
+    // the fence stays signalled until the image is acquired so a skipped frame cannot deadlock the next wait
+    vk::Result acquireResult = m_pVkRenderer->m_pVulkanSwapchain->acquireNextImage( frame.m_vkImageAvailableSemaphore, frame.m_imageIndex );
+    if( acquireResult == vk::Result::eErrorOutOfDateKHR )
+    {
+        m_statistics.m_swapchainRecreations++;
+        m_pVkRenderer->recreateSwapchain();
+        return nullptr;
+    }
+    else if( acquireResult != vk::Result::eSuccess && acquireResult != vk::Result::eSuboptimalKHR )
+    {
+        std::string errorMsg = fmt::format( "Failed to acquire swapchain image: {}", vk::to_string( acquireResult ) );
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    m_pLogicalDevice->resetFences( frame.m_vkInFlightFence );
+    m_pLogicalDevice->resetCommandPool( frame.m_vkCommandPool );
+    frame.m_pDescriptorAllocator->reset();
+    frame.m_pUniformRing->reset();
+
+    frame.m_frameNumber = m_frameNumber;
+    frame.m_waitSemaphores.assign( 1, frame.m_vkImageAvailableSemaphore );
+    frame.m_waitValues.assign( 1, 0 );
+    frame.m_waitStages.assign( 1, vk::PipelineStageFlagBits::eColorAttachmentOutput );
+
+    vk::CommandBufferBeginInfo beginInfo{};
+    beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+    frame.m_vkCmdBuffer.begin( beginInfo );
+
+    m_bFrameActive = true;
+    return &frame;
+}
+
+void VulkanFrameManager::endFrame()
+{
+    if( !m_bFrameActive )
+    {
+        std::string errorMsg = "endFrame called without a matching beginFrame";
+        LOG_ERROR(errorMsg);
+        throw std::logic_error(errorMsg);
+    }
+
+    VulkanFrameContext& frame = *currentFrame();
+
+    frame.m_vkCmdBuffer.end();
+
+    // binary semaphores ignore their value, the array only has to line up with the timeline ones
+    vk::TimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.waitSemaphoreValueCount = static_cast<std::uint32_t>( frame.m_waitValues.size() );
+    timelineInfo.pWaitSemaphoreValues = frame.m_waitValues.data();
+
+    vk::SubmitInfo submitInfo{};
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.waitSemaphoreCount = static_cast<std::uint32_t>( frame.m_waitSemaphores.size() );
+    submitInfo.pWaitSemaphores = frame.m_waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = frame.m_waitStages.data();
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &frame.m_vkCmdBuffer;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &frame.m_vkRenderFinishedSemaphore;
+
+    vk::Result submitResult = m_pVkRenderer->submit( m_pVkRenderer->m_vkGraphicsQueue, 1, &submitInfo, frame.m_vkInFlightFence );
+    if( submitResult != vk::Result::eSuccess )
+    {
+        std::string errorMsg = fmt::format( "Failed to submit frame {}: {}", m_frameNumber, vk::to_string( submitResult ) );
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    vk::Result presentResult;
+    {
+        std::lock_guard<std::mutex> queueLock{ m_pVkRenderer->queueMutex( m_pVkRenderer->m_vkPresentationQueue ) };
+        presentResult = m_pVkRenderer->m_pVulkanSwapchain->present(
+            m_pVkRenderer->m_vkPresentationQueue, frame.m_vkRenderFinishedSemaphore, frame.m_imageIndex
+        );
+    }
+
+    m_bFrameActive = false;
+    m_frameNumber++;
+    m_statistics.m_frameCount++;
+
+    if( presentResult == vk::Result::eErrorOutOfDateKHR || presentResult == vk::Result::eSuboptimalKHR || m_pVkRenderer->m_pVulkanWindow->isFrameBufferResized() )
+    {
+        m_statistics.m_swapchainRecreations++;
+        m_pVkRenderer->recreateSwapchain();
+    }
+    else if( presentResult != vk::Result::eSuccess )
+    {
+        std::string errorMsg = fmt::format( "Failed to present swapchain image: {}", vk::to_string( presentResult ) );
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+}
+
+void VulkanFrameManager::waitForUpload( const VulkanUploadTicket& uploadTicket, const vk::PipelineStageFlags& dstStage )
+{
+    if( !uploadTicket.isValid() || uploadTicket.isReady() )
+        return;
+
+    VulkanFrameContext& frame = *currentFrame();
+    frame.m_waitSemaphores.push_back( uploadTicket.timelineSemaphore() );
+    frame.m_waitValues.push_back( uploadTicket.timelineValue() );
+    frame.m_waitStages.push_back( dstStage );
+}
+
+void VulkanFrameManager::waitIdle()
+{
+    std::vector<vk::Fence> inFlightFences;
+    inFlightFences.reserve( m_frames.size() );
+    for( const VulkanFrameContext& frame : m_frames )
+        inFlightFences.push_back( frame.m_vkInFlightFence );
+
+    vk::Result waitResult = m_pLogicalDevice->waitForFences(
+        static_cast<std::uint32_t>( inFlightFences.size() ), inFlightFences.data(),
+        VK_TRUE, std::numeric_limits<std::uint64_t>::max()
+    );
+    if( waitResult != vk::Result::eSuccess )
+    {
+        std::string errorMsg = "Failed to wait for frames in flight";
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+}
+
+void VulkanFrameManager::createFrameContext( VulkanFrameContext& frame, const std::uint32_t& graphicsFamilyIndex, const vk::DeviceSize& uniformBufferSize )
+{
+    vk::CommandPoolCreateInfo commandPoolInfo{};
+    commandPoolInfo.flags = vk::CommandPoolCreateFlagBits::eTransient;
+    commandPoolInfo.queueFamilyIndex = graphicsFamilyIndex;
+    frame.m_vkCommandPool = m_pLogicalDevice->createCommandPool( commandPoolInfo );
+
+    vk::CommandBufferAllocateInfo allocInfo{};
+    allocInfo.commandPool = frame.m_vkCommandPool;
+    allocInfo.level = vk::CommandBufferLevel::ePrimary;
+    allocInfo.commandBufferCount = 1;
+    frame.m_vkCmdBuffer = m_pLogicalDevice->allocateCommandBuffers( allocInfo )[0];
+
+    frame.m_vkImageAvailableSemaphore = m_pLogicalDevice->createSemaphore( vk::SemaphoreCreateInfo{} );
+    frame.m_vkRenderFinishedSemaphore = m_pLogicalDevice->createSemaphore( vk::SemaphoreCreateInfo{} );
+
+    // created signalled so the first beginFrame does not wait on a submission that never happened
+    frame.m_vkInFlightFence = m_pLogicalDevice->createFence( vk::FenceCreateInfo{ vk::FenceCreateFlagBits::eSignaled } );
+
+    frame.m_pUniformRing = std::make_unique<VulkanUniformRing>( m_pVkRenderer, uniformBufferSize );
+
+    frame.m_pDescriptorAllocator = std::make_unique<VulkanDescriptorAllocator>( m_pLogicalDevice, DEFAULT_DESCRIPTOR_SETS_PER_FRAME );
+}
+
+void VulkanFrameManager::destroyFrameContext( VulkanFrameContext& frame )
+{
+    frame.m_pDescriptorAllocator.reset();
+    frame.m_pUniformRing.reset();
+
+    m_pLogicalDevice->destroyFence( frame.m_vkInFlightFence );
+    m_pLogicalDevice->destroySemaphore( frame.m_vkRenderFinishedSemaphore );
+    m_pLogicalDevice->destroySemaphore( frame.m_vkImageAvailableSemaphore );
+
+    m_pLogicalDevice->destroyCommandPool( frame.m_vkCommandPool );
+}
+
+void VulkanFrameManager::countDescriptorWrites()
+{
+    std::uint64_t totalDescriptorWrites = m_pVkRenderer->getDescriptorAllocator()->writeCount();
+    for( const VulkanFrameContext& frame : m_frames )
+        totalDescriptorWrites += frame.m_pDescriptorAllocator->writeCount();
+    if( VulkanBindlessTable* pBindlessTable = m_pVkRenderer->getBindlessTable() )
+        totalDescriptorWrites += pBindlessTable->descriptorWriteCount();
+
+    m_statistics.m_lastFrameDescriptorWrites = totalDescriptorWrites - m_statistics.m_totalDescriptorWrites;
+    m_statistics.m_totalDescriptorWrites = totalDescriptorWrites;
+}
+
+void VulkanFrameManager::waitForFrameFence( VulkanFrameContext& frame )
+{
+    const auto waitBegin = std::chrono::steady_clock::now();
+
+    vk::Result waitResult = m_pLogicalDevice->waitForFences( 1, &frame.m_vkInFlightFence, VK_TRUE, std::numeric_limits<std::uint64_t>::max() );
+    if( waitResult != vk::Result::eSuccess )
+    {
+        std::string errorMsg = fmt::format( "Failed to wait for frame {} fence", frame.m_frameNumber );
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    const double waitMs = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - waitBegin ).count();
+    m_statistics.m_lastFenceWaitMs = waitMs;
+    m_statistics.m_maxFenceWaitMs = std::max( m_statistics.m_maxFenceWaitMs, waitMs );
+    m_statistics.m_totalFenceWaitMs += waitMs;
+}
+
+} // namespace vkrender
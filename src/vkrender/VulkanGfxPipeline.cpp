@@ -1,11 +1,22 @@
 #include "vkrender/VulkanGfxPipeline.h"
 #include "utilities/VulkanLogger.h"
 
+#include <algorithm>
+#include <string_view>
+
 namespace vkrender
 {
 
-VulkanGfxPipeline::VulkanGfxPipeline( vk::Device* pLogicalDevice )
+VulkanGfxPipeline::VulkanGfxPipeline(
+    vk::Device* pLogicalDevice, VulkanPipelineCache* pPipelineCache, VulkanDeletionQueue* pDeletionQueue,
+    VulkanDescriptorLayoutCache* pDescriptorLayoutCache
+)
     :m_pLogicalDevice{ pLogicalDevice }
+    ,m_pPipelineCache{ pPipelineCache }
+    ,m_pDeletionQueue{ pDeletionQueue }
+    ,m_pDescriptorLayoutCache{ pDescriptorLayoutCache }
+    ,m_bExplicitVertexInput{ false }
+    ,m_bExplicitPushConstants{ false }
 {
     m_vkViewportState.viewportCount = 1;
     m_vkViewportState.pViewports = nullptr;
@@ -31,18 +42,36 @@ void VulkanGfxPipeline::bindShaderStages( const ShaderStages& shaderStages )
 		shaderStageCreateInfo.pSpecializationInfo = nullptr;
 	};
 
-    if( shaderStages.m_vertexShader )
-    {    
+    m_vkShaderStages.clear();
+    m_stageReflections.clear();
+
+    for( VulkanGpuProgram* pGpuProgram : { shaderStages.m_vertexShader, shaderStages.m_fragmentShader } )
+    {
+        if( !pGpuProgram )
+            continue;
+
         m_vkShaderStages.push_back( {} );
-        l_populatePipelineShaderStageCreateInfo( m_vkShaderStages[0], shaderStages.m_vertexShader );
+        l_populatePipelineShaderStageCreateInfo( m_vkShaderStages.back(), pGpuProgram );
+        if( pGpuProgram->reflection() )
+            m_stageReflections.push_back( pGpuProgram->reflection() );
     }
-    else if( shaderStages.m_fragmentShader )
+
+    if( !m_bExplicitVertexInput && shaderStages.m_vertexShader && shaderStages.m_vertexShader->reflection() )
     {
-        m_vkShaderStages.push_back( {} );
-        l_populatePipelineShaderStageCreateInfo( m_vkShaderStages[1], shaderStages.m_fragmentShader );
+        VulkanShaderReflector::deriveVertexInput( *shaderStages.m_vertexShader->reflection(), m_vkVertexBindings, m_vkVertexAttributes );
     }
 }
 
+void VulkanGfxPipeline::setVertexInputState(
+    const std::vector<vk::VertexInputBindingDescription>& vertexBindings,
+    const std::vector<vk::VertexInputAttributeDescription>& vertexAttributes
+)
+{
+    m_vkVertexBindings = vertexBindings;
+    m_vkVertexAttributes = vertexAttributes;
+    m_bExplicitVertexInput = true;
+}
+
 void VulkanGfxPipeline::setInputAssemblyState(
     const vk::PrimitiveTopology& primitiveTopology,
     const bool& bPrimitiveRestart
@@ -111,12 +140,13 @@ void VulkanGfxPipeline::setStencilState(
 }
 
 void VulkanGfxPipeline::setColorBlendState(
-    const vk::ColorComponentFlagBits& colorWriteMask,
+    const vk::ColorComponentFlags& colorWriteMask,
     const bool& bColorBlend,
     const BlendOp& colorBlendOp, const BlendOp& alphaBlendOp
 )
 {
-    m_vkColorBlendAttachment.blendEnable = VK_FALSE;
+    m_vkColorBlendAttachment.colorWriteMask = colorWriteMask;
+    m_vkColorBlendAttachment.blendEnable = static_cast<vk::Bool32>( bColorBlend );
     m_vkColorBlendAttachment.srcColorBlendFactor = colorBlendOp.m_srcBlendFactor;
     m_vkColorBlendAttachment.dstColorBlendFactor = colorBlendOp.m_dstBlendFactor;
     m_vkColorBlendAttachment.colorBlendOp = colorBlendOp.m_blendOp;
@@ -138,8 +168,7 @@ void VulkanGfxPipeline::setDynamicState(
     const std::vector<vk::DynamicState>& dynamicStates
 )
 {
-    m_vkDynamicState.pDynamicStates = dynamicStates.data();
-    m_vkDynamicState.dynamicStateCount = dynamicStates.size();
+    m_vkDynamicStates = dynamicStates;
 }
 
 void VulkanGfxPipeline::bindDescriptors(
@@ -152,6 +181,29 @@ void VulkanGfxPipeline::bindDescriptors(
     }
 }
 
+void VulkanGfxPipeline::bindDescriptorSetLayouts( const std::vector<vk::DescriptorSetLayout>& vkDescriptorSetLayouts )
+{
+    m_vkDescriptorSetLayoutArray.insert( m_vkDescriptorSetLayoutArray.end(), vkDescriptorSetLayouts.begin(), vkDescriptorSetLayouts.end() );
+}
+
+void VulkanGfxPipeline::setPushConstantRanges( const std::vector<vk::PushConstantRange>& pushConstantRanges )
+{
+    // only 128 bytes are guaranteed by every implementation
+    for( const vk::PushConstantRange& pushConstantRange : pushConstantRanges )
+    {
+        if( pushConstantRange.offset + pushConstantRange.size > 128u )
+        {
+            LOG_INFO( fmt::format(
+                "Push constant range [{}, {}) exceeds the guaranteed 128 bytes",
+                pushConstantRange.offset, pushConstantRange.offset + pushConstantRange.size
+            ) );
+        }
+    }
+
+    m_vkPushConstantRanges = pushConstantRanges;
+    m_bExplicitPushConstants = true;
+}
+
 vk::Result VulkanGfxPipeline::createGfxPipeline(
     VulkanRenderPass* pRenderPassToUse, 
     const std::uint32_t& subPassIndexToUse
@@ -159,22 +211,38 @@ vk::Result VulkanGfxPipeline::createGfxPipeline(
 {
     createPipelineLayout();
 
+    m_vkVertexInput.vertexBindingDescriptionCount = static_cast<std::uint32_t>( m_vkVertexBindings.size() );
+    m_vkVertexInput.pVertexBindingDescriptions = m_vkVertexBindings.data();
+    m_vkVertexInput.vertexAttributeDescriptionCount = static_cast<std::uint32_t>( m_vkVertexAttributes.size() );
+    m_vkVertexInput.pVertexAttributeDescriptions = m_vkVertexAttributes.data();
+
+    m_vkDynamicState.dynamicStateCount = static_cast<std::uint32_t>( m_vkDynamicStates.size() );
+    m_vkDynamicState.pDynamicStates = m_vkDynamicStates.data();
+
     vk::GraphicsPipelineCreateInfo vkGfxPipelineCreateInfo{};
     vkGfxPipelineCreateInfo.stageCount = m_vkShaderStages.size();
     vkGfxPipelineCreateInfo.pStages = m_vkShaderStages.data();
-    vkGfxPipelineCreateInfo.pVertexInputState = nullptr;
+    vkGfxPipelineCreateInfo.pVertexInputState = &m_vkVertexInput;
     vkGfxPipelineCreateInfo.pInputAssemblyState = &m_vkInputAssembly;
     vkGfxPipelineCreateInfo.pViewportState = &m_vkViewportState;
     vkGfxPipelineCreateInfo.pRasterizationState = &m_vkRasterizerState;
     vkGfxPipelineCreateInfo.pMultisampleState = &m_vkMultisampleState;
     vkGfxPipelineCreateInfo.pDepthStencilState = &m_vkDepthStencilState;
     vkGfxPipelineCreateInfo.pColorBlendState = &m_vkColorBlendState;
+    vkGfxPipelineCreateInfo.pDynamicState = m_vkDynamicStates.empty() ? nullptr : &m_vkDynamicState;
     vkGfxPipelineCreateInfo.layout = m_vkPipelineLayout;
     vkGfxPipelineCreateInfo.renderPass = pRenderPassToUse->m_vkRenderPass;
-    vkGfxPipelineCreateInfo.subpass = 0;
+    vkGfxPipelineCreateInfo.subpass = subPassIndexToUse;
     vkGfxPipelineCreateInfo.basePipelineHandle = nullptr;
     vkGfxPipelineCreateInfo.basePipelineIndex = -1;
 
+    if( m_pPipelineCache )
+    {
+        m_vkGfxPipeline = m_pPipelineCache->createGraphicsPipeline( vkGfxPipelineCreateInfo );
+        LOG_INFO("Graphics Pipeline created");
+        return vk::Result::eSuccess;
+    }
+
     vk::ResultValue<vk::Pipeline> operationResult = m_pLogicalDevice->createGraphicsPipeline( nullptr, vkGfxPipelineCreateInfo );
 
 	if( operationResult.result == vk::Result::eSuccess )
@@ -192,13 +260,212 @@ vk::Result VulkanGfxPipeline::createGfxPipeline(
     return operationResult.result;
 }
 
+PipelineStateKey VulkanGfxPipeline::stateKey( VulkanRenderPass* pRenderPassToUse, const std::uint32_t& subPassIndexToUse ) const
+{
+    PipelineStateKey stateKey{};
+
+    for( const vk::PipelineShaderStageCreateInfo& shaderStage : m_vkShaderStages )
+    {
+        stateKey.m_shaderStages.push_back( {
+            shaderStage.module,
+            shaderStage.stage,
+            std::hash<std::string_view>{}( shaderStage.pName ? std::string_view{ shaderStage.pName } : std::string_view{} )
+        } );
+    }
+    stateKey.m_vertexBindings = m_vkVertexBindings;
+    stateKey.m_vertexAttributes = m_vkVertexAttributes;
+    stateKey.m_descriptorSetLayouts = descriptorSetLayouts();
+    stateKey.m_pushConstantRanges = pushConstantRanges();
+    stateKey.m_dynamicStates = m_vkDynamicStates;
+    stateKey.m_vkRenderPass = pRenderPassToUse->m_vkRenderPass;
+
+    PipelineStateKey::FixedState& fixedState = stateKey.m_fixedState;
+    fixedState.m_topology = static_cast<std::uint32_t>( m_vkInputAssembly.topology );
+    fixedState.m_primitiveRestart = m_vkInputAssembly.primitiveRestartEnable;
+
+    fixedState.m_polygonMode = static_cast<std::uint32_t>( m_vkRasterizerState.polygonMode );
+    fixedState.m_cullMode = static_cast<std::uint32_t>( m_vkRasterizerState.cullMode );
+    fixedState.m_frontFace = static_cast<std::uint32_t>( m_vkRasterizerState.frontFace );
+    fixedState.m_rasterizerDiscard = m_vkRasterizerState.rasterizerDiscardEnable;
+    fixedState.m_depthClamp = m_vkRasterizerState.depthClampEnable;
+    fixedState.m_depthBias = m_vkRasterizerState.depthBiasEnable;
+    fixedState.m_depthBiasConstantFactor = PipelineStateKey::floatBits( m_vkRasterizerState.depthBiasConstantFactor );
+    fixedState.m_depthBiasSlopeFactor = PipelineStateKey::floatBits( m_vkRasterizerState.depthBiasSlopeFactor );
+    fixedState.m_lineWidth = PipelineStateKey::floatBits( m_vkRasterizerState.lineWidth );
+
+    fixedState.m_sampleCount = static_cast<std::uint32_t>( m_vkMultisampleState.rasterizationSamples );
+    fixedState.m_sampleShading = m_vkMultisampleState.sampleShadingEnable;
+    fixedState.m_minSampleShading = PipelineStateKey::floatBits( m_vkMultisampleState.minSampleShading );
+
+    auto l_packStencilOps = []( std::uint32_t* pStencilOps, const vk::StencilOpState& stencilOpState )
+    {
+        pStencilOps[0] = static_cast<std::uint32_t>( stencilOpState.failOp );
+        pStencilOps[1] = static_cast<std::uint32_t>( stencilOpState.passOp );
+        pStencilOps[2] = static_cast<std::uint32_t>( stencilOpState.depthFailOp );
+        pStencilOps[3] = static_cast<std::uint32_t>( stencilOpState.compareOp );
+    };
+
+    fixedState.m_depthTest = m_vkDepthStencilState.depthTestEnable;
+    fixedState.m_depthWrite = m_vkDepthStencilState.depthWriteEnable;
+    fixedState.m_depthCompareOp = static_cast<std::uint32_t>( m_vkDepthStencilState.depthCompareOp );
+    fixedState.m_depthBoundsTest = m_vkDepthStencilState.depthBoundsTestEnable;
+    fixedState.m_minDepthBounds = PipelineStateKey::floatBits( m_vkDepthStencilState.minDepthBounds );
+    fixedState.m_maxDepthBounds = PipelineStateKey::floatBits( m_vkDepthStencilState.maxDepthBounds );
+    fixedState.m_stencilTest = m_vkDepthStencilState.stencilTestEnable;
+    l_packStencilOps( fixedState.m_frontStencilOps, m_vkDepthStencilState.front );
+    l_packStencilOps( fixedState.m_backStencilOps, m_vkDepthStencilState.back );
+
+    fixedState.m_blendEnable = m_vkColorBlendAttachment.blendEnable;
+    fixedState.m_srcColorBlendFactor = static_cast<std::uint32_t>( m_vkColorBlendAttachment.srcColorBlendFactor );
+    fixedState.m_dstColorBlendFactor = static_cast<std::uint32_t>( m_vkColorBlendAttachment.dstColorBlendFactor );
+    fixedState.m_colorBlendOp = static_cast<std::uint32_t>( m_vkColorBlendAttachment.colorBlendOp );
+    fixedState.m_srcAlphaBlendFactor = static_cast<std::uint32_t>( m_vkColorBlendAttachment.srcAlphaBlendFactor );
+    fixedState.m_dstAlphaBlendFactor = static_cast<std::uint32_t>( m_vkColorBlendAttachment.dstAlphaBlendFactor );
+    fixedState.m_alphaBlendOp = static_cast<std::uint32_t>( m_vkColorBlendAttachment.alphaBlendOp );
+    fixedState.m_colorWriteMask = static_cast<std::uint32_t>( m_vkColorBlendAttachment.colorWriteMask );
+
+    fixedState.m_subpassIndex = subPassIndexToUse;
+
+    return stateKey;
+}
+
+VulkanPipelineLayoutReflection VulkanGfxPipeline::reflectedLayout() const
+{
+    return VulkanShaderReflector::mergeStages( m_stageReflections );
+}
+
+std::vector<vk::DescriptorSetLayout> VulkanGfxPipeline::descriptorSetLayouts() const
+{
+    if( !m_vkDescriptorSetLayoutArray.empty() )
+        return m_vkDescriptorSetLayoutArray;
+
+    const VulkanPipelineLayoutReflection layoutReflection = reflectedLayout();
+    if( layoutReflection.m_setLayoutBindings.empty() )
+        return {};
+
+    if( m_pDescriptorLayoutCache == nullptr )
+    {
+        std::string errorMsg = fmt::format(
+            "Shaders use {} descriptor sets, neither layouts nor a layout cache to derive them are given",
+            layoutReflection.m_setLayoutBindings.size()
+        );
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    return m_pDescriptorLayoutCache->acquire( layoutReflection );
+}
+
+std::vector<vk::PushConstantRange> VulkanGfxPipeline::pushConstantRanges() const
+{
+    std::vector<vk::PushConstantRange> reflectedRanges = reflectedLayout().m_pushConstantRanges;
+    if( !m_bExplicitPushConstants )
+        return reflectedRanges;
+
+    // a stage may only appear in one range, a block outside the explicit range of its stage widens that range
+    std::vector<vk::PushConstantRange> vkPushConstantRanges = m_vkPushConstantRanges;
+    for( const vk::PushConstantRange& reflectedRange : reflectedRanges )
+    {
+        for( const vk::ShaderStageFlagBits shaderStage : { vk::ShaderStageFlagBits::eVertex, vk::ShaderStageFlagBits::eFragment } )
+        {
+            if( !( reflectedRange.stageFlags & shaderStage ) )
+                continue;
+
+            auto rangeItr = std::find_if( vkPushConstantRanges.begin(), vkPushConstantRanges.end(), [shaderStage]( const vk::PushConstantRange& range ){
+                return static_cast<bool>( range.stageFlags & shaderStage );
+            } );
+            if( rangeItr != vkPushConstantRanges.end() )
+            {
+                const std::uint32_t rangeEnd = std::max( rangeItr->offset + rangeItr->size, reflectedRange.offset + reflectedRange.size );
+                rangeItr->offset = std::min( rangeItr->offset, reflectedRange.offset );
+                rangeItr->size = rangeEnd - rangeItr->offset;
+                continue;
+            }
+
+            rangeItr = std::find_if( vkPushConstantRanges.begin(), vkPushConstantRanges.end(), [&reflectedRange]( const vk::PushConstantRange& range ){
+                return range.offset == reflectedRange.offset && range.size == reflectedRange.size;
+            } );
+            if( rangeItr != vkPushConstantRanges.end() )
+                rangeItr->stageFlags |= shaderStage;
+            else
+                vkPushConstantRanges.push_back( vk::PushConstantRange{ shaderStage, reflectedRange.offset, reflectedRange.size } );
+        }
+    }
+
+    return vkPushConstantRanges;
+}
+
+void VulkanGfxPipeline::validateDescriptorSetLayouts( const VulkanPipelineLayoutReflection& layoutReflection ) const
+{
+    // reflection cannot tell a dynamic buffer from a plain one, both are accepted for a buffer binding
+    auto l_compatibleTypes = []( const vk::DescriptorType& reflectedType, const vk::DescriptorType& boundType )
+    {
+        return reflectedType == boundType ||
+            ( reflectedType == vk::DescriptorType::eUniformBuffer && boundType == vk::DescriptorType::eUniformBufferDynamic ) ||
+            ( reflectedType == vk::DescriptorType::eStorageBuffer && boundType == vk::DescriptorType::eStorageBufferDynamic );
+    };
+
+    for( std::size_t setIndex = 0; setIndex < layoutReflection.m_setLayoutBindings.size(); setIndex++ )
+    {
+        const std::vector<vk::DescriptorSetLayoutBinding>& reflectedBindings = layoutReflection.m_setLayoutBindings[setIndex];
+        if( reflectedBindings.empty() )
+            continue;
+
+        if( setIndex >= m_vkDescriptorSetLayoutArray.size() )
+        {
+            std::string errorMsg = fmt::format(
+                "Shaders use descriptor set {}, only {} layouts are bound",
+                setIndex, m_vkDescriptorSetLayoutArray.size()
+            );
+            LOG_ERROR(errorMsg);
+            throw std::runtime_error(errorMsg);
+        }
+
+        // layouts created outside the cache cannot be inspected
+        const DescriptorLayoutKey* pLayoutKey = m_pDescriptorLayoutCache ? m_pDescriptorLayoutCache->find( m_vkDescriptorSetLayoutArray[setIndex] ) : nullptr;
+        if( pLayoutKey == nullptr )
+            continue;
+
+        for( const vk::DescriptorSetLayoutBinding& reflectedBinding : reflectedBindings )
+        {
+            auto boundItr = std::find_if( pLayoutKey->m_bindings.begin(), pLayoutKey->m_bindings.end(), [&reflectedBinding]( const DescriptorLayoutKey::Binding& binding ){
+                return binding.m_binding == reflectedBinding.binding;
+            } );
+
+            std::string mismatch;
+            if( boundItr == pLayoutKey->m_bindings.end() )
+                mismatch = "is missing from the bound layout";
+            else if( !l_compatibleTypes( reflectedBinding.descriptorType, boundItr->m_descriptorType ) )
+                mismatch = fmt::format( "is {} in the shaders and {} in the bound layout", vk::to_string( reflectedBinding.descriptorType ), vk::to_string( boundItr->m_descriptorType ) );
+            else if( reflectedBinding.descriptorCount > boundItr->m_descriptorCount )
+                mismatch = fmt::format( "has {} descriptors in the shaders and {} in the bound layout", reflectedBinding.descriptorCount, boundItr->m_descriptorCount );
+            else if( ( boundItr->m_stageFlags & reflectedBinding.stageFlags ) != reflectedBinding.stageFlags )
+                mismatch = fmt::format( "is used by {} but only visible to {}", vk::to_string( reflectedBinding.stageFlags ), vk::to_string( boundItr->m_stageFlags ) );
+
+            if( !mismatch.empty() )
+            {
+                std::string errorMsg = fmt::format( "Set {} binding {} {}", setIndex, reflectedBinding.binding, mismatch );
+                LOG_ERROR(errorMsg);
+                throw std::runtime_error(errorMsg);
+            }
+        }
+    }
+}
+
 void VulkanGfxPipeline::createPipelineLayout()
 {
+    const VulkanPipelineLayoutReflection layoutReflection = reflectedLayout();
+    const std::vector<vk::PushConstantRange> vkPushConstantRanges = pushConstantRanges();
+
+    if( !m_vkDescriptorSetLayoutArray.empty() )
+        validateDescriptorSetLayouts( layoutReflection );
+    const std::vector<vk::DescriptorSetLayout> vkDescriptorSetLayouts = descriptorSetLayouts();
+
     vk::PipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
-    pipelineLayoutCreateInfo.setLayoutCount = m_vkDescriptorSetLayoutArray.size();
-    pipelineLayoutCreateInfo.pSetLayouts = m_vkDescriptorSetLayoutArray.data();
-    pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
-    pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
+    pipelineLayoutCreateInfo.setLayoutCount = static_cast<std::uint32_t>( vkDescriptorSetLayouts.size() );
+    pipelineLayoutCreateInfo.pSetLayouts = vkDescriptorSetLayouts.data();
+    pipelineLayoutCreateInfo.pushConstantRangeCount = static_cast<std::uint32_t>( vkPushConstantRanges.size() );
+    pipelineLayoutCreateInfo.pPushConstantRanges = vkPushConstantRanges.data();
 
     m_vkPipelineLayout = m_pLogicalDevice->createPipelineLayout( pipelineLayoutCreateInfo );
 
@@ -207,8 +474,22 @@ void VulkanGfxPipeline::createPipelineLayout()
 
 void VulkanGfxPipeline::destroyGfxPipeline()
 {
-    m_pLogicalDevice->destroyPipeline( m_vkGfxPipeline );
-    m_pLogicalDevice->destroyPipelineLayout( m_vkPipelineLayout );
+    // frames recorded with the pipeline may still be executing
+    if( m_pDeletionQueue )
+    {
+        if( m_vkGfxPipeline )
+            m_pDeletionQueue->destroyPipeline( m_vkGfxPipeline );
+        if( m_vkPipelineLayout )
+            m_pDeletionQueue->destroyPipelineLayout( m_vkPipelineLayout );
+    }
+    else
+    {
+        m_pLogicalDevice->destroyPipeline( m_vkGfxPipeline );
+        m_pLogicalDevice->destroyPipelineLayout( m_vkPipelineLayout );
+    }
+
+    m_vkGfxPipeline = vk::Pipeline{};
+    m_vkPipelineLayout = vk::PipelineLayout{};
 }
 
 
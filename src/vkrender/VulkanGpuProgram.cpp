@@ -7,16 +7,20 @@ namespace vkrender
 {
 
 VulkanGpuProgram::VulkanGpuProgram(const std::filesystem::path& shaderPath)
+    :m_pDevice{ nullptr }
 {
     populateShaderBufferFromSourceFile( shaderPath, m_shaderBuffer );
 }
 
 VulkanGpuProgram::VulkanGpuProgram(const std::vector<char>& shaderBuffer)
+    :m_pDevice{ nullptr }
+    ,m_shaderBuffer{ shaderBuffer }
 {}
 
 VulkanGpuProgram::~VulkanGpuProgram()
 {
-    m_pDevice->destroyShaderModule( m_vkShaderModule );
+    if( m_pDevice )
+        m_pDevice->destroyShaderModule( m_vkShaderModule );
 }
 
 void VulkanGpuProgram::createShader(
@@ -28,6 +32,18 @@ void VulkanGpuProgram::createShader(
     m_pDevice = pLogicalDevice;
     m_vkShaderStage = shaderStage;
     m_entryPoint = entryPoint;
+
+    m_pReflection = VulkanShaderReflector::reflect( m_shaderBuffer, m_entryPoint );
+    if( m_pReflection->m_shaderStage != m_vkShaderStage )
+    {
+        std::string errorMsg = fmt::format(
+            "Entry point {} is a {} shader, requested as {}",
+            m_entryPoint, vk::to_string( m_pReflection->m_shaderStage ), vk::to_string( m_vkShaderStage )
+        );
+        LOG_ERROR(errorMsg);
+        throw std::invalid_argument(errorMsg);
+    }
+
     createShaderModule();
 }
 
@@ -4,48 +4,71 @@
 namespace vkrender
 {
 
-QueueFamilyIndices VulkanHelpers::findQueueFamilyIndices( const vk::PhysicalDevice& physicalDevice, vk::SurfaceKHR* pVkSurface )
+std::vector<QueueFamilyInfo> VulkanHelpers::queryQueueFamilies( const vk::PhysicalDevice& physicalDevice, vk::SurfaceKHR* pVkSurface )
 {
-	QueueFamilyIndices queueFamilyIndices;
-
 	std::vector<vk::QueueFamilyProperties> queueFamilyProperties = physicalDevice.getQueueFamilyProperties();
 
-	int validQueueIndex = 0;
+	std::vector<QueueFamilyInfo> queueFamilies( queueFamilyProperties.size() );
+	for( std::uint32_t familyIndex = 0u; familyIndex < queueFamilyProperties.size(); familyIndex++ )
+	{
+		const vk::QueueFamilyProperties& prop = queueFamilyProperties[familyIndex];
+
+		QueueFamilyInfo& queueFamily = queueFamilies[familyIndex];
+		queueFamily.m_index = familyIndex;
+		queueFamily.m_queueFlags = prop.queueFlags;
+		queueFamily.m_queueCount = prop.queueCount;
+		queueFamily.m_timestampValidBits = prop.timestampValidBits;
+		queueFamily.m_minImageTransferGranularity = prop.minImageTransferGranularity;
 
-	for (const auto& prop : queueFamilyProperties)
+		if( pVkSurface )
+			queueFamily.m_bPresentSupport = static_cast<bool>( physicalDevice.getSurfaceSupportKHR( familyIndex, *pVkSurface ) );
+	}
+
+	return queueFamilies;
+}
+
+QueueFamilyIndices VulkanHelpers::selectQueueFamilies( const std::vector<QueueFamilyInfo>& queueFamilies )
+{
+	QueueFamilyIndices queueFamilyIndices;
+
+	for( const QueueFamilyInfo& queueFamily : queueFamilies )
 	{
-		if (prop.queueFlags & vk::QueueFlagBits::eGraphics )
-		{
-			queueFamilyIndices.m_graphicsFamily = validQueueIndex;
-		}
+		const bool bGraphics = static_cast<bool>( queueFamily.m_queueFlags & vk::QueueFlagBits::eGraphics );
+		const bool bCompute = static_cast<bool>( queueFamily.m_queueFlags & vk::QueueFlagBits::eCompute );
+		const bool bTransfer = static_cast<bool>( queueFamily.m_queueFlags & vk::QueueFlagBits::eTransfer );
 
-		if( prop.queueFlags & vk::QueueFlagBits::eCompute )
+		// the first family listed for a capability is usually the most capable one
+		if( bGraphics && !queueFamilyIndices.m_graphicsFamily.has_value() )
 		{
-			queueFamilyIndices.m_computeFamily = validQueueIndex;
+			queueFamilyIndices.m_graphicsFamily = queueFamily.m_index;
+			queueFamilyIndices.m_graphicsQueueCount = queueFamily.m_queueCount;
 		}
 
-		if( 
-			prop.queueFlags & vk::QueueFlagBits::eTransfer && 
-			( !( prop.queueFlags & vk::QueueFlagBits::eGraphics ) && !( prop.queueFlags & vk::QueueFlagBits::eCompute ) )
-		)
-		{
-			queueFamilyIndices.m_exclusiveTransferFamily = validQueueIndex;
-		}
+		if( bCompute && !queueFamilyIndices.m_computeFamily.has_value() )
+			queueFamilyIndices.m_computeFamily = queueFamily.m_index;
 
-		if( pVkSurface )
-		{
-			vk::Bool32 bPresentationSupport = physicalDevice.getSurfaceSupportKHR( validQueueIndex, *pVkSurface );
-			if( bPresentationSupport )
-			{
-				queueFamilyIndices.m_presentFamily = validQueueIndex;					
-			}
-		}
-		validQueueIndex++;
+		if( bCompute && !bGraphics && !queueFamilyIndices.m_exclusiveComputeFamily.has_value() )
+			queueFamilyIndices.m_exclusiveComputeFamily = queueFamily.m_index;
+
+		if( bTransfer && !bGraphics && !bCompute && !queueFamilyIndices.m_exclusiveTransferFamily.has_value() )
+			queueFamilyIndices.m_exclusiveTransferFamily = queueFamily.m_index;
+
+		if( queueFamily.m_bPresentSupport && !queueFamilyIndices.m_presentFamily.has_value() )
+			queueFamilyIndices.m_presentFamily = queueFamily.m_index;
 	}
 
+	// presenting from the graphics family keeps swapchain images exclusive
+	if( queueFamilyIndices.m_graphicsFamily.has_value() && queueFamilies[ queueFamilyIndices.m_graphicsFamily.value() ].m_bPresentSupport )
+		queueFamilyIndices.m_presentFamily = queueFamilyIndices.m_graphicsFamily;
+
 	return queueFamilyIndices;
 }
 
+QueueFamilyIndices VulkanHelpers::findQueueFamilyIndices( const vk::PhysicalDevice& physicalDevice, vk::SurfaceKHR* pVkSurface )
+{
+	return selectQueueFamilies( queryQueueFamilies( physicalDevice, pVkSurface ) );
+}
+
 SwapChainSupportDetails VulkanHelpers::querySwapChainSupport( const vk::PhysicalDevice& vkPhysicalDevice, const vk::SurfaceKHR& vkSurface )
 {
     SwapChainSupportDetails swapChainDetails;
@@ -74,33 +97,42 @@ vk::SampleCountFlagBits VulkanHelpers::getMaxUsableSampleCount( const vk::Physic
 }
 
 std::uint32_t VulkanHelpers::findMemoryType(
-	const vk::PhysicalDevice& vkPhysicalDevice,
+	const vk::PhysicalDeviceMemoryProperties& vkMemoryProperties,
 	const std::uint32_t& typeFilter, const vk::MemoryPropertyFlags& propertyFlags
 )
 {
-	vk::PhysicalDeviceMemoryProperties memoryProps = vkPhysicalDevice.getMemoryProperties();
-
-	for( auto i = 0u; i < memoryProps.memoryTypeCount; i++ )
+	for( auto i = 0u; i < vkMemoryProperties.memoryTypeCount; i++ )
 	{
 		if( 
 			( typeFilter & ( 1u << i ) ) &&
-			( memoryProps.memoryTypes[i].propertyFlags & propertyFlags ) == propertyFlags 
+			( vkMemoryProperties.memoryTypes[i].propertyFlags & propertyFlags ) == propertyFlags 
 		)
 		{
 			return i;
 		}
 	}
 
-	// TODO throw exception
+	std::string errorMsg = fmt::format( "No memory type in bits {:#x} satisfies {}", typeFilter, vk::to_string( propertyFlags ) );
+	LOG_ERROR(errorMsg);
+	throw std::runtime_error(errorMsg);
+}
+
+std::uint32_t VulkanHelpers::findMemoryType(
+	const vk::PhysicalDevice& vkPhysicalDevice,
+	const std::uint32_t& typeFilter, const vk::MemoryPropertyFlags& propertyFlags
+)
+{
+	return findMemoryType( vkPhysicalDevice.getMemoryProperties(), typeFilter, propertyFlags );
 }
 
 void VulkanHelpers::createImage(
-	const vk::PhysicalDevice& vkPhysicalDevice, const vk::Device& vkLogicalDevice,
+	VulkanMemoryAllocator* pMemoryAllocator, const vk::Device& vkLogicalDevice,
     const std::uint32_t& width, const std::uint32_t& height, const std::uint32_t& mipmapLevels,
 	const vk::SampleCountFlagBits& numOfSamples,
     const vk::Format& format, const vk::ImageTiling& tiling,
     const vk::ImageUsageFlags& usageFlags, const vk::MemoryPropertyFlags& memPropFlags,
-    vk::Image& image, vk::DeviceMemory& imageMemory
+    vk::Image& image, VulkanAllocation& imageAllocation,
+    const std::string& owner
 )
 {
 	vk::ImageCreateInfo imageCreateInfo{};
@@ -121,14 +153,11 @@ void VulkanHelpers::createImage(
 	image = vkLogicalDevice.createImage( imageCreateInfo );
 
 	vk::MemoryRequirements memRequirements = vkLogicalDevice.getImageMemoryRequirements( image );
-	
-	vk::MemoryAllocateInfo allocInfo{};
-	allocInfo.allocationSize = memRequirements.size;
-	allocInfo.memoryTypeIndex = findMemoryType( vkPhysicalDevice, memRequirements.memoryTypeBits, memPropFlags );
 
-	imageMemory = vkLogicalDevice.allocateMemory( allocInfo );
+	VulkanMemoryAllocator::ResourceKind resourceKind = tiling == vk::ImageTiling::eOptimal ? VulkanMemoryAllocator::ResourceKind::eOptimal : VulkanMemoryAllocator::ResourceKind::eLinear;
+	imageAllocation = pMemoryAllocator->allocate( memRequirements, memPropFlags, resourceKind, owner.empty() ? "image" : owner );
 
-	vkLogicalDevice.bindImageMemory( image, imageMemory, 0 );
+	pMemoryAllocator->bindImageMemory( image, imageAllocation );
 }
 
 vk::ImageView VulkanHelpers::createImageView(
@@ -0,0 +1,554 @@
+#include "vkrender/VulkanMemoryAllocator.h"
+#include "vkrender/VulkanHelpers.h"
+#include "utilities/VulkanLogger.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace vkrender
+{
+
+VulkanDeviceMemoryCallbacks VulkanDeviceMemoryCallbacks::forDevice( vk::Device* pLogicalDevice )
+{
+    VulkanDeviceMemoryCallbacks memoryCallbacks{};
+    memoryCallbacks.m_allocate = [pLogicalDevice]( const vk::MemoryAllocateInfo& allocInfo ) { return pLogicalDevice->allocateMemory( allocInfo ); };
+    memoryCallbacks.m_free = [pLogicalDevice]( const vk::DeviceMemory& vkMemory ) { pLogicalDevice->freeMemory( vkMemory ); };
+    memoryCallbacks.m_map = [pLogicalDevice]( const vk::DeviceMemory& vkMemory ) { return pLogicalDevice->mapMemory( vkMemory, 0, VK_WHOLE_SIZE ); };
+    memoryCallbacks.m_unmap = [pLogicalDevice]( const vk::DeviceMemory& vkMemory ) { pLogicalDevice->unmapMemory( vkMemory ); };
+    return memoryCallbacks;
+}
+
+VulkanBuddyBlock::VulkanBuddyBlock( const vk::DeviceSize& blockSize, const vk::DeviceSize& minNodeSize )
+    :m_blockSize{ blockSize }
+    ,m_minNodeSize{ minNodeSize }
+    ,m_usedBytes{ 0 }
+    ,m_maxOrder{ 0 }
+{
+    while( nodeSize( m_maxOrder ) < m_blockSize )
+        m_maxOrder++;
+
+    m_freeNodes.resize( m_maxOrder + 1 );
+    m_freeNodes[m_maxOrder].insert( 0 );
+}
+
+std::uint32_t VulkanBuddyBlock::orderForSize( const vk::DeviceSize& size ) const
+{
+    std::uint32_t order = 0;
+    while( nodeSize( order ) < size )
+        order++;
+    return order;
+}
+
+std::optional<vk::DeviceSize> VulkanBuddyBlock::allocate( const vk::DeviceSize& size, const vk::DeviceSize& alignment )
+{
+    const std::uint32_t order = orderForSize( std::max( size, alignment ) );
+    if( order > m_maxOrder )
+        return std::nullopt;
+
+    std::uint32_t freeOrder = order;
+    while( freeOrder <= m_maxOrder && m_freeNodes[freeOrder].empty() )
+        freeOrder++;
+
+    if( freeOrder > m_maxOrder )
+        return std::nullopt;
+
+    vk::DeviceSize offset = *m_freeNodes[freeOrder].begin();
+    m_freeNodes[freeOrder].erase( m_freeNodes[freeOrder].begin() );
+
+    // split down, keeping the lower half and releasing the upper buddy
+    while( freeOrder > order )
+    {
+        freeOrder--;
+        m_freeNodes[freeOrder].insert( offset + nodeSize( freeOrder ) );
+    }
+
+    m_allocatedNodes.emplace( offset, order );
+    m_usedBytes += nodeSize( order );
+
+    return offset;
+}
+
+void VulkanBuddyBlock::free( const vk::DeviceSize& offset )
+{
+    auto nodeItr = m_allocatedNodes.find( offset );
+    if( nodeItr == m_allocatedNodes.end() )
+    {
+        std::string errorMsg = fmt::format( "Freeing unknown buddy node at offset {}", offset );
+        LOG_ERROR(errorMsg);
+        throw std::invalid_argument(errorMsg);
+    }
+
+    std::uint32_t order = nodeItr->second;
+    m_allocatedNodes.erase( nodeItr );
+    m_usedBytes -= nodeSize( order );
+
+    vk::DeviceSize nodeOffset = offset;
+    while( order < m_maxOrder )
+    {
+        const vk::DeviceSize buddyOffset = nodeOffset ^ nodeSize( order );
+        auto buddyItr = m_freeNodes[order].find( buddyOffset );
+        if( buddyItr == m_freeNodes[order].end() )
+            break;
+
+        m_freeNodes[order].erase( buddyItr );
+        nodeOffset = std::min( nodeOffset, buddyOffset );
+        order++;
+    }
+
+    m_freeNodes[order].insert( nodeOffset );
+}
+
+VulkanMemoryBlock::VulkanMemoryBlock(
+    const VulkanDeviceMemoryCallbacks* pMemoryCallbacks,
+    const std::uint32_t& memoryTypeIndex, const vk::DeviceSize& blockSize,
+    const bool& bHostVisible
+)
+    :m_pMemoryCallbacks{ pMemoryCallbacks }
+    ,m_memoryTypeIndex{ memoryTypeIndex }
+    ,m_pMapped{ nullptr }
+    ,m_buddy{ blockSize, VulkanMemoryAllocator::MIN_NODE_SIZE }
+{
+    vk::MemoryAllocateInfo allocInfo{};
+    allocInfo.allocationSize = blockSize;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    m_vkMemory = m_pMemoryCallbacks->m_allocate( allocInfo );
+
+    // host visible blocks stay mapped for their whole lifetime
+    if( bHostVisible )
+        m_pMapped = m_pMemoryCallbacks->m_map( m_vkMemory );
+}
+
+VulkanMemoryBlock::~VulkanMemoryBlock()
+{
+    if( m_pMapped )
+        m_pMemoryCallbacks->m_unmap( m_vkMemory );
+    m_pMemoryCallbacks->m_free( m_vkMemory );
+}
+
+std::optional<VulkanAllocation> VulkanMemoryBlock::allocate( const vk::DeviceSize& size, const vk::DeviceSize& alignment )
+{
+    std::optional<vk::DeviceSize> offset = m_buddy.allocate( size, alignment );
+    if( !offset.has_value() )
+        return std::nullopt;
+
+    VulkanAllocation allocation{};
+    allocation.m_vkMemory = m_vkMemory;
+    allocation.m_offset = offset.value();
+    allocation.m_size = size;
+    allocation.m_memoryTypeIndex = m_memoryTypeIndex;
+    allocation.m_pMapped = m_pMapped ? static_cast<std::uint8_t*>( m_pMapped ) + offset.value() : nullptr;
+    allocation.m_pBlock = this;
+
+    return allocation;
+}
+
+void VulkanMemoryBlock::free( const VulkanAllocation& allocation )
+{
+    m_buddy.free( allocation.m_offset );
+}
+
+VulkanMemoryAllocator::VulkanMemoryAllocator(
+    const VulkanDeviceCapabilities* pDeviceCapabilities, vk::Device* pLogicalDevice,
+    const vk::DeviceSize& preferredBlockSize,
+    const bool& bMemoryBudget
+)
+    :m_pDeviceCapabilities{ pDeviceCapabilities }
+    ,m_vkPhysicalDevice{ pDeviceCapabilities->physicalDevice() }
+    ,m_pLogicalDevice{ pLogicalDevice }
+    ,m_vkMemoryProperties{ pDeviceCapabilities->memoryProperties() }
+    ,m_memoryCallbacks{ VulkanDeviceMemoryCallbacks::forDevice( pLogicalDevice ) }
+    ,m_bMemoryBudget{ bMemoryBudget }
+    ,m_nextAllocationId{ 1 }
+{
+    initBlockSizes( preferredBlockSize );
+}
+
+VulkanMemoryAllocator::VulkanMemoryAllocator(
+    const vk::PhysicalDeviceMemoryProperties& memoryProperties,
+    const VulkanDeviceMemoryCallbacks& memoryCallbacks,
+    const vk::DeviceSize& preferredBlockSize
+)
+    :m_pDeviceCapabilities{ nullptr }
+    ,m_pLogicalDevice{ nullptr }
+    ,m_vkMemoryProperties{ memoryProperties }
+    ,m_memoryCallbacks{ memoryCallbacks }
+    ,m_bMemoryBudget{ false }
+    ,m_nextAllocationId{ 1 }
+{
+    initBlockSizes( preferredBlockSize );
+}
+
+std::uint32_t VulkanMemoryAllocator::findMemoryType( const std::uint32_t& memoryTypeBits, const VulkanMemoryUsage& memoryUsage ) const
+{
+    if( m_pDeviceCapabilities == nullptr )
+    {
+        std::string errorMsg = "Memory usage policies need the device capabilities, allocate with property flags instead";
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    return m_pDeviceCapabilities->findMemoryType( memoryTypeBits, memoryUsage );
+}
+
+void VulkanMemoryAllocator::initBlockSizes( const vk::DeviceSize& preferredBlockSize )
+{
+    m_blockPools.resize( m_vkMemoryProperties.memoryTypeCount * 2 );
+    m_blockSizes.resize( m_vkMemoryProperties.memoryTypeCount );
+
+    m_heapBudgets.resize( m_vkMemoryProperties.memoryHeapCount );
+    for( std::uint32_t i = 0u; i < m_vkMemoryProperties.memoryHeapCount; i++ )
+    {
+        m_heapBudgets[i].m_heapSize = m_vkMemoryProperties.memoryHeaps[i].size;
+        m_heapBudgets[i].m_heapFlags = m_vkMemoryProperties.memoryHeaps[i].flags;
+    }
+
+    for( std::uint32_t i = 0u; i < m_vkMemoryProperties.memoryTypeCount; i++ )
+    {
+        // small heaps ( e.g. the 256MB BAR window ) get blocks of at most an eighth of the heap
+        const vk::DeviceSize heapSize = m_vkMemoryProperties.memoryHeaps[ m_vkMemoryProperties.memoryTypes[i].heapIndex ].size;
+
+        vk::DeviceSize blockSize = preferredBlockSize;
+        while( blockSize > MIN_NODE_SIZE && blockSize > heapSize / 8 )
+            blockSize /= 2;
+
+        m_blockSizes[i] = blockSize;
+    }
+}
+
+VulkanMemoryAllocator::~VulkanMemoryAllocator()
+{
+    std::lock_guard<std::mutex> lock( m_allocatorMutex );
+
+    if( !m_liveAllocations.empty() )
+        LOG_DEBUG( fmt::format( "Memory Allocator destroyed with {} live allocations", m_liveAllocations.size() ) );
+
+    for( BlockArray& blockPool : m_blockPools )
+        blockPool.clear();
+    LOG_DEBUG("Memory Allocator Blocks Released");
+}
+
+bool VulkanMemoryAllocator::isBudgetSupported( const vk::PhysicalDevice& vkPhysicalDevice )
+{
+    for( const vk::ExtensionProperties& extensionProp : vkPhysicalDevice.enumerateDeviceExtensionProperties() )
+    {
+        if( std::strcmp( extensionProp.extensionName, BUDGET_EXTENSION_NAME ) == 0 )
+            return true;
+    }
+    return false;
+}
+
+VulkanAllocation VulkanMemoryAllocator::allocate(
+    const vk::MemoryRequirements& memRequirements,
+    const vk::MemoryPropertyFlags& memProps,
+    const ResourceKind& resourceKind,
+    const std::string& owner
+)
+{
+    const std::uint32_t memoryTypeIndex = VulkanHelpers::findMemoryType( m_vkMemoryProperties, memRequirements.memoryTypeBits, memProps );
+    return allocateFromType( memRequirements, memoryTypeIndex, resourceKind, owner );
+}
+
+VulkanAllocation VulkanMemoryAllocator::allocate(
+    const vk::MemoryRequirements& memRequirements,
+    const VulkanMemoryUsage& memoryUsage,
+    const ResourceKind& resourceKind,
+    const std::string& owner
+)
+{
+    const std::uint32_t memoryTypeIndex = findMemoryType( memRequirements.memoryTypeBits, memoryUsage );
+    return allocateFromType( memRequirements, memoryTypeIndex, resourceKind, owner );
+}
+
+VulkanAllocation VulkanMemoryAllocator::allocateFromType(
+    const vk::MemoryRequirements& memRequirements, const std::uint32_t& memoryTypeIndex,
+    const ResourceKind& resourceKind, const std::string& owner
+)
+{
+    const vk::DeviceSize blockSize = m_blockSizes[memoryTypeIndex];
+
+    // anything that would take more than half a block gets its own vk::DeviceMemory
+    if( std::max( memRequirements.size, memRequirements.alignment ) > blockSize / 2 )
+    {
+        VulkanAllocation allocation = allocateDedicated( memRequirements.size, memoryTypeIndex );
+
+        std::lock_guard<std::mutex> lock( m_allocatorMutex );
+        trackAllocation( allocation, owner, true );
+        return allocation;
+    }
+
+    std::lock_guard<std::mutex> lock( m_allocatorMutex );
+
+    BlockArray& blockPool = m_blockPools[ poolIndex( memoryTypeIndex, resourceKind ) ];
+    for( utils::Uptr<VulkanMemoryBlock>& pBlock : blockPool )
+    {
+        std::optional<VulkanAllocation> allocation = pBlock->allocate( memRequirements.size, memRequirements.alignment );
+        if( allocation.has_value() )
+        {
+            trackAllocation( allocation.value(), owner, false );
+            return allocation.value();
+        }
+    }
+
+    blockPool.push_back( std::make_unique<VulkanMemoryBlock>(
+        &m_memoryCallbacks, memoryTypeIndex, blockSize, isHostVisible( memoryTypeIndex )
+    ) );
+    LOG_DEBUG( fmt::format( "Allocated {} byte memory block for memory type {}", blockSize, memoryTypeIndex ) );
+
+    HeapBudget& heapBudget = m_heapBudgets[ heapIndex( memoryTypeIndex ) ];
+    heapBudget.m_reservedBytes += blockSize;
+    heapBudget.m_blockCount++;
+
+    VulkanAllocation allocation = blockPool.back()->allocate( memRequirements.size, memRequirements.alignment ).value();
+    trackAllocation( allocation, owner, false );
+    return allocation;
+}
+
+void VulkanMemoryAllocator::free( VulkanAllocation& allocation )
+{
+    if( !allocation.m_vkMemory )
+        return;
+
+    if( allocation.m_pBlock == nullptr )
+    {
+        if( allocation.m_pMapped )
+            m_memoryCallbacks.m_unmap( allocation.m_vkMemory );
+        m_memoryCallbacks.m_free( allocation.m_vkMemory );
+
+        std::lock_guard<std::mutex> lock( m_allocatorMutex );
+        HeapBudget& heapBudget = m_heapBudgets[ heapIndex( allocation.m_memoryTypeIndex ) ];
+        heapBudget.m_reservedBytes -= allocation.m_size;
+        heapBudget.m_dedicatedCount--;
+        untrackAllocation( allocation );
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock( m_allocatorMutex );
+        allocation.m_pBlock->free( allocation );
+        untrackAllocation( allocation );
+
+        if( allocation.m_pBlock->isEmpty() )
+            releaseEmptyBlock( allocation.m_pBlock, allocation.m_memoryTypeIndex );
+    }
+
+    allocation = VulkanAllocation{};
+}
+
+void VulkanMemoryAllocator::setOwner( const VulkanAllocation& allocation, const std::string& owner )
+{
+    std::lock_guard<std::mutex> lock( m_allocatorMutex );
+
+    auto allocationItr = m_liveAllocations.find( allocation.m_allocationId );
+    if( allocationItr != m_liveAllocations.end() )
+        allocationItr->second.m_owner = owner;
+}
+
+void VulkanMemoryAllocator::bindBufferMemory( const vk::Buffer& buffer, const VulkanAllocation& allocation )
+{
+    m_pLogicalDevice->bindBufferMemory( buffer, allocation.m_vkMemory, allocation.m_offset );
+}
+
+void VulkanMemoryAllocator::bindImageMemory( const vk::Image& image, const VulkanAllocation& allocation )
+{
+    m_pLogicalDevice->bindImageMemory( image, allocation.m_vkMemory, allocation.m_offset );
+}
+
+std::size_t VulkanMemoryAllocator::blockCount() const
+{
+    std::lock_guard<std::mutex> lock( m_allocatorMutex );
+
+    std::size_t numOfBlocks = 0;
+    for( const BlockArray& blockPool : m_blockPools )
+        numOfBlocks += blockPool.size();
+    return numOfBlocks;
+}
+
+VulkanMemoryAllocator::Snapshot VulkanMemoryAllocator::snapshot() const
+{
+    Snapshot snapshot{};
+    snapshot.m_bDriverBudget = m_bMemoryBudget;
+    snapshot.m_heaps = queryHeapBudgets();
+    return snapshot;
+}
+
+bool VulkanMemoryAllocator::fitsBudget( const vk::MemoryRequirements& memRequirements, const VulkanMemoryUsage& memoryUsage ) const
+{
+    const std::uint32_t memoryTypeIndex = findMemoryType( memRequirements.memoryTypeBits, memoryUsage );
+    const HeapBudget heapBudget = queryHeapBudgets()[ heapIndex( memoryTypeIndex ) ];
+
+    return heapBudget.m_usage + memRequirements.size <= heapBudget.m_budget;
+}
+
+std::string VulkanMemoryAllocator::dumpJson() const
+{
+    auto l_escape = []( const std::string& text ) {
+        std::string escaped;
+        escaped.reserve( text.size() );
+        for( const char character : text )
+        {
+            if( character == '"' || character == '\\' )
+            {
+                escaped.push_back( '\\' );
+                escaped.push_back( character );
+            }
+            else if( static_cast<unsigned char>( character ) < 0x20 )
+            {
+                escaped += fmt::format( "\\u{:04x}", static_cast<unsigned int>( character ) );
+            }
+            else
+            {
+                escaped.push_back( character );
+            }
+        }
+        return escaped;
+    };
+
+    const std::vector<HeapBudget> heapBudgets = queryHeapBudgets();
+
+    std::string json = fmt::format( "{{\"driverBudget\":{},\"heaps\":[", m_bMemoryBudget ? "true" : "false" );
+    for( std::size_t i = 0; i < heapBudgets.size(); i++ )
+    {
+        const HeapBudget& heapBudget = heapBudgets[i];
+        json += fmt::format(
+            "{}{{\"index\":{},\"deviceLocal\":{},\"size\":{},\"budget\":{},\"usage\":{},\"reserved\":{},\"allocated\":{},\"allocations\":{},\"blocks\":{},\"dedicated\":{}}}",
+            i == 0 ? "" : ",", i,
+            ( heapBudget.m_heapFlags & vk::MemoryHeapFlagBits::eDeviceLocal ) ? "true" : "false",
+            heapBudget.m_heapSize, heapBudget.m_budget, heapBudget.m_usage,
+            heapBudget.m_reservedBytes, heapBudget.m_allocatedBytes, heapBudget.m_allocationCount,
+            heapBudget.m_blockCount, heapBudget.m_dedicatedCount
+        );
+    }
+    json += "],\"allocations\":[";
+
+    std::lock_guard<std::mutex> lock( m_allocatorMutex );
+
+    // sorted by id so consecutive dumps diff cleanly
+    std::map<std::uint64_t, const LiveAllocation*> sortedAllocations;
+    for( const auto& [allocationId, liveAllocation] : m_liveAllocations )
+        sortedAllocations.emplace( allocationId, &liveAllocation );
+
+    bool bFirst = true;
+    for( const auto& [allocationId, pLiveAllocation] : sortedAllocations )
+    {
+        json += fmt::format(
+            "{}{{\"id\":{},\"owner\":\"{}\",\"size\":{},\"memoryType\":{},\"heap\":{},\"dedicated\":{}}}",
+            bFirst ? "" : ",", allocationId, l_escape( pLiveAllocation->m_owner ), pLiveAllocation->m_size,
+            pLiveAllocation->m_memoryTypeIndex, heapIndex( pLiveAllocation->m_memoryTypeIndex ),
+            pLiveAllocation->m_bDedicated ? "true" : "false"
+        );
+        bFirst = false;
+    }
+    json += "]}";
+
+    return json;
+}
+
+VulkanAllocation VulkanMemoryAllocator::allocateDedicated( const vk::DeviceSize& size, const std::uint32_t& memoryTypeIndex )
+{
+    vk::MemoryAllocateInfo allocInfo{};
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    VulkanAllocation allocation{};
+    allocation.m_vkMemory = m_memoryCallbacks.m_allocate( allocInfo );
+    allocation.m_offset = 0;
+    allocation.m_size = size;
+    allocation.m_memoryTypeIndex = memoryTypeIndex;
+    allocation.m_pBlock = nullptr;
+    if( isHostVisible( memoryTypeIndex ) )
+        allocation.m_pMapped = m_memoryCallbacks.m_map( allocation.m_vkMemory );
+
+    return allocation;
+}
+
+void VulkanMemoryAllocator::releaseEmptyBlock( VulkanMemoryBlock* pEmptyBlock, const std::uint32_t& memoryTypeIndex )
+{
+    for( const ResourceKind resourceKind : { ResourceKind::eLinear, ResourceKind::eOptimal } )
+    {
+        BlockArray& blockPool = m_blockPools[ poolIndex( memoryTypeIndex, resourceKind ) ];
+        auto blockItr = std::find_if( blockPool.begin(), blockPool.end(), [pEmptyBlock]( const utils::Uptr<VulkanMemoryBlock>& pBlock ){ return pBlock.get() == pEmptyBlock; } );
+        if( blockItr == blockPool.end() )
+            continue;
+
+        // one empty block stays as a spare so a pool hovering around a block boundary does not thrash
+        const bool bOtherEmptyBlock = std::any_of( blockPool.begin(), blockPool.end(), [pEmptyBlock]( const utils::Uptr<VulkanMemoryBlock>& pBlock ){ return pBlock.get() != pEmptyBlock && pBlock->isEmpty(); } );
+        if( !bOtherEmptyBlock )
+            return;
+
+        HeapBudget& heapBudget = m_heapBudgets[ heapIndex( memoryTypeIndex ) ];
+        heapBudget.m_reservedBytes -= pEmptyBlock->buddy().blockSize();
+        heapBudget.m_blockCount--;
+
+        blockPool.erase( blockItr );
+        LOG_DEBUG( fmt::format( "Released empty memory block of memory type {}, {} blocks left in its pool", memoryTypeIndex, blockPool.size() ) );
+        return;
+    }
+}
+
+std::size_t VulkanMemoryAllocator::poolIndex( const std::uint32_t& memoryTypeIndex, const ResourceKind& resourceKind ) const
+{
+    return static_cast<std::size_t>( memoryTypeIndex ) * 2 + static_cast<std::size_t>( resourceKind );
+}
+
+bool VulkanMemoryAllocator::isHostVisible( const std::uint32_t& memoryTypeIndex ) const
+{
+    return static_cast<bool>( m_vkMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible );
+}
+
+void VulkanMemoryAllocator::trackAllocation( VulkanAllocation& allocation, const std::string& owner, const bool& bDedicated )
+{
+    allocation.m_allocationId = m_nextAllocationId++;
+    m_liveAllocations.emplace( allocation.m_allocationId, LiveAllocation{ owner, allocation.m_size, allocation.m_memoryTypeIndex, bDedicated } );
+
+    HeapBudget& heapBudget = m_heapBudgets[ heapIndex( allocation.m_memoryTypeIndex ) ];
+    heapBudget.m_allocatedBytes += allocation.m_size;
+    heapBudget.m_allocationCount++;
+    if( bDedicated )
+    {
+        heapBudget.m_reservedBytes += allocation.m_size;
+        heapBudget.m_dedicatedCount++;
+    }
+}
+
+void VulkanMemoryAllocator::untrackAllocation( const VulkanAllocation& allocation )
+{
+    m_liveAllocations.erase( allocation.m_allocationId );
+
+    HeapBudget& heapBudget = m_heapBudgets[ heapIndex( allocation.m_memoryTypeIndex ) ];
+    heapBudget.m_allocatedBytes -= allocation.m_size;
+    heapBudget.m_allocationCount--;
+}
+
+std::vector<VulkanMemoryAllocator::HeapBudget> VulkanMemoryAllocator::queryHeapBudgets() const
+{
+    std::vector<HeapBudget> heapBudgets;
+    {
+        std::lock_guard<std::mutex> lock( m_allocatorMutex );
+        heapBudgets = m_heapBudgets;
+    }
+
+    if( m_bMemoryBudget )
+    {
+        auto memoryPropertiesChain = m_vkPhysicalDevice.getMemoryProperties2<vk::PhysicalDeviceMemoryProperties2, vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+        const vk::PhysicalDeviceMemoryBudgetPropertiesEXT& budgetProperties = memoryPropertiesChain.get<vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+
+        for( std::size_t i = 0; i < heapBudgets.size(); i++ )
+        {
+            heapBudgets[i].m_usage = budgetProperties.heapUsage[i];
+            heapBudgets[i].m_budget = budgetProperties.heapBudget[i];
+        }
+    }
+    else
+    {
+        // without the extension only our own memory is known, other processes are assumed to leave a fifth of the heap
+        for( HeapBudget& heapBudget : heapBudgets )
+        {
+            heapBudget.m_usage = heapBudget.m_reservedBytes;
+            heapBudget.m_budget = heapBudget.m_heapSize / 5 * 4;
+        }
+    }
+
+    return heapBudgets;
+}
+
+} // namespace vkrender
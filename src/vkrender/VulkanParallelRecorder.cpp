@@ -0,0 +1,148 @@
+#include "vkrender/VulkanParallelRecorder.h"
+#include "vkrender/VulkanRenderer.h"
+#include "vkrender/VulkanHelpers.h"
+#include "utilities/VulkanLogger.h"
+
+#include <algorithm>
+#include <exception>
+#include <future>
+
+namespace vkrender
+{
+
+VulkanParallelRecorder::VulkanParallelRecorder(
+    VulkanRenderer* pVkRenderer, utils::ThreadPool* pThreadPool,
+    const std::uint32_t& framesInFlight,
+    const std::uint32_t& minDrawsPerSlice
+)
+    :m_pLogicalDevice{ pVkRenderer->getDevice() }
+    ,m_pThreadPool{ pThreadPool }
+    ,m_numOfSlices{ pThreadPool->workerCount() + 1u }
+    ,m_minDrawsPerSlice{ std::max( minDrawsPerSlice, 1u ) }
+{
+    const QueueFamilyIndices& queueFamilyIndices = pVkRenderer->getDeviceCapabilities()->queueFamilyIndices();
+
+    vk::CommandPoolCreateInfo commandPoolInfo{};
+    commandPoolInfo.flags = vk::CommandPoolCreateFlagBits::eTransient;
+    commandPoolInfo.queueFamilyIndex = queueFamilyIndices.m_graphicsFamily.value();
+
+    m_frameSlots.resize( framesInFlight );
+    for( FrameSlot& frameSlot : m_frameSlots )
+    {
+        frameSlot.m_slices.resize( m_numOfSlices );
+        for( SliceContext& slice : frameSlot.m_slices )
+            slice.m_vkCommandPool = m_pLogicalDevice->createCommandPool( commandPoolInfo );
+    }
+
+    LOG_INFO( fmt::format( "Parallel Recorder created with {} slices per frame", m_numOfSlices ) );
+}
+
+VulkanParallelRecorder::~VulkanParallelRecorder()
+{
+    for( FrameSlot& frameSlot : m_frameSlots )
+    {
+        for( SliceContext& slice : frameSlot.m_slices )
+            m_pLogicalDevice->destroyCommandPool( slice.m_vkCommandPool );
+    }
+}
+
+void VulkanParallelRecorder::record(
+    VulkanFrameContext* pFrame,
+    vk::CommandBuffer& primaryCmdBuffer,
+    const vk::CommandBufferInheritanceInfo& inheritanceInfo,
+    const std::uint32_t& drawCount,
+    const SliceRecorder& sliceRecorder
+)
+{
+    if( drawCount == 0 )
+        return;
+
+    FrameSlot& frameSlot = acquireFrameSlot( pFrame );
+
+    // small lists are not worth waking the workers for
+    const std::uint32_t numOfSlices = std::min( m_numOfSlices, ( drawCount + m_minDrawsPerSlice - 1 ) / m_minDrawsPerSlice );
+    const std::uint32_t drawsPerSlice = ( drawCount + numOfSlices - 1 ) / numOfSlices;
+
+    std::vector<vk::CommandBuffer> secondaryCmdBuffers( numOfSlices );
+
+    auto l_recordSlice = [&]( const std::uint32_t& sliceIndex )
+    {
+        const std::uint32_t firstDraw = sliceIndex * drawsPerSlice;
+        const std::uint32_t lastDraw = std::min( firstDraw + drawsPerSlice, drawCount );
+
+        vk::CommandBuffer cmdBuffer = nextCmdBuffer( frameSlot.m_slices[sliceIndex] );
+
+        vk::CommandBufferBeginInfo beginInfo{};
+        beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+        cmdBuffer.begin( beginInfo );
+        if( firstDraw < lastDraw )
+            sliceRecorder( cmdBuffer, firstDraw, lastDraw );
+        cmdBuffer.end();
+
+        secondaryCmdBuffers[sliceIndex] = cmdBuffer;
+    };
+
+    std::vector<std::future<void>> sliceJobs;
+    sliceJobs.reserve( numOfSlices - 1 );
+    for( std::uint32_t i = 1u; i < numOfSlices; i++ )
+        sliceJobs.push_back( m_pThreadPool->submit( [&l_recordSlice, i](){ l_recordSlice( i ); }, utils::JobPriority::eHigh ) );
+
+    // the calling thread records the first slice instead of idling
+    std::exception_ptr pFirstSliceError;
+    try
+    {
+        l_recordSlice( 0 );
+    }
+    catch( ... )
+    {
+        pFirstSliceError = std::current_exception();
+    }
+
+    // every job has to finish before an exception leaves this scope, they reference locals
+    for( std::future<void>& sliceJob : sliceJobs )
+        sliceJob.wait();
+
+    if( pFirstSliceError )
+        std::rethrow_exception( pFirstSliceError );
+    for( std::future<void>& sliceJob : sliceJobs )
+        sliceJob.get();
+
+    primaryCmdBuffer.executeCommands( secondaryCmdBuffers );
+}
+
+VulkanParallelRecorder::FrameSlot& VulkanParallelRecorder::acquireFrameSlot( VulkanFrameContext* pFrame )
+{
+    FrameSlot& frameSlot = m_frameSlots[ pFrame->m_frameNumber % m_frameSlots.size() ];
+
+    // first use in this frame, the frame fence guarantees the GPU is done with the previous contents
+    if( frameSlot.m_frameNumber != pFrame->m_frameNumber )
+    {
+        for( SliceContext& slice : frameSlot.m_slices )
+        {
+            m_pLogicalDevice->resetCommandPool( slice.m_vkCommandPool );
+            slice.m_usedCmdBuffers = 0;
+        }
+        frameSlot.m_frameNumber = pFrame->m_frameNumber;
+    }
+
+    return frameSlot;
+}
+
+vk::CommandBuffer VulkanParallelRecorder::nextCmdBuffer( SliceContext& slice )
+{
+    if( slice.m_usedCmdBuffers == slice.m_vkCmdBuffers.size() )
+    {
+        vk::CommandBufferAllocateInfo allocInfo{};
+        allocInfo.commandPool = slice.m_vkCommandPool;
+        allocInfo.level = vk::CommandBufferLevel::eSecondary;
+        allocInfo.commandBufferCount = 1;
+
+        slice.m_vkCmdBuffers.push_back( m_pLogicalDevice->allocateCommandBuffers( allocInfo )[0] );
+    }
+
+    return slice.m_vkCmdBuffers[ slice.m_usedCmdBuffers++ ];
+}
+
+} // namespace vkrender
@@ -0,0 +1,244 @@
+#include "vkrender/VulkanPipelineCache.h"
+#include "utilities/VulkanLogger.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+namespace vkrender
+{
+
+VulkanPipelineCache::VulkanPipelineCache(
+    const vk::PhysicalDevice& vkPhysicalDevice, vk::Device* pLogicalDevice,
+    const bool& bCreationFeedback,
+    const std::filesystem::path& cacheFilePath
+)
+    :m_vkPhysicalDevice{ vkPhysicalDevice }
+    ,m_pLogicalDevice{ pLogicalDevice }
+    ,m_cacheFilePath{ cacheFilePath }
+    ,m_bCreationFeedback{ bCreationFeedback }
+{
+    std::vector<char> cacheData = loadCacheData();
+
+    vk::PipelineCacheCreateInfo pipelineCacheInfo{};
+    pipelineCacheInfo.initialDataSize = cacheData.size();
+    pipelineCacheInfo.pInitialData = cacheData.empty() ? nullptr : cacheData.data();
+
+    m_vkPipelineCache = m_pLogicalDevice->createPipelineCache( pipelineCacheInfo );
+
+    LOG_INFO( fmt::format( "Pipeline Cache created with {} bytes from {}", cacheData.size(), m_cacheFilePath.string() ) );
+}
+
+VulkanPipelineCache::~VulkanPipelineCache()
+{
+    logStatistics();
+    save();
+
+    m_pLogicalDevice->destroyPipelineCache( m_vkPipelineCache );
+}
+
+bool VulkanPipelineCache::isFeedbackCore( const vk::PhysicalDevice& vkPhysicalDevice )
+{
+    return vkPhysicalDevice.getProperties().apiVersion >= VK_API_VERSION_1_3;
+}
+
+bool VulkanPipelineCache::isFeedbackSupported( const vk::PhysicalDevice& vkPhysicalDevice )
+{
+    if( isFeedbackCore( vkPhysicalDevice ) )
+        return true;
+
+    for( const vk::ExtensionProperties& extensionProp : vkPhysicalDevice.enumerateDeviceExtensionProperties() )
+    {
+        if( std::strcmp( extensionProp.extensionName, FEEDBACK_EXTENSION_NAME ) == 0 )
+            return true;
+    }
+    return false;
+}
+
+vk::Pipeline VulkanPipelineCache::createGraphicsPipeline( const vk::GraphicsPipelineCreateInfo& gfxPipelineCreateInfo )
+{
+    vk::PipelineCreationFeedback pipelineFeedback{};
+
+    vk::PipelineCreationFeedbackCreateInfo feedbackInfo{};
+    feedbackInfo.pPipelineCreationFeedback = &pipelineFeedback;
+    feedbackInfo.pipelineStageCreationFeedbackCount = 0;
+    feedbackInfo.pNext = gfxPipelineCreateInfo.pNext;
+
+    vk::GraphicsPipelineCreateInfo createInfo = gfxPipelineCreateInfo;
+    if( m_bCreationFeedback )
+        createInfo.pNext = &feedbackInfo;
+
+    const auto creationBegin = std::chrono::steady_clock::now();
+    vk::ResultValue<vk::Pipeline> operationResult = m_pLogicalDevice->createGraphicsPipeline( m_vkPipelineCache, createInfo );
+    const double creationTimeMs = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - creationBegin ).count();
+
+    if( operationResult.result != vk::Result::eSuccess )
+    {
+        std::string errorMsg = fmt::format( "Failed to create Graphics Pipeline: {}", vk::to_string( operationResult.result ) );
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    recordFeedback( m_bCreationFeedback ? &pipelineFeedback : nullptr, creationTimeMs );
+
+    return operationResult.value;
+}
+
+vk::Pipeline VulkanPipelineCache::createComputePipeline( const vk::ComputePipelineCreateInfo& computePipelineCreateInfo )
+{
+    vk::PipelineCreationFeedback pipelineFeedback{};
+
+    vk::PipelineCreationFeedbackCreateInfo feedbackInfo{};
+    feedbackInfo.pPipelineCreationFeedback = &pipelineFeedback;
+    feedbackInfo.pipelineStageCreationFeedbackCount = 0;
+    feedbackInfo.pNext = computePipelineCreateInfo.pNext;
+
+    vk::ComputePipelineCreateInfo createInfo = computePipelineCreateInfo;
+    if( m_bCreationFeedback )
+        createInfo.pNext = &feedbackInfo;
+
+    const auto creationBegin = std::chrono::steady_clock::now();
+    vk::ResultValue<vk::Pipeline> operationResult = m_pLogicalDevice->createComputePipeline( m_vkPipelineCache, createInfo );
+    const double creationTimeMs = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - creationBegin ).count();
+
+    if( operationResult.result != vk::Result::eSuccess )
+    {
+        std::string errorMsg = fmt::format( "Failed to create Compute Pipeline: {}", vk::to_string( operationResult.result ) );
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    recordFeedback( m_bCreationFeedback ? &pipelineFeedback : nullptr, creationTimeMs );
+
+    return operationResult.value;
+}
+
+void VulkanPipelineCache::save()
+{
+    std::vector<std::uint8_t> cacheData = m_pLogicalDevice->getPipelineCacheData( m_vkPipelineCache );
+    if( cacheData.empty() )
+        return;
+
+    std::filesystem::path tempFilePath = m_cacheFilePath;
+    tempFilePath += ".tmp";
+
+    {
+        std::ofstream fstream( tempFilePath, std::ios::binary | std::ios::trunc );
+        fstream.write( reinterpret_cast<const char*>( cacheData.data() ), static_cast<std::streamsize>( cacheData.size() ) );
+        fstream.flush();
+
+        if( !fstream.good() )
+        {
+            LOG_ERROR( fmt::format( "Failed to write Pipeline Cache to {}", tempFilePath.string() ) );
+            std::error_code removeError;
+            std::filesystem::remove( tempFilePath, removeError );
+            return;
+        }
+    }
+
+    std::error_code renameError;
+    std::filesystem::rename( tempFilePath, m_cacheFilePath, renameError );
+    if( renameError )
+    {
+        LOG_ERROR( fmt::format( "Failed to replace Pipeline Cache {}: {}", m_cacheFilePath.string(), renameError.message() ) );
+        std::filesystem::remove( tempFilePath, renameError );
+        return;
+    }
+
+    LOG_INFO( fmt::format( "Pipeline Cache saved {} bytes to {}", cacheData.size(), m_cacheFilePath.string() ) );
+}
+
+void VulkanPipelineCache::logStatistics() const
+{
+    Statistics cacheStatistics = statistics();
+
+    LOG_INFO( fmt::format(
+        "Pipeline Cache hits: {} ( {:.3f}ms ) misses: {} ( {:.3f}ms ) unknown: {} ( {:.3f}ms )",
+        cacheStatistics.m_hitCount, cacheStatistics.m_hitTimeMs,
+        cacheStatistics.m_missCount, cacheStatistics.m_missTimeMs,
+        cacheStatistics.m_unknownCount, cacheStatistics.m_unknownTimeMs
+    ) );
+}
+
+VulkanPipelineCache::Statistics VulkanPipelineCache::statistics() const
+{
+    std::lock_guard<std::mutex> lock( m_statisticsMutex );
+    return m_statistics;
+}
+
+std::vector<char> VulkanPipelineCache::loadCacheData()
+{
+    std::vector<char> cacheData;
+
+    std::error_code fileError;
+    if( !std::filesystem::exists( m_cacheFilePath, fileError ) )
+        return cacheData;
+
+    std::ifstream fstream( m_cacheFilePath, std::ios::ate | std::ios::binary );
+    if( !fstream.is_open() )
+        return cacheData;
+
+    const std::size_t fileSize = static_cast<std::size_t>( fstream.tellg() );
+    cacheData.resize( fileSize );
+
+    fstream.seekg(0);
+    fstream.read( cacheData.data(), fileSize );
+
+    if( !fstream.good() || !isCacheDataCompatible( cacheData ) )
+    {
+        LOG_INFO( fmt::format( "Discarding incompatible Pipeline Cache {}", m_cacheFilePath.string() ) );
+        cacheData.clear();
+    }
+
+    return cacheData;
+}
+
+bool VulkanPipelineCache::isCacheDataCompatible( const std::vector<char>& cacheData ) const
+{
+    // layout of VkPipelineCacheHeaderVersionOne
+    struct CacheHeader
+    {
+        std::uint32_t m_headerSize;
+        std::uint32_t m_headerVersion;
+        std::uint32_t m_vendorID;
+        std::uint32_t m_deviceID;
+        std::uint8_t m_pipelineCacheUUID[VK_UUID_SIZE];
+    };
+
+    if( cacheData.size() < sizeof( CacheHeader ) )
+        return false;
+
+    CacheHeader cacheHeader{};
+    std::memcpy( &cacheHeader, cacheData.data(), sizeof( CacheHeader ) );
+
+    const vk::PhysicalDeviceProperties deviceProperties = m_vkPhysicalDevice.getProperties();
+
+    return cacheHeader.m_headerSize >= sizeof( CacheHeader ) &&
+        cacheHeader.m_headerVersion == static_cast<std::uint32_t>( vk::PipelineCacheHeaderVersion::eOne ) &&
+        cacheHeader.m_vendorID == deviceProperties.vendorID &&
+        cacheHeader.m_deviceID == deviceProperties.deviceID &&
+        std::memcmp( cacheHeader.m_pipelineCacheUUID, deviceProperties.pipelineCacheUUID.data(), VK_UUID_SIZE ) == 0;
+}
+
+void VulkanPipelineCache::recordFeedback( const vk::PipelineCreationFeedback* pPipelineFeedback, const double& creationTimeMs )
+{
+    std::lock_guard<std::mutex> lock( m_statisticsMutex );
+
+    if( pPipelineFeedback == nullptr || !( pPipelineFeedback->flags & vk::PipelineCreationFeedbackFlagBits::eValid ) )
+    {
+        m_statistics.m_unknownCount++;
+        m_statistics.m_unknownTimeMs += creationTimeMs;
+    }
+    else if( pPipelineFeedback->flags & vk::PipelineCreationFeedbackFlagBits::eApplicationPipelineCacheHit )
+    {
+        m_statistics.m_hitCount++;
+        m_statistics.m_hitTimeMs += creationTimeMs;
+    }
+    else
+    {
+        m_statistics.m_missCount++;
+        m_statistics.m_missTimeMs += creationTimeMs;
+    }
+}
+
+} // namespace vkrender
@@ -0,0 +1,104 @@
+#include "vkrender/VulkanPipelineCompiler.h"
+#include "utilities/VulkanLogger.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace vkrender
+{
+
+bool VulkanPipelineHandle::isReady() const
+{
+    return m_pipelineFuture.valid() && m_pipelineFuture.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready;
+}
+
+VulkanPipelineCompiler::VulkanPipelineCompiler( VulkanPipelineCache* pPipelineCache, utils::ThreadPool* pThreadPool )
+    :m_pPipelineCache{ pPipelineCache }
+    ,m_pThreadPool{ pThreadPool }
+{}
+
+VulkanPipelineCompiler::~VulkanPipelineCompiler()
+{
+    waitIdle();
+}
+
+VulkanPipelineHandle VulkanPipelineCompiler::compile( const CompileRequest& compileRequest )
+{
+    if( compileRequest.m_pGfxPipeline == nullptr || compileRequest.m_pRenderPass == nullptr )
+    {
+        std::string errorMsg = "Pipeline compile request without a pipeline or render pass";
+        LOG_ERROR(errorMsg);
+        throw std::invalid_argument(errorMsg);
+    }
+
+    VulkanGfxPipeline* pGfxPipeline = compileRequest.m_pGfxPipeline;
+    if( pGfxPipeline->m_pPipelineCache == nullptr )
+        pGfxPipeline->m_pPipelineCache = m_pPipelineCache;
+
+    std::shared_future<vk::Pipeline> pipelineFuture = m_pThreadPool->submit(
+        [pGfxPipeline, pRenderPass = compileRequest.m_pRenderPass, subpassIndex = compileRequest.m_subpassIndex]()
+        {
+            pGfxPipeline->createGfxPipeline( pRenderPass, subpassIndex );
+            return pGfxPipeline->handle();
+        },
+        compileRequest.m_priority
+    ).share();
+
+    std::lock_guard<std::mutex> lock( m_compilerMutex );
+    prunePendingCompiles();
+    m_pendingCompiles.push_back( pipelineFuture );
+
+    return VulkanPipelineHandle{ pipelineFuture };
+}
+
+std::vector<VulkanPipelineHandle> VulkanPipelineCompiler::compileBatch( const std::vector<CompileRequest>& compileRequests )
+{
+    // queue the urgent requests first, workers pick them up before the rest of the batch is even submitted
+    std::vector<std::size_t> submitOrder( compileRequests.size() );
+    for( std::size_t i = 0; i < submitOrder.size(); i++ )
+        submitOrder[i] = i;
+
+    std::stable_sort( submitOrder.begin(), submitOrder.end(), [&compileRequests]( const std::size_t& lhs, const std::size_t& rhs ){
+        return compileRequests[lhs].m_priority < compileRequests[rhs].m_priority;
+    } );
+
+    std::vector<VulkanPipelineHandle> pipelineHandles( compileRequests.size() );
+    for( const std::size_t& requestIndex : submitOrder )
+        pipelineHandles[requestIndex] = compile( compileRequests[requestIndex] );
+
+    LOG_INFO( fmt::format( "Queued {} pipelines for compilation on {} workers", compileRequests.size(), m_pThreadPool->workerCount() ) );
+
+    return pipelineHandles;
+}
+
+void VulkanPipelineCompiler::waitIdle()
+{
+    std::vector<std::shared_future<vk::Pipeline>> pendingCompiles;
+    {
+        std::lock_guard<std::mutex> lock( m_compilerMutex );
+        pendingCompiles.swap( m_pendingCompiles );
+    }
+
+    // failures are reported through the handles, waiting must not throw
+    for( const std::shared_future<vk::Pipeline>& pipelineFuture : pendingCompiles )
+        pipelineFuture.wait();
+}
+
+std::size_t VulkanPipelineCompiler::pendingCount()
+{
+    std::lock_guard<std::mutex> lock( m_compilerMutex );
+    prunePendingCompiles();
+    return m_pendingCompiles.size();
+}
+
+void VulkanPipelineCompiler::prunePendingCompiles()
+{
+    m_pendingCompiles.erase(
+        std::remove_if( m_pendingCompiles.begin(), m_pendingCompiles.end(), []( const std::shared_future<vk::Pipeline>& pipelineFuture ){
+            return pipelineFuture.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready;
+        } ),
+        m_pendingCompiles.end()
+    );
+}
+
+} // namespace vkrender
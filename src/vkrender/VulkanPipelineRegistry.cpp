@@ -0,0 +1,94 @@
+#include "vkrender/VulkanPipelineRegistry.h"
+#include "utilities/VulkanLogger.h"
+
+namespace vkrender
+{
+
+VulkanPipelineRegistry::VulkanPipelineRegistry( VulkanPipelineCache* pPipelineCache )
+    :m_pPipelineCache{ pPipelineCache }
+{}
+
+VulkanPipelineRegistry::~VulkanPipelineRegistry()
+{
+    LOG_DEBUG( fmt::format(
+        "Pipeline Registry Destroyed pipelines: {} hits: {} misses: {} hit rate: {:.1f}%",
+        m_pipelines.size(), m_statistics.m_hitCount, m_statistics.m_missCount, m_statistics.hitRate() * 100.0
+    ) );
+}
+
+VulkanGfxPipeline* VulkanPipelineRegistry::acquire(
+    utils::Uptr<VulkanGfxPipeline>&& pGfxPipeline,
+    VulkanRenderPass* pRenderPassToUse, const std::uint32_t& subPassIndexToUse
+)
+{
+    PipelineStateKey stateKey = pGfxPipeline->stateKey( pRenderPassToUse, subPassIndexToUse );
+    VulkanGfxPipeline* pRegisteredPipeline = pGfxPipeline.get();
+    std::promise<VulkanGfxPipeline*> createdPromise;
+
+    {
+        std::unique_lock<std::mutex> lock( m_registryMutex );
+
+        auto pipelineItr = m_pipelines.find( stateKey );
+        if( pipelineItr != m_pipelines.end() )
+        {
+            m_statistics.m_hitCount++;
+            std::shared_future<VulkanGfxPipeline*> created = pipelineItr->second.m_created;
+            lock.unlock();
+            return created.get();
+        }
+
+        m_statistics.m_missCount++;
+
+        // the placeholder makes racing threads wait for this compile instead of starting their own
+        RegisteredPipeline registeredPipeline{};
+        registeredPipeline.m_pGfxPipeline = std::move( pGfxPipeline );
+        registeredPipeline.m_created = createdPromise.get_future().share();
+        m_pipelines.emplace( stateKey, std::move( registeredPipeline ) );
+    }
+
+    try
+    {
+        if( pRegisteredPipeline->m_pPipelineCache == nullptr )
+            pRegisteredPipeline->m_pPipelineCache = m_pPipelineCache;
+        pRegisteredPipeline->createGfxPipeline( pRenderPassToUse, subPassIndexToUse );
+    }
+    catch( ... )
+    {
+        // waiting threads get the same error, the key is free again for a later attempt
+        createdPromise.set_exception( std::current_exception() );
+
+        std::lock_guard<std::mutex> lock( m_registryMutex );
+        m_pipelines.erase( stateKey );
+        throw;
+    }
+
+    createdPromise.set_value( pRegisteredPipeline );
+    return pRegisteredPipeline;
+}
+
+VulkanGfxPipeline* VulkanPipelineRegistry::find( const PipelineStateKey& stateKey )
+{
+    std::unique_lock<std::mutex> lock( m_registryMutex );
+
+    auto pipelineItr = m_pipelines.find( stateKey );
+    if( pipelineItr == m_pipelines.end() )
+        return nullptr;
+
+    std::shared_future<VulkanGfxPipeline*> created = pipelineItr->second.m_created;
+    lock.unlock();
+    return created.get();
+}
+
+std::size_t VulkanPipelineRegistry::size()
+{
+    std::lock_guard<std::mutex> lock( m_registryMutex );
+    return m_pipelines.size();
+}
+
+VulkanPipelineRegistry::Statistics VulkanPipelineRegistry::statistics()
+{
+    std::lock_guard<std::mutex> lock( m_registryMutex );
+    return m_statistics;
+}
+
+} // namespace vkrender
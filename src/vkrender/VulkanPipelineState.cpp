@@ -0,0 +1,90 @@
+#include "vkrender/VulkanPipelineState.h"
+
+#include <cstring>
+
+namespace vkrender
+{
+
+namespace
+{
+    constexpr std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+    constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+    void hashBytes( std::uint64_t& hashValue, const void* pData, const std::size_t& sizeInBytes )
+    {
+        const std::uint8_t* pBytes = static_cast<const std::uint8_t*>( pData );
+        for( std::size_t i = 0; i < sizeInBytes; i++ )
+        {
+            hashValue ^= pBytes[i];
+            hashValue *= FNV_PRIME;
+        }
+    }
+
+    template<typename _Type>
+    void hashValue( std::uint64_t& hashValue, const _Type& value )
+    {
+        hashBytes( hashValue, &value, sizeof( _Type ) );
+    }
+
+    template<typename _Type>
+    void hashArray( std::uint64_t& hashValue, const std::vector<_Type>& values )
+    {
+        const std::uint64_t numOfValues = values.size();
+        hashBytes( hashValue, &numOfValues, sizeof( numOfValues ) );
+        hashBytes( hashValue, values.data(), values.size() * sizeof( _Type ) );
+    }
+}
+
+bool PipelineStateKey::ShaderStage::operator==( const ShaderStage& other ) const
+{
+    return m_vkShaderModule == other.m_vkShaderModule &&
+        m_vkShaderStage == other.m_vkShaderStage &&
+        m_entryPointHash == other.m_entryPointHash;
+}
+
+bool PipelineStateKey::operator==( const PipelineStateKey& other ) const
+{
+    return m_vkRenderPass == other.m_vkRenderPass &&
+        std::memcmp( &m_fixedState, &other.m_fixedState, sizeof( FixedState ) ) == 0 &&
+        m_shaderStages == other.m_shaderStages &&
+        m_vertexBindings == other.m_vertexBindings &&
+        m_vertexAttributes == other.m_vertexAttributes &&
+        m_descriptorSetLayouts == other.m_descriptorSetLayouts &&
+        m_pushConstantRanges == other.m_pushConstantRanges &&
+        m_dynamicStates == other.m_dynamicStates;
+}
+
+std::size_t PipelineStateKey::hash() const
+{
+    static_assert( sizeof( FixedState ) % sizeof( std::uint32_t ) == 0, "FixedState must not contain padding" );
+    static_assert( sizeof( vk::VertexInputBindingDescription ) == 3 * sizeof( std::uint32_t ), "unexpected padding" );
+    static_assert( sizeof( vk::VertexInputAttributeDescription ) == 4 * sizeof( std::uint32_t ), "unexpected padding" );
+    static_assert( sizeof( vk::PushConstantRange ) == 3 * sizeof( std::uint32_t ), "unexpected padding" );
+
+    std::uint64_t hashResult = FNV_OFFSET_BASIS;
+
+    for( const ShaderStage& shaderStage : m_shaderStages )
+    {
+        hashValue( hashResult, static_cast<VkShaderModule>( shaderStage.m_vkShaderModule ) );
+        hashValue( hashResult, static_cast<std::uint32_t>( shaderStage.m_vkShaderStage ) );
+        hashValue( hashResult, shaderStage.m_entryPointHash );
+    }
+    hashArray( hashResult, m_vertexBindings );
+    hashArray( hashResult, m_vertexAttributes );
+    hashArray( hashResult, m_descriptorSetLayouts );
+    hashArray( hashResult, m_pushConstantRanges );
+    hashArray( hashResult, m_dynamicStates );
+    hashValue( hashResult, static_cast<VkRenderPass>( m_vkRenderPass ) );
+    hashValue( hashResult, m_fixedState );
+
+    return static_cast<std::size_t>( hashResult );
+}
+
+std::uint32_t PipelineStateKey::floatBits( const float& value )
+{
+    std::uint32_t bits;
+    std::memcpy( &bits, &value, sizeof( bits ) );
+    return bits;
+}
+
+} // namespace vkrender
@@ -0,0 +1,46 @@
+#include "vkrender/VulkanPushDescriptor.h"
+#include "utilities/VulkanLogger.h"
+
+#include <cstring>
+
+namespace vkrender
+{
+
+VulkanPushDescriptor::VulkanPushDescriptor( vk::Device* pLogicalDevice )
+    :m_pfnCmdPushDescriptorSet{ reinterpret_cast<PFN_vkCmdPushDescriptorSetKHR>( pLogicalDevice->getProcAddr( "vkCmdPushDescriptorSetKHR" ) ) }
+{
+    if( m_pfnCmdPushDescriptorSet == nullptr )
+    {
+        std::string errorMsg = "vkCmdPushDescriptorSetKHR is unavailable, VK_KHR_push_descriptor was not enabled";
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+}
+
+bool VulkanPushDescriptor::isSupported( const vk::PhysicalDevice& vkPhysicalDevice )
+{
+    for( const vk::ExtensionProperties& extensionProp : vkPhysicalDevice.enumerateDeviceExtensionProperties() )
+    {
+        if( std::strcmp( extensionProp.extensionName, EXTENSION_NAME ) == 0 )
+            return true;
+    }
+    return false;
+}
+
+void VulkanPushDescriptor::push(
+    vk::CommandBuffer& vkCmdBuffer,
+    const vk::PipelineBindPoint& bindPoint, const vk::PipelineLayout& vkPipelineLayout, const std::uint32_t& setIndex,
+    const std::vector<vk::WriteDescriptorSet>& writeDescriptorSets
+) const
+{
+    m_pfnCmdPushDescriptorSet(
+        static_cast<VkCommandBuffer>( vkCmdBuffer ),
+        static_cast<VkPipelineBindPoint>( bindPoint ),
+        static_cast<VkPipelineLayout>( vkPipelineLayout ),
+        setIndex,
+        static_cast<std::uint32_t>( writeDescriptorSets.size() ),
+        reinterpret_cast<const VkWriteDescriptorSet*>( writeDescriptorSets.data() )
+    );
+}
+
+} // namespace vkrender
@@ -4,13 +4,21 @@
 
 #include "utilities/VulkanLogger.h"
 
+#include <algorithm>
 #include <vulkan/vulkan_wayland.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
 namespace vkrender
 {
 
-VulkanRenderer::VulkanRenderer()
+VulkanRenderer::VulkanRenderer( const std::uint32_t& framesInFlight, const bool& bRequestBindless )
+	:m_bHasExclusiveTransferQueue{ false }
+	,m_bBindlessRequested{ bRequestBindless }
+	,m_bBindlessEnabled{ false }
+	,m_bPushDescriptorSupported{ false }
+	,m_bMemoryBudgetSupported{ false }
+	,m_bPipelineFeedbackSupported{ false }
+	,m_framesInFlight{ framesInFlight }
 {
     if (utils::VulkanRendererApiLogger::getSingletonPtr() == nullptr)
 	{
@@ -35,20 +43,59 @@ void VulkanRenderer::initVulkan( VulkanWindow* pVulkanWindow )
 	createSurface( pVulkanWindow );
 	pickPhysicalDevice();
 	createLogicalDevice();
+	createMemoryAllocator();
+	createDeletionQueue();
+	createPipelineCache();
+	createDescriptorLayoutCache();
+	createBindlessTable();
+	createPushDescriptor();
+	createThreadPool();
+	createPipelineCompiler();
 	createCommandPool();
 	createConfigCommandBuffer();
+	createStagingRing();
+	createUploadScheduler();
 
 	SwapchainCreateInfo swapchainCreateInfo{};
 	swapchainCreateInfo.vkPhysicalDevice = m_vkPhysicalDevice;
 	swapchainCreateInfo.vkLogicalDevice = m_vkLogicalDevice;
 	swapchainCreateInfo.vkSurface = m_vkSurface;
+	swapchainCreateInfo.queueFamilyIndices = m_pDeviceCapabilities->queueFamilyIndices();
 	swapchainCreateInfo.vkSampleCount = m_msaaSampleCount;
+	swapchainCreateInfo.pMemoryAllocator = m_pMemoryAllocator.get();
 	m_pVulkanSwapchain = std::make_unique<VulkanSwapchain>( swapchainCreateInfo );
 	m_pVulkanSwapchain->createSwapchain( m_pVulkanWindow->getFrameBufferSize() );
+
+	createFrameManager();
+	createParallelRecorder();
 }
 
 void VulkanRenderer::shutdown()
 {
+	m_pFrameManager.reset();
+	LOG_DEBUG("Frame Manager Destroyed");
+
+	m_pParallelRecorder.reset();
+	LOG_DEBUG("Parallel Recorder Destroyed");
+
+	m_pPipelineCompiler.reset();
+	LOG_DEBUG("Pipeline Compiler Destroyed");
+
+	m_pThreadPool.reset();
+	LOG_DEBUG("Thread Pool Destroyed");
+
+	m_pUploadScheduler.reset();
+	LOG_DEBUG("Upload Scheduler Destroyed");
+
+	m_pStagingRing.reset();
+	LOG_DEBUG("Staging Ring Destroyed");
+
+	m_pConfigCmdBuffer.reset();
+	LOG_DEBUG("Config Command Buffer Destroyed");
+
+	// every queue has been drained above, whatever is still pending can go before the pools it came from
+	m_pDeletionQueue->flush();
+
 	if( m_bHasExclusiveTransferQueue )
 		m_vkLogicalDevice.destroyCommandPool( m_vkTransferCommandPool );
 	m_vkLogicalDevice.destroyCommandPool( m_vkGraphicsCommandPool );
@@ -61,6 +108,31 @@ void VulkanRenderer::shutdown()
 	m_pVulkanSwapchain->destroySwapchain();
 	m_pVulkanSwapchain.reset();
 
+	m_pPipelineRegistry.reset();
+	LOG_DEBUG("Pipeline Registry Destroyed");
+
+	m_pDeletionQueue.reset();
+	LOG_DEBUG("Deletion Queue Destroyed");
+
+	m_pPushDescriptor.reset();
+
+	m_pBindlessTable.reset();
+	LOG_DEBUG("Bindless Table Destroyed");
+
+	m_pDescriptorAllocator.reset();
+	LOG_DEBUG("Descriptor Allocator Destroyed");
+
+	m_pDescriptorLayoutCache.reset();
+	LOG_DEBUG("Descriptor Layout Cache Destroyed");
+
+	m_pPipelineCache.reset();
+	LOG_DEBUG("Pipeline Cache Destroyed");
+
+	m_pMemoryAllocator.reset();
+	LOG_DEBUG("Memory Allocator Destroyed");
+
+	m_pDeviceCapabilities.reset();
+
     m_vkLogicalDevice.destroy();
 	LOG_DEBUG("Logical Device Destroyed");
 
@@ -92,13 +164,42 @@ void VulkanRenderer::createBuffer(
     const vk::DeviceSize& bufferSizeInBytes,
     const vk::BufferUsageFlags& bufferUsage, const vk::SharingMode& bufferSharingMode,
     const vk::MemoryPropertyFlags& memProps,
-    vk::Buffer& buffer, vk::DeviceMemory& bufferMemory
+    vk::Buffer& buffer, VulkanAllocation& bufferAllocation,
+    const std::string& owner
 )
 {
-	vkrender::QueueFamilyIndices queueFamilyIndices = VulkanHelpers::findQueueFamilyIndices( 
-		m_vkPhysicalDevice,
-		&m_vkSurface
-	);
+	buffer = createBufferHandle( bufferSizeInBytes, bufferUsage, bufferSharingMode );
+
+	vk::MemoryRequirements memRequirements = m_vkLogicalDevice.getBufferMemoryRequirements( buffer );
+
+	bufferAllocation = m_pMemoryAllocator->allocate( memRequirements, memProps, VulkanMemoryAllocator::ResourceKind::eLinear, owner.empty() ? "buffer" : owner );
+
+	m_pMemoryAllocator->bindBufferMemory( buffer, bufferAllocation );
+}
+
+void VulkanRenderer::createBuffer(
+    const vk::DeviceSize& bufferSizeInBytes,
+    const vk::BufferUsageFlags& bufferUsage, const vk::SharingMode& bufferSharingMode,
+    const VulkanMemoryUsage& memoryUsage,
+    vk::Buffer& buffer, VulkanAllocation& bufferAllocation,
+    const std::string& owner
+)
+{
+	buffer = createBufferHandle( bufferSizeInBytes, bufferUsage, bufferSharingMode );
+
+	vk::MemoryRequirements memRequirements = m_vkLogicalDevice.getBufferMemoryRequirements( buffer );
+
+	bufferAllocation = m_pMemoryAllocator->allocate( memRequirements, memoryUsage, VulkanMemoryAllocator::ResourceKind::eLinear, owner.empty() ? "buffer" : owner );
+
+	m_pMemoryAllocator->bindBufferMemory( buffer, bufferAllocation );
+}
+
+vk::Buffer VulkanRenderer::createBufferHandle(
+    const vk::DeviceSize& bufferSizeInBytes,
+    const vk::BufferUsageFlags& bufferUsage, const vk::SharingMode& bufferSharingMode
+)
+{
+	const vkrender::QueueFamilyIndices& queueFamilyIndices = m_pDeviceCapabilities->queueFamilyIndices();
 
 	vk::BufferCreateInfo bufferInfo{};
 	bufferInfo.size = bufferSizeInBytes;
@@ -110,20 +211,52 @@ void VulkanRenderer::createBuffer(
 	bufferInfo.pQueueFamilyIndices = queueFamilyToShare.data();
 	bufferInfo.queueFamilyIndexCount = queueFamilyToShare.size();
 
-	buffer = m_vkLogicalDevice.createBuffer(
+	return m_vkLogicalDevice.createBuffer(
 		bufferInfo
 	);
+}
 
-	vk::MemoryRequirements memRequirements = m_vkLogicalDevice.getBufferMemoryRequirements( buffer );
+void VulkanRenderer::destroyBuffer( vk::Buffer& buffer, VulkanAllocation& bufferAllocation )
+{
+	m_vkLogicalDevice.destroyBuffer( buffer );
+	buffer = vk::Buffer{};
 
-	vk::MemoryAllocateInfo allocInfo{};
-	allocInfo.allocationSize = memRequirements.size;
-	allocInfo.memoryTypeIndex = VulkanHelpers::findMemoryType( m_vkPhysicalDevice, memRequirements.memoryTypeBits, memProps );
+	m_pMemoryAllocator->free( bufferAllocation );
+}
+
+std::mutex& VulkanRenderer::queueMutex( const vk::Queue& vkQueue )
+{
+	// graphics first, the transfer and presentation handles alias it when their family has no queue of its own
+	if( vkQueue == m_vkGraphicsQueue )
+		return m_graphicsQueueMutex;
+	if( vkQueue == m_vkPresentationQueue )
+		return m_presentationQueueMutex;
+	if( vkQueue == m_vkTransferQueue )
+		return m_transferQueueMutex;
+
+	std::string errorMsg = "Queue was not retrieved by the renderer";
+	LOG_ERROR(errorMsg);
+	throw std::invalid_argument(errorMsg);
+}
 
-	bufferMemory = m_vkLogicalDevice.allocateMemory( allocInfo );
+std::mutex& VulkanRenderer::commandPoolMutex( const vk::CommandPool& vkCommandPool )
+{
+	// the transfer pool is the graphics pool without an exclusive transfer queue
+	if( vkCommandPool == m_vkGraphicsCommandPool )
+		return m_graphicsCommandPoolMutex;
+	if( vkCommandPool == m_vkTransferCommandPool )
+		return m_transferCommandPoolMutex;
+
+	std::string errorMsg = "Command pool was not created by the renderer";
+	LOG_ERROR(errorMsg);
+	throw std::invalid_argument(errorMsg);
+}
 
-	m_vkLogicalDevice.bindBufferMemory( buffer, bufferMemory, 0 );
-}	
+vk::Result VulkanRenderer::submit( const vk::Queue& vkQueue, const std::uint32_t& submitCount, const vk::SubmitInfo* pSubmitInfos, const vk::Fence& vkFence )
+{
+	std::lock_guard<std::mutex> queueLock{ queueMutex( vkQueue ) };
+	return vkQueue.submit( submitCount, pSubmitInfos, vkFence );
+}
 
 vk::Sampler* VulkanRenderer::createTexSampler(
     const vk::Filter& minFilter, const vk::Filter& magFilter,
@@ -136,8 +269,6 @@ vk::Sampler* VulkanRenderer::createTexSampler(
     const bool& bCmpEnable, const vk::CompareOp& cmpOp
 )
 {
-	vk::PhysicalDeviceProperties phyDeviceProp = m_vkPhysicalDevice.getProperties(); 
-
 	vk::SamplerCreateInfo samplerCreateInfo{};
 	samplerCreateInfo.minFilter = minFilter;
 	samplerCreateInfo.magFilter = magFilter;
@@ -145,7 +276,7 @@ vk::Sampler* VulkanRenderer::createTexSampler(
 	samplerCreateInfo.addressModeV = vAddrMode;
 	samplerCreateInfo.addressModeW = wAddrMode;
 	samplerCreateInfo.anisotropyEnable = static_cast<vk::Bool32>( bEnableAnisotropy );
-	samplerCreateInfo.maxAnisotropy = phyDeviceProp.limits.maxSamplerAnisotropy;
+	samplerCreateInfo.maxAnisotropy = m_pDeviceCapabilities->limits().maxSamplerAnisotropy;
 	samplerCreateInfo.borderColor = borderColor;
 	samplerCreateInfo.unnormalizedCoordinates = static_cast<vk::Bool32>( !bnormalizedCoords );
 	samplerCreateInfo.compareEnable = static_cast<vk::Bool32>( bCmpEnable );
@@ -195,9 +326,94 @@ void VulkanRenderer::createSurface( VulkanWindow* pVulkanWindow )
 	LOG_INFO( "Vulkan Surface Created" );
 }
 
+void VulkanRenderer::createMemoryAllocator()
+{
+	m_pMemoryAllocator = std::make_unique<VulkanMemoryAllocator>(
+		m_pDeviceCapabilities.get(), &m_vkLogicalDevice,
+		VulkanMemoryAllocator::DEFAULT_BLOCK_SIZE, m_bMemoryBudgetSupported
+	);
+	LOG_INFO( fmt::format( "Memory Allocator created, driver memory budget {}", m_bMemoryBudgetSupported ? "available" : "estimated" ) );
+}
+
+void VulkanRenderer::createDeletionQueue()
+{
+	m_pDeletionQueue = std::make_unique<VulkanDeletionQueue>( &m_vkLogicalDevice, m_pMemoryAllocator.get(), m_framesInFlight );
+	LOG_INFO("Deletion Queue created");
+}
+
+void VulkanRenderer::createPipelineCache()
+{
+	m_pPipelineCache = std::make_unique<VulkanPipelineCache>( m_vkPhysicalDevice, &m_vkLogicalDevice, m_bPipelineFeedbackSupported );
+	LOG_INFO( fmt::format( "Pipeline Cache created, creation feedback {}", m_bPipelineFeedbackSupported ? "available" : "unavailable" ) );
+
+	m_pPipelineRegistry = std::make_unique<VulkanPipelineRegistry>( m_pPipelineCache.get() );
+	LOG_INFO("Pipeline Registry created");
+}
+
+void VulkanRenderer::createDescriptorLayoutCache()
+{
+	m_pDescriptorLayoutCache = std::make_unique<VulkanDescriptorLayoutCache>( &m_vkLogicalDevice );
+	LOG_INFO("Descriptor Layout Cache created");
+
+	// materials come and go for the lifetime of the renderer, their sets are freed one by one
+	m_pDescriptorAllocator = std::make_unique<VulkanDescriptorAllocator>(
+		&m_vkLogicalDevice,
+		VulkanDescriptorAllocator::DEFAULT_SETS_PER_POOL, VulkanDescriptorAllocator::DEFAULT_POOL_SIZE_RATIOS,
+		vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet
+	);
+	LOG_INFO("Descriptor Allocator created");
+}
+
+void VulkanRenderer::createBindlessTable()
+{
+	if( !m_bBindlessEnabled )
+		return;
+
+	const vk::PhysicalDeviceVulkan12Properties& vulkan12Properties = m_pDeviceCapabilities->vulkan12Properties();
+
+	// leave room below the device limits for the regular descriptor sets of a pipeline
+	const std::uint32_t maxSampledImages = std::min(
+		VulkanBindlessTable::DEFAULT_MAX_SAMPLED_IMAGES,
+		std::min( vulkan12Properties.maxDescriptorSetUpdateAfterBindSampledImages, vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSampledImages ) / 2u
+	);
+	const std::uint32_t maxSamplers = std::min(
+		VulkanBindlessTable::DEFAULT_MAX_SAMPLERS,
+		std::min( vulkan12Properties.maxDescriptorSetUpdateAfterBindSamplers, vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSamplers ) / 2u
+	);
+
+	m_pBindlessTable = std::make_unique<VulkanBindlessTable>(
+		&m_vkLogicalDevice, m_pDescriptorLayoutCache.get(), m_framesInFlight,
+		maxSampledImages, maxSamplers
+	);
+}
+
+void VulkanRenderer::createPushDescriptor()
+{
+	if( !m_bPushDescriptorSupported )
+	{
+		LOG_INFO("VK_KHR_push_descriptor unsupported, per draw sets are allocated from descriptor pools");
+		return;
+	}
+
+	m_pPushDescriptor = std::make_unique<VulkanPushDescriptor>( &m_vkLogicalDevice );
+	LOG_INFO("Push Descriptors enabled");
+}
+
+void VulkanRenderer::createThreadPool()
+{
+	m_pThreadPool = std::make_unique<utils::ThreadPool>();
+	LOG_INFO( fmt::format( "Thread Pool created with {} worker threads", m_pThreadPool->workerCount() ) );
+}
+
+void VulkanRenderer::createPipelineCompiler()
+{
+	m_pPipelineCompiler = std::make_unique<VulkanPipelineCompiler>( m_pPipelineCache.get(), m_pThreadPool.get() );
+	LOG_INFO("Pipeline Compiler created");
+}
+
 void VulkanRenderer::createCommandPool()
 {
-	QueueFamilyIndices queueFamilyIndices = VulkanHelpers::findQueueFamilyIndices( m_vkPhysicalDevice, &m_vkSurface );
+	const QueueFamilyIndices& queueFamilyIndices = m_pDeviceCapabilities->queueFamilyIndices();
 
 	vk::CommandPoolCreateInfo vkGraphicsCommandPoolInfo{};
 	vkGraphicsCommandPoolInfo.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
@@ -230,10 +446,36 @@ void VulkanRenderer::createConfigCommandBuffer()
 	m_pConfigCmdBuffer = std::make_unique<VulkanImmediateCmdBuffer>(
 		&m_vkLogicalDevice,
 		&m_vkGraphicsQueue,
-		&m_vkGraphicsCommandPool
+		&m_graphicsQueueMutex,
+		&m_vkGraphicsCommandPool,
+		&m_graphicsCommandPoolMutex
 	);
 	m_pConfigCmdBuffer->allocate();
 	LOG_INFO("Config Command Buffer created");
 }
 
+void VulkanRenderer::createStagingRing()
+{
+	m_pStagingRing = std::make_unique<VulkanStagingRing>( this );
+	LOG_INFO("Staging Ring created");
+}
+
+void VulkanRenderer::createUploadScheduler()
+{
+	m_pUploadScheduler = std::make_unique<VulkanUploadScheduler>( this );
+	LOG_INFO("Upload Scheduler created");
+}
+
+void VulkanRenderer::createFrameManager()
+{
+	m_pFrameManager = std::make_unique<VulkanFrameManager>( this, m_framesInFlight );
+	LOG_INFO("Frame Manager created");
+}
+
+void VulkanRenderer::createParallelRecorder()
+{
+	m_pParallelRecorder = std::make_unique<VulkanParallelRecorder>( this, m_pThreadPool.get(), m_framesInFlight );
+	LOG_INFO("Parallel Recorder created");
+}
+
 } // namespace vkrender
\ No newline at end of file
@@ -84,6 +84,19 @@ void VulkanRenderer::pickPhysicalDevice()
         bool bSamplerAnisotropy = static_cast<bool>( vkPhysicalDeviceFeatures.samplerAnisotropy );
 
         bool bGraphicsFamily = queueFamilyIndices.m_graphicsFamily.has_value();
+
+		// the upload scheduler needs timeline semaphores, PhysicalDeviceVulkan12Features may only be chained on 1.2 devices
+		auto l_checkTimelineSemaphoreSupport = []( const vk::PhysicalDevice& physicalDevice, const std::uint32_t& apiVersion ) -> bool {
+			if( apiVersion < VK_API_VERSION_1_2 )
+				return false;
+
+			auto featuresChain = physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+			return static_cast<bool>( featuresChain.get<vk::PhysicalDeviceVulkan12Features>().timelineSemaphore );
+		};
+
+		bool bTimelineSemaphore = l_checkTimelineSemaphoreSupport( physicalDevice, vkPhysicalDeviceProperties.apiVersion );
+		if( !bTimelineSemaphore )
+			LOG_INFO( fmt::format( "Device {} lacks Vulkan 1.2 timeline semaphores", vkPhysicalDeviceProperties.deviceName ) );
         
 		auto l_checkDeviceExtensionSupport = []( const vk::PhysicalDevice& physicalDevice, const std::vector<const char*>& requiredExtensions ){
 			std::vector<vk::ExtensionProperties, std::allocator<vk::ExtensionProperties>> availableExtensions = physicalDevice.enumerateDeviceExtensionProperties();
@@ -119,7 +132,7 @@ void VulkanRenderer::pickPhysicalDevice()
 		if( vkPhysicalDeviceFeatures.geometryShader == bestCandidate.mbHasGeometryShader )
 			deviceScore += 10;
 
-        return bShader && ( bIntegratedGpu || bDiscreteGpu ) && bGraphicsFamily && bExtensionsSupported && bSwapChainAdequate & bSamplerAnisotropy;
+        return bShader && ( bIntegratedGpu || bDiscreteGpu ) && bGraphicsFamily && bExtensionsSupported && bSwapChainAdequate & bSamplerAnisotropy && bTimelineSemaphore;
 	};
 
 	DeviceCandiate bestCandidate{
@@ -158,8 +171,25 @@ void VulkanRenderer::pickPhysicalDevice()
 	if( bestDeviceScore > 0u )
 	{
 		m_vkPhysicalDevice = devices[bestCandidateIndex];
-		m_msaaSampleCount = VulkanHelpers::getMaxUsableSampleCount( m_vkPhysicalDevice );
+		m_pDeviceCapabilities = std::make_unique<VulkanDeviceCapabilities>( m_vkPhysicalDevice, &m_vkSurface );
+		m_msaaSampleCount = m_pDeviceCapabilities->maxUsableSampleCount();
 		m_deviceExtensionContainer = requiredExtensions;
+
+		// optional, lets per draw descriptors skip set allocation
+		m_bPushDescriptorSupported = VulkanPushDescriptor::isSupported( m_vkPhysicalDevice );
+		if( m_bPushDescriptorSupported )
+			m_deviceExtensionContainer.push_back( VulkanPushDescriptor::EXTENSION_NAME );
+
+		// optional, without it heap budgets are estimated from our own allocations
+		m_bMemoryBudgetSupported = VulkanMemoryAllocator::isBudgetSupported( m_vkPhysicalDevice );
+		if( m_bMemoryBudgetSupported )
+			m_deviceExtensionContainer.push_back( VulkanMemoryAllocator::BUDGET_EXTENSION_NAME );
+
+		// optional, without it pipeline cache hits and misses are counted as unknown
+		m_bPipelineFeedbackSupported = VulkanPipelineCache::isFeedbackSupported( m_vkPhysicalDevice );
+		if( m_bPipelineFeedbackSupported && !VulkanPipelineCache::isFeedbackCore( m_vkPhysicalDevice ) )
+			m_deviceExtensionContainer.push_back( VulkanPipelineCache::FEEDBACK_EXTENSION_NAME );
+
 		m_deviceExtensionContainer.shrink_to_fit();
 
 		LOG_INFO("Selected Suitable Vulkan GPU!");
@@ -174,7 +204,7 @@ void VulkanRenderer::pickPhysicalDevice()
 
 void VulkanRenderer::createLogicalDevice()
 {
-	QueueFamilyIndices queueFamilyIndices = VulkanHelpers::findQueueFamilyIndices( m_vkPhysicalDevice, &m_vkSurface );
+	const QueueFamilyIndices& queueFamilyIndices = m_pDeviceCapabilities->queueFamilyIndices();
 
 	logQueueFamilyIndices( queueFamilyIndices );
 	
@@ -204,9 +234,43 @@ void VulkanRenderer::createLogicalDevice()
 	}
 
 	vk::DeviceCreateInfo vkDeviceCreateInfo{};
-	vk::PhysicalDeviceFeatures physicalDeviceFeatures = m_vkPhysicalDevice.getFeatures(); // TODO check state
+	vk::PhysicalDeviceFeatures physicalDeviceFeatures = m_pDeviceCapabilities->features(); // TODO check state
 	populateDeviceCreateInfo( vkDeviceCreateInfo, deviceQueueCreateInfos, &physicalDeviceFeatures, m_deviceExtensionContainer );
 
+	// timeline semaphores drive the upload scheduler, pickPhysicalDevice only accepts devices supporting them
+	m_vkEnabledVulkan12Features = vk::PhysicalDeviceVulkan12Features{};
+	m_vkEnabledVulkan12Features.timelineSemaphore = VK_TRUE;
+
+	if( m_bBindlessRequested )
+	{
+		auto featuresChain = m_vkPhysicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+		const vk::PhysicalDeviceVulkan12Features& supportedVulkan12Features = featuresChain.get<vk::PhysicalDeviceVulkan12Features>();
+
+		m_bBindlessEnabled = supportedVulkan12Features.descriptorIndexing &&
+			supportedVulkan12Features.runtimeDescriptorArray &&
+			supportedVulkan12Features.descriptorBindingPartiallyBound &&
+			supportedVulkan12Features.descriptorBindingSampledImageUpdateAfterBind &&
+			supportedVulkan12Features.descriptorBindingUpdateUnusedWhilePending &&
+			supportedVulkan12Features.shaderSampledImageArrayNonUniformIndexing;
+
+		if( m_bBindlessEnabled )
+		{
+			m_vkEnabledVulkan12Features.descriptorIndexing = VK_TRUE;
+			m_vkEnabledVulkan12Features.runtimeDescriptorArray = VK_TRUE;
+			m_vkEnabledVulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+			m_vkEnabledVulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+			m_vkEnabledVulkan12Features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+			m_vkEnabledVulkan12Features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+			LOG_INFO("Bindless descriptors enabled");
+		}
+		else
+		{
+			LOG_INFO("Bindless descriptors requested but the device lacks descriptor indexing support, using bound descriptor sets");
+		}
+	}
+
+	vkDeviceCreateInfo.pNext = &m_vkEnabledVulkan12Features;
+
 	m_vkLogicalDevice = m_vkPhysicalDevice.createDevice( vkDeviceCreateInfo );	
 	LOG_INFO("Logical Device created");
 
@@ -253,6 +317,13 @@ void logQueueFamilyIndices( const vkrender::QueueFamilyIndices& queueFamilyIndic
 	{
 		LOG_DEBUG(fmt::format("Has Exclusive Transfer Queue Index: {}", queueFamilyIndices.m_exclusiveTransferFamily.value()));
 	}
+
+	if( queueFamilyIndices.m_exclusiveComputeFamily.has_value() )
+	{
+		LOG_DEBUG(fmt::format("Has Exclusive Compute Queue Index: {}", queueFamilyIndices.m_exclusiveComputeFamily.value()));
+	}
+
+	LOG_DEBUG(fmt::format("Graphics Queue Family holds {} queues", queueFamilyIndices.m_graphicsQueueCount));
 }
 
 void populateDeviceQueueCreateInfo( 
@@ -0,0 +1,833 @@
+#include "vkrender/VulkanShaderReflection.h"
+#include "utilities/VulkanLogger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace vkrender
+{
+
+namespace
+{
+    constexpr std::uint32_t SPIRV_MAGIC = 0x07230203u;
+    constexpr std::uint32_t SPIRV_HEADER_WORDS = 5u;
+    // from this version on entry points list every global variable they use, not only inputs and outputs
+    constexpr std::uint32_t SPIRV_VERSION_1_4 = 0x00010400u;
+
+    // subset of the SPIR-V grammar the reflection needs
+    namespace SpvOp
+    {
+        constexpr std::uint32_t eName = 5;
+        constexpr std::uint32_t eEntryPoint = 15;
+        constexpr std::uint32_t eTypeBool = 20;
+        constexpr std::uint32_t eTypeInt = 21;
+        constexpr std::uint32_t eTypeFloat = 22;
+        constexpr std::uint32_t eTypeVector = 23;
+        constexpr std::uint32_t eTypeMatrix = 24;
+        constexpr std::uint32_t eTypeImage = 25;
+        constexpr std::uint32_t eTypeSampler = 26;
+        constexpr std::uint32_t eTypeSampledImage = 27;
+        constexpr std::uint32_t eTypeArray = 28;
+        constexpr std::uint32_t eTypeRuntimeArray = 29;
+        constexpr std::uint32_t eTypeStruct = 30;
+        constexpr std::uint32_t eTypePointer = 32;
+        constexpr std::uint32_t eConstant = 43;
+        constexpr std::uint32_t eSpecConstantTrue = 48;
+        constexpr std::uint32_t eSpecConstantFalse = 49;
+        constexpr std::uint32_t eSpecConstant = 50;
+        constexpr std::uint32_t eFunction = 54;
+        constexpr std::uint32_t eFunctionEnd = 56;
+        constexpr std::uint32_t eFunctionCall = 57;
+        constexpr std::uint32_t eVariable = 59;
+        constexpr std::uint32_t eDecorate = 71;
+        constexpr std::uint32_t eMemberDecorate = 72;
+        constexpr std::uint32_t eTypeAccelerationStructure = 5341;
+    }
+
+    namespace SpvDecoration
+    {
+        constexpr std::uint32_t eSpecId = 1;
+        constexpr std::uint32_t eBlock = 2;
+        constexpr std::uint32_t eBufferBlock = 3;
+        constexpr std::uint32_t eArrayStride = 6;
+        constexpr std::uint32_t eMatrixStride = 7;
+        constexpr std::uint32_t eBuiltIn = 11;
+        constexpr std::uint32_t eLocation = 30;
+        constexpr std::uint32_t eBinding = 33;
+        constexpr std::uint32_t eDescriptorSet = 34;
+        constexpr std::uint32_t eOffset = 35;
+    }
+
+    namespace SpvStorageClass
+    {
+        constexpr std::uint32_t eUniformConstant = 0;
+        constexpr std::uint32_t eInput = 1;
+        constexpr std::uint32_t eUniform = 2;
+        constexpr std::uint32_t ePushConstant = 9;
+        constexpr std::uint32_t eStorageBuffer = 12;
+    }
+
+    namespace SpvDim
+    {
+        constexpr std::uint32_t eBuffer = 5;
+        constexpr std::uint32_t eSubpassData = 6;
+    }
+
+    struct SpvMember
+    {
+        std::uint32_t m_typeId = 0;
+        std::uint32_t m_offset = 0;
+        std::uint32_t m_matrixStride = 0;
+    };
+
+    struct SpvId
+    {
+        std::uint32_t m_opcode = 0;
+        std::string m_name;
+
+        // types
+        std::uint32_t m_width = 0;
+        bool m_bSigned = false;
+        std::uint32_t m_elementTypeId = 0;
+        std::uint32_t m_elementCount = 0;
+        std::uint32_t m_lengthId = 0;
+        std::uint32_t m_storageClass = 0;
+        std::uint32_t m_imageDim = 0;
+        std::uint32_t m_imageSampled = 0;
+        std::vector<SpvMember> m_members;
+
+        // constants
+        std::uint32_t m_constantTypeId = 0;
+        std::uint64_t m_constantValue = 0;
+
+        // decorations
+        std::optional<std::uint32_t> m_set;
+        std::optional<std::uint32_t> m_binding;
+        std::optional<std::uint32_t> m_location;
+        std::optional<std::uint32_t> m_specId;
+        std::uint32_t m_arrayStride = 0;
+        bool m_bBuiltIn = false;
+        bool m_bBlock = false;
+        bool m_bBufferBlock = false;
+
+        // declared outside of any function
+        bool m_bGlobalVariable = false;
+    };
+
+    struct SpvEntryPoint
+    {
+        std::uint32_t m_executionModel = 0;
+        std::uint32_t m_functionId = 0;
+        std::string m_name;
+        std::vector<std::uint32_t> m_interfaceIds;
+    };
+
+    struct SpvFunction
+    {
+        std::vector<std::uint32_t> m_calledFunctionIds;
+        std::vector<std::uint32_t> m_usedVariableIds;
+    };
+
+    struct SpvVariable
+    {
+        std::uint32_t m_id = 0;
+        std::uint32_t m_pointerTypeId = 0;
+        std::uint32_t m_storageClass = 0;
+    };
+
+    class SpirvParser
+    {
+    public:
+        explicit SpirvParser( const std::vector<char>& spirvBuffer )
+        {
+            if( spirvBuffer.size() % sizeof( std::uint32_t ) != 0 || spirvBuffer.size() < SPIRV_HEADER_WORDS * sizeof( std::uint32_t ) )
+                fail( "SPIR-V buffer is not a whole number of words" );
+
+            m_words.resize( spirvBuffer.size() / sizeof( std::uint32_t ) );
+            std::memcpy( m_words.data(), spirvBuffer.data(), spirvBuffer.size() );
+
+            if( m_words[0] != SPIRV_MAGIC )
+                fail( "SPIR-V magic number mismatch" );
+
+            m_ids.resize( m_words[3] );
+            parseInstructions();
+        }
+
+        VulkanShaderReflection reflect( const std::string& entryPoint ) const;
+    private:
+        std::vector<std::uint32_t> m_words;
+        std::vector<SpvId> m_ids;
+        std::vector<SpvEntryPoint> m_entryPoints;
+        std::vector<SpvVariable> m_variables;
+        std::unordered_map<std::uint32_t, SpvFunction> m_functions;
+
+        [[noreturn]] static void fail( const std::string& reason )
+        {
+            std::string errorMsg = fmt::format( "Failed to reflect SPIR-V module: {}", reason );
+            LOG_ERROR(errorMsg);
+            throw std::runtime_error(errorMsg);
+        }
+
+        SpvId& id( const std::uint32_t& idIndex )
+        {
+            if( idIndex >= m_ids.size() )
+                fail( fmt::format( "id {} is out of bounds", idIndex ) );
+            return m_ids[idIndex];
+        }
+
+        const SpvId& id( const std::uint32_t& idIndex ) const
+        {
+            if( idIndex >= m_ids.size() )
+                fail( fmt::format( "id {} is out of bounds", idIndex ) );
+            return m_ids[idIndex];
+        }
+
+        static std::string readString( const std::uint32_t* pWords, const std::uint32_t& maxWords, std::uint32_t& wordsRead );
+
+        void parseInstructions();
+        void recordFunctionUse( SpvFunction& function, const std::uint32_t& opcode, const std::uint32_t* pOperands, const std::uint32_t& numOfOperands ) const;
+        void parseDecoration( SpvId& target, const std::uint32_t* pOperands, const std::uint32_t& numOfOperands );
+
+        std::uint32_t sizeOfType( const std::uint32_t& typeId, const std::uint32_t& matrixStride = 0 ) const;
+        std::uint32_t arrayLength( const SpvId& arrayType ) const;
+        vk::Format formatOfType( const SpvId& type ) const;
+        std::optional<vk::DescriptorType> descriptorTypeOf( const SpvId& type, const std::uint32_t& storageClass ) const;
+        std::unordered_set<std::uint32_t> usedVariables( const SpvEntryPoint& entryPoint ) const;
+    };
+
+    std::string SpirvParser::readString( const std::uint32_t* pWords, const std::uint32_t& maxWords, std::uint32_t& wordsRead )
+    {
+        const char* pChars = reinterpret_cast<const char*>( pWords );
+        const std::size_t maxChars = static_cast<std::size_t>( maxWords ) * sizeof( std::uint32_t );
+        const std::size_t length = strnlen( pChars, maxChars );
+
+        wordsRead = static_cast<std::uint32_t>( length / sizeof( std::uint32_t ) + 1 );
+        return std::string( pChars, length );
+    }
+
+    void SpirvParser::parseInstructions()
+    {
+        SpvFunction* pCurrentFunction = nullptr;
+
+        std::size_t wordIndex = SPIRV_HEADER_WORDS;
+        while( wordIndex < m_words.size() )
+        {
+            const std::uint32_t opcode = m_words[wordIndex] & 0xFFFFu;
+            const std::uint32_t wordCount = m_words[wordIndex] >> 16;
+            if( wordCount == 0 || wordIndex + wordCount > m_words.size() )
+                fail( "malformed instruction stream" );
+
+            const std::uint32_t* pOperands = &m_words[wordIndex + 1];
+            const std::uint32_t numOfOperands = wordCount - 1;
+
+            switch( opcode )
+            {
+            case SpvOp::eName:
+            {
+                std::uint32_t wordsRead = 0;
+                id( pOperands[0] ).m_name = readString( pOperands + 1, numOfOperands - 1, wordsRead );
+                break;
+            }
+            case SpvOp::eEntryPoint:
+            {
+                SpvEntryPoint entryPoint{};
+                entryPoint.m_executionModel = pOperands[0];
+                entryPoint.m_functionId = pOperands[1];
+
+                std::uint32_t wordsRead = 0;
+                entryPoint.m_name = readString( pOperands + 2, numOfOperands - 2, wordsRead );
+                entryPoint.m_interfaceIds.assign( pOperands + 2 + wordsRead, pOperands + numOfOperands );
+
+                m_entryPoints.push_back( std::move( entryPoint ) );
+                break;
+            }
+            case SpvOp::eTypeBool:
+            case SpvOp::eTypeSampler:
+            case SpvOp::eTypeAccelerationStructure:
+                id( pOperands[0] ).m_opcode = opcode;
+                break;
+            case SpvOp::eTypeInt:
+            {
+                SpvId& type = id( pOperands[0] );
+                type.m_opcode = opcode;
+                type.m_width = pOperands[1];
+                type.m_bSigned = pOperands[2] != 0;
+                break;
+            }
+            case SpvOp::eTypeFloat:
+            {
+                SpvId& type = id( pOperands[0] );
+                type.m_opcode = opcode;
+                type.m_width = pOperands[1];
+                type.m_bSigned = true;
+                break;
+            }
+            case SpvOp::eTypeVector:
+            case SpvOp::eTypeMatrix:
+            {
+                SpvId& type = id( pOperands[0] );
+                type.m_opcode = opcode;
+                type.m_elementTypeId = pOperands[1];
+                type.m_elementCount = pOperands[2];
+                break;
+            }
+            case SpvOp::eTypeImage:
+            {
+                SpvId& type = id( pOperands[0] );
+                type.m_opcode = opcode;
+                type.m_elementTypeId = pOperands[1];
+                type.m_imageDim = pOperands[2];
+                type.m_imageSampled = pOperands[6];
+                break;
+            }
+            case SpvOp::eTypeSampledImage:
+            case SpvOp::eTypeRuntimeArray:
+            {
+                SpvId& type = id( pOperands[0] );
+                type.m_opcode = opcode;
+                type.m_elementTypeId = pOperands[1];
+                break;
+            }
+            case SpvOp::eTypeArray:
+            {
+                SpvId& type = id( pOperands[0] );
+                type.m_opcode = opcode;
+                type.m_elementTypeId = pOperands[1];
+                type.m_lengthId = pOperands[2];
+                break;
+            }
+            case SpvOp::eTypeStruct:
+            {
+                SpvId& type = id( pOperands[0] );
+                type.m_opcode = opcode;
+                // member decorations may precede the type, keep what was recorded so far
+                type.m_members.resize( std::max<std::size_t>( type.m_members.size(), numOfOperands - 1 ) );
+                for( std::uint32_t i = 1; i < numOfOperands; i++ )
+                    type.m_members[i - 1].m_typeId = pOperands[i];
+                break;
+            }
+            case SpvOp::eTypePointer:
+            {
+                SpvId& type = id( pOperands[0] );
+                type.m_opcode = opcode;
+                type.m_storageClass = pOperands[1];
+                type.m_elementTypeId = pOperands[2];
+                break;
+            }
+            case SpvOp::eConstant:
+            case SpvOp::eSpecConstant:
+            {
+                SpvId& constant = id( pOperands[1] );
+                constant.m_opcode = opcode;
+                constant.m_constantTypeId = pOperands[0];
+                constant.m_constantValue = pOperands[2];
+                if( numOfOperands > 3 )
+                    constant.m_constantValue |= static_cast<std::uint64_t>( pOperands[3] ) << 32;
+                break;
+            }
+            case SpvOp::eSpecConstantTrue:
+            case SpvOp::eSpecConstantFalse:
+            {
+                SpvId& constant = id( pOperands[1] );
+                constant.m_opcode = opcode;
+                constant.m_constantTypeId = pOperands[0];
+                constant.m_constantValue = opcode == SpvOp::eSpecConstantTrue ? 1u : 0u;
+                break;
+            }
+            case SpvOp::eVariable:
+            {
+                // function local variables never hold resources
+                if( pCurrentFunction )
+                    break;
+
+                SpvVariable variable{};
+                variable.m_pointerTypeId = pOperands[0];
+                variable.m_id = pOperands[1];
+                variable.m_storageClass = pOperands[2];
+                m_variables.push_back( variable );
+                id( variable.m_id ).m_bGlobalVariable = true;
+                break;
+            }
+            case SpvOp::eFunction:
+                pCurrentFunction = &m_functions[pOperands[1]];
+                break;
+            case SpvOp::eFunctionEnd:
+                pCurrentFunction = nullptr;
+                break;
+            case SpvOp::eDecorate:
+                parseDecoration( id( pOperands[0] ), pOperands + 1, numOfOperands - 1 );
+                break;
+            case SpvOp::eMemberDecorate:
+            {
+                SpvId& structType = id( pOperands[0] );
+                const std::uint32_t memberIndex = pOperands[1];
+                if( structType.m_members.size() <= memberIndex )
+                    structType.m_members.resize( memberIndex + 1 );
+
+                if( pOperands[2] == SpvDecoration::eOffset )
+                    structType.m_members[memberIndex].m_offset = pOperands[3];
+                else if( pOperands[2] == SpvDecoration::eMatrixStride )
+                    structType.m_members[memberIndex].m_matrixStride = pOperands[3];
+                else if( pOperands[2] == SpvDecoration::eBuiltIn )
+                    structType.m_bBuiltIn = true;
+                break;
+            }
+            default:
+                break;
+            }
+
+            if( pCurrentFunction )
+                recordFunctionUse( *pCurrentFunction, opcode, pOperands, numOfOperands );
+
+            wordIndex += wordCount;
+        }
+    }
+
+    void SpirvParser::recordFunctionUse( SpvFunction& function, const std::uint32_t& opcode, const std::uint32_t* pOperands, const std::uint32_t& numOfOperands ) const
+    {
+        if( opcode == SpvOp::eFunctionCall && numOfOperands > 2 )
+            function.m_calledFunctionIds.push_back( pOperands[2] );
+
+        // literal operands may alias a variable id, that only ever keeps an unused resource and never drops a used one
+        for( std::uint32_t i = 0; i < numOfOperands; i++ )
+        {
+            if( pOperands[i] < m_ids.size() && m_ids[pOperands[i]].m_bGlobalVariable )
+                function.m_usedVariableIds.push_back( pOperands[i] );
+        }
+    }
+
+    void SpirvParser::parseDecoration( SpvId& target, const std::uint32_t* pOperands, const std::uint32_t& numOfOperands )
+    {
+        switch( pOperands[0] )
+        {
+        case SpvDecoration::eSpecId:        target.m_specId = pOperands[1]; break;
+        case SpvDecoration::eBlock:         target.m_bBlock = true; break;
+        case SpvDecoration::eBufferBlock:   target.m_bBufferBlock = true; break;
+        case SpvDecoration::eArrayStride:   target.m_arrayStride = pOperands[1]; break;
+        case SpvDecoration::eBuiltIn:       target.m_bBuiltIn = true; break;
+        case SpvDecoration::eLocation:      target.m_location = pOperands[1]; break;
+        case SpvDecoration::eBinding:       target.m_binding = pOperands[1]; break;
+        case SpvDecoration::eDescriptorSet: target.m_set = pOperands[1]; break;
+        default: break;
+        }
+    }
+
+    std::uint32_t SpirvParser::arrayLength( const SpvId& arrayType ) const
+    {
+        const SpvId& lengthConstant = id( arrayType.m_lengthId );
+        return static_cast<std::uint32_t>( lengthConstant.m_constantValue );
+    }
+
+    std::uint32_t SpirvParser::sizeOfType( const std::uint32_t& typeId, const std::uint32_t& matrixStride ) const
+    {
+        const SpvId& type = id( typeId );
+        switch( type.m_opcode )
+        {
+        case SpvOp::eTypeBool:
+            return 4u;
+        case SpvOp::eTypeInt:
+        case SpvOp::eTypeFloat:
+            return type.m_width / 8u;
+        case SpvOp::eTypeVector:
+            return type.m_elementCount * sizeOfType( type.m_elementTypeId );
+        case SpvOp::eTypeMatrix:
+            return type.m_elementCount * ( matrixStride != 0 ? matrixStride : sizeOfType( type.m_elementTypeId ) );
+        case SpvOp::eTypeArray:
+        {
+            const std::uint32_t elementSize = type.m_arrayStride != 0 ? type.m_arrayStride : sizeOfType( type.m_elementTypeId, matrixStride );
+            return arrayLength( type ) * elementSize;
+        }
+        case SpvOp::eTypeRuntimeArray:
+            return 0u;
+        case SpvOp::eTypeStruct:
+        {
+            std::uint32_t structSize = 0u;
+            for( const SpvMember& member : type.m_members )
+                structSize = std::max( structSize, member.m_offset + sizeOfType( member.m_typeId, member.m_matrixStride ) );
+            return structSize;
+        }
+        default:
+            return 0u;
+        }
+    }
+
+    vk::Format SpirvParser::formatOfType( const SpvId& type ) const
+    {
+        const SpvId& scalarType = type.m_opcode == SpvOp::eTypeVector ? id( type.m_elementTypeId ) : type;
+        const std::uint32_t numOfComponents = type.m_opcode == SpvOp::eTypeVector ? type.m_elementCount : 1u;
+        if( numOfComponents < 1u || numOfComponents > 4u )
+            return vk::Format::eUndefined;
+
+        static const vk::Format float32Formats[] = { vk::Format::eR32Sfloat, vk::Format::eR32G32Sfloat, vk::Format::eR32G32B32Sfloat, vk::Format::eR32G32B32A32Sfloat };
+        static const vk::Format sint32Formats[] = { vk::Format::eR32Sint, vk::Format::eR32G32Sint, vk::Format::eR32G32B32Sint, vk::Format::eR32G32B32A32Sint };
+        static const vk::Format uint32Formats[] = { vk::Format::eR32Uint, vk::Format::eR32G32Uint, vk::Format::eR32G32B32Uint, vk::Format::eR32G32B32A32Uint };
+        static const vk::Format float16Formats[] = { vk::Format::eR16Sfloat, vk::Format::eR16G16Sfloat, vk::Format::eR16G16B16Sfloat, vk::Format::eR16G16B16A16Sfloat };
+        static const vk::Format float64Formats[] = { vk::Format::eR64Sfloat, vk::Format::eR64G64Sfloat, vk::Format::eR64G64B64Sfloat, vk::Format::eR64G64B64A64Sfloat };
+
+        if( scalarType.m_opcode == SpvOp::eTypeFloat )
+        {
+            if( scalarType.m_width == 32u ) return float32Formats[numOfComponents - 1];
+            if( scalarType.m_width == 16u ) return float16Formats[numOfComponents - 1];
+            if( scalarType.m_width == 64u ) return float64Formats[numOfComponents - 1];
+        }
+        else if( scalarType.m_opcode == SpvOp::eTypeInt && scalarType.m_width == 32u )
+        {
+            return scalarType.m_bSigned ? sint32Formats[numOfComponents - 1] : uint32Formats[numOfComponents - 1];
+        }
+
+        return vk::Format::eUndefined;
+    }
+
+    std::optional<vk::DescriptorType> SpirvParser::descriptorTypeOf( const SpvId& type, const std::uint32_t& storageClass ) const
+    {
+        switch( type.m_opcode )
+        {
+        case SpvOp::eTypeStruct:
+            if( storageClass == SpvStorageClass::eStorageBuffer || type.m_bBufferBlock )
+                return vk::DescriptorType::eStorageBuffer;
+            if( storageClass == SpvStorageClass::eUniform )
+                return vk::DescriptorType::eUniformBuffer;
+            return std::nullopt;
+        case SpvOp::eTypeSampler:
+            return vk::DescriptorType::eSampler;
+        case SpvOp::eTypeSampledImage:
+            return vk::DescriptorType::eCombinedImageSampler;
+        case SpvOp::eTypeImage:
+            if( type.m_imageDim == SpvDim::eBuffer )
+                return type.m_imageSampled == 2u ? vk::DescriptorType::eStorageTexelBuffer : vk::DescriptorType::eUniformTexelBuffer;
+            if( type.m_imageDim == SpvDim::eSubpassData )
+                return vk::DescriptorType::eInputAttachment;
+            return type.m_imageSampled == 2u ? vk::DescriptorType::eStorageImage : vk::DescriptorType::eSampledImage;
+        case SpvOp::eTypeAccelerationStructure:
+            return vk::DescriptorType::eAccelerationStructureKHR;
+        default:
+            return std::nullopt;
+        }
+    }
+
+    std::unordered_set<std::uint32_t> SpirvParser::usedVariables( const SpvEntryPoint& entryPoint ) const
+    {
+        if( m_words[1] >= SPIRV_VERSION_1_4 )
+            return std::unordered_set<std::uint32_t>( entryPoint.m_interfaceIds.begin(), entryPoint.m_interfaceIds.end() );
+
+        // older modules only list inputs and outputs, walk the call graph of the entry point instead
+        std::unordered_set<std::uint32_t> usedVariableIds;
+        std::unordered_set<std::uint32_t> visitedFunctionIds{ entryPoint.m_functionId };
+        std::vector<std::uint32_t> pendingFunctionIds{ entryPoint.m_functionId };
+
+        while( !pendingFunctionIds.empty() )
+        {
+            const std::uint32_t functionId = pendingFunctionIds.back();
+            pendingFunctionIds.pop_back();
+
+            auto functionItr = m_functions.find( functionId );
+            if( functionItr == m_functions.end() )
+                continue;
+
+            usedVariableIds.insert( functionItr->second.m_usedVariableIds.begin(), functionItr->second.m_usedVariableIds.end() );
+            for( const std::uint32_t& calledFunctionId : functionItr->second.m_calledFunctionIds )
+            {
+                if( visitedFunctionIds.insert( calledFunctionId ).second )
+                    pendingFunctionIds.push_back( calledFunctionId );
+            }
+        }
+
+        return usedVariableIds;
+    }
+
+    VulkanShaderReflection SpirvParser::reflect( const std::string& entryPoint ) const
+    {
+        auto entryPointItr = std::find_if( m_entryPoints.begin(), m_entryPoints.end(), [&entryPoint]( const SpvEntryPoint& candidate ){
+            return candidate.m_name == entryPoint;
+        } );
+        if( entryPointItr == m_entryPoints.end() )
+            fail( fmt::format( "entry point {} not found", entryPoint ) );
+
+        VulkanShaderReflection reflection{};
+        reflection.m_entryPoint = entryPoint;
+
+        switch( entryPointItr->m_executionModel )
+        {
+        case 0: reflection.m_shaderStage = vk::ShaderStageFlagBits::eVertex; break;
+        case 1: reflection.m_shaderStage = vk::ShaderStageFlagBits::eTessellationControl; break;
+        case 2: reflection.m_shaderStage = vk::ShaderStageFlagBits::eTessellationEvaluation; break;
+        case 3: reflection.m_shaderStage = vk::ShaderStageFlagBits::eGeometry; break;
+        case 4: reflection.m_shaderStage = vk::ShaderStageFlagBits::eFragment; break;
+        case 5: reflection.m_shaderStage = vk::ShaderStageFlagBits::eCompute; break;
+        case 5364: reflection.m_shaderStage = vk::ShaderStageFlagBits::eTaskEXT; break;
+        case 5365: reflection.m_shaderStage = vk::ShaderStageFlagBits::eMeshEXT; break;
+        default: fail( fmt::format( "unsupported execution model {}", entryPointItr->m_executionModel ) );
+        }
+
+        const std::vector<std::uint32_t>& interfaceIds = entryPointItr->m_interfaceIds;
+        // resources of other entry points in the same module stay out of this stage's layout
+        const std::unordered_set<std::uint32_t> usedVariableIds = usedVariables( *entryPointItr );
+
+        for( const SpvVariable& variable : m_variables )
+        {
+            const SpvId& variableId = id( variable.m_id );
+            const SpvId& pointerType = id( variable.m_pointerTypeId );
+
+            if( variable.m_storageClass == SpvStorageClass::eUniformConstant ||
+                variable.m_storageClass == SpvStorageClass::eUniform ||
+                variable.m_storageClass == SpvStorageClass::eStorageBuffer )
+            {
+                if( !variableId.m_binding.has_value() || usedVariableIds.count( variable.m_id ) == 0 )
+                    continue;
+
+                // peel arrays of descriptors down to the resource type
+                std::uint32_t descriptorCount = 1u;
+                const SpvId* pResourceType = &id( pointerType.m_elementTypeId );
+                while( pResourceType->m_opcode == SpvOp::eTypeArray || pResourceType->m_opcode == SpvOp::eTypeRuntimeArray )
+                {
+                    descriptorCount = pResourceType->m_opcode == SpvOp::eTypeArray ? descriptorCount * arrayLength( *pResourceType ) : 0u;
+                    pResourceType = &id( pResourceType->m_elementTypeId );
+                }
+
+                std::optional<vk::DescriptorType> descriptorType = descriptorTypeOf( *pResourceType, variable.m_storageClass );
+                if( !descriptorType.has_value() )
+                    continue;
+
+                VulkanShaderReflection::DescriptorBinding descriptorBinding{};
+                descriptorBinding.m_set = variableId.m_set.value_or( 0u );
+                descriptorBinding.m_binding = variableId.m_binding.value();
+                descriptorBinding.m_descriptorType = descriptorType.value();
+                descriptorBinding.m_descriptorCount = descriptorCount;
+                descriptorBinding.m_name = variableId.m_name.empty() ? pResourceType->m_name : variableId.m_name;
+                reflection.m_descriptorBindings.push_back( std::move( descriptorBinding ) );
+            }
+            else if( variable.m_storageClass == SpvStorageClass::ePushConstant )
+            {
+                const SpvId& blockType = id( pointerType.m_elementTypeId );
+                if( blockType.m_members.empty() || usedVariableIds.count( variable.m_id ) == 0 )
+                    continue;
+
+                std::uint32_t rangeBegin = std::numeric_limits<std::uint32_t>::max();
+                std::uint32_t rangeEnd = 0u;
+                for( const SpvMember& member : blockType.m_members )
+                {
+                    rangeBegin = std::min( rangeBegin, member.m_offset );
+                    rangeEnd = std::max( rangeEnd, member.m_offset + sizeOfType( member.m_typeId, member.m_matrixStride ) );
+                }
+
+                vk::PushConstantRange pushConstantRange{};
+                pushConstantRange.stageFlags = reflection.m_shaderStage;
+                pushConstantRange.offset = rangeBegin & ~3u;
+                pushConstantRange.size = ( ( rangeEnd - pushConstantRange.offset ) + 3u ) & ~3u;
+                reflection.m_pushConstantRanges.push_back( pushConstantRange );
+            }
+            else if( variable.m_storageClass == SpvStorageClass::eInput )
+            {
+                if( variableId.m_bBuiltIn || !variableId.m_location.has_value() )
+                    continue;
+                if( std::find( interfaceIds.begin(), interfaceIds.end(), variable.m_id ) == interfaceIds.end() )
+                    continue;
+
+                const SpvId& inputType = id( pointerType.m_elementTypeId );
+                if( inputType.m_bBuiltIn )
+                    continue;
+
+                // matrices and arrays take one location per column or element
+                std::uint32_t numOfLocations = 1u;
+                const SpvId* pLocationType = &inputType;
+                if( inputType.m_opcode == SpvOp::eTypeMatrix )
+                {
+                    numOfLocations = inputType.m_elementCount;
+                    pLocationType = &id( inputType.m_elementTypeId );
+                }
+                else if( inputType.m_opcode == SpvOp::eTypeArray )
+                {
+                    numOfLocations = arrayLength( inputType );
+                    pLocationType = &id( inputType.m_elementTypeId );
+                }
+
+                for( std::uint32_t i = 0u; i < numOfLocations; i++ )
+                {
+                    VulkanShaderReflection::InputVariable inputVariable{};
+                    inputVariable.m_location = variableId.m_location.value() + i;
+                    inputVariable.m_format = formatOfType( *pLocationType );
+                    inputVariable.m_sizeInBytes = pLocationType->m_opcode == SpvOp::eTypeVector
+                        ? pLocationType->m_elementCount * sizeOfType( pLocationType->m_elementTypeId )
+                        : sizeOfType( static_cast<std::uint32_t>( pLocationType - m_ids.data() ) );
+                    inputVariable.m_name = variableId.m_name;
+                    reflection.m_inputVariables.push_back( std::move( inputVariable ) );
+                }
+            }
+        }
+
+        for( std::uint32_t idIndex = 0u; idIndex < m_ids.size(); idIndex++ )
+        {
+            const SpvId& constant = m_ids[idIndex];
+            if( !constant.m_specId.has_value() )
+                continue;
+            if( constant.m_opcode != SpvOp::eSpecConstant && constant.m_opcode != SpvOp::eSpecConstantTrue && constant.m_opcode != SpvOp::eSpecConstantFalse )
+                continue;
+
+            VulkanShaderReflection::SpecializationConstant specConstant{};
+            specConstant.m_constantId = constant.m_specId.value();
+            // booleans are specialized through a VkBool32
+            specConstant.m_sizeInBytes = constant.m_opcode == SpvOp::eSpecConstant ? sizeOfType( constant.m_constantTypeId ) : 4u;
+            specConstant.m_defaultValue = constant.m_constantValue;
+            specConstant.m_name = constant.m_name;
+            reflection.m_specializationConstants.push_back( std::move( specConstant ) );
+        }
+
+        std::sort( reflection.m_descriptorBindings.begin(), reflection.m_descriptorBindings.end(), []( const auto& lhs, const auto& rhs ){
+            return lhs.m_set != rhs.m_set ? lhs.m_set < rhs.m_set : lhs.m_binding < rhs.m_binding;
+        } );
+        std::sort( reflection.m_inputVariables.begin(), reflection.m_inputVariables.end(), []( const auto& lhs, const auto& rhs ){
+            return lhs.m_location < rhs.m_location;
+        } );
+        std::sort( reflection.m_specializationConstants.begin(), reflection.m_specializationConstants.end(), []( const auto& lhs, const auto& rhs ){
+            return lhs.m_constantId < rhs.m_constantId;
+        } );
+
+        return reflection;
+    }
+}
+
+VulkanShaderReflector::ReflectionPtr VulkanShaderReflector::reflect( const std::vector<char>& spirvBuffer, const std::string& entryPoint )
+{
+    static std::mutex s_cacheMutex;
+    static std::unordered_map<std::string, ReflectionPtr> s_reflectionCache;
+
+    const std::uint64_t moduleHash = hashModule( spirvBuffer );
+    const std::string cacheKey = fmt::format( "{:016x}:{}", moduleHash, entryPoint );
+
+    {
+        std::lock_guard<std::mutex> lock( s_cacheMutex );
+        auto cacheItr = s_reflectionCache.find( cacheKey );
+        if( cacheItr != s_reflectionCache.end() )
+            return cacheItr->second;
+    }
+
+    auto pReflection = std::make_shared<VulkanShaderReflection>( SpirvParser{ spirvBuffer }.reflect( entryPoint ) );
+    pReflection->m_moduleHash = moduleHash;
+
+    LOG_DEBUG( fmt::format(
+        "Reflected {} {}: {} descriptors {} push constant ranges {} inputs {} specialization constants",
+        vk::to_string( pReflection->m_shaderStage ), entryPoint,
+        pReflection->m_descriptorBindings.size(), pReflection->m_pushConstantRanges.size(),
+        pReflection->m_inputVariables.size(), pReflection->m_specializationConstants.size()
+    ) );
+
+    std::lock_guard<std::mutex> lock( s_cacheMutex );
+    return s_reflectionCache.emplace( cacheKey, std::move( pReflection ) ).first->second;
+}
+
+VulkanPipelineLayoutReflection VulkanShaderReflector::mergeStages( const std::vector<ReflectionPtr>& stageReflections )
+{
+    VulkanPipelineLayoutReflection layoutReflection{};
+
+    std::map<std::pair<std::uint32_t, std::uint32_t>, vk::DescriptorSetLayoutBinding> mergedBindings;
+    for( const ReflectionPtr& pReflection : stageReflections )
+    {
+        for( const VulkanShaderReflection::DescriptorBinding& descriptorBinding : pReflection->m_descriptorBindings )
+        {
+            auto [bindingItr, bInserted] = mergedBindings.try_emplace( std::make_pair( descriptorBinding.m_set, descriptorBinding.m_binding ) );
+            vk::DescriptorSetLayoutBinding& layoutBinding = bindingItr->second;
+
+            if( bInserted )
+            {
+                layoutBinding.binding = descriptorBinding.m_binding;
+                layoutBinding.descriptorType = descriptorBinding.m_descriptorType;
+                layoutBinding.descriptorCount = descriptorBinding.m_descriptorCount;
+            }
+            else if( layoutBinding.descriptorType != descriptorBinding.m_descriptorType )
+            {
+                std::string errorMsg = fmt::format(
+                    "Set {} binding {} is declared as {} and {} by different stages",
+                    descriptorBinding.m_set, descriptorBinding.m_binding,
+                    vk::to_string( layoutBinding.descriptorType ), vk::to_string( descriptorBinding.m_descriptorType )
+                );
+                LOG_ERROR(errorMsg);
+                throw std::runtime_error(errorMsg);
+            }
+            else if( layoutBinding.descriptorCount != 0u )
+            {
+                layoutBinding.descriptorCount = descriptorBinding.m_descriptorCount == 0u ? 0u : std::max( layoutBinding.descriptorCount, descriptorBinding.m_descriptorCount );
+            }
+
+            layoutBinding.stageFlags |= pReflection->m_shaderStage;
+        }
+
+        for( const vk::PushConstantRange& stageRange : pReflection->m_pushConstantRanges )
+        {
+            // stages reading the same block share one range
+            auto rangeItr = std::find_if( layoutReflection.m_pushConstantRanges.begin(), layoutReflection.m_pushConstantRanges.end(), [&stageRange]( const vk::PushConstantRange& range ){
+                return range.offset == stageRange.offset && range.size == stageRange.size;
+            } );
+            if( rangeItr != layoutReflection.m_pushConstantRanges.end() )
+                rangeItr->stageFlags |= stageRange.stageFlags;
+            else
+                layoutReflection.m_pushConstantRanges.push_back( stageRange );
+        }
+    }
+
+    for( const auto& [setBinding, layoutBinding] : mergedBindings )
+    {
+        if( layoutReflection.m_setLayoutBindings.size() <= setBinding.first )
+            layoutReflection.m_setLayoutBindings.resize( setBinding.first + 1 );
+        layoutReflection.m_setLayoutBindings[setBinding.first].push_back( layoutBinding );
+    }
+
+    return layoutReflection;
+}
+
+void VulkanShaderReflector::deriveVertexInput(
+    const VulkanShaderReflection& vertexReflection,
+    std::vector<vk::VertexInputBindingDescription>& vertexBindings,
+    std::vector<vk::VertexInputAttributeDescription>& vertexAttributes
+)
+{
+    vertexBindings.clear();
+    vertexAttributes.clear();
+
+    std::uint32_t stride = 0u;
+    for( const VulkanShaderReflection::InputVariable& inputVariable : vertexReflection.m_inputVariables )
+    {
+        if( inputVariable.m_format == vk::Format::eUndefined )
+        {
+            std::string errorMsg = fmt::format( "Vertex input {} at location {} has no vertex format", inputVariable.m_name, inputVariable.m_location );
+            LOG_ERROR(errorMsg);
+            throw std::runtime_error(errorMsg);
+        }
+
+        vk::VertexInputAttributeDescription attribute{};
+        attribute.location = inputVariable.m_location;
+        attribute.binding = 0u;
+        attribute.format = inputVariable.m_format;
+        attribute.offset = stride;
+        vertexAttributes.push_back( attribute );
+
+        stride += inputVariable.m_sizeInBytes;
+    }
+
+    if( vertexAttributes.empty() )
+        return;
+
+    vk::VertexInputBindingDescription binding{};
+    binding.binding = 0u;
+    binding.stride = stride;
+    binding.inputRate = vk::VertexInputRate::eVertex;
+    vertexBindings.push_back( binding );
+}
+
+std::uint64_t VulkanShaderReflector::hashModule( const std::vector<char>& spirvBuffer )
+{
+    std::uint64_t hashValue = 14695981039346656037ull;
+    for( const char& byte : spirvBuffer )
+    {
+        hashValue ^= static_cast<std::uint8_t>( byte );
+        hashValue *= 1099511628211ull;
+    }
+    return hashValue;
+}
+
+} // namespace vkrender
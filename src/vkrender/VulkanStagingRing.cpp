@@ -0,0 +1,229 @@
+#include "vkrender/VulkanStagingRing.h"
+#include "vkrender/VulkanRenderer.h"
+#include "utilities/VulkanLogger.h"
+
+namespace vkrender
+{
+
+VulkanStagingRing::VulkanStagingRing( VulkanRenderer* pVkRenderer, const vk::DeviceSize& ringSize )
+    :m_pVkRenderer{ pVkRenderer }
+    ,m_pLogicalDevice{ pVkRenderer->getDevice() }
+    ,m_ringSize{ ringSize }
+    ,m_head{ 0 }
+    ,m_tail{ 0 }
+    ,m_frontSpanId{ 1 }
+{
+    m_pVkRenderer->createBuffer(
+        m_ringSize,
+        vk::BufferUsageFlagBits::eTransferSrc, m_pVkRenderer->getStagingSharingMode(),
+        VulkanMemoryUsage::eUpload,
+        m_vkRingBuffer, m_ringAllocation,
+        "staging ring"
+    );
+}
+
+VulkanStagingRing::~VulkanStagingRing()
+{
+    waitIdle();
+
+    if( !m_spans.empty() )
+        LOG_DEBUG( fmt::format( "Staging Ring destroyed with {} spans that were never submitted", m_spans.size() ) );
+
+    for( Span& span : m_spans )
+    {
+        for( SpillBuffer& spillBuffer : span.m_spillBuffers )
+            m_pVkRenderer->destroyBuffer( spillBuffer.m_vkBuffer, spillBuffer.m_allocation );
+        if( span.m_vkFence )
+            m_pLogicalDevice->destroyFence( span.m_vkFence );
+    }
+
+    for( const vk::Fence& vkFence : m_freeFences )
+        m_pLogicalDevice->destroyFence( vkFence );
+
+    m_pVkRenderer->destroyBuffer( m_vkRingBuffer, m_ringAllocation );
+
+    LOG_DEBUG( fmt::format(
+        "Staging Ring Destroyed stalls: {} wraps: {} spills: {} staged: {} bytes",
+        m_statistics.m_stallCount, m_statistics.m_wrapCount, m_statistics.m_spillCount, m_statistics.m_bytesStaged
+    ) );
+}
+
+VulkanStagingSpan VulkanStagingRing::beginSpan()
+{
+    std::lock_guard<std::mutex> lock( m_ringMutex );
+
+    Span& span = m_spans.emplace_back();
+    span.m_begin = m_head;
+
+    return VulkanStagingSpan{ m_frontSpanId + m_spans.size() - 1 };
+}
+
+VulkanStagingRegion VulkanStagingRing::allocate( const VulkanStagingSpan& span, const vk::DeviceSize& size, const vk::DeviceSize& alignment )
+{
+    std::lock_guard<std::mutex> lock( m_ringMutex );
+
+    // open spans are never retired, the reference stays valid while older spans are
+    Span& allocSpan = findSpan( span );
+    if( allocSpan.m_bSubmitted )
+    {
+        std::string errorMsg = fmt::format( "Staging span {} allocated from after its submission", span.m_id );
+        LOG_ERROR(errorMsg);
+        throw std::logic_error(errorMsg);
+    }
+
+    m_statistics.m_bytesStaged += size;
+
+    if( size > m_ringSize )
+        return allocateSpill( allocSpan, size );
+
+    reclaimSignalled();
+
+    while( true )
+    {
+        vk::DeviceSize start = ( m_head + alignment - 1 ) & ~( alignment - 1 );
+        const vk::DeviceSize physicalOffset = start % m_ringSize;
+        const bool bWrapped = physicalOffset + size > m_ringSize;
+        if( bWrapped )
+            start += m_ringSize - physicalOffset;
+
+        if( start + size - m_tail <= m_ringSize )
+        {
+            if( bWrapped )
+                m_statistics.m_wrapCount++;
+            m_head = start + size;
+
+            VulkanStagingRegion region{};
+            region.m_vkBuffer = m_vkRingBuffer;
+            region.m_offset = start % m_ringSize;
+            region.m_size = size;
+            region.m_pMapped = static_cast<std::uint8_t*>( m_ringAllocation.m_pMapped ) + region.m_offset;
+            return region;
+        }
+
+        // the oldest span is still being recorded, by this thread or another one, waiting cannot help
+        if( m_spans.empty() || !m_spans.front().m_bSubmitted )
+            return allocateSpill( allocSpan, size );
+
+        m_statistics.m_stallCount++;
+        retireFrontSpan( true );
+    }
+}
+
+vk::Fence VulkanStagingRing::submitFence( const VulkanStagingSpan& span )
+{
+    std::lock_guard<std::mutex> lock( m_ringMutex );
+
+    Span& submittedSpan = findSpan( span );
+    if( submittedSpan.m_bSubmitted )
+    {
+        std::string errorMsg = fmt::format( "Staging span {} submitted twice", span.m_id );
+        LOG_ERROR(errorMsg);
+        throw std::logic_error(errorMsg);
+    }
+
+    if( m_freeFences.empty() )
+    {
+        submittedSpan.m_vkFence = m_pLogicalDevice->createFence( vk::FenceCreateInfo{} );
+    }
+    else
+    {
+        submittedSpan.m_vkFence = m_freeFences.back();
+        m_freeFences.pop_back();
+    }
+    submittedSpan.m_bSubmitted = true;
+
+    return submittedSpan.m_vkFence;
+}
+
+void VulkanStagingRing::reclaim()
+{
+    std::lock_guard<std::mutex> lock( m_ringMutex );
+    reclaimSignalled();
+}
+
+void VulkanStagingRing::waitIdle()
+{
+    std::lock_guard<std::mutex> lock( m_ringMutex );
+
+    while( !m_spans.empty() && m_spans.front().m_bSubmitted )
+        retireFrontSpan( true );
+}
+
+VulkanStagingRing::Statistics VulkanStagingRing::statistics() const
+{
+    std::lock_guard<std::mutex> lock( m_ringMutex );
+    return m_statistics;
+}
+
+VulkanStagingRing::Span& VulkanStagingRing::findSpan( const VulkanStagingSpan& span )
+{
+    if( span.m_id < m_frontSpanId || span.m_id - m_frontSpanId >= m_spans.size() )
+    {
+        std::string errorMsg = fmt::format( "Staging span {} is not open", span.m_id );
+        LOG_ERROR(errorMsg);
+        throw std::invalid_argument(errorMsg);
+    }
+
+    return m_spans[ static_cast<std::size_t>( span.m_id - m_frontSpanId ) ];
+}
+
+VulkanStagingRegion VulkanStagingRing::allocateSpill( Span& span, const vk::DeviceSize& size )
+{
+    m_statistics.m_spillCount++;
+    LOG_DEBUG( fmt::format( "Staging Ring spilling {} bytes to a temporary buffer", size ) );
+
+    SpillBuffer& spillBuffer = span.m_spillBuffers.emplace_back();
+    m_pVkRenderer->createBuffer(
+        size,
+        vk::BufferUsageFlagBits::eTransferSrc, m_pVkRenderer->getStagingSharingMode(),
+        VulkanMemoryUsage::eUpload,
+        spillBuffer.m_vkBuffer, spillBuffer.m_allocation,
+        "staging spill"
+    );
+
+    VulkanStagingRegion region{};
+    region.m_vkBuffer = spillBuffer.m_vkBuffer;
+    region.m_offset = 0;
+    region.m_size = size;
+    region.m_pMapped = spillBuffer.m_allocation.m_pMapped;
+    return region;
+}
+
+void VulkanStagingRing::reclaimSignalled()
+{
+    while(
+        !m_spans.empty() && m_spans.front().m_bSubmitted &&
+        m_pLogicalDevice->getFenceStatus( m_spans.front().m_vkFence ) == vk::Result::eSuccess
+    )
+        retireFrontSpan( false );
+}
+
+void VulkanStagingRing::retireFrontSpan( const bool& bWait )
+{
+    Span& span = m_spans.front();
+
+    if( bWait )
+    {
+        vk::Result waitResult = m_pLogicalDevice->waitForFences( 1, &span.m_vkFence, VK_TRUE, std::numeric_limits<std::uint64_t>::max() );
+        if( waitResult != vk::Result::eSuccess )
+        {
+            std::string errorMsg = "Failed to wait for staging ring fence";
+            LOG_ERROR(errorMsg);
+            throw std::runtime_error(errorMsg);
+        }
+    }
+
+    m_pLogicalDevice->resetFences( span.m_vkFence );
+    m_freeFences.push_back( span.m_vkFence );
+
+    for( SpillBuffer& spillBuffer : span.m_spillBuffers )
+        m_pVkRenderer->destroyBuffer( spillBuffer.m_vkBuffer, spillBuffer.m_allocation );
+
+    m_spans.pop_front();
+    m_frontSpanId++;
+
+    // regions of later spans never start before the head at the time they were opened
+    m_tail = m_spans.empty() ? m_head : m_spans.front().m_begin;
+}
+
+} // namespace vkrender
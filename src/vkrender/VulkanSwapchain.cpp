@@ -3,6 +3,8 @@
 #include "vkrender/VulkanHelpers.h"
 #include "utilities/VulkanLogger.h"
 
+#include <limits>
+
 namespace vkrender
 {
 
@@ -10,6 +12,8 @@ VulkanSwapchain::VulkanSwapchain( const SwapchainCreateInfo& swapchainCreateInfo
     :m_vkPhysicalDevice{ swapchainCreateInfo.vkPhysicalDevice }
     ,m_vkLogicalDevice{ swapchainCreateInfo.vkLogicalDevice }
     ,m_vkSurface{ swapchainCreateInfo.vkSurface }
+    ,m_queueFamilyIndices{ swapchainCreateInfo.queueFamilyIndices }
+    ,m_pMemoryAllocator{ swapchainCreateInfo.pMemoryAllocator }
     ,m_vkSampleCount{ swapchainCreateInfo.vkSampleCount }
 {}
 
@@ -28,7 +32,7 @@ void VulkanSwapchain::createSwapchain( const utils::Dimension& framebufferDimens
     vk::Extent2D imageExtent = chooseSwapExtent( swapChainSupportDetails, m_framebufferSize );
     vk::PresentModeKHR presentMode = chooseSwapPresentMode( swapChainSupportDetails );
 
-	QueueFamilyIndices queueFamilyIndices = VulkanHelpers::findQueueFamilyIndices( m_vkPhysicalDevice, &m_vkSurface );
+	const QueueFamilyIndices& queueFamilyIndices = m_queueFamilyIndices;
 	std::vector<std::uint32_t> queueFamilyContainer;
     if( queueFamilyIndices.m_graphicsFamily.value() != queueFamilyIndices.m_presentFamily.value() )
     {
@@ -100,16 +104,37 @@ void VulkanSwapchain::recreateSwapchain( const utils::Dimension& framebufferDime
 #endif
 }
 
+vk::Result VulkanSwapchain::acquireNextImage( const vk::Semaphore& imageAvailableSemaphore, std::uint32_t& imageIndex )
+{
+	return m_vkLogicalDevice.acquireNextImageKHR(
+		m_vkSwapchain, std::numeric_limits<std::uint64_t>::max(),
+		imageAvailableSemaphore, nullptr,
+		&imageIndex
+	);
+}
+
+vk::Result VulkanSwapchain::present( const vk::Queue& presentationQueue, const vk::Semaphore& renderFinishedSemaphore, const std::uint32_t& imageIndex )
+{
+	vk::PresentInfoKHR presentInfo{};
+	presentInfo.waitSemaphoreCount = 1;
+	presentInfo.pWaitSemaphores = &renderFinishedSemaphore;
+	presentInfo.swapchainCount = 1;
+	presentInfo.pSwapchains = &m_vkSwapchain;
+	presentInfo.pImageIndices = &imageIndex;
+
+	return presentationQueue.presentKHR( &presentInfo );
+}
+
 void VulkanSwapchain::destroySwapchain()
 {
 #if 0
 	m_vkLogicalDevice.destroyImageView( m_vkColorImageView );
 	m_vkLogicalDevice.destroyImage( m_vkColorImage );
-	m_vkLogicalDevice.freeMemory( m_vkColorImageMemory );
+	m_pMemoryAllocator->free( m_colorImageAllocation );
 
 	m_vkLogicalDevice.destroyImageView( m_vkDepthImageView );
 	m_vkLogicalDevice.destroyImage( m_vkDepthImage );
-	m_vkLogicalDevice.freeMemory( m_vkDepthImageMemory );
+	m_pMemoryAllocator->free( m_depthImageAllocation );
 
 	for( auto& vkFramebuffer : m_vkSwapchainFramebuffers )
 	{
@@ -132,13 +157,13 @@ void VulkanSwapchain::destroySwapchain()
 void VulkanSwapchain::createColorResources()
 {
 	VulkanHelpers::createImage(
-        m_vkPhysicalDevice, m_vkLogicalDevice,
+        m_pMemoryAllocator, m_vkLogicalDevice,
 		m_vkSwapchainExtent.width, m_vkSwapchainExtent.height, 1,
 		m_vkSampleCount,
 		m_vkSwapchainImageFormat, vk::ImageTiling::eOptimal,
 		vk::ImageUsageFlagBits::eTransientAttachment | vk::ImageUsageFlagBits::eColorAttachment,
 		vk::MemoryPropertyFlagBits::eDeviceLocal,
-		m_vkColorImage, m_vkColorImageMemory
+		m_vkColorImage, m_colorImageAllocation
 	);
 
 	m_vkColorImageView = VulkanHelpers::createImageView(
@@ -154,11 +179,11 @@ void VulkanSwapchain::createDepthResources()
 	m_vkDepthImageFormat = findDepthFormat();
 
 	VulkanHelpers::createImage(
-        m_vkPhysicalDevice, m_vkLogicalDevice,
+        m_pMemoryAllocator, m_vkLogicalDevice,
 		m_vkSwapchainExtent.width, m_vkSwapchainExtent.height, 1, m_vkSampleCount,
 		m_vkDepthImageFormat, vk::ImageTiling::eOptimal, 
 		vk::ImageUsageFlagBits::eDepthStencilAttachment, vk::MemoryPropertyFlagBits::eDeviceLocal,
-		m_vkDepthImage, m_vkDepthImageMemory
+		m_vkDepthImage, m_depthImageAllocation
 	);
 	m_vkDepthImageView = VulkanHelpers::createImageView(
         m_vkLogicalDevice,
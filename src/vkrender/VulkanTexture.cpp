@@ -1,6 +1,7 @@
 #include "vkrender/VulkanTexture.h"
 #include "vkrender/VulkanTextureManager.h"
 #include "vkrender/VulkanHelpers.h"
+#include "utilities/VulkanLogger.h"
 
 namespace vkrender
 {
@@ -19,16 +20,29 @@ VulkanTexture::VulkanTexture(
     ,m_vkImgFormat{ imgFormat }
     ,m_vkImgTiling{ imgTiling }
     ,m_vkImgUsageFlags{ imgUsageFlags }
+    ,m_vkImgCreateFlags{}
     ,m_vkImgMemoryFlags{ memoryPropertyFlags }
     ,m_vkImgSampleCountFlags{ imgSampleCountFlags }
     ,m_vkImgAspect{ imgAspect }
+    ,m_bindlessSlot{ VulkanBindlessTable::INVALID_SLOT }
 {}
 
 VulkanTexture::~VulkanTexture()
 {
+    if( m_bindlessSlot != VulkanBindlessTable::INVALID_SLOT )
+        m_pTextureManager->getRenderer()->getBindlessTable()->releaseSampledImage( m_bindlessSlot );
+
+    // frames in flight may still sample the image, the queue frees it once they retired
+    if( VulkanDeletionQueue* pDeletionQueue = m_pTextureManager->getRenderer()->getDeletionQueue() )
+    {
+        pDeletionQueue->destroyImageView( m_vkImageView );
+        pDeletionQueue->destroyImage( m_vkImage, m_imgAllocation );
+        return;
+    }
+
     m_pTextureManager->getDevice()->destroyImageView( m_vkImageView );
     m_pTextureManager->getDevice()->destroyImage( m_vkImage );
-    m_pTextureManager->getDevice()->freeMemory( m_vkImgMemory );
+    m_pTextureManager->getRenderer()->getMemoryAllocator()->free( m_imgAllocation );
 }
 
 void VulkanTexture::createImage()
@@ -45,21 +59,22 @@ void VulkanTexture::createImage()
     imgCreateInfo.initialLayout = vk::ImageLayout::eUndefined;
     imgCreateInfo.usage = m_vkImgUsageFlags;
     imgCreateInfo.samples = m_vkImgSampleCountFlags;
-    imgCreateInfo.flags = {};
+    imgCreateInfo.flags = m_vkImgCreateFlags;
 
     vk::Device* pDevice = m_pTextureManager->getDevice();
     m_vkImage = pDevice->createImage( imgCreateInfo );
 
+    VulkanMemoryAllocator* pMemoryAllocator = m_pTextureManager->getRenderer()->getMemoryAllocator();
     vk::MemoryRequirements memRequirements = pDevice->getImageMemoryRequirements( m_vkImage );
-    vk::MemoryAllocateInfo allocInfo{};
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = VulkanHelpers::findMemoryType(
-        m_pTextureManager->getRenderer()->getPhysicalDevice(),
-        memRequirements.memoryTypeBits, m_vkImgMemoryFlags
-    );
+    VulkanMemoryAllocator::ResourceKind resourceKind = m_vkImgTiling == vk::ImageTiling::eOptimal ? VulkanMemoryAllocator::ResourceKind::eOptimal : VulkanMemoryAllocator::ResourceKind::eLinear;
+
+    m_imgAllocation = pMemoryAllocator->allocate( memRequirements, m_vkImgMemoryFlags, resourceKind, "texture" );
+    pMemoryAllocator->bindImageMemory( m_vkImage, m_imgAllocation );
+}
 
-    m_vkImgMemory = pDevice->allocateMemory( allocInfo );
-    pDevice->bindImageMemory( m_vkImage, m_vkImgMemory, 0 );
+void VulkanTexture::setName( const std::string& name )
+{
+    m_pTextureManager->getRenderer()->getMemoryAllocator()->setOwner( m_imgAllocation, fmt::format( "texture {}", name ) );
 }
 
 void VulkanTexture::createImageView()
@@ -82,6 +97,12 @@ void VulkanTexture::createImageView()
     subResourceRange.layerCount = 1;
     imgViewCreateInfo.subresourceRange = subResourceRange;
 
+    // usages the view format cannot support, such as storage on sRGB, are left to aliasing views
+    vk::ImageViewUsageCreateInfo viewUsageInfo{};
+    viewUsageInfo.usage = m_vkImgUsageFlags & ~vk::ImageUsageFlagBits::eStorage;
+    if( m_vkImgCreateFlags & vk::ImageCreateFlagBits::eExtendedUsage )
+        imgViewCreateInfo.pNext = &viewUsageInfo;
+
     m_vkImageView = m_pTextureManager->getDevice()->createImageView( imgViewCreateInfo );
 }
 
@@ -4,11 +4,16 @@
 #include "vkrender/VulkanHelpers.h"
 #include "utilities/VulkanLogger.h"
 
+#include <algorithm>
+#include <unordered_map>
+
 namespace vkrender
 {
 
 VulkanTextureManager::VulkanTextureManager( vkrender::VulkanRenderer* pVkRenderer )
     :m_pVkRenderer{ pVkRenderer }
+    ,m_cpuMipmapSettings{}
+    ,m_bCpuMipmapsAlways{ false }
 {}
 
 VulkanTextureManager::~VulkanTextureManager()
@@ -22,15 +27,27 @@ VulkanTexture* VulkanTextureManager::createTexture(
     const vk::ImageAspectFlags& imgAspect
 )
 {
-    VulkanTexture* pTexture = &m_textureArray.emplace_back(
+    // the downsampler writes every level below the first through storage views
+    const bool bComputeMipmaps = m_pComputeDownsampler && miplevels > 1 && m_pComputeDownsampler->isFormatSupported( imgFormat );
+    const vk::ImageUsageFlags textureUsageFlags = bComputeMipmaps ? imgUsageFlags | VulkanComputeDownsampler::requiredUsage() : imgUsageFlags;
+
+    VulkanTexture* pTexture = m_textureArray.emplace_back( std::make_unique<VulkanTexture>(
         this, texDimension, miplevels,
         imgFormat, imgTiling,
-        imgUsageFlags, memoryPropertyFlags,
+        textureUsageFlags, memoryPropertyFlags,
         imgSampleCountFlags, imgAspect
-    );
+    ) ).get();
+
+    if( bComputeMipmaps )
+        pTexture->m_vkImgCreateFlags = VulkanComputeDownsampler::requiredCreateFlags( imgFormat );
 
     pTexture->createImage();
 	pTexture->createImageView();
+
+    VulkanBindlessTable* pBindlessTable = m_pVkRenderer->getBindlessTable();
+    if( pBindlessTable && ( imgUsageFlags & vk::ImageUsageFlagBits::eSampled ) )
+        pTexture->m_bindlessSlot = pBindlessTable->registerSampledImage( pTexture->m_vkImageView );
+
     return pTexture;
 }
 
@@ -42,9 +59,13 @@ VulkanTexture* VulkanTextureManager::createTextureAndUploadBuffer(
     const vk::ImageAspectFlags& imgAspect
 )
 {
+    const vk::Format textureFormat = selectTextureFormat( img, imgFormat );
+    utils::Uptr<utils::Image> pMipChain = needsCpuMipmaps( img, textureFormat ) ? generateCpuMipmaps( img, textureFormat ) : nullptr;
+    const utils::Image& uploadImg = pMipChain ? *pMipChain : img;
+
     VulkanTexture* pTexture = createTexture(
-        img.dimension(), img.miplevels(),
-        imgFormat, imgTiling,
+        uploadImg.dimension(), uploadImg.miplevels(),
+        textureFormat, imgTiling,
         imgUsageFlags, memoryPropertyFlags,
         imgSampleCountFlags, imgAspect
     );
@@ -55,14 +76,179 @@ VulkanTexture* VulkanTextureManager::createTextureAndUploadBuffer(
     );
 
     transferImgBufferToTexture(
-        img, pTexture
+        uploadImg, pTexture
     );
 
-	generateMipmaps( pTexture );
+	// every level came from the file or the CPU generator, nothing to blit
+	if( uploadImg.storedMiplevels() == uploadImg.miplevels() )
+		transitionImageLayout( pTexture, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal );
+	else
+		generateMipmaps( pTexture );
 
 	return pTexture;
 }
 
+std::vector<VulkanTexture*> VulkanTextureManager::createTexturesAndUploadBuffers(
+    const std::vector<const utils::Image*>& images,
+    const vk::Format& imgFormat, const vk::ImageTiling& imgTiling,
+    const vk::ImageUsageFlags& imgUsageFlags, const vk::MemoryPropertyFlags& memoryPropertyFlags,
+    const vk::SampleCountFlagBits& imgSampleCountFlags,
+    const vk::ImageAspectFlags& imgAspect
+)
+{
+	std::vector<VulkanTexture*> textures;
+	textures.reserve( images.size() );
+
+	// images with CPU built chains are uploaded in place of their source, the chains live until recording is done
+	std::vector<const utils::Image*> uploadImages = images;
+	std::vector<utils::Uptr<utils::Image>> mipChains;
+
+	for( const utils::Image*& pImg : uploadImages )
+	{
+		const vk::Format textureFormat = selectTextureFormat( *pImg, imgFormat );
+		if( needsCpuMipmaps( *pImg, textureFormat ) )
+			pImg = mipChains.emplace_back( generateCpuMipmaps( *pImg, textureFormat ) ).get();
+
+		textures.push_back( createTexture(
+			pImg->dimension(), pImg->miplevels(),
+			textureFormat, imgTiling,
+			imgUsageFlags, memoryPropertyFlags,
+			imgSampleCountFlags, imgAspect
+		) );
+	}
+
+	if( textures.empty() )
+		return textures;
+
+	// each batch takes at most half of the staging ring so the next one can be filled while the previous executes
+	VulkanStagingRing* pStagingRing = m_pVkRenderer->m_pStagingRing.get();
+	const vk::DeviceSize batchBudget = pStagingRing->size() / 2;
+
+	std::vector<vk::CommandBuffer> cmdBuffers;
+	std::size_t batchBegin = 0;
+	vk::DeviceSize batchBytes = 0;
+
+	for( std::size_t i = 0; i <= uploadImages.size(); i++ )
+	{
+		const bool bLastImage = i == uploadImages.size();
+		const vk::DeviceSize imgBytes = bLastImage ? 0 : uploadImages[i]->sizeInBytes() + VulkanStagingRing::DEFAULT_ALIGNMENT;
+
+		if( i > batchBegin && ( bLastImage || batchBytes + imgBytes > batchBudget ) )
+		{
+			const VulkanStagingSpan stagingSpan = pStagingRing->beginSpan();
+			vk::CommandBuffer* pVkCmdBuffer = nullptr;
+			{
+				// the pool is shared with other threads and with the deletion queue freeing earlier batches
+				std::lock_guard<std::mutex> poolLock{ m_pVkRenderer->m_graphicsCommandPoolMutex };
+
+				vk::CommandBufferAllocateInfo allocInfo{};
+				allocInfo.commandPool = m_pVkRenderer->m_vkGraphicsCommandPool;
+				allocInfo.level = vk::CommandBufferLevel::ePrimary;
+				allocInfo.commandBufferCount = 1;
+				pVkCmdBuffer = &cmdBuffers.emplace_back( getDevice()->allocateCommandBuffers( allocInfo )[0] );
+
+				vk::CommandBufferBeginInfo beginInfo{};
+				beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+				pVkCmdBuffer->begin( beginInfo );
+
+				recordTextureBatch(
+					*pVkCmdBuffer, stagingSpan,
+					std::vector<const utils::Image*>( uploadImages.begin() + batchBegin, uploadImages.begin() + i ),
+					std::vector<VulkanTexture*>( textures.begin() + batchBegin, textures.begin() + i )
+				);
+
+				pVkCmdBuffer->end();
+			}
+			const vk::CommandBuffer& vkCmdBuffer = *pVkCmdBuffer;
+
+			vk::SubmitInfo submitInfo{};
+			submitInfo.commandBufferCount = 1;
+			submitInfo.pCommandBuffers = &vkCmdBuffer;
+			if( m_pVkRenderer->submit( m_pVkRenderer->m_vkGraphicsQueue, 1, &submitInfo, pStagingRing->submitFence( stagingSpan ) ) != vk::Result::eSuccess )
+			{
+				std::string errorMsg = "Failed to submit texture upload batch";
+				LOG_ERROR(errorMsg);
+				throw std::runtime_error(errorMsg);
+			}
+
+			batchBegin = i;
+			batchBytes = 0;
+		}
+
+		batchBytes += imgBytes;
+	}
+
+	// later graphics submissions are ordered after the batches, the host does not have to wait for them
+	m_pVkRenderer->m_pDeletionQueue->freeCommandBuffers( m_pVkRenderer->m_vkGraphicsCommandPool, &m_pVkRenderer->m_graphicsCommandPoolMutex, cmdBuffers );
+
+	LOG_INFO( fmt::format( "Uploaded {} textures in {} submissions", textures.size(), cmdBuffers.size() ) );
+	if( !mipChains.empty() )
+		LOG_INFO( fmt::format( "Built {} mip chains on the CPU ({})", mipChains.size(), utils::MipmapGenerator::simdPath() ) );
+
+	return textures;
+}
+
+std::vector<VulkanTexture*> VulkanTextureManager::createTexturesAndUploadBuffers(
+    utils::ImageLoader& imageLoader, const std::vector<utils::ImageLoader::Handle>& imageHandles,
+    const vk::Format& imgFormat, const vk::ImageTiling& imgTiling,
+    const vk::ImageUsageFlags& imgUsageFlags, const vk::MemoryPropertyFlags& memoryPropertyFlags,
+    const vk::SampleCountFlagBits& imgSampleCountFlags,
+    const vk::ImageAspectFlags& imgAspect
+)
+{
+	std::vector<VulkanTexture*> textures( imageHandles.size(), nullptr );
+
+	std::unordered_map<utils::ImageLoader::Handle, std::size_t> handleIndices;
+	for( std::size_t i = 0; i < imageHandles.size(); i++ )
+		handleIndices.emplace( imageHandles[i], i );
+
+	std::vector<utils::ImageLoader::Handle> pendingHandles = imageHandles;
+
+	while( !pendingHandles.empty() )
+	{
+		const std::vector<utils::ImageLoader::Handle> finishedHandles = imageLoader.waitAny( pendingHandles );
+
+		std::vector<const utils::Image*> readyImages;
+		std::vector<std::size_t> readyIndices;
+
+		for( const utils::ImageLoader::Handle& handle : finishedHandles )
+		{
+			const utils::Image* pImg = imageLoader.image( handle );
+			if( pImg )
+			{
+				readyImages.push_back( pImg );
+				readyIndices.push_back( handleIndices[handle] );
+			}
+			else
+			{
+				LOG_ERROR( fmt::format( "Skipping texture upload, image handle {} failed to decode", handle ) );
+			}
+		}
+
+		if( !readyImages.empty() )
+		{
+			std::vector<VulkanTexture*> readyTextures = createTexturesAndUploadBuffers(
+				readyImages,
+				imgFormat, imgTiling,
+				imgUsageFlags, memoryPropertyFlags,
+				imgSampleCountFlags, imgAspect
+			);
+
+			for( std::size_t i = 0; i < readyTextures.size(); i++ )
+				textures[ readyIndices[i] ] = readyTextures[i];
+		}
+
+		// the pixels were copied into the staging ring while recording
+		for( const utils::ImageLoader::Handle& handle : finishedHandles )
+		{
+			imageLoader.release( handle );
+			pendingHandles.erase( std::find( pendingHandles.begin(), pendingHandles.end(), handle ) );
+		}
+	}
+
+	return textures;
+}
+
 void VulkanTextureManager::transitionImageLayout(
     VulkanTexture* pTexture,
     const vk::ImageLayout& oldLayout, const vk::ImageLayout& newLayout
@@ -152,55 +338,173 @@ void VulkanTextureManager::transferImgBufferToTexture(
 {
     vk::DeviceSize imageSizeInBytes = static_cast<vk::DeviceSize>( img.sizeInBytes() );
 
-    vk::Buffer stagingBuffer;
-    vk::DeviceMemory stagingBufferMemory;
-    vk::SharingMode stagingBufferMemorySharingMode = m_pVkRenderer->m_bHasExclusiveTransferQueue ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive;
-    m_pVkRenderer->createBuffer(
-        imageSizeInBytes,
-        vk::BufferUsageFlagBits::eTransferSrc, stagingBufferMemorySharingMode,
-        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-        stagingBuffer, stagingBufferMemory
-    );
+    const VulkanStagingSpan stagingSpan = m_pVkRenderer->m_pStagingRing->beginSpan();
+    VulkanStagingRegion stagingRegion = m_pVkRenderer->m_pStagingRing->allocate( stagingSpan, imageSizeInBytes );
+    std::memcpy( stagingRegion.m_pMapped, img.buffer(), img.sizeInBytes() );
 
-    void* bufferMapped = getDevice()->mapMemory( stagingBufferMemory, 0, imageSizeInBytes );
-    std::memcpy(bufferMapped, img.buffer(), img.sizeInBytes() );
-    getDevice()->unmapMemory( stagingBufferMemory );
+	std::vector<vk::BufferImageCopy> copyRegions;
+	appendCopyRegions( img, stagingRegion.m_offset, copyRegions );
 
 	utils::Uptr<VulkanCmdBuffer> cmdBuf = std::make_unique<VulkanTemporaryCmdBuffer>( 
 		getDevice(),
 		&m_pVkRenderer->m_vkTransferQueue,
-		&m_pVkRenderer->m_vkTransferCommandPool
+		&m_pVkRenderer->queueMutex( m_pVkRenderer->m_vkTransferQueue ),
+		&m_pVkRenderer->m_vkTransferCommandPool,
+		&m_pVkRenderer->commandPoolMutex( m_pVkRenderer->m_vkTransferCommandPool )
 	);
 	cmdBuf->allocate();
 
-	vk::BufferImageCopy copyRegion{};
-	copyRegion.bufferOffset = 0;
-	copyRegion.bufferRowLength = 0;
-	copyRegion.bufferImageHeight = 0;
-	copyRegion.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
-	copyRegion.imageSubresource.mipLevel = 0;
-	copyRegion.imageSubresource.baseArrayLayer = 0;
-	copyRegion.imageSubresource.layerCount = 1;
-	copyRegion.imageOffset = vk::Offset3D{ 0, 0, 0 };
-	copyRegion.imageExtent = vk::Extent3D{ img.dimension().m_width, img.dimension().m_height, 1 };
-
 	cmdBuf->beginCmdBuffer();
 
 	cmdBuf->handle()->copyBufferToImage(
-		stagingBuffer, pTexture->m_vkImage,
+		stagingRegion.m_vkBuffer, pTexture->m_vkImage,
 		vk::ImageLayout::eTransferDstOptimal,
-		1, &copyRegion
+		static_cast<std::uint32_t>( copyRegions.size() ), copyRegions.data()
 	);
 
+	cmdBuf->signalFenceOnSubmit( m_pVkRenderer->m_pStagingRing->submitFence( stagingSpan ) );
 	cmdBuf->endCmdBuffer();
+}
+
+VulkanUploadTicket VulkanTextureManager::transferImgBufferToTextureAsync(
+    const utils::Image& img, VulkanTexture* pTexture
+)
+{
+	utils::Uptr<utils::Image> pMipChain = needsCpuMipmaps( img, pTexture->m_vkImgFormat ) ? generateCpuMipmaps( img, pTexture->m_vkImgFormat ) : nullptr;
+	const utils::Image& uploadImg = pMipChain ? *pMipChain : img;
+
+	VulkanUploadScheduler::ImageUpload imageUpload{};
+	imageUpload.m_vkImage = pTexture->m_vkImage;
+	imageUpload.m_subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+	imageUpload.m_subresourceRange.baseMipLevel = 0;
+	imageUpload.m_subresourceRange.levelCount = pTexture->m_miplevels;
+	imageUpload.m_subresourceRange.baseArrayLayer = 0;
+	imageUpload.m_subresourceRange.layerCount = 1;
+
+	appendCopyRegions( uploadImg, 0, imageUpload.m_copyRegions );
+
+	// mips are blitted or downsampled on the graphics queue once it owns the image, stored and CPU built chains are copied as they are
+	if( uploadImg.storedMiplevels() < pTexture->m_miplevels && usesComputeMipmaps( pTexture ) )
+	{
+		imageUpload.m_graphicsRecorder = [this, pTexture]( vk::CommandBuffer& vkCmdBuffer ) {
+			m_pComputeDownsampler->record( vkCmdBuffer, { pTexture } );
+		};
+	}
+	else if( uploadImg.storedMiplevels() < pTexture->m_miplevels )
+	{
+		validateMipmapSupport( pTexture );
+		imageUpload.m_graphicsRecorder = [this, pTexture]( vk::CommandBuffer& vkCmdBuffer ) {
+			recordMipmapGeneration( vkCmdBuffer, pTexture );
+		};
+	}
 
-	getDevice()->destroyBuffer( stagingBuffer, nullptr );
-	getDevice()->freeMemory( stagingBufferMemory, nullptr );
+	return m_pVkRenderer->m_pUploadScheduler->uploadImage(
+		uploadImg.buffer(), static_cast<vk::DeviceSize>( uploadImg.sizeInBytes() ),
+		imageUpload
+	);
 }
 
 void VulkanTextureManager::generateMipmaps( VulkanTexture* pTexture )
 {
-	vk::FormatProperties formatProps = m_pVkRenderer->m_vkPhysicalDevice.getFormatProperties( pTexture->m_vkImgFormat );
+	// the dispatch stays on the graphics queue, which owns the image and runs the fragment shaders sampling it,
+	// a separate compute family would need ownership transfers both ways for a submission that is waited for anyway
+	if( usesComputeMipmaps( pTexture ) )
+	{
+		utils::Uptr<VulkanCmdBuffer> cmdBuf = std::make_unique<VulkanTemporaryCmdBuffer>(
+			getDevice(),
+			&m_pVkRenderer->m_vkGraphicsQueue,
+			&m_pVkRenderer->m_graphicsQueueMutex,
+			&m_pVkRenderer->m_vkGraphicsCommandPool,
+			&m_pVkRenderer->m_graphicsCommandPoolMutex
+		);
+		cmdBuf->allocate();
+
+		cmdBuf->beginCmdBuffer();
+
+		m_pComputeDownsampler->record( *cmdBuf->handle(), { pTexture } );
+
+		cmdBuf->endCmdBuffer();
+		return;
+	}
+
+	validateMipmapSupport( pTexture );
+
+	utils::Uptr<VulkanCmdBuffer> cmdBuf = std::make_unique<VulkanTemporaryCmdBuffer>( 
+		getDevice(),
+		&m_pVkRenderer->m_vkGraphicsQueue,
+		&m_pVkRenderer->m_graphicsQueueMutex,
+		&m_pVkRenderer->m_vkGraphicsCommandPool,
+		&m_pVkRenderer->m_graphicsCommandPoolMutex
+	);
+	cmdBuf->allocate();
+
+	cmdBuf->beginCmdBuffer();
+
+	recordMipmapGeneration( *cmdBuf->handle(), pTexture );
+
+	cmdBuf->endCmdBuffer();
+}
+
+void VulkanTextureManager::setCpuMipmapGeneration( const utils::MipmapGenerator::Settings& settings, const bool& bAlwaysOnCpu )
+{
+	m_cpuMipmapSettings = settings;
+	m_bCpuMipmapsAlways = bAlwaysOnCpu;
+}
+
+void VulkanTextureManager::setComputeMipmapGeneration( const bool& bEnable )
+{
+	if( !bEnable )
+		m_pComputeDownsampler.reset();
+	else if( !m_pComputeDownsampler )
+		m_pComputeDownsampler = std::make_unique<VulkanComputeDownsampler>( m_pVkRenderer );
+}
+
+vk::Format VulkanTextureManager::selectTextureFormat( const utils::Image& img, const vk::Format& requestedFormat )
+{
+	// decoded pixels take the caller's format, container payloads keep the format they were baked to
+	if( img.vkFormat() == 0 )
+		return requestedFormat;
+
+	const vk::Format imgFormat = static_cast<vk::Format>( img.vkFormat() );
+	const vk::FormatFeatureFlags requiredFeatures = vk::FormatFeatureFlagBits::eSampledImage | vk::FormatFeatureFlagBits::eTransferDst;
+
+	vk::FormatProperties formatProps = m_pVkRenderer->m_pDeviceCapabilities->formatProperties( imgFormat );
+	if( ( formatProps.optimalTilingFeatures & requiredFeatures ) != requiredFeatures )
+	{
+		std::string errorMsg = fmt::format( "device cannot sample {} textures, bake them to another format", vk::to_string( imgFormat ) );
+		LOG_ERROR(errorMsg);
+		throw std::runtime_error(errorMsg);
+	}
+
+	return imgFormat;
+}
+
+void VulkanTextureManager::appendCopyRegions(
+    const utils::Image& img, const vk::DeviceSize& bufferOffset,
+    std::vector<vk::BufferImageCopy>& copyRegions
+)
+{
+	for( std::uint32_t level = 0; level < img.storedMiplevels(); level++ )
+	{
+		const utils::Image::MipLevel& mipLevel = img.mipLevel( level );
+
+		// tightly packed rows, block compressed extents may end mid block at the image edge
+		vk::BufferImageCopy& copyRegion = copyRegions.emplace_back();
+		copyRegion.bufferOffset = bufferOffset + mipLevel.m_offset;
+		copyRegion.bufferRowLength = 0;
+		copyRegion.bufferImageHeight = 0;
+		copyRegion.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+		copyRegion.imageSubresource.mipLevel = level;
+		copyRegion.imageSubresource.baseArrayLayer = 0;
+		copyRegion.imageSubresource.layerCount = 1;
+		copyRegion.imageOffset = vk::Offset3D{ 0, 0, 0 };
+		copyRegion.imageExtent = vk::Extent3D{ mipLevel.m_dimension.m_width, mipLevel.m_dimension.m_height, 1 };
+	}
+}
+
+void VulkanTextureManager::validateMipmapSupport( VulkanTexture* pTexture )
+{
+	vk::FormatProperties formatProps = m_pVkRenderer->m_pDeviceCapabilities->formatProperties( pTexture->m_vkImgFormat );
 
 	if( !( formatProps.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImageFilterLinear ) )
 	{
@@ -208,17 +512,47 @@ void VulkanTextureManager::generateMipmaps( VulkanTexture* pTexture )
 		LOG_ERROR(errormsg);
 		throw std::runtime_error(errormsg);
 	}
+}
+
+bool VulkanTextureManager::needsCpuMipmaps( const utils::Image& img, const vk::Format& textureFormat )
+{
+	// container images bring their own levels, the generator only handles decoded RGBA
+	if( img.storedMiplevels() >= img.miplevels() || img.vkFormat() != 0 || img.colorChannels() != 4 )
+		return false;
+
+	if( m_bCpuMipmapsAlways )
+		return true;
+
+	// storage writes do not depend on linear filtering support
+	if( m_pComputeDownsampler && m_pComputeDownsampler->isFormatSupported( textureFormat ) )
+		return false;
+
+	vk::FormatProperties formatProps = m_pVkRenderer->m_pDeviceCapabilities->formatProperties( textureFormat );
+	return !( formatProps.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImageFilterLinear );
+}
+
+utils::Uptr<utils::Image> VulkanTextureManager::generateCpuMipmaps( const utils::Image& img, const vk::Format& textureFormat )
+{
+	utils::MipmapGenerator::Settings settings = m_cpuMipmapSettings;
+	settings.m_bSrgb = textureFormat == vk::Format::eR8G8B8A8Srgb || textureFormat == vk::Format::eB8G8R8A8Srgb;
+
+	utils::Uptr<utils::Image> pMipChain = std::make_unique<utils::Image>();
+	utils::MipmapGenerator( m_pVkRenderer->getThreadPool() ).generate( img, settings, *pMipChain );
+
+	return pMipChain;
+}
 
+bool VulkanTextureManager::usesComputeMipmaps( VulkanTexture* pTexture ) const
+{
+	// textures created before compute generation was enabled have no storage usage and keep blitting
+	return m_pComputeDownsampler && ( pTexture->m_vkImgUsageFlags & vk::ImageUsageFlagBits::eStorage ) && m_pComputeDownsampler->isFormatSupported( pTexture->m_vkImgFormat );
+}
+
+void VulkanTextureManager::recordMipmapGeneration( vk::CommandBuffer& vkCmdBuffer, VulkanTexture* pTexture )
+{
 	std::int32_t mipImgWidth = static_cast<std::int32_t>( pTexture->m_texDimension.m_width );
 	std::int32_t mipImgHeight = static_cast<std::int32_t>( pTexture->m_texDimension.m_height );
 
-	utils::Uptr<VulkanCmdBuffer> cmdBuf = std::make_unique<VulkanTemporaryCmdBuffer>( 
-		getDevice(),
-		&m_pVkRenderer->m_vkGraphicsQueue,
-		&m_pVkRenderer->m_vkGraphicsCommandPool
-	);
-	cmdBuf->allocate();
-
 	vk::ImageMemoryBarrier imgBarrier{};
 	imgBarrier.image = pTexture->m_vkImage;
 	imgBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
@@ -228,8 +562,6 @@ void VulkanTextureManager::generateMipmaps( VulkanTexture* pTexture )
 	imgBarrier.subresourceRange.layerCount = 1;
 	imgBarrier.subresourceRange.levelCount = 1;
 
-	cmdBuf->beginCmdBuffer();
-
 	for( int32_t i = 1; i < pTexture->m_miplevels; i++ )
 	{
 		// Transition the baseMipLevel to Transfer source first
@@ -239,7 +571,7 @@ void VulkanTextureManager::generateMipmaps( VulkanTexture* pTexture )
 		imgBarrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
 		imgBarrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
 
-		cmdBuf->handle()->pipelineBarrier(
+		vkCmdBuffer.pipelineBarrier(
 			vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, {},
 			0, nullptr, 
 			0, nullptr,
@@ -267,7 +599,7 @@ void VulkanTextureManager::generateMipmaps( VulkanTexture* pTexture )
 
 		vk::ArrayProxy<vk::ImageBlit> imgBlitArray{ imgBlit };
 		
-		cmdBuf->handle()->blitImage(
+		vkCmdBuffer.blitImage(
 			pTexture->m_vkImage, vk::ImageLayout::eTransferSrcOptimal,
 			pTexture->m_vkImage, vk::ImageLayout::eTransferDstOptimal,
 			imgBlitArray,
@@ -280,7 +612,7 @@ void VulkanTextureManager::generateMipmaps( VulkanTexture* pTexture )
 		imgBarrier.srcAccessMask = vk::AccessFlagBits::eTransferRead;
 		imgBarrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;		
 
-		cmdBuf->handle()->pipelineBarrier(
+		vkCmdBuffer.pipelineBarrier(
 			vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader, {},
 			0, nullptr, 
 			0, nullptr,
@@ -298,14 +630,195 @@ void VulkanTextureManager::generateMipmaps( VulkanTexture* pTexture )
 	imgBarrier.srcAccessMask = vk::AccessFlagBits::eTransferRead;
 	imgBarrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
 
-	cmdBuf->handle()->pipelineBarrier(
+	vkCmdBuffer.pipelineBarrier(
 		vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader, {},
 		0, nullptr, 
 		0, nullptr,
 		1, &imgBarrier
 	);
+}
 
-	cmdBuf->endCmdBuffer();
+void VulkanTextureManager::recordTextureBatch(
+    vk::CommandBuffer& vkCmdBuffer, const VulkanStagingSpan& stagingSpan,
+    const std::vector<const utils::Image*>& images, const std::vector<VulkanTexture*>& textures
+)
+{
+	auto l_imageBarrier = []( 
+		VulkanTexture* pTexture, const std::uint32_t& baseMipLevel, const std::uint32_t& levelCount,
+		const vk::ImageLayout& oldLayout, const vk::ImageLayout& newLayout,
+		const vk::AccessFlags& srcAccessMask, const vk::AccessFlags& dstAccessMask
+	) -> vk::ImageMemoryBarrier {
+		vk::ImageMemoryBarrier imgBarrier{};
+		imgBarrier.image = pTexture->m_vkImage;
+		imgBarrier.oldLayout = oldLayout;
+		imgBarrier.newLayout = newLayout;
+		imgBarrier.srcAccessMask = srcAccessMask;
+		imgBarrier.dstAccessMask = dstAccessMask;
+		imgBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imgBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imgBarrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+		imgBarrier.subresourceRange.baseMipLevel = baseMipLevel;
+		imgBarrier.subresourceRange.levelCount = levelCount;
+		imgBarrier.subresourceRange.baseArrayLayer = 0;
+		imgBarrier.subresourceRange.layerCount = 1;
+		return imgBarrier;
+	};
+
+	std::vector<vk::ImageMemoryBarrier> transferBarriers;
+	std::vector<vk::ImageMemoryBarrier> shaderReadBarriers;
+	std::vector<vk::BufferImageCopy> copyRegions;
+
+	// every texture of the batch goes to TransferDst with a single barrier
+	std::vector<VulkanTexture*> mipTextures;
+	std::vector<VulkanTexture*> computeMipTextures;
+	std::uint32_t maxMiplevels = 1;
+	for( std::size_t i = 0; i < textures.size(); i++ )
+	{
+		VulkanTexture* pTexture = textures[i];
+		transferBarriers.push_back( l_imageBarrier(
+			pTexture, 0, pTexture->m_miplevels,
+			vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal,
+			{}, vk::AccessFlagBits::eTransferWrite
+		) );
+
+		if( images[i]->storedMiplevels() < pTexture->m_miplevels && usesComputeMipmaps( pTexture ) )
+		{
+			computeMipTextures.push_back( pTexture );
+		}
+		else if( images[i]->storedMiplevels() < pTexture->m_miplevels )
+		{
+			mipTextures.push_back( pTexture );
+			maxMiplevels = std::max( maxMiplevels, pTexture->m_miplevels );
+		}
+		else
+		{
+			// levels stored in the file are final once copied
+			shaderReadBarriers.push_back( l_imageBarrier(
+				pTexture, 0, pTexture->m_miplevels,
+				vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal,
+				vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eShaderRead
+			) );
+		}
+	}
+
+	vkCmdBuffer.pipelineBarrier(
+		vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer, {},
+		0, nullptr,
+		0, nullptr,
+		static_cast<std::uint32_t>( transferBarriers.size() ), transferBarriers.data()
+	);
+
+	for( std::size_t i = 0; i < textures.size(); i++ )
+	{
+		const utils::Image* pImg = images[i];
+
+		VulkanStagingRegion stagingRegion = m_pVkRenderer->m_pStagingRing->allocate( stagingSpan, static_cast<vk::DeviceSize>( pImg->sizeInBytes() ) );
+		std::memcpy( stagingRegion.m_pMapped, pImg->buffer(), pImg->sizeInBytes() );
+
+		copyRegions.clear();
+		appendCopyRegions( *pImg, stagingRegion.m_offset, copyRegions );
+
+		vkCmdBuffer.copyBufferToImage(
+			stagingRegion.m_vkBuffer, textures[i]->m_vkImage,
+			vk::ImageLayout::eTransferDstOptimal,
+			static_cast<std::uint32_t>( copyRegions.size() ), copyRegions.data()
+		);
+	}
+
+	if( !shaderReadBarriers.empty() )
+	{
+		vkCmdBuffer.pipelineBarrier(
+			vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader, {},
+			0, nullptr,
+			0, nullptr,
+			static_cast<std::uint32_t>( shaderReadBarriers.size() ), shaderReadBarriers.data()
+		);
+	}
+
+	// batches are submitted to the graphics queue, which runs the dispatches as well
+	if( !computeMipTextures.empty() )
+		m_pComputeDownsampler->record( vkCmdBuffer, computeMipTextures );
+
+	// mip chains advance one level at a time across the whole batch so barriers merge per stage
+	for( std::uint32_t level = 1; !mipTextures.empty() && level <= maxMiplevels; level++ )
+	{
+		transferBarriers.clear();
+		shaderReadBarriers.clear();
+
+		for( VulkanTexture* pTexture : mipTextures )
+		{
+			if( pTexture->m_miplevels > level )
+			{
+				transferBarriers.push_back( l_imageBarrier(
+					pTexture, level - 1, 1,
+					vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eTransferSrcOptimal,
+					vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eTransferRead
+				) );
+			}
+		}
+
+		if( !transferBarriers.empty() )
+		{
+			vkCmdBuffer.pipelineBarrier(
+				vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, {},
+				0, nullptr,
+				0, nullptr,
+				static_cast<std::uint32_t>( transferBarriers.size() ), transferBarriers.data()
+			);
+		}
+
+		for( VulkanTexture* pTexture : mipTextures )
+		{
+			if( pTexture->m_miplevels > level )
+			{
+				const std::int32_t srcWidth = std::max( 1, static_cast<std::int32_t>( pTexture->m_texDimension.m_width >> ( level - 1 ) ) );
+				const std::int32_t srcHeight = std::max( 1, static_cast<std::int32_t>( pTexture->m_texDimension.m_height >> ( level - 1 ) ) );
+
+				vk::ImageBlit imgBlit{};
+				imgBlit.srcOffsets[0] = vk::Offset3D{ 0, 0, 0 };
+				imgBlit.srcOffsets[1] = vk::Offset3D{ srcWidth, srcHeight, 1 };
+				imgBlit.srcSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+				imgBlit.srcSubresource.mipLevel = level - 1;
+				imgBlit.srcSubresource.baseArrayLayer = 0;
+				imgBlit.srcSubresource.layerCount = 1;
+				imgBlit.dstOffsets[0] = vk::Offset3D{ 0, 0, 0 };
+				imgBlit.dstOffsets[1] = vk::Offset3D{ std::max( 1, srcWidth / 2 ), std::max( 1, srcHeight / 2 ), 1 };
+				imgBlit.dstSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+				imgBlit.dstSubresource.mipLevel = level;
+				imgBlit.dstSubresource.baseArrayLayer = 0;
+				imgBlit.dstSubresource.layerCount = 1;
+
+				vkCmdBuffer.blitImage(
+					pTexture->m_vkImage, vk::ImageLayout::eTransferSrcOptimal,
+					pTexture->m_vkImage, vk::ImageLayout::eTransferDstOptimal,
+					1, &imgBlit,
+					vk::Filter::eLinear
+				);
+
+				shaderReadBarriers.push_back( l_imageBarrier(
+					pTexture, level - 1, 1,
+					vk::ImageLayout::eTransferSrcOptimal, vk::ImageLayout::eShaderReadOnlyOptimal,
+					vk::AccessFlagBits::eTransferRead, vk::AccessFlagBits::eShaderRead
+				) );
+			}
+			else if( pTexture->m_miplevels == level )
+			{
+				// last level of this chain was only ever written to
+				shaderReadBarriers.push_back( l_imageBarrier(
+					pTexture, level - 1, 1,
+					vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal,
+					vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eShaderRead
+				) );
+			}
+		}
+
+		vkCmdBuffer.pipelineBarrier(
+			vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader, {},
+			0, nullptr,
+			0, nullptr,
+			static_cast<std::uint32_t>( shaderReadBarriers.size() ), shaderReadBarriers.data()
+		);
+	}
 }
 
 } // namespace vkrender
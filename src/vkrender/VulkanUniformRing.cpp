@@ -0,0 +1,64 @@
+#include "vkrender/VulkanUniformRing.h"
+#include "vkrender/VulkanRenderer.h"
+#include "utilities/VulkanLogger.h"
+
+#include <algorithm>
+
+namespace vkrender
+{
+
+VulkanUniformRing::VulkanUniformRing( VulkanRenderer* pVkRenderer, const vk::DeviceSize& ringSize )
+    :m_pVkRenderer{ pVkRenderer }
+    ,m_ringSize{ ringSize }
+    ,m_alignment{ std::max<vk::DeviceSize>( pVkRenderer->getDeviceCapabilities()->limits().minUniformBufferOffsetAlignment, 1ull ) }
+    ,m_head{ 0 }
+    ,m_highWaterMark{ 0 }
+{
+    m_pVkRenderer->createBuffer(
+        m_ringSize,
+        vk::BufferUsageFlagBits::eUniformBuffer, vk::SharingMode::eExclusive,
+        VulkanMemoryUsage::eDynamic,
+        m_vkBuffer, m_allocation,
+        "uniform ring"
+    );
+
+    if( m_allocation.m_pMapped == nullptr )
+    {
+        std::string errorMsg = "Uniform ring memory is not host mapped";
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+}
+
+VulkanUniformRing::~VulkanUniformRing()
+{
+    m_pVkRenderer->destroyBuffer( m_vkBuffer, m_allocation );
+}
+
+VulkanUniformSlice VulkanUniformRing::allocate( const vk::DeviceSize& size )
+{
+    const vk::DeviceSize alignedSize = ( size + m_alignment - 1 ) & ~( m_alignment - 1 );
+    const vk::DeviceSize offset = m_head.fetch_add( alignedSize, std::memory_order_relaxed );
+
+    if( offset + size > m_ringSize )
+    {
+        std::string errorMsg = fmt::format( "Uniform ring of {} bytes exhausted by a {} byte slice", m_ringSize, size );
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    VulkanUniformSlice uniformSlice{};
+    uniformSlice.m_vkBuffer = m_vkBuffer;
+    uniformSlice.m_dynamicOffset = static_cast<std::uint32_t>( offset );
+    uniformSlice.m_size = size;
+    uniformSlice.m_pMapped = static_cast<std::uint8_t*>( m_allocation.m_pMapped ) + offset;
+    return uniformSlice;
+}
+
+void VulkanUniformRing::reset()
+{
+    m_highWaterMark = std::max( m_highWaterMark, usedBytes() );
+    m_head.store( 0, std::memory_order_relaxed );
+}
+
+} // namespace vkrender
@@ -0,0 +1,430 @@
+#include "vkrender/VulkanUploadScheduler.h"
+#include "vkrender/VulkanRenderer.h"
+#include "vkrender/VulkanHelpers.h"
+#include "utilities/VulkanLogger.h"
+
+namespace vkrender
+{
+
+bool VulkanUploadTicket::isReady() const
+{
+    return m_pScheduler == nullptr || m_pScheduler->isComplete( m_timelineValue );
+}
+
+void VulkanUploadTicket::wait() const
+{
+    if( m_pScheduler )
+        m_pScheduler->wait( m_timelineValue );
+}
+
+vk::Semaphore VulkanUploadTicket::timelineSemaphore() const
+{
+    return m_pScheduler ? m_pScheduler->timelineSemaphore() : vk::Semaphore{};
+}
+
+VulkanUploadScheduler::VulkanUploadScheduler( VulkanRenderer* pVkRenderer )
+    :m_pVkRenderer{ pVkRenderer }
+    ,m_pLogicalDevice{ &pVkRenderer->m_vkLogicalDevice }
+    ,m_vkTransferQueue{ pVkRenderer->m_vkTransferQueue }
+    ,m_vkGraphicsQueue{ pVkRenderer->m_vkGraphicsQueue }
+    ,m_lastSubmittedValue{ 0 }
+{
+    const QueueFamilyIndices& queueFamilyIndices = pVkRenderer->getDeviceCapabilities()->queueFamilyIndices();
+
+    m_graphicsFamilyIndex = queueFamilyIndices.m_graphicsFamily.value();
+    m_transferFamilyIndex = queueFamilyIndices.m_exclusiveTransferFamily.has_value() ? queueFamilyIndices.m_exclusiveTransferFamily.value() : m_graphicsFamilyIndex;
+    m_bOwnershipTransfer = m_transferFamilyIndex != m_graphicsFamilyIndex;
+
+    vk::CommandPoolCreateInfo transferPoolInfo{};
+    transferPoolInfo.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+    transferPoolInfo.queueFamilyIndex = m_transferFamilyIndex;
+    m_vkTransferCommandPool = m_pLogicalDevice->createCommandPool( transferPoolInfo );
+
+    if( m_bOwnershipTransfer )
+    {
+        vk::CommandPoolCreateInfo graphicsPoolInfo{};
+        graphicsPoolInfo.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+        graphicsPoolInfo.queueFamilyIndex = m_graphicsFamilyIndex;
+        m_vkGraphicsCommandPool = m_pLogicalDevice->createCommandPool( graphicsPoolInfo );
+    }
+
+    vk::SemaphoreTypeCreateInfo semaphoreTypeInfo{};
+    semaphoreTypeInfo.semaphoreType = vk::SemaphoreType::eTimeline;
+    semaphoreTypeInfo.initialValue = 0;
+
+    vk::SemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.pNext = &semaphoreTypeInfo;
+    m_vkTimelineSemaphore = m_pLogicalDevice->createSemaphore( semaphoreInfo );
+    if( m_bOwnershipTransfer )
+        m_vkTransferSemaphore = m_pLogicalDevice->createSemaphore( semaphoreInfo );
+
+    LOG_INFO( m_bOwnershipTransfer ? "Upload Scheduler using exclusive Transfer Queue" : "Upload Scheduler using Graphics Queue" );
+}
+
+VulkanUploadScheduler::~VulkanUploadScheduler()
+{
+    waitIdle();
+
+    m_pLogicalDevice->destroySemaphore( m_vkTimelineSemaphore );
+    m_pLogicalDevice->destroyCommandPool( m_vkTransferCommandPool );
+    if( m_bOwnershipTransfer )
+    {
+        m_pLogicalDevice->destroySemaphore( m_vkTransferSemaphore );
+        m_pLogicalDevice->destroyCommandPool( m_vkGraphicsCommandPool );
+    }
+}
+
+VulkanUploadTicket VulkanUploadScheduler::uploadBuffer(
+    const void* pData, const vk::DeviceSize& sizeInBytes,
+    const vk::Buffer& dstBuffer, const vk::DeviceSize& dstOffset,
+    const vk::PipelineStageFlags& dstStage, const vk::AccessFlags& dstAccess
+)
+{
+    std::lock_guard<std::recursive_mutex> lock( m_schedulerMutex );
+
+    UploadBatch& batch = openBatch();
+
+    VulkanStagingRegion stagingRegion = m_pVkRenderer->getStagingRing()->allocate( batch.m_stagingSpan, sizeInBytes );
+    std::memcpy( stagingRegion.m_pMapped, pData, sizeInBytes );
+
+    vk::BufferCopy copyRegion{};
+    copyRegion.srcOffset = stagingRegion.m_offset;
+    copyRegion.dstOffset = dstOffset;
+    copyRegion.size = sizeInBytes;
+    batch.m_vkTransferCmdBuffer.copyBuffer( stagingRegion.m_vkBuffer, dstBuffer, 1, &copyRegion );
+
+    vk::BufferMemoryBarrier bufferBarrier{};
+    bufferBarrier.buffer = dstBuffer;
+    bufferBarrier.offset = dstOffset;
+    bufferBarrier.size = sizeInBytes;
+    bufferBarrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+
+    if( m_bOwnershipTransfer )
+    {
+        bufferBarrier.srcQueueFamilyIndex = m_transferFamilyIndex;
+        bufferBarrier.dstQueueFamilyIndex = m_graphicsFamilyIndex;
+        bufferBarrier.dstAccessMask = {};
+        batch.m_vkTransferCmdBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe, {},
+            0, nullptr,
+            1, &bufferBarrier,
+            0, nullptr
+        );
+
+        bufferBarrier.srcAccessMask = {};
+        bufferBarrier.dstAccessMask = dstAccess;
+        batch.m_acquireBufferBarriers.push_back( bufferBarrier );
+        batch.m_acquireDstStages |= dstStage;
+    }
+    else
+    {
+        bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.dstAccessMask = dstAccess;
+        batch.m_vkTransferCmdBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer, dstStage, {},
+            0, nullptr,
+            1, &bufferBarrier,
+            0, nullptr
+        );
+    }
+
+    return VulkanUploadTicket{ this, batch.m_readyValue };
+}
+
+VulkanUploadTicket VulkanUploadScheduler::uploadImage(
+    const void* pData, const vk::DeviceSize& sizeInBytes,
+    const ImageUpload& imageUpload
+)
+{
+    std::lock_guard<std::recursive_mutex> lock( m_schedulerMutex );
+
+    UploadBatch& batch = openBatch();
+
+    VulkanStagingRegion stagingRegion = m_pVkRenderer->getStagingRing()->allocate( batch.m_stagingSpan, sizeInBytes );
+    std::memcpy( stagingRegion.m_pMapped, pData, sizeInBytes );
+
+    vk::ImageMemoryBarrier imgBarrier{};
+    imgBarrier.image = imageUpload.m_vkImage;
+    imgBarrier.subresourceRange = imageUpload.m_subresourceRange;
+    imgBarrier.oldLayout = vk::ImageLayout::eUndefined;
+    imgBarrier.newLayout = vk::ImageLayout::eTransferDstOptimal;
+    imgBarrier.srcAccessMask = {};
+    imgBarrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
+    imgBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imgBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+    batch.m_vkTransferCmdBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer, {},
+        0, nullptr,
+        0, nullptr,
+        1, &imgBarrier
+    );
+
+    std::vector<vk::BufferImageCopy> copyRegions = imageUpload.m_copyRegions;
+    for( vk::BufferImageCopy& copyRegion : copyRegions )
+        copyRegion.bufferOffset += stagingRegion.m_offset;
+
+    batch.m_vkTransferCmdBuffer.copyBufferToImage(
+        stagingRegion.m_vkBuffer, imageUpload.m_vkImage,
+        vk::ImageLayout::eTransferDstOptimal,
+        static_cast<std::uint32_t>( copyRegions.size() ), copyRegions.data()
+    );
+
+    // with a graphics recorder the image stays in TransferDst and the recorder takes it to its final layout
+    const bool bHasRecorder = static_cast<bool>( imageUpload.m_graphicsRecorder );
+    const vk::ImageLayout handoverLayout = bHasRecorder ? vk::ImageLayout::eTransferDstOptimal : imageUpload.m_finalLayout;
+    const vk::PipelineStageFlags dstStage = bHasRecorder ? vk::PipelineStageFlags{ vk::PipelineStageFlagBits::eTransfer } : imageUpload.m_dstStage;
+    const vk::AccessFlags dstAccess = bHasRecorder ? ( vk::AccessFlagBits::eTransferWrite | vk::AccessFlagBits::eTransferRead ) : imageUpload.m_dstAccess;
+
+    imgBarrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+    imgBarrier.newLayout = handoverLayout;
+    imgBarrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+
+    if( m_bOwnershipTransfer )
+    {
+        imgBarrier.srcQueueFamilyIndex = m_transferFamilyIndex;
+        imgBarrier.dstQueueFamilyIndex = m_graphicsFamilyIndex;
+        imgBarrier.dstAccessMask = {};
+        batch.m_vkTransferCmdBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe, {},
+            0, nullptr,
+            0, nullptr,
+            1, &imgBarrier
+        );
+
+        imgBarrier.srcAccessMask = {};
+        imgBarrier.dstAccessMask = dstAccess;
+        batch.m_acquireImageBarriers.push_back( imgBarrier );
+        batch.m_acquireDstStages |= dstStage;
+    }
+    else if( !bHasRecorder )
+    {
+        imgBarrier.dstAccessMask = dstAccess;
+        batch.m_vkTransferCmdBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer, dstStage, {},
+            0, nullptr,
+            0, nullptr,
+            1, &imgBarrier
+        );
+    }
+
+    if( bHasRecorder )
+        batch.m_graphicsRecorders.push_back( imageUpload.m_graphicsRecorder );
+
+    return VulkanUploadTicket{ this, batch.m_readyValue };
+}
+
+VulkanUploadTicket VulkanUploadScheduler::flush()
+{
+    std::lock_guard<std::recursive_mutex> lock( m_schedulerMutex );
+
+    submitBatch();
+    return VulkanUploadTicket{ this, m_lastSubmittedValue };
+}
+
+void VulkanUploadScheduler::waitIdle()
+{
+    wait( flush().timelineValue() );
+
+    std::lock_guard<std::recursive_mutex> lock( m_schedulerMutex );
+    recycleBatches();
+}
+
+bool VulkanUploadScheduler::isComplete( const std::uint64_t& timelineValue )
+{
+    {
+        std::lock_guard<std::recursive_mutex> lock( m_schedulerMutex );
+        if( timelineValue > m_lastSubmittedValue )
+            return false;
+    }
+    return m_pLogicalDevice->getSemaphoreCounterValue( m_vkTimelineSemaphore ) >= timelineValue;
+}
+
+void VulkanUploadScheduler::wait( const std::uint64_t& timelineValue )
+{
+    {
+        std::lock_guard<std::recursive_mutex> lock( m_schedulerMutex );
+        if( timelineValue > m_lastSubmittedValue )
+            submitBatch();
+    }
+
+    vk::SemaphoreWaitInfo waitInfo{};
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &m_vkTimelineSemaphore;
+    waitInfo.pValues = &timelineValue;
+
+    if( m_pLogicalDevice->waitSemaphores( waitInfo, std::numeric_limits<std::uint64_t>::max() ) != vk::Result::eSuccess )
+    {
+        std::string errorMsg = "Failed to wait for upload timeline semaphore";
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+}
+
+VulkanUploadScheduler::UploadBatch& VulkanUploadScheduler::openBatch()
+{
+    if( m_currentBatch.m_bRecording )
+        return m_currentBatch;
+
+    recycleBatches();
+
+    if( m_freeBatches.empty() )
+    {
+        vk::CommandBufferAllocateInfo allocInfo{};
+        allocInfo.commandPool = m_vkTransferCommandPool;
+        allocInfo.level = vk::CommandBufferLevel::ePrimary;
+        allocInfo.commandBufferCount = 1;
+        m_currentBatch.m_vkTransferCmdBuffer = m_pLogicalDevice->allocateCommandBuffers( allocInfo )[0];
+
+        if( m_bOwnershipTransfer )
+        {
+            allocInfo.commandPool = m_vkGraphicsCommandPool;
+            m_currentBatch.m_vkGraphicsCmdBuffer = m_pLogicalDevice->allocateCommandBuffers( allocInfo )[0];
+        }
+    }
+    else
+    {
+        m_currentBatch = std::move( m_freeBatches.back() );
+        m_freeBatches.pop_back();
+    }
+
+    m_currentBatch.m_stagingSpan = m_pVkRenderer->getStagingRing()->beginSpan();
+    m_currentBatch.m_readyValue = m_lastSubmittedValue + 1;
+    m_currentBatch.m_bRecording = true;
+
+    vk::CommandBufferBeginInfo beginInfo{};
+    beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+    m_currentBatch.m_vkTransferCmdBuffer.begin( beginInfo );
+
+    return m_currentBatch;
+}
+
+void VulkanUploadScheduler::submitBatch()
+{
+    if( !m_currentBatch.m_bRecording )
+        return;
+
+    UploadBatch& batch = m_currentBatch;
+    const vk::Fence stagingFence = m_pVkRenderer->getStagingRing()->submitFence( batch.m_stagingSpan );
+
+    if( m_bOwnershipTransfer )
+    {
+        batch.m_vkTransferCmdBuffer.end();
+
+        vk::TimelineSemaphoreSubmitInfo transferTimelineInfo{};
+        transferTimelineInfo.signalSemaphoreValueCount = 1;
+        transferTimelineInfo.pSignalSemaphoreValues = &batch.m_readyValue;
+
+        vk::SubmitInfo transferSubmitInfo{};
+        transferSubmitInfo.pNext = &transferTimelineInfo;
+        transferSubmitInfo.commandBufferCount = 1;
+        transferSubmitInfo.pCommandBuffers = &batch.m_vkTransferCmdBuffer;
+        transferSubmitInfo.signalSemaphoreCount = 1;
+        transferSubmitInfo.pSignalSemaphores = &m_vkTransferSemaphore;
+
+        submit( m_vkTransferQueue, transferSubmitInfo, stagingFence );
+
+        vk::CommandBufferBeginInfo beginInfo{};
+        beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+        batch.m_vkGraphicsCmdBuffer.begin( beginInfo );
+
+        if( !batch.m_acquireImageBarriers.empty() || !batch.m_acquireBufferBarriers.empty() )
+        {
+            batch.m_vkGraphicsCmdBuffer.pipelineBarrier(
+                vk::PipelineStageFlagBits::eTopOfPipe, batch.m_acquireDstStages, {},
+                0, nullptr,
+                static_cast<std::uint32_t>( batch.m_acquireBufferBarriers.size() ), batch.m_acquireBufferBarriers.data(),
+                static_cast<std::uint32_t>( batch.m_acquireImageBarriers.size() ), batch.m_acquireImageBarriers.data()
+            );
+        }
+
+        for( GraphicsRecorder& recorder : batch.m_graphicsRecorders )
+            recorder( batch.m_vkGraphicsCmdBuffer );
+
+        batch.m_vkGraphicsCmdBuffer.end();
+
+        vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eAllCommands;
+
+        vk::TimelineSemaphoreSubmitInfo graphicsTimelineInfo{};
+        graphicsTimelineInfo.waitSemaphoreValueCount = 1;
+        graphicsTimelineInfo.pWaitSemaphoreValues = &batch.m_readyValue;
+        graphicsTimelineInfo.signalSemaphoreValueCount = 1;
+        graphicsTimelineInfo.pSignalSemaphoreValues = &batch.m_readyValue;
+
+        vk::SubmitInfo graphicsSubmitInfo{};
+        graphicsSubmitInfo.pNext = &graphicsTimelineInfo;
+        graphicsSubmitInfo.waitSemaphoreCount = 1;
+        graphicsSubmitInfo.pWaitSemaphores = &m_vkTransferSemaphore;
+        graphicsSubmitInfo.pWaitDstStageMask = &waitStage;
+        graphicsSubmitInfo.commandBufferCount = 1;
+        graphicsSubmitInfo.pCommandBuffers = &batch.m_vkGraphicsCmdBuffer;
+        graphicsSubmitInfo.signalSemaphoreCount = 1;
+        graphicsSubmitInfo.pSignalSemaphores = &m_vkTimelineSemaphore;
+
+        submit( m_vkGraphicsQueue, graphicsSubmitInfo, nullptr );
+    }
+    else
+    {
+        for( GraphicsRecorder& recorder : batch.m_graphicsRecorders )
+            recorder( batch.m_vkTransferCmdBuffer );
+
+        batch.m_vkTransferCmdBuffer.end();
+
+        vk::TimelineSemaphoreSubmitInfo timelineInfo{};
+        timelineInfo.signalSemaphoreValueCount = 1;
+        timelineInfo.pSignalSemaphoreValues = &batch.m_readyValue;
+
+        vk::SubmitInfo submitInfo{};
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &batch.m_vkTransferCmdBuffer;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &m_vkTimelineSemaphore;
+
+        submit( m_vkTransferQueue, submitInfo, stagingFence );
+    }
+
+    m_lastSubmittedValue = batch.m_readyValue;
+    batch.m_bRecording = false;
+    m_inFlightBatches.push_back( std::move( batch ) );
+    m_currentBatch = UploadBatch{};
+}
+
+void VulkanUploadScheduler::submit( const vk::Queue& vkQueue, const vk::SubmitInfo& submitInfo, const vk::Fence& vkFence )
+{
+    // the queues are shared with the frame manager and the texture manager, the renderer serializes access to them
+    if( m_pVkRenderer->submit( vkQueue, 1, &submitInfo, vkFence ) != vk::Result::eSuccess )
+    {
+        std::string errorMsg = fmt::format( "Failed to submit upload batch {}", m_currentBatch.m_readyValue );
+        LOG_ERROR(errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+}
+
+void VulkanUploadScheduler::recycleBatches()
+{
+    const std::uint64_t completedValue = m_pLogicalDevice->getSemaphoreCounterValue( m_vkTimelineSemaphore );
+
+    for( auto itr = m_inFlightBatches.begin(); itr != m_inFlightBatches.end(); )
+    {
+        if( itr->m_readyValue > completedValue )
+        {
+            ++itr;
+            continue;
+        }
+
+        itr->m_vkTransferCmdBuffer.reset( {} );
+        if( m_bOwnershipTransfer )
+            itr->m_vkGraphicsCmdBuffer.reset( {} );
+        itr->m_acquireImageBarriers.clear();
+        itr->m_acquireBufferBarriers.clear();
+        itr->m_acquireDstStages = {};
+        itr->m_graphicsRecorders.clear();
+
+        m_freeBatches.push_back( std::move( *itr ) );
+        itr = m_inFlightBatches.erase( itr );
+    }
+}
+
+} // namespace vkrender
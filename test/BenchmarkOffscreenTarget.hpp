@@ -0,0 +1,216 @@
+#ifndef VKRENDER_TEST_BENCHMARK_OFFSCREEN_TARGET_HPP
+#define VKRENDER_TEST_BENCHMARK_OFFSCREEN_TARGET_HPP
+
+#include "vkrender/VulkanRenderer.h"
+#include "vkrender/VulkanTextureManager.h"
+#include "vkrender/VulkanTexture.h"
+#include "vkrender/VulkanRenderTarget.h"
+#include "vkrender/VulkanRenderPass.h"
+#include "vkrender/VulkanGfxPipeline.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+// Color target, render pass and framebuffer for benchmarks that draw without presenting. Every frame is
+// recorded into the same primary command buffer and waited for on the host before the next one begins,
+// so per frame resources of the benchmark can be reused right away.
+class BenchmarkOffscreenTarget
+{
+public:
+    BenchmarkOffscreenTarget( vkrender::VulkanRenderer* pVkRenderer, const utils::Dimension& dimension )
+        :m_pVkRenderer{ pVkRenderer }
+        ,m_pLogicalDevice{ pVkRenderer->getDevice() }
+        ,m_dimension{ dimension }
+        ,m_textureManager{ pVkRenderer }
+        ,m_renderPass{ pVkRenderer->getDevice(), "Benchmark Pass" }
+    {
+        m_pColorTexture = m_textureManager.createTexture(
+            m_dimension, 1,
+            vk::Format::eR8G8B8A8Unorm, vk::ImageTiling::eOptimal,
+            vk::ImageUsageFlagBits::eColorAttachment, vk::MemoryPropertyFlagBits::eDeviceLocal,
+            vk::SampleCountFlagBits::e1,
+            vk::ImageAspectFlagBits::eColor
+        );
+
+        vkrender::VulkanRenderTarget colorTarget{ m_pColorTexture };
+        colorTarget.setTargetSemantics( vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore, vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eDontCare );
+        colorTarget.setTargetLayout( vk::ImageLayout::eUndefined, vk::ImageLayout::eColorAttachmentOptimal, vk::ImageLayout::eColorAttachmentOptimal );
+
+        m_renderPass.prepareTargetAttachments( { colorTarget } );
+        m_renderPass.addSubPass(
+            vk::PipelineBindPoint::eGraphics,
+            VK_SUBPASS_EXTERNAL, 0,
+            vk::PipelineStageFlagBits::eColorAttachmentOutput, {},
+            vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::AccessFlagBits::eColorAttachmentWrite
+        );
+        m_renderPass.createRenderPass();
+
+        const vk::ImageView colorView = m_pColorTexture->imageView();
+
+        vk::FramebufferCreateInfo framebufferInfo{};
+        framebufferInfo.renderPass = m_renderPass.handle();
+        framebufferInfo.attachmentCount = 1;
+        framebufferInfo.pAttachments = &colorView;
+        framebufferInfo.width = m_dimension.m_width;
+        framebufferInfo.height = m_dimension.m_height;
+        framebufferInfo.layers = 1;
+        m_vkFramebuffer = m_pLogicalDevice->createFramebuffer( framebufferInfo );
+
+        const std::uint32_t graphicsFamily = pVkRenderer->getDeviceCapabilities()->queueFamilyIndices().m_graphicsFamily.value();
+        m_vkGraphicsQueue = m_pLogicalDevice->getQueue( graphicsFamily, 0 );
+
+        vk::CommandPoolCreateInfo commandPoolInfo{};
+        commandPoolInfo.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+        commandPoolInfo.queueFamilyIndex = graphicsFamily;
+        m_vkCommandPool = m_pLogicalDevice->createCommandPool( commandPoolInfo );
+
+        vk::CommandBufferAllocateInfo allocInfo{};
+        allocInfo.commandPool = m_vkCommandPool;
+        allocInfo.level = vk::CommandBufferLevel::ePrimary;
+        allocInfo.commandBufferCount = 1;
+        m_vkCmdBuffer = m_pLogicalDevice->allocateCommandBuffers( allocInfo )[0];
+
+        m_vkFence = m_pLogicalDevice->createFence( vk::FenceCreateInfo{} );
+    }
+
+    BenchmarkOffscreenTarget( const BenchmarkOffscreenTarget& ) = delete;
+    BenchmarkOffscreenTarget& operator=( const BenchmarkOffscreenTarget& ) = delete;
+
+    ~BenchmarkOffscreenTarget()
+    {
+        m_pLogicalDevice->waitIdle();
+        m_pLogicalDevice->destroyFence( m_vkFence );
+        m_pLogicalDevice->destroyCommandPool( m_vkCommandPool );
+        m_pLogicalDevice->destroyFramebuffer( m_vkFramebuffer );
+    }
+
+    // opaque triangles without depth test or culling, viewport and scissor are dynamic
+    void createPipeline( vkrender::VulkanGfxPipeline& pipeline, const vkrender::VulkanGfxPipeline::ShaderStages& shaderStages )
+    {
+        pipeline.bindShaderStages( shaderStages );
+        pipeline.setInputAssemblyState( vk::PrimitiveTopology::eTriangleList );
+        pipeline.setRasterizerState( vk::PolygonMode::eFill, vk::CullModeFlagBits::eNone );
+        pipeline.setMultisampleState( vk::SampleCountFlagBits::e1 );
+        pipeline.setDepthState( false, false );
+        pipeline.setColorBlendState(
+            vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA
+        );
+        pipeline.setDynamicState();
+        pipeline.createGfxPipeline( &m_renderPass, 0 );
+    }
+
+    // resets and begins the primary command buffer with the render pass begun
+    vk::CommandBuffer& beginPass( const vk::SubpassContents& subpassContents )
+    {
+        m_vkCmdBuffer.reset();
+
+        vk::CommandBufferBeginInfo beginInfo{};
+        beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+        m_vkCmdBuffer.begin( beginInfo );
+
+        vk::ClearValue clearValue{};
+        clearValue.color = vk::ClearColorValue{ std::array<float, 4>{ 0.0f, 0.0f, 0.0f, 1.0f } };
+
+        vk::RenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.renderPass = m_renderPass.handle();
+        renderPassInfo.framebuffer = m_vkFramebuffer;
+        renderPassInfo.renderArea = vk::Rect2D{ vk::Offset2D{ 0, 0 }, vk::Extent2D{ m_dimension.m_width, m_dimension.m_height } };
+        renderPassInfo.clearValueCount = 1;
+        renderPassInfo.pClearValues = &clearValue;
+        m_vkCmdBuffer.beginRenderPass( renderPassInfo, subpassContents );
+
+        return m_vkCmdBuffer;
+    }
+
+    // ends the pass, submits and blocks until the GPU is done, returns the seconds from submit to fence
+    double submitAndWait()
+    {
+        m_vkCmdBuffer.endRenderPass();
+        m_vkCmdBuffer.end();
+
+        vk::SubmitInfo submitInfo{};
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &m_vkCmdBuffer;
+
+        const auto submitBegin = std::chrono::steady_clock::now();
+
+        if( m_pVkRenderer->submit( m_vkGraphicsQueue, 1, &submitInfo, m_vkFence ) != vk::Result::eSuccess )
+            throw std::runtime_error( "Benchmark frame submit failed" );
+        if( m_pLogicalDevice->waitForFences( m_vkFence, VK_TRUE, UINT64_MAX ) != vk::Result::eSuccess )
+            throw std::runtime_error( "Benchmark frame fence wait failed" );
+        m_pLogicalDevice->resetFences( m_vkFence );
+
+        return std::chrono::duration<double>( std::chrono::steady_clock::now() - submitBegin ).count();
+    }
+
+    // secondary command buffers recorded inside the pass begun by beginPass
+    vk::CommandBufferInheritanceInfo inheritanceInfo() const
+    {
+        vk::CommandBufferInheritanceInfo inheritanceInfo{};
+        inheritanceInfo.renderPass = m_renderPass.handle();
+        inheritanceInfo.subpass = 0;
+        inheritanceInfo.framebuffer = m_vkFramebuffer;
+        return inheritanceInfo;
+    }
+
+    // dynamic state is not inherited by secondary command buffers, each of them sets it again
+    void setViewportAndScissor( vk::CommandBuffer& cmdBuffer ) const
+    {
+        const vk::Viewport viewport{ 0.0f, 0.0f, static_cast<float>( m_dimension.m_width ), static_cast<float>( m_dimension.m_height ), 0.0f, 1.0f };
+        const vk::Rect2D scissor{ vk::Offset2D{ 0, 0 }, vk::Extent2D{ m_dimension.m_width, m_dimension.m_height } };
+        cmdBuffer.setViewport( 0, viewport );
+        cmdBuffer.setScissor( 0, scissor );
+    }
+
+    // draw drawIndex of drawCount placed in its own cell of a square grid over the target
+    static glm::mat4 gridModel( const std::uint32_t& drawIndex, const std::uint32_t& drawCount )
+    {
+        const std::uint32_t columns = std::max( static_cast<std::uint32_t>( std::ceil( std::sqrt( static_cast<double>( drawCount ) ) ) ), 1u );
+        const float cellSize = 2.0f / static_cast<float>( columns );
+
+        const glm::vec3 cellCenter{
+            -1.0f + cellSize * ( static_cast<float>( drawIndex % columns ) + 0.5f ),
+            -1.0f + cellSize * ( static_cast<float>( drawIndex / columns ) + 0.5f ),
+            0.0f
+        };
+
+        return glm::scale( glm::translate( glm::mat4{ 1.0f }, cellCenter ), glm::vec3{ 0.4f * cellSize, 0.4f * cellSize, 1.0f } );
+    }
+
+    // SPIR-V words embedded by glslc -mfmt=num as the byte buffer VulkanGpuProgram expects
+    template<std::size_t _WordCount>
+    static std::vector<char> spirvBuffer( const std::uint32_t ( &spirvWords )[_WordCount] )
+    {
+        std::vector<char> shaderBuffer( sizeof( spirvWords ) );
+        std::memcpy( shaderBuffer.data(), spirvWords, sizeof( spirvWords ) );
+        return shaderBuffer;
+    }
+
+    vkrender::VulkanRenderPass* renderPass() { return &m_renderPass; }
+    const utils::Dimension& dimension() const { return m_dimension; }
+private:
+    vkrender::VulkanRenderer* m_pVkRenderer;
+    vk::Device* m_pLogicalDevice;
+    utils::Dimension m_dimension;
+
+    vkrender::VulkanTextureManager m_textureManager;
+    vkrender::VulkanTexture* m_pColorTexture;
+    vkrender::VulkanRenderPass m_renderPass;
+    vk::Framebuffer m_vkFramebuffer;
+
+    vk::Queue m_vkGraphicsQueue;
+    vk::CommandPool m_vkCommandPool;
+    vk::CommandBuffer m_vkCmdBuffer;
+    vk::Fence m_vkFence;
+};
+
+#endif
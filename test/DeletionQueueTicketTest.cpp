@@ -0,0 +1,105 @@
+#include "vkrender/VulkanWindow.h"
+#include "vkrender/VulkanRenderer.h"
+#include "vkrender/VulkanFrameManager.h"
+#include "vkrender/VulkanDeletionQueue.h"
+#include "vkrender/VulkanUploadScheduler.h"
+#include "utilities/VulkanLogger.h"
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Uploads into a buffer through the upload scheduler and hands the buffer to the deletion queue on the
+// upload's ticket while the ticket is still pending, next to a buffer keyed on the current frame. Frames are
+// then collected well past the frames in flight: the frame keyed buffer has to be destroyed and the ticket
+// keyed one has to survive until the ticket's graphics timeline value is reached through wait().
+// Needs a Vulkan device and a window like TriangleApplication.
+// usage: DeletionQueueTicketTest
+int main()
+{
+    using namespace vkrender;
+
+    // renderer setup is logged at info level, only problems are of interest here
+    spdlog::sink_ptr consoleSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    utils::VulkanRendererApiLogger::createInstance( { consoleSink } );
+    utils::VulkanRendererApiLogger::getSingletonPtr()->getLogger()->set_level( spdlog::level::warn );
+
+    VulkanWindow vkWindow{ 800, 600 };
+    vkWindow.init();
+
+    VulkanRenderer vkRenderer;
+    vkRenderer.initVulkan( &vkWindow );
+
+    bool bPassed = true;
+
+    {
+        VulkanDeletionQueue* pDeletionQueue = vkRenderer.getDeletionQueue();
+        VulkanUploadScheduler* pUploadScheduler = vkRenderer.getUploadScheduler();
+
+        // uploads queued during setup must be done before the test retires frames on its own
+        pUploadScheduler->waitIdle();
+        vkRenderer.getDevice()->waitIdle();
+
+        const std::vector<std::uint32_t> payload( 1024, 0xA5A5A5A5u );
+        const vk::DeviceSize payloadSize = payload.size() * sizeof( std::uint32_t );
+
+        auto l_createBuffer = [&]( vk::Buffer& vkBuffer, VulkanAllocation& allocation )
+        {
+            vkRenderer.createBuffer(
+                payloadSize,
+                vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eStorageBuffer, vk::SharingMode::eExclusive,
+                VulkanMemoryUsage::eGpuOnly,
+                vkBuffer, allocation,
+                "deletion queue test"
+            );
+        };
+
+        vk::Buffer ticketBuffer;
+        VulkanAllocation ticketAllocation;
+        l_createBuffer( ticketBuffer, ticketAllocation );
+        vk::Buffer frameBuffer;
+        VulkanAllocation frameAllocation;
+        l_createBuffer( frameBuffer, frameAllocation );
+
+        // not flushed, so the graphics queue cannot have signalled the ticket's value yet
+        const VulkanUploadTicket ticket = pUploadScheduler->uploadBuffer(
+            payload.data(), payloadSize, ticketBuffer, 0,
+            vk::PipelineStageFlagBits::eVertexShader, vk::AccessFlagBits::eShaderRead
+        );
+
+        // retires whatever setup left keyed on earlier frames so the counts below are the test's own
+        std::uint64_t frameNumber = 2 * VulkanFrameManager::DEFAULT_FRAMES_IN_FLIGHT;
+        pDeletionQueue->collect( frameNumber );
+
+        const VulkanDeletionQueue::Statistics statisticsBefore = pDeletionQueue->statistics();
+        pDeletionQueue->destroyBuffer( ticketBuffer, ticketAllocation, ticket );
+        pDeletionQueue->destroyBuffer( frameBuffer, frameAllocation );
+
+        // well past the frames in flight, only the ticket may hold its buffer back
+        frameNumber += 2 * VulkanFrameManager::DEFAULT_FRAMES_IN_FLIGHT;
+        pDeletionQueue->collect( frameNumber );
+
+        const bool bTicketPending = !ticket.isReady();
+        const std::uint64_t pendingDestroyedCount = pDeletionQueue->statistics().m_destroyedCount - statisticsBefore.m_destroyedCount;
+        const std::size_t pendingCount = pDeletionQueue->pendingCount();
+
+        ticket.wait();
+        pDeletionQueue->collect( ++frameNumber );
+
+        const std::uint64_t readyDestroyedCount = pDeletionQueue->statistics().m_destroyedCount - statisticsBefore.m_destroyedCount;
+        const std::size_t readyPendingCount = pDeletionQueue->pendingCount();
+
+        std::printf( "%16s %10s %10s\n", "ticket", "destroyed", "pending" );
+        std::printf( "%16s %10llu %10zu\n", bTicketPending ? "pending" : "ready", static_cast<unsigned long long>( pendingDestroyedCount ), pendingCount );
+        std::printf( "%16s %10llu %10zu\n", "waited", static_cast<unsigned long long>( readyDestroyedCount ), readyPendingCount );
+
+        // the frame keyed buffer retires on its own, the ticket keyed one only after the wait
+        if( !bTicketPending || pendingDestroyedCount != 1 || pendingCount != 1 || readyDestroyedCount != 2 || readyPendingCount != 0 )
+            bPassed = false;
+    }
+
+    std::printf( "%s\n", bPassed ? "PASSED" : "FAILED" );
+    return bPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,119 @@
+#include "vkrender/VulkanWindow.h"
+#include "vkrender/VulkanRenderer.h"
+#include "vkrender/VulkanDescriptor.h"
+#include "vkrender/VulkanDeletionQueue.h"
+#include "utilities/VulkanLogger.h"
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace
+{
+
+// one way of handing the sets of a destroyed material back to the allocator
+struct LifetimePath
+{
+    const char* m_name;
+    vkrender::VulkanDeletionQueue* m_pDeletionQueue;
+};
+
+// a set per frame in flight like a material updated every frame would have
+constexpr std::uint32_t MATERIAL_SET_COUNT = 3u;
+
+} // namespace
+
+// Creates and destroys materials one after the other, each a VulkanDescriptor with a uniform buffer and a
+// combined image sampler per set, from the renderer's long lived descriptor allocator. Sets are freed once
+// right away and once through the deletion queue, which is collected every iteration like a frame would.
+// Fails when the allocator's pool count grows past what the first material needed or sets are left unfreed.
+// Needs a Vulkan device and a window like TriangleApplication.
+// usage: DescriptorLifetimeTest [materials]
+int main( int argc, char** argv )
+{
+    using namespace vkrender;
+
+    // renderer setup is logged at info level, only problems are of interest here
+    spdlog::sink_ptr consoleSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    utils::VulkanRendererApiLogger::createInstance( { consoleSink } );
+    utils::VulkanRendererApiLogger::getSingletonPtr()->getLogger()->set_level( spdlog::level::warn );
+
+    const std::uint32_t materialCount = argc > 1 ? static_cast<std::uint32_t>( std::max( std::stoul( argv[1] ), 1ul ) ) : 4096u;
+
+    VulkanWindow vkWindow{ 800, 600 };
+    vkWindow.init();
+
+    VulkanRenderer vkRenderer;
+    vkRenderer.initVulkan( &vkWindow );
+
+    bool bPassed = true;
+
+    {
+        VulkanDescriptorAllocator* pDescriptorAllocator = vkRenderer.getDescriptorAllocator();
+        VulkanDeletionQueue* pDeletionQueue = vkRenderer.getDeletionQueue();
+
+        // uploads queued during setup must be done before the test retires frames on its own
+        vkRenderer.getDevice()->waitIdle();
+
+        const VulkanDescriptor::DescriptorBindingArray materialBindings{
+            VulkanDescriptor::DescriptorBinding{ vk::DescriptorType::eUniformBuffer, vk::ShaderStageFlagBits::eFragment },
+            VulkanDescriptor::DescriptorBinding{ vk::DescriptorType::eCombinedImageSampler, vk::ShaderStageFlagBits::eFragment }
+        };
+
+        auto l_createAndDestroyMaterial = [&]( VulkanDeletionQueue* pMaterialDeletionQueue )
+        {
+            VulkanDescriptor material{
+                vkRenderer.getDevice(), vkRenderer.getDescriptorLayoutCache(), pDescriptorAllocator,
+                MATERIAL_SET_COUNT, pMaterialDeletionQueue
+            };
+            material.allocateDescriptorSets( materialBindings );
+        };
+
+        std::uint64_t frameNumber = 0;
+        const LifetimePath lifetimePaths[] = {
+            { "immediate", nullptr },
+            { "deletion queue", pDeletionQueue }
+        };
+
+        std::printf( "%u materials of %u sets each\n", materialCount, MATERIAL_SET_COUNT );
+        std::printf( "%16s %8s %8s %12s %12s\n", "path", "pools", "after", "allocated", "freed" );
+
+        for( const LifetimePath& lifetimePath : lifetimePaths )
+        {
+            const VulkanDescriptorAllocator::Statistics statisticsBefore = pDescriptorAllocator->statistics();
+
+            l_createAndDestroyMaterial( lifetimePath.m_pDeletionQueue );
+            pDeletionQueue->collect( ++frameNumber );
+            const std::uint32_t firstPoolCount = pDescriptorAllocator->statistics().m_poolCount;
+
+            for( std::uint32_t i = 1u; i < materialCount; i++ )
+            {
+                l_createAndDestroyMaterial( lifetimePath.m_pDeletionQueue );
+                pDeletionQueue->collect( ++frameNumber );
+            }
+
+            // retire the frames still holding the last materials
+            frameNumber += VulkanFrameManager::DEFAULT_FRAMES_IN_FLIGHT;
+            pDeletionQueue->collect( frameNumber );
+
+            const VulkanDescriptorAllocator::Statistics statisticsAfter = pDescriptorAllocator->statistics();
+            const std::uint64_t allocatedCount = statisticsAfter.m_allocationCount - statisticsBefore.m_allocationCount;
+            const std::uint64_t freedCount = statisticsAfter.m_freeCount - statisticsBefore.m_freeCount;
+
+            std::printf(
+                "%16s %8u %8u %12llu %12llu\n",
+                lifetimePath.m_name, firstPoolCount, statisticsAfter.m_poolCount,
+                static_cast<unsigned long long>( allocatedCount ), static_cast<unsigned long long>( freedCount )
+            );
+
+            if( statisticsAfter.m_poolCount != firstPoolCount || freedCount != allocatedCount )
+                bPassed = false;
+        }
+    }
+
+    std::printf( "%s\n", bPassed ? "PASSED" : "FAILED" );
+    return bPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,210 @@
+#include "vkrender/VulkanWindow.h"
+#include "vkrender/VulkanRenderer.h"
+#include "vkrender/VulkanGPUProgram.h"
+#include "vkrender/VulkanGfxPipeline.h"
+#include "vkrender/VulkanPushDescriptor.h"
+#include "vkrender/VulkanUniformRing.h"
+#include "vkrender/VulkanUBO.hpp"
+#include "utilities/VulkanLogger.h"
+
+#include "BenchmarkOffscreenTarget.hpp"
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const std::uint32_t BENCHMARK_DRAW_VERT_SPIRV[] = {
+#include "BenchmarkDraw.vert.inc"
+};
+
+const std::uint32_t BENCHMARK_DRAW_UNIFORM_VERT_SPIRV[] = {
+#include "BenchmarkDrawUniform.vert.inc"
+};
+
+const std::uint32_t BENCHMARK_DRAW_FRAG_SPIRV[] = {
+#include "BenchmarkDraw.frag.inc"
+};
+
+// one way of handing a draw its model matrix, recordDraw records everything the draw needs after the pipeline bind
+struct BindingPath
+{
+    const char* m_name;
+    vkrender::VulkanGfxPipeline* m_pGfxPipeline;
+    std::function<void(vk::CommandBuffer& cmdBuffer, const std::uint32_t& drawIndex)> m_recordDraw;
+};
+
+} // namespace
+
+// Records N draws on one thread with the model matrix of every draw passed as push constants, as a push
+// descriptor of a uniform ring slice (when VK_KHR_push_descriptor is available) and as a dynamic offset into
+// the uniform ring, then prints record and frame throughput of each path. Uniform data is written during
+// recording, so its memcpy counts towards the record time like the push constant copy does.
+// Needs a Vulkan device and a window like TriangleApplication.
+// usage: DrawBindingBenchmark [draws] [repetitions]
+int main( int argc, char** argv )
+{
+    using namespace vkrender;
+
+    // renderer setup is logged at info level, only problems are of interest here
+    spdlog::sink_ptr consoleSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    utils::VulkanRendererApiLogger::createInstance( { consoleSink } );
+    utils::VulkanRendererApiLogger::getSingletonPtr()->getLogger()->set_level( spdlog::level::warn );
+
+    const std::uint32_t drawCount = argc > 1 ? static_cast<std::uint32_t>( std::max( std::stoul( argv[1] ), 1ul ) ) : 20000u;
+    const int repetitions = argc > 2 ? std::max( std::stoi( argv[2] ), 1 ) : 10;
+
+    VulkanWindow vkWindow{ 800, 600 };
+    vkWindow.init();
+
+    VulkanRenderer vkRenderer;
+    vkRenderer.initVulkan( &vkWindow );
+
+    {
+        BenchmarkOffscreenTarget offscreenTarget{ &vkRenderer, { 1024, 1024 } };
+        vk::Device* pLogicalDevice = vkRenderer.getDevice();
+        VulkanPushDescriptor* pPushDescriptor = vkRenderer.getPushDescriptor();
+
+        VulkanGpuProgram pushConstantShader{ BenchmarkOffscreenTarget::spirvBuffer( BENCHMARK_DRAW_VERT_SPIRV ) };
+        pushConstantShader.createShader( pLogicalDevice, vk::ShaderStageFlagBits::eVertex, "main" );
+        VulkanGpuProgram uniformShader{ BenchmarkOffscreenTarget::spirvBuffer( BENCHMARK_DRAW_UNIFORM_VERT_SPIRV ) };
+        uniformShader.createShader( pLogicalDevice, vk::ShaderStageFlagBits::eVertex, "main" );
+        VulkanGpuProgram fragmentShader{ BenchmarkOffscreenTarget::spirvBuffer( BENCHMARK_DRAW_FRAG_SPIRV ) };
+        fragmentShader.createShader( pLogicalDevice, vk::ShaderStageFlagBits::eFragment, "main" );
+
+        // every draw of a frame takes its own slice, the ring is rewound once the frame was waited for
+        const vk::DeviceSize uniformAlignment = std::max<vk::DeviceSize>( vkRenderer.getDeviceCapabilities()->limits().minUniformBufferOffsetAlignment, 1ull );
+        const vk::DeviceSize uniformSliceSize = ( sizeof( VulkanObjectUniforms ) + uniformAlignment - 1 ) / uniformAlignment * uniformAlignment;
+        VulkanUniformRing uniformRing{ &vkRenderer, uniformSliceSize * drawCount };
+
+        std::vector<VulkanObjectPushConstants> drawConstants( drawCount );
+        std::vector<VulkanObjectUniforms> drawUniforms( drawCount );
+        for( std::uint32_t i = 0u; i < drawCount; i++ )
+        {
+            drawConstants[i].model = BenchmarkOffscreenTarget::gridModel( i, drawCount );
+            drawUniforms[i].model = drawConstants[i].model;
+        }
+
+        const std::vector<vk::DescriptorSetLayoutBinding> uniformBindings{
+            vk::DescriptorSetLayoutBinding{ 0, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eVertex }
+        };
+        const std::vector<vk::DescriptorSetLayoutBinding> dynamicUniformBindings{
+            vk::DescriptorSetLayoutBinding{ 0, vk::DescriptorType::eUniformBufferDynamic, 1, vk::ShaderStageFlagBits::eVertex }
+        };
+
+        std::vector<BindingPath> bindingPaths;
+
+        VulkanGfxPipeline pushConstantPipeline{ pLogicalDevice, vkRenderer.getPipelineCache(), vkRenderer.getDeletionQueue(), vkRenderer.getDescriptorLayoutCache() };
+        offscreenTarget.createPipeline( pushConstantPipeline, { &pushConstantShader, &fragmentShader } );
+
+        bindingPaths.push_back( { "push constants", &pushConstantPipeline, [&]( vk::CommandBuffer& cmdBuffer, const std::uint32_t& drawIndex )
+        {
+            pushConstantPipeline.pushConstants( cmdBuffer, vk::ShaderStageFlagBits::eVertex, drawConstants[drawIndex] );
+        } } );
+
+        VulkanGfxPipeline pushDescriptorPipeline{ pLogicalDevice, vkRenderer.getPipelineCache(), vkRenderer.getDeletionQueue(), vkRenderer.getDescriptorLayoutCache() };
+        if( pPushDescriptor )
+        {
+            pushDescriptorPipeline.bindDescriptorSetLayouts( {
+                vkRenderer.getDescriptorLayoutCache()->acquire( uniformBindings, vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR )
+            } );
+            offscreenTarget.createPipeline( pushDescriptorPipeline, { &uniformShader, &fragmentShader } );
+
+            bindingPaths.push_back( { "push descriptor", &pushDescriptorPipeline, [&]( vk::CommandBuffer& cmdBuffer, const std::uint32_t& drawIndex )
+            {
+                const VulkanUniformSlice uniformSlice = uniformRing.push( drawUniforms[drawIndex] );
+                const vk::DescriptorBufferInfo bufferInfo{ uniformSlice.m_vkBuffer, uniformSlice.m_dynamicOffset, sizeof( VulkanObjectUniforms ) };
+
+                vk::WriteDescriptorSet writeDescriptorSet{};
+                writeDescriptorSet.dstBinding = 0;
+                writeDescriptorSet.descriptorCount = 1;
+                writeDescriptorSet.descriptorType = vk::DescriptorType::eUniformBuffer;
+                writeDescriptorSet.pBufferInfo = &bufferInfo;
+
+                pPushDescriptor->push( cmdBuffer, vk::PipelineBindPoint::eGraphics, pushDescriptorPipeline.layout(), 0, { writeDescriptorSet } );
+            } } );
+        }
+        else
+        {
+            std::printf( "%s is not supported, the push descriptor path is skipped\n", VulkanPushDescriptor::EXTENSION_NAME );
+        }
+
+        // a single set written once, only the dynamic offset changes per draw
+        const vk::DescriptorSetLayout dynamicUniformLayout = vkRenderer.getDescriptorLayoutCache()->acquire( dynamicUniformBindings );
+        const vk::DescriptorSet dynamicUniformSet = vkRenderer.getDescriptorAllocator()->allocate( dynamicUniformLayout );
+        {
+            const vk::DescriptorBufferInfo bufferInfo = uniformRing.descriptorInfo( sizeof( VulkanObjectUniforms ) );
+
+            vk::WriteDescriptorSet writeDescriptorSet{};
+            writeDescriptorSet.dstSet = dynamicUniformSet;
+            writeDescriptorSet.dstBinding = 0;
+            writeDescriptorSet.descriptorCount = 1;
+            writeDescriptorSet.descriptorType = vk::DescriptorType::eUniformBufferDynamic;
+            writeDescriptorSet.pBufferInfo = &bufferInfo;
+
+            pLogicalDevice->updateDescriptorSets( writeDescriptorSet, nullptr );
+            vkRenderer.getDescriptorAllocator()->recordWrites( 1 );
+        }
+
+        VulkanGfxPipeline dynamicUniformPipeline{ pLogicalDevice, vkRenderer.getPipelineCache(), vkRenderer.getDeletionQueue(), vkRenderer.getDescriptorLayoutCache() };
+        dynamicUniformPipeline.bindDescriptorSetLayouts( { dynamicUniformLayout } );
+        offscreenTarget.createPipeline( dynamicUniformPipeline, { &uniformShader, &fragmentShader } );
+
+        bindingPaths.push_back( { "dynamic UBO", &dynamicUniformPipeline, [&]( vk::CommandBuffer& cmdBuffer, const std::uint32_t& drawIndex )
+        {
+            const VulkanUniformSlice uniformSlice = uniformRing.push( drawUniforms[drawIndex] );
+            cmdBuffer.bindDescriptorSets( vk::PipelineBindPoint::eGraphics, dynamicUniformPipeline.layout(), 0, dynamicUniformSet, uniformSlice.m_dynamicOffset );
+        } } );
+
+        std::printf( "%u draws, best of %d runs\n", drawCount, repetitions );
+        std::printf( "%16s %12s %12s %12s %12s\n", "path", "record ms", "draws/ms", "frame ms", "draws/ms" );
+
+        for( const BindingPath& bindingPath : bindingPaths )
+        {
+            double bestSeconds = 0.0;
+            double bestFrameSeconds = 0.0;
+
+            for( int run = 0; run < repetitions; run++ )
+            {
+                vk::CommandBuffer& cmdBuffer = offscreenTarget.beginPass( vk::SubpassContents::eInline );
+
+                const auto recordBegin = std::chrono::steady_clock::now();
+
+                cmdBuffer.bindPipeline( vk::PipelineBindPoint::eGraphics, bindingPath.m_pGfxPipeline->handle() );
+                offscreenTarget.setViewportAndScissor( cmdBuffer );
+                for( std::uint32_t i = 0u; i < drawCount; i++ )
+                {
+                    bindingPath.m_recordDraw( cmdBuffer, i );
+                    cmdBuffer.draw( 3, 1, 0, 0 );
+                }
+
+                const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - recordBegin ).count();
+
+                const double frameSeconds = offscreenTarget.submitAndWait();
+                uniformRing.reset();
+
+                if( run == 0 || seconds < bestSeconds )
+                    bestSeconds = seconds;
+                if( run == 0 || frameSeconds < bestFrameSeconds )
+                    bestFrameSeconds = frameSeconds;
+            }
+
+            std::printf(
+                "%16s %12.3f %12.1f %12.3f %12.1f\n",
+                bindingPath.m_name,
+                bestSeconds * 1000.0, drawCount / ( bestSeconds * 1000.0 ),
+                bestFrameSeconds * 1000.0, drawCount / ( bestFrameSeconds * 1000.0 )
+            );
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,135 @@
+#include "utilities/Image.h"
+#include "utilities/VulkanLogger.h"
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+constexpr std::array<unsigned char, 12> KTX2_IDENTIFIER = {
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+};
+
+// header fields up to the level index, laid out as in the KTX2 specification
+struct Ktx2Header
+{
+    std::uint32_t m_vkFormat;
+    std::uint32_t m_typeSize;
+    std::uint32_t m_pixelWidth;
+    std::uint32_t m_pixelHeight;
+    std::uint32_t m_pixelDepth;
+    std::uint32_t m_layerCount;
+    std::uint32_t m_faceCount;
+    std::uint32_t m_levelCount;
+    std::uint32_t m_supercompressionScheme;
+    std::uint32_t m_indexWords[8];
+};
+
+struct Ktx2LevelIndex
+{
+    std::uint64_t m_byteOffset;
+    std::uint64_t m_byteLength;
+    std::uint64_t m_uncompressedByteLength;
+};
+
+constexpr std::uint32_t TEXTURE_SIZE = 4;
+constexpr std::uint64_t LEVEL_SIZE = TEXTURE_SIZE * TEXTURE_SIZE * 4;
+constexpr std::uint64_t LEVEL_OFFSET = KTX2_IDENTIFIER.size() + sizeof( Ktx2Header ) + sizeof( Ktx2LevelIndex );
+constexpr std::uint64_t FILE_SIZE = LEVEL_OFFSET + LEVEL_SIZE;
+
+struct LevelIndexCase
+{
+    const char* m_name;
+    std::uint64_t m_byteOffset;
+    std::uint64_t m_byteLength;
+    bool m_bValid;
+};
+
+// a 4x4 RGBA8 KTX2 file with a single level described by the given index entry
+void writeKtx2( const std::filesystem::path& path, const std::uint64_t& byteOffset, const std::uint64_t& byteLength )
+{
+    Ktx2Header header{};
+    header.m_vkFormat = VK_FORMAT_R8G8B8A8_UNORM;
+    header.m_typeSize = 1;
+    header.m_pixelWidth = TEXTURE_SIZE;
+    header.m_pixelHeight = TEXTURE_SIZE;
+    header.m_faceCount = 1;
+    header.m_levelCount = 1;
+
+    const Ktx2LevelIndex levelIndex{ byteOffset, byteLength, byteLength };
+    const std::vector<unsigned char> pixels( LEVEL_SIZE, 0x7F );
+
+    std::ofstream file( path, std::ios::binary | std::ios::trunc );
+    file.write( reinterpret_cast<const char*>( KTX2_IDENTIFIER.data() ), KTX2_IDENTIFIER.size() );
+    file.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+    file.write( reinterpret_cast<const char*>( &levelIndex ), sizeof( levelIndex ) );
+    file.write( reinterpret_cast<const char*>( pixels.data() ), static_cast<std::streamsize>( pixels.size() ) );
+}
+
+} // namespace
+
+// Writes KTX2 files whose level index points inside, past and around the end of the file and loads them through
+// utils::Image. Only the well formed file may load, the others have to be rejected before any level is read,
+// including an offset and length whose sum wraps around to a position inside the file.
+// Runs on the CPU only, the files are written to the temporary directory.
+// usage: ImageContainerTest
+int main()
+{
+    // expected load failures are logged at error level, only the verdicts below are of interest
+    spdlog::sink_ptr consoleSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    utils::VulkanRendererApiLogger::createInstance( { consoleSink } );
+    utils::VulkanRendererApiLogger::getSingletonPtr()->getLogger()->set_level( spdlog::level::critical );
+
+    const std::uint64_t maxValue = std::numeric_limits<std::uint64_t>::max();
+    const LevelIndexCase levelIndexCases[] = {
+        { "valid", LEVEL_OFFSET, LEVEL_SIZE, true },
+        { "offset past end", FILE_SIZE + 1, LEVEL_SIZE, false },
+        { "length past end", LEVEL_OFFSET, LEVEL_SIZE + 1, false },
+        { "wrapping sum", LEVEL_OFFSET, maxValue - LEVEL_OFFSET + 1, false },
+        { "wrapping offset", maxValue, LEVEL_SIZE, false }
+    };
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "ImageContainerTest.ktx2";
+    bool bPassed = true;
+
+    std::printf( "%16s %10s %10s\n", "level index", "expected", "loaded" );
+
+    for( const LevelIndexCase& levelIndexCase : levelIndexCases )
+    {
+        writeKtx2( path, levelIndexCase.m_byteOffset, levelIndexCase.m_byteLength );
+
+        bool bLoaded = false;
+        try
+        {
+            utils::Image image;
+            image.loadBuffer( path, 4 );
+            bLoaded = image.buffer() != nullptr && image.sizeInBytes() == LEVEL_SIZE;
+        }
+        catch( const std::runtime_error& )
+        {
+            bLoaded = false;
+        }
+
+        std::printf( "%16s %10s %10s\n", levelIndexCase.m_name, levelIndexCase.m_bValid ? "yes" : "no", bLoaded ? "yes" : "no" );
+
+        if( bLoaded != levelIndexCase.m_bValid )
+            bPassed = false;
+    }
+
+    std::filesystem::remove( path );
+
+    std::printf( "%s\n", bPassed ? "PASSED" : "FAILED" );
+    return bPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
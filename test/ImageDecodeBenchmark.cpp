@@ -0,0 +1,114 @@
+#include "utilities/ImageLoader.h"
+#include "utilities/ThreadPool.h"
+#include "utilities/VulkanLogger.h"
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Decodes every PNG and JPEG of a folder with 1, 2, 4 ... hardware threads and prints the throughput
+// usage: ImageDecodeBenchmark <image folder> [repetitions]
+int main( int argc, char** argv )
+{
+    if( argc < 2 )
+    {
+        std::printf( "usage: %s <image folder> [repetitions]\n", argv[0] );
+        return EXIT_FAILURE;
+    }
+
+    // decode failures are reported through the renderer logger
+    spdlog::sink_ptr consoleSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    utils::VulkanRendererApiLogger::createInstance( { consoleSink } );
+    utils::VulkanRendererApiLogger::getSingletonPtr()->getLogger()->set_level( spdlog::level::info );
+
+    const std::filesystem::path imageFolder{ argv[1] };
+    const int repetitions = argc > 2 ? std::max( std::stoi( argv[2] ), 1 ) : 3;
+
+    std::vector<std::filesystem::path> imagePaths;
+    for( const auto& entry : std::filesystem::recursive_directory_iterator( imageFolder ) )
+    {
+        if( !entry.is_regular_file() )
+            continue;
+
+        std::string extension = entry.path().extension().string();
+        std::transform( extension.begin(), extension.end(), extension.begin(), []( unsigned char c ){ return static_cast<char>( std::tolower( c ) ); } );
+
+        if( extension == ".png" || extension == ".jpg" || extension == ".jpeg" )
+            imagePaths.push_back( entry.path() );
+    }
+
+    if( imagePaths.empty() )
+    {
+        std::printf( "no PNG or JPEG files found in %s\n", imageFolder.string().c_str() );
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::uint32_t> threadCounts;
+    const std::uint32_t hardwareThreads = std::max( std::thread::hardware_concurrency(), 1u );
+    for( std::uint32_t threadCount = 1u; threadCount < hardwareThreads; threadCount *= 2u )
+        threadCounts.push_back( threadCount );
+    threadCounts.push_back( hardwareThreads );
+
+    std::printf( "%zu images, best of %d runs\n", imagePaths.size(), repetitions );
+    std::printf( "%8s %12s %14s %14s %10s\n", "threads", "time ms", "file MB/s", "decoded MB/s", "speedup" );
+
+    double singleThreadSeconds = 0.0;
+
+    for( const std::uint32_t threadCount : threadCounts )
+    {
+        utils::ThreadPool threadPool{ threadCount };
+
+        double bestSeconds = 0.0;
+        utils::ImageLoader::Statistics bestStatistics;
+
+        for( int run = 0; run < repetitions; run++ )
+        {
+            utils::ImageLoader imageLoader{ &threadPool };
+
+            const auto runBegin = std::chrono::steady_clock::now();
+
+            std::vector<utils::ImageLoader::Handle> handles;
+            handles.reserve( imagePaths.size() );
+            for( const std::filesystem::path& imagePath : imagePaths )
+                handles.push_back( imageLoader.load( imagePath ) );
+
+            imageLoader.waitAll();
+
+            const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - runBegin ).count();
+
+            if( run == 0 || seconds < bestSeconds )
+            {
+                bestSeconds = seconds;
+                bestStatistics = imageLoader.statistics();
+            }
+
+            for( const utils::ImageLoader::Handle& handle : handles )
+                imageLoader.release( handle );
+        }
+
+        if( threadCount == 1u )
+            singleThreadSeconds = bestSeconds;
+
+        constexpr double MEGABYTE = 1024.0 * 1024.0;
+        std::printf(
+            "%8u %12.1f %14.1f %14.1f %9.2fx\n",
+            threadCount, bestSeconds * 1000.0,
+            bestStatistics.m_fileBytes / MEGABYTE / bestSeconds,
+            bestStatistics.m_decodedBytes / MEGABYTE / bestSeconds,
+            singleThreadSeconds / bestSeconds
+        );
+
+        if( bestStatistics.m_failedCount > 0 )
+            std::printf( "%8s %llu images failed to decode\n", "", static_cast<unsigned long long>( bestStatistics.m_failedCount ) );
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,237 @@
+#include "vkrender/VulkanMemoryAllocator.h"
+#include "utilities/VulkanLogger.h"
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+constexpr double MEGABYTE = 1024.0 * 1024.0;
+
+// sizes spread evenly over powers of two between 256 bytes and 4MB, like a mix of uniform buffers,
+// vertex buffers and textures, alignments between 256 bytes and 64KB
+struct RequestGenerator
+{
+    std::mt19937_64 m_random;
+    std::uniform_real_distribution<double> m_sizeExponent{ 8.0, 22.0 };
+    std::uniform_int_distribution<int> m_alignmentExponent{ 8, 16 };
+
+    explicit RequestGenerator( const std::uint64_t& seed ) :m_random{ seed } {}
+
+    vk::MemoryRequirements next()
+    {
+        vk::MemoryRequirements memRequirements{};
+        memRequirements.size = static_cast<vk::DeviceSize>( std::exp2( m_sizeExponent( m_random ) ) );
+        memRequirements.alignment = vk::DeviceSize{ 1 } << m_alignmentExponent( m_random );
+        memRequirements.memoryTypeBits = ~0u;
+        return memRequirements;
+    }
+};
+
+// host memory stands in for device memory, the handle is the host pointer
+vkrender::VulkanDeviceMemoryCallbacks hostMemoryCallbacks( std::uint64_t* pDeviceAllocationCount )
+{
+    vkrender::VulkanDeviceMemoryCallbacks memoryCallbacks{};
+    memoryCallbacks.m_allocate = [pDeviceAllocationCount]( const vk::MemoryAllocateInfo& allocInfo ) {
+        ( *pDeviceAllocationCount )++;
+        // pages are only committed once written, device local blocks never are
+        return vk::DeviceMemory{ reinterpret_cast<VkDeviceMemory>( std::malloc( static_cast<std::size_t>( allocInfo.allocationSize ) ) ) };
+    };
+    memoryCallbacks.m_free = []( const vk::DeviceMemory& vkMemory ) { std::free( reinterpret_cast<void*>( static_cast<VkDeviceMemory>( vkMemory ) ) ); };
+    memoryCallbacks.m_map = []( const vk::DeviceMemory& vkMemory ) { return reinterpret_cast<void*>( static_cast<VkDeviceMemory>( vkMemory ) ); };
+    memoryCallbacks.m_unmap = []( const vk::DeviceMemory& ) {};
+    return memoryCallbacks;
+}
+
+// one device local heap and one host visible heap, like a discrete GPU without a BAR window
+vk::PhysicalDeviceMemoryProperties fakeMemoryProperties()
+{
+    vk::PhysicalDeviceMemoryProperties memoryProperties{};
+    memoryProperties.memoryHeapCount = 2;
+    memoryProperties.memoryHeaps[0] = vk::MemoryHeap{ 8ull * 1024ull * 1024ull * 1024ull, vk::MemoryHeapFlagBits::eDeviceLocal };
+    memoryProperties.memoryHeaps[1] = vk::MemoryHeap{ 16ull * 1024ull * 1024ull * 1024ull, vk::MemoryHeapFlags{} };
+    memoryProperties.memoryTypeCount = 2;
+    memoryProperties.memoryTypes[0] = vk::MemoryType{ vk::MemoryPropertyFlagBits::eDeviceLocal, 0 };
+    memoryProperties.memoryTypes[1] = vk::MemoryType{ vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, 1 };
+    return memoryProperties;
+}
+
+// fills a single block until a request no longer fits, then churns it at that fill level
+void benchmarkBuddyBlock( const std::uint64_t& operationCount )
+{
+    constexpr vk::DeviceSize BLOCK_SIZE = vkrender::VulkanMemoryAllocator::DEFAULT_BLOCK_SIZE;
+    vkrender::VulkanBuddyBlock buddyBlock{ BLOCK_SIZE, vkrender::VulkanMemoryAllocator::MIN_NODE_SIZE };
+    RequestGenerator requestGenerator{ 1 };
+
+    struct Node
+    {
+        vk::DeviceSize m_offset;
+        vk::DeviceSize m_size;
+    };
+
+    std::vector<Node> liveNodes;
+    vk::DeviceSize requestedBytes = 0;
+    while( true )
+    {
+        const vk::MemoryRequirements memRequirements = requestGenerator.next();
+        std::optional<vk::DeviceSize> offset = buddyBlock.allocate( memRequirements.size, memRequirements.alignment );
+        if( !offset.has_value() )
+            break;
+
+        liveNodes.push_back( Node{ offset.value(), memRequirements.size } );
+        requestedBytes += memRequirements.size;
+    }
+
+    std::printf( "buddy block of %.0f MB filled with %zu allocations until the first failure\n", BLOCK_SIZE / MEGABYTE, liveNodes.size() );
+    std::printf( "  %.1f%% of the block in nodes, %.1f%% of it requested, %.1f%% of node bytes lost to rounding\n",
+        100.0 * buddyBlock.usedBytes() / BLOCK_SIZE, 100.0 * requestedBytes / BLOCK_SIZE,
+        100.0 * ( buddyBlock.usedBytes() - requestedBytes ) / buddyBlock.usedBytes()
+    );
+
+    std::uint64_t failedCount = 0;
+    const auto churnBegin = std::chrono::steady_clock::now();
+
+    for( std::uint64_t i = 0; i < operationCount; i++ )
+    {
+        const std::size_t victim = static_cast<std::size_t>( requestGenerator.m_random() % liveNodes.size() );
+        buddyBlock.free( liveNodes[victim].m_offset );
+        requestedBytes -= liveNodes[victim].m_size;
+
+        const vk::MemoryRequirements memRequirements = requestGenerator.next();
+        std::optional<vk::DeviceSize> offset = buddyBlock.allocate( memRequirements.size, memRequirements.alignment );
+        if( offset.has_value() )
+        {
+            liveNodes[victim] = Node{ offset.value(), memRequirements.size };
+            requestedBytes += memRequirements.size;
+        }
+        else
+        {
+            liveNodes[victim] = liveNodes.back();
+            liveNodes.pop_back();
+            failedCount++;
+
+            // an empty block fits any request
+            if( liveNodes.empty() )
+            {
+                const vk::MemoryRequirements refill = requestGenerator.next();
+                offset = buddyBlock.allocate( refill.size, refill.alignment );
+                liveNodes.push_back( Node{ offset.value(), refill.size } );
+                requestedBytes += refill.size;
+            }
+        }
+    }
+
+    const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - churnBegin ).count();
+    std::printf( "  churn: %llu free + allocate pairs in %.1f ms, %.2f M ops/s, %.2f%% of allocations failed\n",
+        static_cast<unsigned long long>( operationCount ), seconds * 1000.0,
+        2.0 * operationCount / seconds / 1e6, 100.0 * failedCount / operationCount
+    );
+    std::printf( "  after churn: %zu live nodes, %.1f%% of the block requested\n\n", liveNodes.size(), 100.0 * requestedBytes / BLOCK_SIZE );
+
+    for( const Node& node : liveNodes )
+        buddyBlock.free( node.m_offset );
+}
+
+void printHeaps( const vkrender::VulkanMemoryAllocator& allocator, const char* label )
+{
+    const vkrender::VulkanMemoryAllocator::Snapshot snapshot = allocator.snapshot();
+    for( std::size_t i = 0; i < snapshot.m_heaps.size(); i++ )
+    {
+        const vkrender::VulkanMemoryAllocator::HeapBudget& heapBudget = snapshot.m_heaps[i];
+        const vk::DeviceSize reservedBytes = heapBudget.m_reservedBytes;
+        std::printf( "  %-14s heap %zu: %8.1f MB reserved in %3u blocks + %3u dedicated, %8.1f MB allocated, %5.1f%% unused\n",
+            label, i, reservedBytes / MEGABYTE, heapBudget.m_blockCount, heapBudget.m_dedicatedCount,
+            heapBudget.m_allocatedBytes / MEGABYTE,
+            reservedBytes == 0 ? 0.0 : 100.0 * ( reservedBytes - heapBudget.m_allocatedBytes ) / reservedBytes
+        );
+    }
+}
+
+// keeps liveCount allocations alive across both heaps and both resource kinds, replacing a random one per step
+void benchmarkAllocator( const std::size_t& liveCount, const std::uint64_t& operationCount )
+{
+    std::uint64_t deviceAllocationCount = 0;
+    vkrender::VulkanMemoryAllocator allocator{ fakeMemoryProperties(), hostMemoryCallbacks( &deviceAllocationCount ) };
+    RequestGenerator requestGenerator{ 2 };
+
+    auto l_allocate = [&allocator, &requestGenerator]( const std::uint64_t& index ) {
+        const vk::MemoryPropertyFlags memProps = ( index % 4 == 0 )
+            ? vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+            : vk::MemoryPropertyFlags{ vk::MemoryPropertyFlagBits::eDeviceLocal };
+        const vkrender::VulkanMemoryAllocator::ResourceKind resourceKind = ( index % 2 == 0 )
+            ? vkrender::VulkanMemoryAllocator::ResourceKind::eLinear
+            : vkrender::VulkanMemoryAllocator::ResourceKind::eOptimal;
+        return allocator.allocate( requestGenerator.next(), memProps, resourceKind );
+    };
+
+    std::printf( "allocator with %zu live allocations\n", liveCount );
+
+    std::vector<vkrender::VulkanAllocation> liveAllocations;
+    liveAllocations.reserve( liveCount );
+
+    const auto fillBegin = std::chrono::steady_clock::now();
+    for( std::size_t i = 0; i < liveCount; i++ )
+        liveAllocations.push_back( l_allocate( i ) );
+    const double fillSeconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - fillBegin ).count();
+
+    std::printf( "  fill: %.1f ms, %.2f M allocations/s\n", fillSeconds * 1000.0, liveCount / fillSeconds / 1e6 );
+    printHeaps( allocator, "after fill" );
+
+    const auto churnBegin = std::chrono::steady_clock::now();
+    for( std::uint64_t i = 0; i < operationCount; i++ )
+    {
+        const std::size_t victim = static_cast<std::size_t>( requestGenerator.m_random() % liveAllocations.size() );
+        allocator.free( liveAllocations[victim] );
+        liveAllocations[victim] = l_allocate( victim );
+    }
+    const double churnSeconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - churnBegin ).count();
+
+    std::printf( "  churn: %llu free + allocate pairs in %.1f ms, %.2f M ops/s\n",
+        static_cast<unsigned long long>( operationCount ), churnSeconds * 1000.0, 2.0 * operationCount / churnSeconds / 1e6
+    );
+    printHeaps( allocator, "after churn" );
+
+    // frees every other allocation, what is left shows how well freed space comes back as whole blocks
+    for( std::size_t i = 0; i < liveAllocations.size(); i += 2 )
+        allocator.free( liveAllocations[i] );
+    printHeaps( allocator, "half freed" );
+
+    const auto drainBegin = std::chrono::steady_clock::now();
+    for( vkrender::VulkanAllocation& allocation : liveAllocations )
+        allocator.free( allocation );
+    const double drainSeconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - drainBegin ).count();
+
+    std::printf( "  drain: %.1f ms\n", drainSeconds * 1000.0 );
+    printHeaps( allocator, "drained" );
+    std::printf( "  %llu device memory allocations over the run\n\n", static_cast<unsigned long long>( deviceAllocationCount ) );
+}
+
+} // namespace
+
+// Drives the buddy placement and the block pools on host memory and prints allocate / free throughput
+// and how much reserved memory ends up unused
+// usage: MemoryAllocatorBenchmark [operations]
+int main( int argc, char** argv )
+{
+    spdlog::sink_ptr consoleSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    utils::VulkanRendererApiLogger::createInstance( { consoleSink } );
+    utils::VulkanRendererApiLogger::getSingletonPtr()->getLogger()->set_level( spdlog::level::warn );
+
+    const std::uint64_t operationCount = argc > 1 ? std::max( std::stoull( argv[1] ), 1ull ) : 200000ull;
+
+    benchmarkBuddyBlock( operationCount );
+    for( const std::size_t liveCount : { std::size_t{ 1024 }, std::size_t{ 4096 } } )
+        benchmarkAllocator( liveCount, operationCount );
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,121 @@
+#include "utilities/Image.h"
+#include "utilities/MipmapGenerator.h"
+#include "utilities/VulkanLogger.h"
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct MipmapCase
+{
+    const char* m_name;
+    utils::Dimension m_dimension;
+    utils::MipmapGenerator::Settings m_settings;
+};
+
+// largest difference of any byte between two generated chains, the whole payload when the layouts differ
+int maxByteDifference( const utils::Image& image0, const utils::Image& image1 )
+{
+    if( image0.sizeInBytes() != image1.sizeInBytes() || image0.storedMiplevels() != image1.storedMiplevels() )
+        return 256;
+
+    int maxDifference = 0;
+    for( std::size_t i = 0; i < image0.sizeInBytes(); i++ )
+        maxDifference = std::max( maxDifference, std::abs( static_cast<int>( image0.buffer()[i] ) - static_cast<int>( image1.buffer()[i] ) ) );
+    return maxDifference;
+}
+
+} // namespace
+
+// Builds mip chains of noise images with every kernel set the build and CPU offer: the widest one (AVX2 when
+// available), SSE2 or NEON, and scalar. The vector kernels add in the same order as the AVX2 ones and have to
+// match them bit for bit. Scalar rounding differs from the vector conversion, so it may be one step off.
+// Runs on the CPU only, without AVX2 the AVX2 comparison is skipped.
+// usage: MipmapSimdTest [seed]
+int main( int argc, char** argv )
+{
+    using namespace utils;
+
+    spdlog::sink_ptr consoleSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    VulkanRendererApiLogger::createInstance( { consoleSink } );
+    VulkanRendererApiLogger::getSingletonPtr()->getLogger()->set_level( spdlog::level::warn );
+
+    const std::uint32_t seed = argc > 1 ? static_cast<std::uint32_t>( std::stoul( argv[1] ) ) : 1u;
+
+    MipmapGenerator::Settings box{};
+    MipmapGenerator::Settings srgbBox{};
+    srgbBox.m_bSrgb = true;
+    MipmapGenerator::Settings kaiser{};
+    kaiser.m_filter = MipmapGenerator::Filter::eKaiser;
+    MipmapGenerator::Settings srgbKaiserCoverage = kaiser;
+    srgbKaiserCoverage.m_bSrgb = true;
+    srgbKaiserCoverage.m_alphaCoverageCutoff = 0.5f;
+
+    // even sizes take the 2x2 box kernel, odd ones the separable filter and its row accumulation
+    const MipmapCase mipmapCases[] = {
+        { "box even", { 512, 256 }, box },
+        { "box odd", { 317, 129 }, box },
+        { "srgb box", { 256, 256 }, srgbBox },
+        { "kaiser", { 300, 200 }, kaiser },
+        { "srgb kaiser cov", { 255, 97 }, srgbKaiserCoverage }
+    };
+
+    const MipmapGenerator::SimdPath bestSimdPath = MipmapGenerator::bestSimdPath();
+    const bool bAvx2 = bestSimdPath == MipmapGenerator::SimdPath::eAvx2;
+    if( !bAvx2 )
+        std::printf( "AVX2 is not available, comparing %s against scalar only\n", MipmapGenerator::simdPath() );
+
+    MipmapGenerator mipmapGenerator{};
+    std::mt19937 randomEngine{ seed };
+    std::uniform_int_distribution<int> byteDistribution{ 0, 255 };
+    bool bPassed = true;
+
+    std::printf( "%16s %10s %10s %10s\n", "case", "best", "vector", "scalar" );
+
+    for( const MipmapCase& mipmapCase : mipmapCases )
+    {
+        // Image frees pixels it was handed like stb_image output
+        const std::size_t baseSize = static_cast<std::size_t>( mipmapCase.m_dimension.m_width ) * mipmapCase.m_dimension.m_height * 4;
+        unsigned char* pPixels = static_cast<unsigned char*>( std::malloc( baseSize ) );
+        for( std::size_t i = 0; i < baseSize; i++ )
+            pPixels[i] = static_cast<unsigned char>( byteDistribution( randomEngine ) );
+        const Image source{ mipmapCase.m_dimension, 4, pPixels };
+
+        auto l_generate = [&]( const MipmapGenerator::SimdPath& simdPath, Image& chain )
+        {
+            MipmapGenerator::Settings settings = mipmapCase.m_settings;
+            settings.m_maxSimdPath = simdPath;
+            mipmapGenerator.generate( source, settings, chain );
+        };
+
+        Image bestChain;
+        Image vectorChain;
+        Image scalarChain;
+        l_generate( bestSimdPath, bestChain );
+        l_generate( MipmapGenerator::SimdPath::eVector, vectorChain );
+        l_generate( MipmapGenerator::SimdPath::eScalar, scalarChain );
+
+        const int vectorDifference = maxByteDifference( bestChain, vectorChain );
+        const int scalarDifference = maxByteDifference( bestChain, scalarChain );
+
+        std::printf(
+            "%16s %10s %10d %10d\n",
+            mipmapCase.m_name, MipmapGenerator::simdPathName( bestSimdPath ), vectorDifference, scalarDifference
+        );
+
+        if( vectorDifference != 0 || scalarDifference > 1 )
+            bPassed = false;
+    }
+
+    std::printf( "%s\n", bPassed ? "PASSED" : "FAILED" );
+    return bPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
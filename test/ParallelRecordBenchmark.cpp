@@ -0,0 +1,144 @@
+#include "vkrender/VulkanWindow.h"
+#include "vkrender/VulkanRenderer.h"
+#include "vkrender/VulkanGPUProgram.h"
+#include "vkrender/VulkanGfxPipeline.h"
+#include "vkrender/VulkanParallelRecorder.h"
+#include "vkrender/VulkanUBO.hpp"
+#include "utilities/ThreadPool.h"
+#include "utilities/VulkanLogger.h"
+
+#include "BenchmarkOffscreenTarget.hpp"
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+const std::uint32_t BENCHMARK_DRAW_VERT_SPIRV[] = {
+#include "BenchmarkDraw.vert.inc"
+};
+
+const std::uint32_t BENCHMARK_DRAW_FRAG_SPIRV[] = {
+#include "BenchmarkDraw.frag.inc"
+};
+
+} // namespace
+
+// Records the same draw list into secondary command buffers through VulkanParallelRecorder on 1, 2, 4 ...
+// hardware threads and prints the recording throughput, every draw pushes its model matrix as push constants.
+// Only the record call is timed, the frame is then submitted and waited for before the next run.
+// Needs a Vulkan device and a window like TriangleApplication.
+// usage: ParallelRecordBenchmark [draws] [repetitions]
+int main( int argc, char** argv )
+{
+    using namespace vkrender;
+
+    // renderer setup is logged at info level, only problems are of interest here
+    spdlog::sink_ptr consoleSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    utils::VulkanRendererApiLogger::createInstance( { consoleSink } );
+    utils::VulkanRendererApiLogger::getSingletonPtr()->getLogger()->set_level( spdlog::level::warn );
+
+    const std::uint32_t drawCount = argc > 1 ? static_cast<std::uint32_t>( std::max( std::stoul( argv[1] ), 1ul ) ) : 20000u;
+    const int repetitions = argc > 2 ? std::max( std::stoi( argv[2] ), 1 ) : 10;
+
+    std::vector<std::uint32_t> threadCounts;
+    const std::uint32_t hardwareThreads = std::max( std::thread::hardware_concurrency(), 1u );
+    for( std::uint32_t threadCount = 1u; threadCount < hardwareThreads; threadCount *= 2u )
+        threadCounts.push_back( threadCount );
+    threadCounts.push_back( hardwareThreads );
+
+    VulkanWindow vkWindow{ 800, 600 };
+    vkWindow.init();
+
+    VulkanRenderer vkRenderer;
+    vkRenderer.initVulkan( &vkWindow );
+
+    {
+        BenchmarkOffscreenTarget offscreenTarget{ &vkRenderer, { 1024, 1024 } };
+
+        VulkanGpuProgram vertexShader{ BenchmarkOffscreenTarget::spirvBuffer( BENCHMARK_DRAW_VERT_SPIRV ) };
+        vertexShader.createShader( vkRenderer.getDevice(), vk::ShaderStageFlagBits::eVertex, "main" );
+        VulkanGpuProgram fragmentShader{ BenchmarkOffscreenTarget::spirvBuffer( BENCHMARK_DRAW_FRAG_SPIRV ) };
+        fragmentShader.createShader( vkRenderer.getDevice(), vk::ShaderStageFlagBits::eFragment, "main" );
+
+        VulkanGfxPipeline gfxPipeline{ vkRenderer.getDevice(), vkRenderer.getPipelineCache(), vkRenderer.getDeletionQueue(), vkRenderer.getDescriptorLayoutCache() };
+        offscreenTarget.createPipeline( gfxPipeline, { &vertexShader, &fragmentShader } );
+
+        // built up front so the runs time command recording and not matrix math
+        std::vector<VulkanObjectPushConstants> drawConstants( drawCount );
+        for( std::uint32_t i = 0u; i < drawCount; i++ )
+            drawConstants[i].model = BenchmarkOffscreenTarget::gridModel( i, drawCount );
+
+        auto l_recordSlice = [&]( vk::CommandBuffer& cmdBuffer, const std::uint32_t& firstDraw, const std::uint32_t& lastDraw )
+        {
+            cmdBuffer.bindPipeline( vk::PipelineBindPoint::eGraphics, gfxPipeline.handle() );
+            offscreenTarget.setViewportAndScissor( cmdBuffer );
+
+            for( std::uint32_t i = firstDraw; i < lastDraw; i++ )
+            {
+                gfxPipeline.pushConstants( cmdBuffer, vk::ShaderStageFlagBits::eVertex, drawConstants[i] );
+                cmdBuffer.draw( 3, 1, 0, 0 );
+            }
+        };
+
+        std::printf( "%u draws, best of %d runs\n", drawCount, repetitions );
+        std::printf( "%8s %12s %12s %12s %10s\n", "threads", "record ms", "draws/ms", "frame ms", "speedup" );
+
+        double singleThreadSeconds = 0.0;
+        VulkanFrameContext frame{};
+
+        for( const std::uint32_t threadCount : threadCounts )
+        {
+            // the calling thread records the first slice, the pool keeps at least one worker so a single
+            // thread is reached by making that first slice the whole list
+            utils::ThreadPool threadPool{ std::max( threadCount - 1u, 1u ) };
+            VulkanParallelRecorder parallelRecorder{
+                &vkRenderer, &threadPool, 1u,
+                threadCount == 1u ? drawCount : VulkanParallelRecorder::DEFAULT_MIN_DRAWS_PER_SLICE
+            };
+
+            double bestSeconds = 0.0;
+            double bestFrameSeconds = 0.0;
+
+            for( int run = 0; run < repetitions; run++ )
+            {
+                // a new frame number lets the recorder reset its pools, the previous frame was waited for
+                frame.m_frameNumber++;
+
+                vk::CommandBuffer& primaryCmdBuffer = offscreenTarget.beginPass( vk::SubpassContents::eSecondaryCommandBuffers );
+
+                const auto recordBegin = std::chrono::steady_clock::now();
+                parallelRecorder.record( &frame, primaryCmdBuffer, offscreenTarget.inheritanceInfo(), drawCount, l_recordSlice );
+                const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - recordBegin ).count();
+
+                const double frameSeconds = offscreenTarget.submitAndWait();
+
+                if( run == 0 || seconds < bestSeconds )
+                    bestSeconds = seconds;
+                if( run == 0 || frameSeconds < bestFrameSeconds )
+                    bestFrameSeconds = frameSeconds;
+            }
+
+            if( threadCount == 1u )
+                singleThreadSeconds = bestSeconds;
+
+            std::printf(
+                "%8u %12.3f %12.1f %12.3f %9.2fx\n",
+                threadCount, bestSeconds * 1000.0,
+                drawCount / ( bestSeconds * 1000.0 ),
+                bestFrameSeconds * 1000.0,
+                singleThreadSeconds / bestSeconds
+            );
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,28 @@
+#version 450
+
+// Triangle without vertex input, every draw is placed on the target by its own model matrix.
+// PER_DRAW_UNIFORM reads the matrix from a uniform buffer, bound either as a push descriptor or
+// as a dynamic uniform buffer, instead of push constants.
+
+#ifdef PER_DRAW_UNIFORM
+layout( set = 0, binding = 0 ) uniform ObjectUniforms
+{
+    mat4 model;
+} object;
+#else
+layout( push_constant ) uniform ObjectPushConstants
+{
+    mat4 model;
+} object;
+#endif
+
+layout( location = 0 ) out vec3 fragColor;
+
+const vec2 POSITIONS[3] = vec2[]( vec2( 0.0, -1.0 ), vec2( 1.0, 1.0 ), vec2( -1.0, 1.0 ) );
+const vec3 COLORS[3] = vec3[]( vec3( 1.0, 0.0, 0.0 ), vec3( 0.0, 1.0, 0.0 ), vec3( 0.0, 0.0, 1.0 ) );
+
+void main()
+{
+    gl_Position = object.model * vec4( POSITIONS[gl_VertexIndex], 0.0, 1.0 );
+    fragColor = COLORS[gl_VertexIndex];
+}
@@ -0,0 +1,216 @@
+#include "utilities/Image.h"
+#include "utilities/MipmapGenerator.h"
+#include "utilities/TextureCache.h"
+#include "utilities/ThreadPool.h"
+#include "utilities/VulkanLogger.h"
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#define STB_DXT_IMPLEMENTATION
+#include <stb/stb_dxt.h>
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct BakeFormat
+{
+    const char* m_name;
+    VkFormat m_unormFormat;
+    VkFormat m_srgbFormat;
+    // 0 for uncompressed rgba8
+    std::uint32_t m_bytesPerBlock;
+};
+
+const std::array<BakeFormat, 5> BAKE_FORMATS{ {
+    { "rgba8", VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_R8G8B8A8_SRGB, 0 },
+    { "bc1", VK_FORMAT_BC1_RGBA_UNORM_BLOCK, VK_FORMAT_BC1_RGBA_SRGB_BLOCK, 8 },
+    { "bc3", VK_FORMAT_BC3_UNORM_BLOCK, VK_FORMAT_BC3_SRGB_BLOCK, 16 },
+    { "bc4", VK_FORMAT_BC4_UNORM_BLOCK, VK_FORMAT_UNDEFINED, 8 },
+    { "bc5", VK_FORMAT_BC5_UNORM_BLOCK, VK_FORMAT_UNDEFINED, 16 },
+} };
+
+// edge blocks of levels smaller than 4x4 or of odd sizes repeat the last row and column
+std::vector<unsigned char> compressLevel( const utils::Dimension& dimension, const unsigned char* pPixels, const BakeFormat& format )
+{
+    const std::uint32_t blocksX = ( dimension.m_width + 3 ) / 4;
+    const std::uint32_t blocksY = ( dimension.m_height + 3 ) / 4;
+    std::vector<unsigned char> blocks( static_cast<std::size_t>( blocksX ) * blocksY * format.m_bytesPerBlock );
+
+    unsigned char texels[16 * 4];
+    unsigned char channels[16 * 2];
+    for( std::uint32_t blockY = 0; blockY < blocksY; blockY++ )
+    {
+        for( std::uint32_t blockX = 0; blockX < blocksX; blockX++ )
+        {
+            for( std::uint32_t texel = 0; texel < 16; texel++ )
+            {
+                const std::uint32_t x = std::min( blockX * 4 + texel % 4, dimension.m_width - 1 );
+                const std::uint32_t y = std::min( blockY * 4 + texel / 4, dimension.m_height - 1 );
+                std::memcpy( &texels[texel * 4], pPixels + ( static_cast<std::size_t>( y ) * dimension.m_width + x ) * 4, 4 );
+            }
+
+            unsigned char* pBlock = &blocks[( static_cast<std::size_t>( blockY ) * blocksX + blockX ) * format.m_bytesPerBlock];
+            if( format.m_unormFormat == VK_FORMAT_BC4_UNORM_BLOCK )
+            {
+                for( std::uint32_t texel = 0; texel < 16; texel++ )
+                    channels[texel] = texels[texel * 4];
+                stb_compress_bc4_block( pBlock, channels );
+            }
+            else if( format.m_unormFormat == VK_FORMAT_BC5_UNORM_BLOCK )
+            {
+                for( std::uint32_t texel = 0; texel < 16; texel++ )
+                {
+                    channels[texel * 2] = texels[texel * 4];
+                    channels[texel * 2 + 1] = texels[texel * 4 + 1];
+                }
+                stb_compress_bc5_block( pBlock, channels );
+            }
+            else
+            {
+                stb_compress_dxt_block( pBlock, texels, format.m_unormFormat == VK_FORMAT_BC3_UNORM_BLOCK ? 1 : 0, STB_DXT_HIGHQUAL );
+            }
+        }
+    }
+
+    return blocks;
+}
+
+} // namespace
+
+// Bakes an image into a .vkrtex texture cache with its full mip chain, optionally BC compressed,
+// so the renderer maps it at load time instead of decoding and generating mips
+// usage: TextureBaker <input image> <output.vkrtex> [--format rgba8|bc1|bc3|bc4|bc5] [--srgb] [--kaiser] [--alpha-coverage <cutoff>]
+int main( int argc, char** argv )
+{
+    if( argc < 3 )
+    {
+        std::printf( "usage: %s <input image> <output%s> [--format rgba8|bc1|bc3|bc4|bc5] [--srgb] [--kaiser] [--alpha-coverage <cutoff>]\n", argv[0], utils::TextureCache::FILE_EXTENSION );
+        return EXIT_FAILURE;
+    }
+
+    spdlog::sink_ptr consoleSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    utils::VulkanRendererApiLogger::createInstance( { consoleSink } );
+    utils::VulkanRendererApiLogger::getSingletonPtr()->getLogger()->set_level( spdlog::level::info );
+
+    const std::filesystem::path inputPath{ argv[1] };
+    const std::filesystem::path outputPath{ argv[2] };
+    const BakeFormat* pFormat = &BAKE_FORMATS[0];
+    bool srgb = false;
+    utils::MipmapGenerator::Settings mipmapSettings{};
+
+    for( int i = 3; i < argc; i++ )
+    {
+        const std::string argument{ argv[i] };
+        if( argument == "--srgb" )
+        {
+            srgb = true;
+        }
+        else if( argument == "--kaiser" )
+        {
+            mipmapSettings.m_filter = utils::MipmapGenerator::Filter::eKaiser;
+        }
+        else if( argument == "--alpha-coverage" && i + 1 < argc )
+        {
+            mipmapSettings.m_alphaCoverageCutoff = std::stof( argv[++i] );
+        }
+        else if( argument == "--format" && i + 1 < argc )
+        {
+            const std::string name{ argv[++i] };
+            auto itFormat = std::find_if( BAKE_FORMATS.begin(), BAKE_FORMATS.end(), [&name]( const BakeFormat& format ){ return name == format.m_name; } );
+            if( itFormat == BAKE_FORMATS.end() )
+            {
+                std::printf( "unknown format %s\n", name.c_str() );
+                return EXIT_FAILURE;
+            }
+            pFormat = &*itFormat;
+        }
+        else
+        {
+            std::printf( "unknown argument %s\n", argument.c_str() );
+            return EXIT_FAILURE;
+        }
+    }
+
+    if( srgb && pFormat->m_srgbFormat == VK_FORMAT_UNDEFINED )
+    {
+        std::printf( "%s has no sRGB variant\n", pFormat->m_name );
+        return EXIT_FAILURE;
+    }
+
+    // Image::loadBuffer only logs a missing file and leaves the image empty
+    if( !std::filesystem::is_regular_file( inputPath ) )
+    {
+        std::printf( "%s does not exist or is not a file\n", inputPath.string().c_str() );
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        utils::Image image;
+        image.loadBuffer( inputPath, 4 );
+        // decode errors throw, an empty image means the file went away or was skipped by the loader
+        if( !image.buffer() )
+        {
+            std::printf( "%s has no pixel data after loading\n", inputPath.string().c_str() );
+            return EXIT_FAILURE;
+        }
+
+        if( image.vkFormat() != VK_FORMAT_UNDEFINED )
+        {
+            std::printf( "%s is already a GPU ready container\n", inputPath.string().c_str() );
+            return EXIT_FAILURE;
+        }
+
+        // same filtering the renderer falls back to at load time
+        mipmapSettings.m_bSrgb = srgb;
+        utils::ThreadPool threadPool;
+        utils::Image mipChain;
+        utils::MipmapGenerator( &threadPool ).generate( image, mipmapSettings, mipChain );
+        image.clearBuffer();
+
+        std::vector<std::vector<unsigned char>> compressedLevels( mipChain.storedMiplevels() );
+        std::vector<utils::TextureCache::Level> levels;
+        for( std::uint32_t level = 0; level < mipChain.storedMiplevels(); level++ )
+        {
+            const utils::Image::MipLevel& mipLevel = mipChain.mipLevel( level );
+            const unsigned char* pPixels = mipChain.buffer() + mipLevel.m_offset;
+
+            if( pFormat->m_bytesPerBlock == 0 )
+            {
+                levels.push_back( utils::TextureCache::Level{ mipLevel.m_dimension, pPixels, mipLevel.m_sizeInBytes } );
+                continue;
+            }
+
+            compressedLevels[level] = compressLevel( mipLevel.m_dimension, pPixels, *pFormat );
+            levels.push_back( utils::TextureCache::Level{ mipLevel.m_dimension, compressedLevels[level].data(), compressedLevels[level].size() } );
+        }
+
+        const VkFormat vkFormat = srgb ? pFormat->m_srgbFormat : pFormat->m_unormFormat;
+        utils::TextureCache::write( outputPath, static_cast<std::uint32_t>( vkFormat ), levels );
+
+        std::size_t bakedBytes = 0;
+        for( const utils::TextureCache::Level& level : levels )
+            bakedBytes += level.m_sizeInBytes;
+
+        std::printf( "%s -> %s: %ux%u %s%s, %zu levels, %zu bytes\n", inputPath.string().c_str(), outputPath.string().c_str(),
+                     mipChain.dimension().m_width, mipChain.dimension().m_height, pFormat->m_name, srgb ? " srgb" : "", levels.size(), bakedBytes );
+    }
+    catch( const std::exception& e )
+    {
+        std::printf( "baking failed: %s\n", e.what() );
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}